@@ -121,7 +121,8 @@ int main() {
     // Subscribe to metrics alerts
     auto alert_sub = event_bus->subscribe<metrics_alert_event>(
         [](const metrics_alert_event& alert) {
-            std::cout << "[METRICS ALERT] " << alert.message 
+            std::cout << "[METRICS ALERT] " << alert.message
+                     << " [" << alert_state_name(alert.state) << "]"
                      << " (current: " << alert.current_value 
                      << ", threshold: " << alert.threshold << ")" << std::endl;
         }
@@ -146,8 +147,8 @@ int main() {
     monitor->initialize();
     
     // Register components with metrics aggregator
-    aggregator.register_component("thread_executor", executor);
-    aggregator.register_component("system_monitor", monitor);
+    aggregator.register_component("thread_executor", component_kind::thread_pool, executor);
+    aggregator.register_component("system_monitor", component_kind::system_monitor, monitor);
     
     // Start metrics collection
     aggregator.start();
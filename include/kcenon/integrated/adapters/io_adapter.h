@@ -0,0 +1,113 @@
+// BSD 3-Clause License
+// Copyright (c) 2025, kcenon
+// See the LICENSE file in the project root for full license information.
+
+/**
+ * @file io_adapter.h
+ * @brief Asynchronous file I/O executor
+ *
+ * Submits positional reads, writes and fsyncs to the kernel through io_uring
+ * and completes them into futures from a single completion thread, so no
+ * pool worker is occupied while the kernel performs the I/O.
+ *
+ * When io_uring is unavailable (older kernels, seccomp filters, non-Linux
+ * platforms) or disabled, requests are executed with pread/pwrite/fsync on a
+ * small set of dedicated I/O threads instead.
+ *
+ * Buffers passed to read() and write() must stay valid until the returned
+ * future is ready. Like the underlying system calls, reads and writes may
+ * transfer fewer bytes than requested.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <span>
+#include <kcenon/common/patterns/result.h>
+#include <kcenon/integrated/core/configuration.h>
+
+namespace kcenon::integrated::adapters {
+
+/**
+ * @brief Backend executing asynchronous file I/O
+ */
+enum class io_backend {
+    io_uring,   // Kernel submission/completion rings
+    threads     // Blocking system calls on dedicated I/O threads
+};
+
+/**
+ * @brief Adapter for asynchronous file I/O
+ */
+class io_adapter {
+public:
+    /**
+     * @brief Construct adapter with configuration
+     */
+    explicit io_adapter(const io_config& config);
+
+    /**
+     * @brief Destructor waits for in-flight requests and releases the backend
+     */
+    ~io_adapter();
+
+    // Non-copyable, movable
+    io_adapter(const io_adapter&) = delete;
+    io_adapter& operator=(const io_adapter&) = delete;
+    io_adapter(io_adapter&&) noexcept;
+    io_adapter& operator=(io_adapter&&) noexcept;
+
+    /**
+     * @brief Set up io_uring, or the thread fallback if that fails
+     */
+    common::VoidResult initialize();
+
+    /**
+     * @brief Wait for in-flight requests, then stop the backend
+     */
+    common::VoidResult shutdown();
+
+    /**
+     * @brief Check if adapter is initialized
+     */
+    bool is_initialized() const;
+
+    /**
+     * @brief Get the backend selected by initialize()
+     */
+    io_backend backend() const;
+
+    /**
+     * @brief Read from a file descriptor at an offset
+     * @return Future with the number of bytes read (0 at end of file);
+     *         holds std::system_error on failure
+     */
+    std::future<std::size_t> read(int fd, std::span<std::byte> buffer, std::uint64_t offset);
+
+    /**
+     * @brief Write to a file descriptor at an offset
+     * @return Future with the number of bytes written; holds std::system_error on failure
+     */
+    std::future<std::size_t> write(int fd, std::span<const std::byte> buffer, std::uint64_t offset);
+
+    /**
+     * @brief Flush a file descriptor's data and metadata to storage
+     * @return Future that becomes ready once the flush completed; holds
+     *         std::system_error on failure
+     */
+    std::future<void> fsync(int fd);
+
+    /**
+     * @brief Get number of submitted requests that have not completed yet
+     */
+    std::size_t in_flight() const;
+
+private:
+    class impl;
+    std::unique_ptr<impl> pimpl_;
+};
+
+} // namespace kcenon::integrated::adapters
@@ -0,0 +1,104 @@
+// BSD 3-Clause License
+// Copyright (c) 2025, kcenon
+// See the LICENSE file in the project root for full license information.
+
+/**
+ * @file metrics_endpoint.h
+ * @brief Built-in HTTP endpoint for metrics scraping and health probes
+ *
+ * A minimal HTTP/1.1 server running on one thread around an epoll loop. It
+ * answers GET and HEAD for three paths:
+ * - metrics_path: Prometheus text, or OpenMetrics when the Accept header asks for it
+ * - metrics_path + ".json": the JSON export
+ * - health_path: health as JSON, 200 when healthy and 503 otherwise
+ *
+ * Connections are kept alive (HTTP/1.1 default) and pipelined requests are
+ * answered in order. The Prometheus exposition is written into one writer
+ * owned by the server thread, and connection buffers keep their capacity, so
+ * steady-state scrapes do not allocate.
+ *
+ * The endpoint is available on Linux in builds with ENABLE_WEB_DASHBOARD;
+ * elsewhere initialize() returns an error.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <kcenon/common/patterns/result.h>
+#include <kcenon/integrated/core/configuration.h>
+#include <kcenon/integrated/core/prometheus_writer.h>
+
+namespace kcenon::integrated::adapters {
+
+/**
+ * @brief Response body of a health probe
+ */
+struct health_response {
+    bool healthy = true;  // false answers 503 Service Unavailable
+    std::string body;     // JSON document
+};
+
+/**
+ * @brief Sources the endpoint serves; invoked on the server thread
+ */
+struct metrics_endpoint_handlers {
+    std::function<void(prometheus_writer&)> write_metrics;
+    std::function<std::string()> metrics_json;
+    std::function<health_response()> health;
+};
+
+/**
+ * @brief Adapter serving metrics and health over HTTP
+ */
+class metrics_endpoint {
+public:
+    /**
+     * @brief Construct adapter with configuration and content sources
+     */
+    metrics_endpoint(const metrics_endpoint_config& config, metrics_endpoint_handlers handlers);
+
+    /**
+     * @brief Destructor stops the server and closes every connection
+     */
+    ~metrics_endpoint();
+
+    // Non-copyable, movable
+    metrics_endpoint(const metrics_endpoint&) = delete;
+    metrics_endpoint& operator=(const metrics_endpoint&) = delete;
+    metrics_endpoint(metrics_endpoint&&) noexcept;
+    metrics_endpoint& operator=(metrics_endpoint&&) noexcept;
+
+    /**
+     * @brief Bind the listening socket and start the server thread
+     */
+    common::VoidResult initialize();
+
+    /**
+     * @brief Stop the server thread and close every connection
+     */
+    common::VoidResult shutdown();
+
+    /**
+     * @brief Check if the server is running
+     */
+    bool is_initialized() const;
+
+    /**
+     * @brief Port the server listens on (the chosen one when configured as 0)
+     */
+    std::uint16_t port() const;
+
+    /**
+     * @brief Get number of requests answered so far
+     */
+    std::uint64_t requests_served() const;
+
+private:
+    class impl;
+    std::unique_ptr<impl> pimpl_;
+};
+
+} // namespace kcenon::integrated::adapters
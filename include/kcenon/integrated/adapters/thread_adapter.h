@@ -16,11 +16,13 @@
 
 #pragma once
 
+#include <chrono>
 #include <functional>
 #include <future>
 #include <memory>
 #include <concepts>
 #include <iterator>
+#include <vector>
 #include <kcenon/common/patterns/result.h>
 #include <kcenon/integrated/core/configuration.h>
 
@@ -31,6 +33,11 @@
     #endif
 #endif
 
+namespace kcenon::integrated {
+class lock_profiler;
+struct worker_utilization;
+}
+
 namespace kcenon::integrated::adapters {
 
 /**
@@ -79,6 +86,17 @@ public:
      */
     common::VoidResult execute(std::function<void()> task);
 
+    /**
+     * @brief Execute a task that completion waits do not wait for
+     *
+     * For background work such as health probes, which may run long or hang.
+     * The external thread_system pool counts it like any other task.
+     *
+     * @param task Task to execute
+     * @return Result indicating success or error
+     */
+    common::VoidResult execute_untracked(std::function<void()> task);
+
     /**
      * @brief Execute a task with priority
      * @param priority Priority level (0-127: 0-31=Background, 32-95=Batch, 96-127=RealTime)
@@ -140,6 +158,65 @@ public:
      */
     bool wait_for_completion_timeout(std::chrono::milliseconds timeout);
 
+    /**
+     * @brief Check whether the calling thread is one of this pool's workers
+     * @return false when the external thread_system pool is in use
+     */
+    bool is_worker_thread() const;
+
+    /**
+     * @brief Run one queued task on the calling worker thread
+     *
+     * Lets a worker that waits on a future make progress on other work
+     * instead of blocking. Nesting is bounded to protect the worker's stack.
+     *
+     * @return true if a task was run, false if the caller is not a worker,
+     *         the nesting bound is reached or nothing is queued
+     */
+    bool run_pending_task();
+
+    /**
+     * @brief Mark the calling worker as about to block
+     *
+     * Starts or unparks a compensating worker so that the configured number
+     * of workers stays runnable. Compensators park again once blocked
+     * workers resume. Pair every successful call with end_blocking().
+     *
+     * @return true if the caller is a worker and the block was registered
+     */
+    bool begin_blocking();
+
+    /**
+     * @brief Mark the end of a section started with begin_blocking()
+     */
+    void end_blocking();
+
+    /**
+     * @brief Get number of workers currently inside a blocking section
+     */
+    std::size_t blocked_worker_count() const;
+
+    /**
+     * @brief Get number of compensating workers currently running
+     */
+    std::size_t compensating_worker_count() const;
+
+    /**
+     * @brief Contention profile of the built-in pool's queue lock
+     * @return Null unless thread_config::enable_lock_profiling is set and the
+     *         built-in pool is in use
+     */
+    const lock_profiler* lock_profiling() const;
+
+    /**
+     * @brief Read each built-in pool worker's busy, spinning, idle and parked time
+     * @param out Replaced with one entry per started worker, compensators included;
+     *            left empty when the external thread_system pool is in use
+     * @param now Time up to which the current activity is counted
+     */
+    void read_workers(std::vector<worker_utilization>& out,
+                      std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now()) const;
+
     // Scheduler Interface Support (thread_system v1.0.0+)
 
     /**
@@ -225,6 +302,13 @@ public:
      */
     void cancel_token(std::shared_ptr<void> token);
 
+    /**
+     * @brief Check if a token has been cancelled
+     * @param token Token to check
+     * @return true if cancelled, false otherwise
+     */
+    bool is_token_cancelled(std::shared_ptr<void> token) const;
+
     /**
      * @brief Submit a cancellable task
      * @tparam F Function type (must be invocable with Args)
@@ -242,13 +326,6 @@ public:
         -> std::future<std::invoke_result_t<F, Args...>>;
 
 private:
-    /**
-     * @brief Check if a token has been cancelled
-     * @param token Token to check
-     * @return true if cancelled, false otherwise
-     */
-    bool is_token_cancelled(std::shared_ptr<void> token) const;
-
     class impl;
     std::unique_ptr<impl> pimpl_;
 };
@@ -0,0 +1,175 @@
+// BSD 3-Clause License
+// Copyright (c) 2025, kcenon
+// See the LICENSE file in the project root for full license information.
+
+/**
+ * @file alert_rule_engine.h
+ * @brief Alert rules with sustain windows, compiled once and evaluated per sample
+ *
+ * A rule is a condition over named metrics plus how long it must hold, as in
+ * the alerting section of production.json:
+ *
+ *     "condition": "queue_utilization > 95", "duration": "1m"
+ *
+ * Conditions compare metrics and numbers with > >= < <= == != and combine
+ * comparisons with && (and), || (or), ! (not) and parentheses. add_rule()
+ * resolves metric names to column indexes and compiles the condition into a
+ * flat postfix program, so evaluate() walks a few instructions per rule over
+ * the sample's values without parsing, lookups or allocation.
+ *
+ * Each rule follows inactive -> pending -> firing -> resolved: pending while
+ * the condition holds for less than its duration, firing once it has held
+ * that long, resolved when it stops holding after firing. Only transitions
+ * are reported; a rule that stays firing is reported once.
+ *
+ * parse_alerting_section() reads the rules of such an alerting section, so a
+ * configuration file can be handed to add_rule() as is.
+ *
+ * Not thread-safe; the owner serializes access.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <kcenon/common/patterns/result.h>
+
+namespace kcenon::integrated {
+
+enum class alert_state {
+    inactive,
+    pending,   // Condition holds, for less than the rule's duration so far
+    firing,
+    resolved   // Condition stopped holding after firing
+};
+
+const char* alert_state_name(alert_state state);
+
+struct alert_rule_definition {
+    std::string name;
+    std::string condition;                  // e.g. "cpu_usage > 85 && error_rate > 1"
+    std::chrono::milliseconds duration{0};  // How long the condition must hold before firing
+    std::string severity{"warning"};
+};
+
+/**
+ * @brief A rule changing state
+ */
+struct alert_transition {
+    std::size_t rule;
+    alert_state from;
+    alert_state to;
+    std::chrono::system_clock::time_point since;  // When the condition started or stopped holding
+    double value;      // Metric of the rule's first comparison
+    double threshold;  // Number it is compared with
+};
+
+class alert_rule_engine {
+public:
+    using clock = std::chrono::system_clock;
+    using transition_handler = std::function<void(const alert_transition&)>;
+
+    /**
+     * @param metrics Names of the columns of the samples passed to evaluate()
+     */
+    explicit alert_rule_engine(std::vector<std::string> metrics);
+
+    /**
+     * @brief Name another column; aliases are accepted in conditions like the name
+     */
+    void add_alias(std::string alias, std::size_t column);
+
+    /**
+     * @brief Compile and add a rule
+     * @return Index of the rule, or an error naming what does not parse
+     */
+    common::Result<std::size_t> add_rule(const alert_rule_definition& rule);
+
+    /**
+     * @brief Remove every rule
+     */
+    void clear();
+
+    /**
+     * @brief Evaluate every rule against one sample, reporting transitions
+     *
+     * values must hold one value per metric given to the constructor.
+     */
+    void evaluate(clock::time_point now, std::span<const double> values,
+                  const transition_handler& on_transition);
+
+    std::size_t rule_count() const { return rules_.size(); }
+    const alert_rule_definition& rule(std::size_t index) const { return rules_[index].definition; }
+    alert_state state(std::size_t index) const { return rules_[index].state; }
+
+    /**
+     * @brief Index of a rule by name
+     */
+    common::Result<std::size_t> find_rule(std::string_view name) const;
+
+    /**
+     * @brief Parse durations such as "30s", "1m", "1h30m", "250ms" or "2d"
+     *
+     * A bare number is seconds.
+     */
+    static common::Result<std::chrono::milliseconds> parse_duration(std::string_view text);
+
+    /**
+     * @brief Rule definitions of an alerting section in the production.json form
+     *
+     * json may be a whole configuration file; the first "alerting" object in
+     * it is used. Each member of its "rules" object becomes a rule named after
+     * its key, from "condition", "duration" and "severity". A section with
+     * "enabled": false yields no rules.
+     */
+    static common::Result<std::vector<alert_rule_definition>> parse_alerting_section(std::string_view json);
+
+    /**
+     * @brief parse_alerting_section() of a file
+     */
+    static common::Result<std::vector<alert_rule_definition>> load_alerting_section(const std::string& path);
+
+private:
+    enum class opcode : std::uint8_t { compare, logical_and, logical_or, logical_not };
+    enum class comparison : std::uint8_t { greater, greater_equal, less, less_equal, equal, not_equal };
+
+    struct operand {
+        bool is_metric;
+        std::size_t column;
+        double constant;
+    };
+
+    struct instruction {
+        opcode op;
+        comparison cmp;
+        operand lhs;
+        operand rhs;
+    };
+
+    struct compiled_rule {
+        alert_rule_definition definition;
+        std::vector<instruction> program;  // Postfix
+        std::size_t depth;                 // Stack slots the program needs
+        alert_state state{alert_state::inactive};
+        clock::time_point since{};
+    };
+
+    class parser;
+
+    bool run(const compiled_rule& rule, std::span<const double> values);
+    static double load(const operand& source, std::span<const double> values);
+
+    std::vector<std::string> names_;
+    std::vector<std::size_t> columns_;  // Column of each name
+    std::size_t metric_count_;
+    std::vector<compiled_rule> rules_;
+    std::vector<std::uint8_t> stack_;
+};
+
+} // namespace kcenon::integrated
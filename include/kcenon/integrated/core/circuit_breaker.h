@@ -0,0 +1,156 @@
+// BSD 3-Clause License
+// Copyright (c) 2025, kcenon
+// See the LICENSE file in the project root for full license information.
+
+/**
+ * @file circuit_breaker.h
+ * @brief Lock-free sliding-window circuit breaker for the submit path
+ *
+ * Outcomes are counted in a ring of per-second buckets. The breaker opens
+ * when, over the window, the failure rate or the slow-call rate reaches its
+ * threshold (once minimum_calls were seen), or after failure_threshold
+ * consecutive failures. After reset_timeout it turns half-open and admits
+ * half_open_permits probe calls; all of them succeeding closes it again,
+ * any failing or slow probe re-opens it.
+ *
+ * Every admitted call carries a circuit_permit to record(), or back to
+ * release() if it is rejected further down the submit path. Only probes
+ * decide a half-open round: calls admitted while closed that finish during
+ * it are ignored, and a released probe permit can be handed out again.
+ *
+ * acquire() costs one atomic load while the breaker is closed. Each bucket
+ * counts into sharded_counters, so concurrent record() calls on different
+ * threads do not bounce one cache line. Counts are approximate when a bucket
+ * is recycled concurrently with a record().
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <kcenon/integrated/core/configuration.h>
+#include <kcenon/integrated/core/sharded_counter.h>
+
+namespace kcenon::integrated {
+
+/**
+ * @brief State of a circuit breaker
+ */
+enum class circuit_state : std::uint8_t {
+    closed,     // Calls are admitted and counted
+    open,       // Calls are rejected until reset_timeout elapsed
+    half_open   // A limited number of probe calls are admitted
+};
+
+/**
+ * @brief Outcome rates over the breaker's sliding window
+ */
+struct circuit_window_stats {
+    std::uint64_t calls{0};
+    std::uint64_t failures{0};
+    std::uint64_t slow_calls{0};
+};
+
+/**
+ * @brief Admission of one call, handed from acquire() to record() or release()
+ */
+struct circuit_permit {
+    std::uint64_t probe_round{0};  // Half-open round that admitted the call; 0 unless a probe
+
+    bool is_probe() const noexcept { return probe_round != 0; }
+};
+
+class circuit_breaker {
+public:
+    using clock = std::chrono::steady_clock;
+
+    explicit circuit_breaker(const circuit_breaker_config& config);
+
+    circuit_breaker(const circuit_breaker&) = delete;
+    circuit_breaker& operator=(const circuit_breaker&) = delete;
+
+    /**
+     * @brief Admit a call, or reject it
+     *
+     * Moves an open breaker to half-open once reset_timeout has elapsed and
+     * hands out probe permits while half-open.
+     *
+     * @return The call's permit, or nothing when it must be rejected
+     */
+    std::optional<circuit_permit> acquire() noexcept {
+        if (state_.load(std::memory_order_acquire) == circuit_state::closed) {
+            return circuit_permit{};
+        }
+        return acquire_slow();
+    }
+
+    /**
+     * @brief Record the outcome of a call admitted with permit
+     * @return true if this outcome opened the breaker
+     */
+    bool record(const circuit_permit& permit, bool success, std::chrono::nanoseconds duration) noexcept;
+
+    /**
+     * @brief Return the permit of an admitted call that will never run
+     */
+    void release(const circuit_permit& permit) noexcept;
+
+    /**
+     * @brief Force the breaker closed and clear the window
+     */
+    void reset() noexcept;
+
+    circuit_state state() const noexcept {
+        return state_.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief Check whether calls are currently being rejected
+     */
+    bool is_open() const noexcept {
+        return state() == circuit_state::open;
+    }
+
+    /**
+     * @brief Sum the buckets that are still inside the window
+     */
+    circuit_window_stats window_stats() const noexcept;
+
+private:
+    struct bucket {
+        alignas(sharded_counter::cache_line_size) std::atomic<std::int64_t> second{-1};
+        sharded_counter calls;
+        sharded_counter failures;
+        sharded_counter slow_calls;
+    };
+
+    std::optional<circuit_permit> acquire_slow() noexcept;
+    bool record_probe(const circuit_permit& permit, bool success, bool slow, std::int64_t now) noexcept;
+    bool trip(circuit_state from, std::int64_t now) noexcept;
+    bool should_trip(std::int64_t now_second) const noexcept;
+    bucket& bucket_for(std::int64_t second) noexcept;
+    circuit_window_stats sum_window(std::int64_t now_second) const noexcept;
+    void clear_window() noexcept;
+
+    static std::int64_t now_ns() noexcept;
+
+    circuit_breaker_config config_;
+    std::size_t bucket_count_;
+    std::int64_t slow_call_ns_;
+    std::unique_ptr<bucket[]> buckets_;
+
+    std::atomic<circuit_state> state_{circuit_state::closed};
+    std::atomic<std::int64_t> open_until_{0};
+    std::atomic<std::size_t> consecutive_failures_{0};
+
+    // Half-open round in the high bits, permits left / successes in the low
+    // bits, so a stale probe can never spend or fill another round's count
+    std::atomic<std::uint64_t> probe_permits_{0};
+    std::atomic<std::uint64_t> probe_successes_{0};
+};
+
+} // namespace kcenon::integrated
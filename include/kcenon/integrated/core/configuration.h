@@ -13,6 +13,8 @@
 #pragma once
 
 #include <cstddef>
+#include <cstdint>
+#include <functional>
 #include <string>
 #include <chrono>
 
@@ -52,7 +54,11 @@ struct thread_config {
     bool enable_dynamic_scaling = false;
     std::size_t min_threads = 1;
     std::size_t max_threads = 0;  // 0 = no limit
+    bool enable_batch_processing = true;  // Drain several queued tasks per lock acquisition
+    std::size_t batch_size = 64;  // Upper bound on tasks taken per acquisition
     bool enable_priority_scheduling = false;  // Enable for typed_thread_pool
+    bool enable_lock_profiling = false;  // Count and time contended queue lock acquisitions
+    std::function<void(std::size_t)> on_worker_start;  // Called on each built-in pool worker with its index
 
     // Scheduler options (thread_system v1.0.0+)
     bool enable_scheduler = false;  // Enable scheduler interface support
@@ -136,8 +142,39 @@ struct monitoring_config {
  */
 struct circuit_breaker_config {
     bool enabled = false;
-    std::size_t failure_threshold = 5;
-    std::chrono::milliseconds reset_timeout{5000};
+    std::size_t failure_threshold = 5;  // Consecutive failures that open the breaker
+    std::chrono::milliseconds reset_timeout{5000};  // Time open before half-open probing
+
+    // Sliding window over per-second buckets
+    std::size_t window_seconds = 10;
+    std::size_t minimum_calls = 20;  // Calls in the window before rates are evaluated
+    double failure_rate_threshold = 0.5;  // Failed / calls that opens the breaker
+    double slow_call_rate_threshold = 1.0;  // Slow / calls that opens the breaker
+    std::chrono::milliseconds slow_call_duration{0};  // 0 disables slow-call tracking
+
+    std::size_t half_open_permits = 3;  // Probe calls admitted while half-open
+};
+
+/**
+ * @brief Asynchronous file I/O configuration
+ */
+struct io_config {
+    bool enable_io_uring = true;  // Fall back to blocking I/O threads when false or unsupported
+    std::size_t queue_depth = 256;  // io_uring submission queue entries
+    std::size_t fallback_threads = 2;  // Dedicated I/O threads for the fallback backend
+};
+
+/**
+ * @brief Built-in HTTP endpoint serving metrics and health
+ */
+struct metrics_endpoint_config {
+    bool enabled = false;
+    std::string bind_address = "127.0.0.1";  // IPv4 address; 0.0.0.0 listens on all interfaces
+    std::uint16_t port = 9090;  // 0 picks a free port
+    std::string metrics_path = "/metrics";  // JSON is served at metrics_path + ".json"
+    std::string health_path = "/health";
+    std::size_t max_connections = 64;  // Further connections are refused
+    std::chrono::milliseconds idle_timeout{30000};  // Keep-alive connections idle this long are closed
 };
 
 /**
@@ -149,6 +186,8 @@ struct unified_config {
     logger_config logger;
     monitoring_config monitoring;
     circuit_breaker_config circuit_breaker;
+    io_config io;
+    metrics_endpoint_config metrics_endpoint;
 
     // Integration settings
     bool enable_auto_profiling = true;
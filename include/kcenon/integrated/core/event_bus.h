@@ -0,0 +1,138 @@
+// BSD 3-Clause License
+// Copyright (c) 2025, kcenon
+// See the LICENSE file in the project root for full license information.
+
+/**
+ * @file event_bus.h
+ * @brief Event dispatch with lock-free readers
+ *
+ * Event types are interned once into small integer IDs, so emitting does
+ * not look anything up by string. Each type holds an immutable subscriber
+ * array that writers replace copy-on-write; emit() only loads the current
+ * array and never takes a lock.
+ *
+ * Subscribers choose their delivery:
+ * - sync: the callback runs on the emitting thread
+ * - async: the event is pushed into the subscriber's own bounded ring and
+ *   a dedicated dispatcher thread runs the callback. A full ring drops the
+ *   event and counts it, so a slow subscriber never stalls the emitter.
+ *
+ * Because readers work on a snapshot, a callback may still run once after
+ * unsubscribe() returned for an emit that was already in progress.
+ */
+
+#pragma once
+
+#include <any>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace kcenon::integrated {
+
+using event_type_id = std::uint32_t;
+
+/**
+ * @brief How a subscriber receives events
+ */
+enum class event_delivery {
+    sync,   // On the emitting thread
+    async   // On the subscriber's dispatcher thread, through a bounded ring
+};
+
+/**
+ * @brief Event bus counters
+ */
+struct event_bus_stats {
+    std::size_t event_types{0};        // Interned event types
+    std::size_t subscribers{0};        // Active subscriptions
+    std::uint64_t dropped{0};          // Async events discarded because a ring was full
+    std::uint64_t callback_errors{0};  // Exceptions thrown by callbacks
+};
+
+class event_bus {
+public:
+    using callback = std::function<void(const std::string&, const std::any&)>;
+
+    static constexpr std::size_t max_event_types = 256;
+    static constexpr std::size_t default_queue_capacity = 1024;
+
+    event_bus();
+    ~event_bus();
+
+    event_bus(const event_bus&) = delete;
+    event_bus& operator=(const event_bus&) = delete;
+
+    /**
+     * @brief Get the ID of an event type, registering it on first use
+     * @throws std::runtime_error when max_event_types are already registered
+     */
+    event_type_id intern(std::string_view type);
+
+    /**
+     * @brief Get the name an ID was interned from
+     */
+    const std::string& name(event_type_id id) const;
+
+    /**
+     * @brief Add a subscriber
+     * @param queue_capacity Ring size for async delivery (rounded up to a power of two)
+     * @return Subscription ID for unsubscribe()
+     */
+    std::size_t subscribe(event_type_id type, callback cb,
+                          event_delivery delivery = event_delivery::sync,
+                          std::size_t queue_capacity = default_queue_capacity);
+
+    /**
+     * @brief Remove a subscriber; async subscribers drain their ring first
+     * @return false if the ID is unknown
+     */
+    bool unsubscribe(std::size_t subscription_id);
+
+    /**
+     * @brief Check for subscribers with a single atomic load
+     *
+     * Lets emitters skip building a payload nobody receives.
+     */
+    bool has_subscribers(event_type_id type) const noexcept;
+
+    /**
+     * @brief Deliver an event to the current subscribers of its type
+     */
+    void emit(event_type_id type, const std::any& payload);
+
+    /**
+     * @brief Remove all subscribers and stop their dispatcher threads
+     */
+    void shutdown();
+
+    event_bus_stats stats() const;
+
+private:
+    struct counters;
+    struct subscriber;
+    struct type_slot;
+
+    using subscriber_list = std::vector<std::shared_ptr<subscriber>>;
+
+    static void stop_subscriber(subscriber& sub);
+
+    std::unique_ptr<type_slot[]> slots_;
+    std::shared_ptr<counters> counters_;  // Shared with dispatcher threads
+
+    // Guards interning and subscriber list replacement
+    mutable std::mutex write_mutex_;
+    std::unordered_map<std::string, event_type_id> type_ids_;
+    std::atomic<std::size_t> type_count_{0};
+    std::unordered_map<std::size_t, event_type_id> subscription_types_;
+    std::size_t next_subscription_id_{1};
+};
+
+} // namespace kcenon::integrated
@@ -0,0 +1,189 @@
+// BSD 3-Clause License
+// Copyright (c) 2025, kcenon
+// See the LICENSE file in the project root for full license information.
+
+/**
+ * @file flight_recorder.h
+ * @brief Always-on rings of compact scheduler events, dumped after the fact
+ *
+ * Every worker owns a fixed-size ring of 16-byte events (enqueue, dequeue,
+ * start, finish, park, unpark, steal, reject); one more ring is shared by
+ * the threads that are not workers. Full rings overwrite their oldest
+ * events, so the recorder always holds the most recent history of each
+ * worker and costs nothing to leave on: recording is two relaxed stores and
+ * a counter bump, with timestamps the scheduler has already read.
+ *
+ * dump() writes the rings to a binary file while they keep recording;
+ * passing it the heads() taken earlier leaves out what was recorded since,
+ * so the slow write can happen elsewhere. Both
+ * words of an event carry the lap of the ring it was written in; dump()
+ * drops events whose laps do not match their position, which are the ones
+ * overwritten while being read. Timestamps keep 56 bits of nanoseconds,
+ * about two years of uptime.
+ *
+ * File layout (native byte order):
+ *
+ *     header: "KCFLIGHT", u32 version (1), u32 ring count,
+ *             i64 system_clock ns at timestamp 0
+ *     per ring: u32 ring id (worker id, or shared_ring_id),
+ *               u32 event count, flight_event[count] oldest first
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include <kcenon/common/patterns/result.h>
+
+namespace kcenon::integrated {
+
+enum class flight_event_kind : std::uint8_t {
+    enqueue,  // arg = queue depth after the push
+    dequeue,  // Taken from the shared queue; arg = tasks taken in the batch
+    start,    // arg = priority
+    finish,   // arg = 0 succeeded, 1 failed
+    park,     // Worker going to sleep; arg = 0 waiting for work, 1 parked as a spare
+    unpark,   // Worker woke up
+    steal,    // arg = victim worker
+    reject    // arg = flight_reject_reason
+};
+
+enum class flight_reject_reason : std::uint32_t {
+    circuit_open = 1,
+    shutting_down = 2,
+    queue_full = 3
+};
+
+const char* flight_event_name(flight_event_kind kind);
+
+/**
+ * @brief One recorded event, as laid out in memory and in dump files
+ */
+struct flight_event {
+    std::uint64_t timestamp_ns;  // steady_clock, since the recorder was created
+    std::uint32_t arg;
+    std::uint16_t lap;           // Ring lap the event was written in (consistency check)
+    flight_event_kind kind;
+    std::uint8_t reserved;
+};
+static_assert(sizeof(flight_event) == 16);
+
+/**
+ * @brief Events of one ring, read back from a dump
+ */
+struct flight_ring_dump {
+    std::uint32_t id;
+    std::vector<flight_event> events;  // Oldest first
+};
+
+struct flight_recorder_dump {
+    std::chrono::system_clock::time_point epoch;  // Wall time of timestamp 0
+    std::vector<flight_ring_dump> rings;
+};
+
+class flight_recorder {
+public:
+    using clock = std::chrono::steady_clock;
+
+    static constexpr std::uint32_t shared_ring_id = 0xFFFFFFFF;
+
+    /**
+     * @param workers Number of worker rings
+     * @param events_per_ring Ring capacity, rounded up to a power of two
+     */
+    flight_recorder(std::size_t workers, std::size_t events_per_ring);
+    ~flight_recorder();
+
+    flight_recorder(const flight_recorder&) = delete;
+    flight_recorder& operator=(const flight_recorder&) = delete;
+
+    /**
+     * @brief Record on a worker's ring; only that worker may call this
+     */
+    void record(std::size_t worker, flight_event_kind kind, clock::time_point at,
+                std::uint32_t arg = 0) noexcept {
+        ring& target = rings_[worker];
+        const std::uint64_t position = target.head.load(std::memory_order_relaxed);
+        write(target, position, kind, at, arg);
+        target.head.store(position + 1, std::memory_order_release);
+    }
+
+    /**
+     * @brief Record on the shared ring; any thread may call this
+     */
+    void record_shared(flight_event_kind kind, clock::time_point at, std::uint32_t arg = 0) noexcept {
+        ring& target = rings_[workers_];
+        write(target, target.head.fetch_add(1, std::memory_order_relaxed), kind, at, arg);
+    }
+
+    std::size_t workers() const noexcept { return workers_; }
+    std::size_t capacity() const noexcept { return mask_ + 1; }
+
+    /**
+     * @brief Copy the events of one ring, oldest first
+     * @param ring Worker index, or workers() for the shared ring
+     */
+    std::vector<flight_event> events(std::size_t ring) const;
+
+    /**
+     * @brief Positions every ring has recorded up to, one per ring
+     */
+    std::vector<std::uint64_t> heads() const;
+
+    /**
+     * @brief Write every ring to a file; see the file comment for the layout
+     */
+    common::VoidResult dump(const std::string& path) const;
+
+    /**
+     * @brief Write every ring as of heads, which an earlier heads() returned
+     *
+     * Events older than heads that were overwritten since are lost.
+     */
+    common::VoidResult dump(const std::string& path, const std::vector<std::uint64_t>& heads) const;
+
+    /**
+     * @brief Read a file written by dump()
+     */
+    static common::Result<flight_recorder_dump> load(const std::string& path);
+
+private:
+    struct alignas(64) ring {
+        std::unique_ptr<std::atomic<std::uint64_t>[]> words;  // Two per event
+        std::atomic<std::uint64_t> head{0};
+    };
+
+    static constexpr std::uint64_t timestamp_mask = (std::uint64_t{1} << 56) - 1;
+
+    // Word 0: timestamp | lap << 56; word 1: arg | lap << 32 | kind << 48
+    void write(ring& target, std::uint64_t position, flight_event_kind kind, clock::time_point at,
+               std::uint32_t arg) noexcept {
+        const std::uint64_t slot = (position & mask_) * 2;
+        const std::uint64_t current_lap = lap(position);
+        const auto elapsed = static_cast<std::uint64_t>((at - epoch_).count());
+        target.words[slot].store((elapsed & timestamp_mask) | (current_lap << 56), std::memory_order_relaxed);
+        target.words[slot + 1].store(static_cast<std::uint64_t>(arg) | (current_lap << 32) |
+                                         (static_cast<std::uint64_t>(kind) << 48),
+                                     std::memory_order_relaxed);
+    }
+
+    std::vector<flight_event> events(std::size_t ring, std::uint64_t head) const;
+
+    std::uint16_t lap(std::uint64_t position) const noexcept {
+        return static_cast<std::uint16_t>(position >> shift_);
+    }
+
+    std::size_t workers_;
+    std::uint64_t mask_;
+    unsigned shift_;
+    std::unique_ptr<ring[]> rings_;  // workers_ + 1, the last one shared
+    clock::time_point epoch_;
+    std::chrono::system_clock::time_point system_epoch_;
+};
+
+} // namespace kcenon::integrated
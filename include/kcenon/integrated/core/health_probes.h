@@ -0,0 +1,90 @@
+// BSD 3-Clause License
+// Copyright (c) 2025, kcenon
+// See the LICENSE file in the project root for full license information.
+
+/**
+ * @file health_probes.h
+ * @brief Health checks and metric collectors run in parallel on a thread pool
+ *
+ * Every check and collector is its own pool task, so they run side by side.
+ * Their results are cached: poll() starts a probe again only once its last
+ * start is older than the TTL, and never while it is still running. A check
+ * that has not returned within its timeout is reported as an issue until it
+ * does. Nothing can interrupt the call itself, but a hung database ping
+ * occupies one worker and stalls nothing else.
+ *
+ * Collector results go to a gauge, which keeps its last value when a
+ * collector throws or hangs.
+ */
+
+#pragma once
+
+#include <kcenon/integrated/core/metric_registry.h>
+
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace kcenon::integrated {
+
+class health_probes {
+public:
+    using clock = std::chrono::steady_clock;
+    using check_fn = std::function<std::pair<bool, std::string>()>;
+    using collector_fn = std::function<double()>;
+    // Queues a task on the pool; false when the pool did not accept it
+    using executor = std::function<bool(std::function<void()>)>;
+
+    /**
+     * @param ttl Age of a result after which its probe runs again
+     * @param default_timeout Timeout of checks added without one
+     * @param on_change Called from the pool when a check's result changes; may be empty
+     */
+    health_probes(std::chrono::milliseconds ttl, std::chrono::milliseconds default_timeout,
+                  std::function<void()> on_change = {});
+    ~health_probes();
+
+    health_probes(const health_probes&) = delete;
+    health_probes& operator=(const health_probes&) = delete;
+
+    /**
+     * @brief Add or replace a check; a zero timeout uses the default
+     */
+    void add_check(const std::string& name, check_fn check,
+                   std::chrono::milliseconds timeout = std::chrono::milliseconds::zero());
+
+    /**
+     * @brief Add or replace a collector whose results are stored in gauge
+     */
+    void add_collector(const std::string& name, collector_fn collector, gauge_handle gauge);
+
+    /**
+     * @brief Start the probes that are due, and time out overdue checks
+     *
+     * Cheap when nothing is due, so it can be called on every timer tick.
+     *
+     * @return true when a check newly timed out
+     */
+    bool poll(clock::time_point now, const executor& run);
+
+    /**
+     * @brief "<name>: <message>" for every failing or timed-out check, by name
+     */
+    std::vector<std::string> issues() const;
+
+private:
+    struct probe;
+    struct state;
+
+    static void complete(const std::shared_ptr<state>& shared, const std::shared_ptr<probe>& target,
+                         std::string issue);
+
+    std::shared_ptr<state> state_;  // Shared with queued probe tasks, which may outlive this object
+    std::chrono::milliseconds ttl_;
+    std::chrono::milliseconds default_timeout_;
+};
+
+} // namespace kcenon::integrated
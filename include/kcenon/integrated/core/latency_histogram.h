@@ -0,0 +1,127 @@
+// BSD 3-Clause License
+// Copyright (c) 2025, kcenon
+// See the LICENSE file in the project root for full license information.
+
+/**
+ * @file latency_histogram.h
+ * @brief Lock-free log-linear (HDR-style) latency histogram
+ *
+ * Values are counted in buckets that are linear within each power of two:
+ * every octave is split into 2^p sub-buckets, with p chosen so that any
+ * recorded value is reported within 10^-digits of its true magnitude.
+ * Values below 2^(p+1) are counted exactly.
+ *
+ * record() is a handful of relaxed atomic increments, so a histogram can be
+ * shared, but the intended use is one histogram per worker thread, merged
+ * into a latency_snapshot on read. Buckets are allocated on the first
+ * record(), so histograms that never see a value stay small.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <vector>
+
+namespace kcenon::integrated {
+
+/**
+ * @brief Merged, immutable view of one or more histograms
+ */
+class latency_snapshot {
+public:
+    latency_snapshot() = default;
+
+    std::uint64_t count() const { return count_; }
+    std::chrono::nanoseconds min() const { return std::chrono::nanoseconds(count_ ? min_ : 0); }
+    std::chrono::nanoseconds max() const { return std::chrono::nanoseconds(max_); }
+    std::chrono::nanoseconds mean() const;
+    std::chrono::nanoseconds sum() const { return std::chrono::nanoseconds(sum_); }
+
+    /**
+     * @brief Value at a quantile (0.0 - 1.0)
+     *
+     * Exact for values in the linear range, otherwise within the configured
+     * precision; clamped to the recorded min/max.
+     */
+    std::chrono::nanoseconds percentile(double quantile) const;
+
+    /**
+     * @brief Empty the snapshot but keep its buckets allocated for reuse
+     */
+    void clear() noexcept;
+
+    /**
+     * @brief Count values at or below each of the ascending bounds, in one pass
+     *
+     * Values are placed by their bucket's reported value, so the split at a
+     * bound is as precise as the histogram.
+     */
+    void cumulative_counts(std::span<const std::chrono::nanoseconds> bounds,
+                           std::span<std::uint64_t> out) const;
+
+    /**
+     * @brief Combine with a snapshot taken at the same precision
+     */
+    void merge(const latency_snapshot& other);
+
+private:
+    friend class latency_histogram;
+
+    unsigned sub_bucket_bits_{0};
+    std::uint64_t count_{0};
+    std::uint64_t sum_{0};
+    std::uint64_t min_{0};
+    std::uint64_t max_{0};
+    std::vector<std::uint64_t> counts_;
+};
+
+class latency_histogram {
+public:
+    static constexpr unsigned default_precision_digits = 2;
+    static constexpr std::chrono::nanoseconds default_max_value = std::chrono::hours(1);
+
+    /**
+     * @param precision_digits Significant decimal digits kept (1-4)
+     * @param max_value Largest distinguishable value; larger values land in the top bucket
+     */
+    explicit latency_histogram(unsigned precision_digits = default_precision_digits,
+                               std::chrono::nanoseconds max_value = default_max_value);
+    ~latency_histogram();
+
+    latency_histogram(const latency_histogram&) = delete;
+    latency_histogram& operator=(const latency_histogram&) = delete;
+
+    void record(std::chrono::nanoseconds value) noexcept;
+
+    /**
+     * @brief Add this histogram's counts to a snapshot
+     *
+     * Concurrent record() calls may be partially included.
+     */
+    void merge_into(latency_snapshot& snapshot) const;
+
+    latency_snapshot snapshot() const;
+
+    void reset() noexcept;
+
+    std::size_t bucket_count() const noexcept { return bucket_count_; }
+
+private:
+    std::size_t index_of(std::uint64_t value) const noexcept;
+    std::atomic<std::uint64_t>* allocate_counts() noexcept;
+
+    unsigned sub_bucket_bits_;
+    std::size_t bucket_count_;
+    std::atomic<std::atomic<std::uint64_t>*> counts_{nullptr};
+
+    std::atomic<std::uint64_t> sum_{0};
+    std::atomic<std::uint64_t> min_{std::numeric_limits<std::uint64_t>::max()};
+    std::atomic<std::uint64_t> max_{0};
+};
+
+} // namespace kcenon::integrated
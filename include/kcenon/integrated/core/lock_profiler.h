@@ -0,0 +1,227 @@
+// BSD 3-Clause License
+// Copyright (c) 2025, kcenon
+// See the LICENSE file in the project root for full license information.
+
+/**
+ * @file lock_profiler.h
+ * @brief Optional contention profiling for the scheduler's queue locks
+ *
+ * A profiled_lock takes a std::mutex with try_lock() first. When that
+ * succeeds, which is the uncontended case, the acquisition costs what
+ * lock() would have: one compare-and-swap. With profiling enabled the owner
+ * then bumps a counter it already holds exclusively. Only when try_lock()
+ * fails does the lock read the clock, block, and record the wait.
+ *
+ * Hold times need a clock read on both ends of the critical section, so
+ * they are sampled: one acquisition in hold_sample_interval is timed.
+ *
+ * Each lock_profile belongs to exactly one mutex, which is what lets its
+ * counters be updated with plain loads and stores under that mutex.
+ * Profiles registered under the same name, such as the per-worker local
+ * queues, are summed when read.
+ */
+
+#pragma once
+
+#include <kcenon/integrated/core/latency_histogram.h>
+#include <kcenon/integrated/core/task_latency.h>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace kcenon::integrated {
+
+class prometheus_writer;
+
+/**
+ * @brief Histogram bounds for lock wait and hold times, 250 ns to 1 s
+ */
+inline constexpr std::array<std::chrono::nanoseconds, 12> lock_time_buckets{
+    std::chrono::nanoseconds(250), std::chrono::microseconds(1),
+    std::chrono::microseconds(4), std::chrono::microseconds(16),
+    std::chrono::microseconds(64), std::chrono::microseconds(256),
+    std::chrono::milliseconds(1), std::chrono::milliseconds(4),
+    std::chrono::milliseconds(16), std::chrono::milliseconds(64),
+    std::chrono::milliseconds(256), std::chrono::seconds(1)};
+
+/**
+ * @brief Contention of one lock, or of every lock sharing a name
+ */
+struct lock_contention {
+    std::string name;
+    std::uint64_t acquisitions{0};
+    std::uint64_t contended{0};  // Acquisitions that found the lock held and had to wait
+    latency_summary wait;        // Time contended acquisitions waited
+    latency_summary hold;        // Time the lock was held, over sampled acquisitions
+
+    /**
+     * @brief Share of acquisitions that had to wait, 0 to 1
+     */
+    double contention_ratio() const noexcept {
+        return acquisitions > 0 ? static_cast<double>(contended) / acquisitions : 0.0;
+    }
+};
+
+/**
+ * @brief Counters and histograms of a single mutex
+ */
+class lock_profile {
+public:
+    lock_profile(std::string name, std::uint64_t hold_sample_mask, unsigned precision_digits);
+
+    lock_profile(const lock_profile&) = delete;
+    lock_profile& operator=(const lock_profile&) = delete;
+
+    const std::string& name() const noexcept { return name_; }
+
+private:
+    friend class profiled_lock;
+    friend class lock_profiler;
+
+    std::string name_;
+    std::uint64_t hold_sample_mask_;
+    std::atomic<std::uint64_t> acquisitions_{0};  // Written only with the mutex held
+    std::atomic<std::uint64_t> contended_{0};     // Written only with the mutex held
+    latency_histogram wait_;
+    latency_histogram hold_;
+};
+
+/**
+ * @brief Scoped lock on a std::mutex that reports to a lock_profile
+ *
+ * Used where std::unique_lock or std::lock_guard would be. A null profile
+ * keeps the try_lock() fast path and records nothing.
+ */
+class profiled_lock {
+public:
+    using clock = std::chrono::steady_clock;
+
+    profiled_lock(std::mutex& mutex, lock_profile* profile)
+        : lock_(mutex, std::try_to_lock), profile_(profile) {
+        if (lock_.owns_lock()) {
+            if (profile_) {
+                acquired(false);
+            }
+            return;
+        }
+        if (!profile_) {
+            lock_.lock();
+            return;
+        }
+
+        const auto started = clock::now();
+        lock_.lock();
+        const auto waited = clock::now() - started;
+        acquired(true);
+        profile_->wait_.record(waited);
+    }
+
+    ~profiled_lock() {
+        if (held_since_ == clock::time_point{}) {
+            return;
+        }
+        const auto held = clock::now() - held_since_;
+        lock_.unlock();
+        profile_->hold_.record(held);
+    }
+
+    profiled_lock(const profiled_lock&) = delete;
+    profiled_lock& operator=(const profiled_lock&) = delete;
+
+    /**
+     * @brief The underlying lock, for condition variable waits
+     *
+     * Ends a running hold-time sample first, so that time spent asleep in
+     * the wait is not counted as time holding the lock.
+     */
+    std::unique_lock<std::mutex>& for_wait() noexcept {
+        if (held_since_ != clock::time_point{}) {
+            profile_->hold_.record(clock::now() - held_since_);
+            held_since_ = {};
+        }
+        return lock_;
+    }
+
+private:
+    // Called with the mutex held, so the counters need no read-modify-write
+    void acquired(bool contended) noexcept {
+        const std::uint64_t count = profile_->acquisitions_.load(std::memory_order_relaxed);
+        profile_->acquisitions_.store(count + 1, std::memory_order_relaxed);
+        if (contended) {
+            profile_->contended_.store(profile_->contended_.load(std::memory_order_relaxed) + 1,
+                                       std::memory_order_relaxed);
+        }
+        if ((count & profile_->hold_sample_mask_) == 0) {
+            held_since_ = clock::now();
+        }
+    }
+
+    std::unique_lock<std::mutex> lock_;
+    lock_profile* profile_;
+    clock::time_point held_since_{};  // Set while a hold-time sample is running
+};
+
+/**
+ * @brief Owner of the lock profiles of one thread pool
+ */
+class lock_profiler {
+public:
+    static constexpr std::size_t default_hold_sample_interval = 64;
+
+    /**
+     * @param hold_sample_interval Time one acquisition in this many; rounded up to a power of two
+     * @param precision_digits Significant digits kept by the wait and hold histograms (1-4)
+     */
+    explicit lock_profiler(std::size_t hold_sample_interval = default_hold_sample_interval,
+                           unsigned precision_digits = latency_histogram::default_precision_digits);
+    ~lock_profiler();
+
+    lock_profiler(const lock_profiler&) = delete;
+    lock_profiler& operator=(const lock_profiler&) = delete;
+
+    /**
+     * @brief Create the profile of one mutex
+     *
+     * The pointer stays valid for the profiler's lifetime. Register every
+     * mutex before it is shared between threads.
+     */
+    lock_profile* add(std::string name);
+
+    /**
+     * @brief Contention per lock name, in order of first registration
+     */
+    std::vector<lock_contention> snapshot() const;
+
+    /**
+     * @brief Write lock_acquisitions_total, lock_contended_acquisitions_total,
+     *        lock_wait_seconds and lock_hold_seconds, labelled by pool and lock
+     */
+    void write_prometheus(prometheus_writer& writer, std::string_view pool) const;
+
+private:
+    struct merged;
+    std::vector<merged> merge() const;
+
+    std::uint64_t hold_sample_mask_;
+    unsigned precision_digits_;
+    std::vector<std::unique_ptr<lock_profile>> profiles_;
+};
+
+/**
+ * @brief Write lock contention as a JSON array
+ * @param indent Spaces before each nested line; the opening bracket is not indented
+ */
+void write_lock_contention_json(std::ostream& out, std::span<const lock_contention> locks,
+                                int indent = 0);
+
+} // namespace kcenon::integrated
@@ -0,0 +1,153 @@
+// BSD 3-Clause License
+// Copyright (c) 2025, kcenon
+// See the LICENSE file in the project root for full license information.
+
+/**
+ * @file metric_registry.h
+ * @brief Pre-registered counters, gauges and histograms updated through handles
+ *
+ * Registering a series validates its name and labels, escapes the label set
+ * once and allocates the series' storage; the returned handle points straight
+ * at that storage. Updating through a handle is a relaxed atomic on memory the
+ * handle already holds (two for a histogram: its bucket and its sum), with no
+ * string formatting, hashing or lookup on the hot path.
+ *
+ * Counters are sharded_counters, so threads incrementing the same counter do
+ * not contend on one cache line.
+ *
+ * Each metric family accepts up to max_series_per_family distinct label sets.
+ * Registrations beyond that share one overflow series per family, labelled
+ * overflow="true", so totals stay correct while cardinality stays bounded;
+ * they are counted by rejected_series().
+ *
+ * Handles stay valid for the lifetime of the registry. Registration is
+ * thread-safe; registering the same name and labels again returns the
+ * existing series.
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <kcenon/common/patterns/result.h>
+#include <kcenon/integrated/core/prometheus_writer.h>
+#include <kcenon/integrated/core/sharded_counter.h>
+
+namespace kcenon::integrated {
+
+/**
+ * @brief Default histogram bounds (Prometheus client defaults), in the observed unit
+ */
+inline constexpr std::array<double, 11> default_histogram_buckets{
+    0.005, 0.01, 0.025, 0.05, 0.1, 0.25, 0.5, 1.0, 2.5, 5.0, 10.0};
+
+namespace detail {
+
+struct histogram_cells {
+    std::span<const double> bounds;                      // Ascending; +Inf is implicit
+    std::unique_ptr<std::atomic<std::uint64_t>[]> counts;  // bounds.size() + 1, not cumulative
+    std::atomic<double> sum{0.0};
+};
+
+} // namespace detail
+
+class counter_handle {
+public:
+    void increment(std::uint64_t amount = 1) const noexcept { cell_->add(amount); }
+    std::uint64_t value() const noexcept { return cell_->value(); }
+
+private:
+    friend class metric_registry;
+    explicit counter_handle(sharded_counter* cell) noexcept : cell_(cell) {}
+
+    sharded_counter* cell_;
+};
+
+class gauge_handle {
+public:
+    void set(double value) const noexcept { cell_->store(value, std::memory_order_relaxed); }
+    void add(double delta) const noexcept { cell_->fetch_add(delta, std::memory_order_relaxed); }
+    double value() const noexcept { return cell_->load(std::memory_order_relaxed); }
+
+private:
+    friend class metric_registry;
+    explicit gauge_handle(std::atomic<double>* cell) noexcept : cell_(cell) {}
+
+    std::atomic<double>* cell_;
+};
+
+class histogram_handle {
+public:
+    void observe(double value) const noexcept {
+        std::size_t bucket = 0;
+        while (bucket < cells_->bounds.size() && value > cells_->bounds[bucket]) {
+            ++bucket;
+        }
+        cells_->counts[bucket].fetch_add(1, std::memory_order_relaxed);
+        cells_->sum.fetch_add(value, std::memory_order_relaxed);
+    }
+
+private:
+    friend class metric_registry;
+    explicit histogram_handle(detail::histogram_cells* cells) noexcept : cells_(cells) {}
+
+    detail::histogram_cells* cells_;
+};
+
+class metric_registry {
+public:
+    static constexpr std::size_t default_max_series_per_family = 1000;
+    static constexpr std::size_t max_histogram_buckets = 64;
+
+    /**
+     * @param pool Value of the pool label added to every series
+     */
+    explicit metric_registry(std::string pool,
+                             std::size_t max_series_per_family = default_max_series_per_family);
+    ~metric_registry();
+
+    metric_registry(const metric_registry&) = delete;
+    metric_registry& operator=(const metric_registry&) = delete;
+
+    /**
+     * @brief Register a counter series; name is the family name, without _total
+     * @return Error for an invalid name or label, or a name registered with another type
+     */
+    common::Result<counter_handle> register_counter(std::string_view name, metric_labels labels = {},
+                                                    std::string_view help = {});
+
+    common::Result<gauge_handle> register_gauge(std::string_view name, metric_labels labels = {},
+                                                std::string_view help = {});
+
+    /**
+     * @brief Register a histogram series
+     * @param bounds Ascending upper bounds, shared by every series of the family
+     */
+    common::Result<histogram_handle> register_histogram(
+        std::string_view name, metric_labels labels = {},
+        std::span<const double> bounds = default_histogram_buckets, std::string_view help = {});
+
+    /**
+     * @brief Write every family, sorted by name
+     */
+    void write(prometheus_writer& writer) const;
+
+    std::size_t series_count() const;
+
+    /**
+     * @brief Registrations folded into an overflow series by the cardinality limit
+     */
+    std::uint64_t rejected_series() const;
+
+private:
+    class impl;
+    std::unique_ptr<impl> pimpl_;
+};
+
+} // namespace kcenon::integrated
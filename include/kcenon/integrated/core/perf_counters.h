@@ -0,0 +1,249 @@
+// BSD 3-Clause License
+// Copyright (c) 2025, kcenon
+// See the LICENSE file in the project root for full license information.
+
+/**
+ * @file perf_counters.h
+ * @brief Hardware performance counters per task label and priority lane
+ *
+ * Each worker thread opens its own perf_event_open() group on first use:
+ * cycles, instructions, last-level cache misses and branch misses, counted
+ * in user space only. Around every measured task the thread reads the
+ * group. It uses rdpmc when the kernel allows user-space counter reads, and
+ * one read() of the whole group otherwise. Context switches and CPU time
+ * come from getrusage(RUSAGE_THREAD). That is also the only source left
+ * when the kernel or the container refuses hardware counters, as
+ * perf_event_paranoid or a seccomp profile often does.
+ *
+ * Deltas are summed per (label, lane) cell in a table owned by the thread,
+ * so recording takes no lock and writes no shared cache line. Readers merge
+ * the tables of all threads. IPC and misses per thousand instructions are
+ * ratios, so they stay accurate when only one task in N is measured.
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace kcenon::integrated {
+
+class prometheus_writer;
+
+enum class perf_event : std::uint8_t {
+    cycles,
+    instructions,
+    llc_misses,        // Last-level cache misses
+    branch_misses,
+    context_switches,  // Voluntary and involuntary
+    cpu_time_ns        // User plus system CPU time
+};
+
+inline constexpr std::size_t perf_event_count = 6;
+
+const char* perf_event_name(perf_event event);
+
+/**
+ * @brief How a thread reads its hardware counters
+ */
+enum class perf_counter_source : std::uint8_t {
+    none,      // No counters on this platform
+    software,  // Context switches and CPU time only
+    read,      // Hardware counters through read()
+    rdpmc      // Hardware counters through rdpmc, without a system call
+};
+
+const char* perf_counter_source_name(perf_counter_source source);
+
+/**
+ * @brief Cumulative counter values of one thread
+ */
+struct perf_reading {
+    std::array<std::uint64_t, perf_event_count> values{};
+};
+
+/**
+ * @brief The calling thread's counters
+ *
+ * Opened by the first call on each thread and closed when the thread exits.
+ */
+class perf_counter_group {
+public:
+    perf_counter_group();
+    ~perf_counter_group();
+
+    perf_counter_group(const perf_counter_group&) = delete;
+    perf_counter_group& operator=(const perf_counter_group&) = delete;
+
+    static perf_counter_group& this_thread();
+
+    perf_counter_source source() const noexcept { return source_; }
+    std::uint8_t available() const noexcept { return available_; }  // Bit per perf_event
+
+    /**
+     * @brief Current values; owner thread only
+     */
+    perf_reading read() noexcept;
+
+private:
+    bool read_hardware(perf_reading& reading) noexcept;
+
+    perf_counter_source source_{perf_counter_source::none};
+    std::uint8_t available_{0};
+    int group_fd_{-1};
+    std::array<int, 4> fds_{-1, -1, -1, -1};
+    std::array<void*, 4> pages_{};  // perf_event_mmap_page per event, for rdpmc
+};
+
+/**
+ * @brief Handle naming a class of tasks, from perf_profiler::label()
+ */
+struct task_label {
+    std::uint16_t id = 0;  // 0 = unlabelled
+
+    friend bool operator==(task_label, task_label) = default;
+};
+
+/**
+ * @brief Counter totals of the tasks of one label and priority lane
+ */
+struct task_counters {
+    std::string label;
+    std::string lane;
+    std::uint64_t tasks{0};                               // Tasks measured
+    std::array<std::uint64_t, perf_event_count> values{};  // Summed over those tasks
+    std::uint8_t available{0};                             // Bit per perf_event counted by every thread
+
+    std::uint64_t operator[](perf_event event) const noexcept {
+        return values[static_cast<std::size_t>(event)];
+    }
+
+    bool has(perf_event event) const noexcept {
+        return (available >> static_cast<unsigned>(event)) & 1u;
+    }
+
+    /**
+     * @brief Instructions per cycle; 0 without hardware counters
+     */
+    double ipc() const noexcept {
+        return has(perf_event::cycles) && (*this)[perf_event::cycles] > 0
+            ? static_cast<double>((*this)[perf_event::instructions]) / (*this)[perf_event::cycles]
+            : 0.0;
+    }
+
+    /**
+     * @brief Last-level cache misses per thousand instructions
+     */
+    double llc_mpki() const noexcept { return per_kilo_instruction(perf_event::llc_misses); }
+
+    /**
+     * @brief Branch misses per thousand instructions
+     */
+    double branch_mpki() const noexcept { return per_kilo_instruction(perf_event::branch_misses); }
+
+private:
+    double per_kilo_instruction(perf_event event) const noexcept {
+        return has(event) && (*this)[perf_event::instructions] > 0
+            ? 1000.0 * static_cast<double>((*this)[event]) / (*this)[perf_event::instructions]
+            : 0.0;
+    }
+};
+
+/**
+ * @brief Task labels plus per-thread counter tables of one thread pool
+ */
+class perf_profiler {
+public:
+    static constexpr std::size_t default_max_labels = 64;
+
+    /**
+     * @brief A started measurement; inactive when the task is not sampled
+     */
+    struct measurement {
+        perf_reading start;
+        bool active = false;
+    };
+
+    /**
+     * @param max_labels Labels kept apart, including "default" and "other";
+     *        labels registered beyond that count as "other"
+     * @param sample_interval Measure one task in this many on each thread
+     */
+    explicit perf_profiler(std::size_t max_labels = default_max_labels, std::size_t sample_interval = 1);
+    ~perf_profiler();
+
+    perf_profiler(const perf_profiler&) = delete;
+    perf_profiler& operator=(const perf_profiler&) = delete;
+
+    /**
+     * @brief The label registered under name, registering it if needed
+     *
+     * An empty name is the unlabelled default.
+     */
+    task_label label(std::string_view name);
+
+    /**
+     * @brief Read the calling thread's counters before a task runs
+     */
+    measurement begin() noexcept;
+
+    /**
+     * @brief Add the counters consumed since begin() to the task's cell
+     */
+    void end(const measurement& started, task_label label, int priority) noexcept;
+
+    /**
+     * @brief Totals of every cell with at least one task, by label then lane
+     */
+    std::vector<task_counters> snapshot() const;
+
+    /**
+     * @brief Write task_perf_samples_total and task_<event>_total counters,
+     *        labelled by pool, label and priority lane
+     *
+     * Only events available on every measuring thread are written. CPU time
+     * is written as task_cpu_seconds_total.
+     */
+    void write_prometheus(prometheus_writer& writer, std::string_view pool) const;
+
+private:
+    struct shard;
+    struct thread_state {
+        std::uint64_t profiler = 0;  // instance_ of the profiler current belongs to
+        shard* current = nullptr;
+    };
+
+    static thread_state& local_state() noexcept {
+        thread_local thread_state state;
+        return state;
+    }
+
+    shard* local_shard() noexcept {
+        auto& local = local_state();
+        return local.profiler == instance_ ? local.current : attach(local);
+    }
+
+    shard* attach(thread_state& local) noexcept;
+
+    class impl;
+    std::unique_ptr<impl> pimpl_;
+    std::uint64_t instance_;  // Never reused, so stale thread-local caches cannot match
+    std::size_t max_labels_;
+    std::size_t sample_interval_;
+};
+
+/**
+ * @brief Write task counters as a JSON array, with IPC and miss rates
+ * @param indent Spaces before each nested line; the opening bracket is not indented
+ */
+void write_task_counters_json(std::ostream& out, std::span<const task_counters> counters, int indent = 0);
+
+} // namespace kcenon::integrated
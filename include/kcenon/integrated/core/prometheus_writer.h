@@ -0,0 +1,154 @@
+// BSD 3-Clause License
+// Copyright (c) 2025, kcenon
+// See the LICENSE file in the project root for full license information.
+
+/**
+ * @file prometheus_writer.h
+ * @brief Allocation-free Prometheus / OpenMetrics text exposition
+ *
+ * The writer appends into one std::string that reset() clears without
+ * releasing, so a writer kept across scrapes stops allocating once the
+ * buffer has grown to the size of a scrape. Numbers are formatted with
+ * std::to_chars and labels are passed as initializer lists of views.
+ *
+ * Counters are declared without the _total suffix; the writer adds it to
+ * the samples (and, in the Prometheus text format, to the TYPE line) as
+ * each format expects.
+ */
+
+#pragma once
+
+#include <kcenon/integrated/core/latency_histogram.h>
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <initializer_list>
+#include <span>
+#include <string>
+#include <string_view>
+
+namespace kcenon::integrated {
+
+enum class exposition_format {
+    prometheus_text,  // text/plain; version=0.0.4
+    openmetrics       // application/openmetrics-text; version=1.0.0
+};
+
+enum class metric_type {
+    counter,
+    gauge,
+    histogram
+};
+
+struct metric_label {
+    std::string_view name;
+    std::string_view value;
+};
+
+using metric_labels = std::initializer_list<metric_label>;
+
+/**
+ * @brief Label set escaped once, for series written on every scrape
+ */
+class rendered_labels {
+public:
+    rendered_labels() = default;
+    explicit rendered_labels(std::span<const metric_label> labels);
+
+    std::string_view view() const noexcept { return text_; }  // name="value",... without braces
+
+private:
+    std::string text_;
+};
+
+/**
+ * @brief Default histogram bounds for task latencies, 10 us to 10 s
+ */
+inline constexpr std::array<std::chrono::nanoseconds, 13> default_latency_buckets{
+    std::chrono::microseconds(10), std::chrono::microseconds(50),
+    std::chrono::microseconds(100), std::chrono::microseconds(500),
+    std::chrono::milliseconds(1), std::chrono::milliseconds(5),
+    std::chrono::milliseconds(10), std::chrono::milliseconds(50),
+    std::chrono::milliseconds(100), std::chrono::milliseconds(500),
+    std::chrono::seconds(1), std::chrono::seconds(5), std::chrono::seconds(10)};
+
+class prometheus_writer {
+public:
+    explicit prometheus_writer(exposition_format format = exposition_format::prometheus_text);
+
+    /**
+     * @brief Start a new exposition, keeping the buffer's capacity
+     */
+    void reset();
+    void reset(exposition_format format);
+
+    exposition_format format() const noexcept { return format_; }
+
+    /**
+     * @brief HTTP Content-Type for a format
+     */
+    static std::string_view content_type(exposition_format format) noexcept;
+
+    /**
+     * @brief Write the HELP / TYPE header of a metric family
+     *
+     * Samples of a family must follow its header without other families in between.
+     */
+    void family(std::string_view name, metric_type type, std::string_view help);
+
+    void gauge(std::string_view name, metric_labels labels, double value);
+
+    /**
+     * @brief Write a counter sample; name is the family name, without _total
+     */
+    void counter(std::string_view name, metric_labels labels, std::uint64_t value);
+
+    /**
+     * @brief Write a counter of accumulated time, in seconds
+     */
+    void counter(std::string_view name, metric_labels labels, std::chrono::nanoseconds value);
+
+    /**
+     * @brief Write cumulative _bucket, _sum and _count samples, in seconds
+     * @param bounds Ascending upper bounds; +Inf is added
+     */
+    void histogram(std::string_view name, metric_labels labels, const latency_snapshot& snapshot,
+                   std::span<const std::chrono::nanoseconds> bounds = default_latency_buckets);
+
+    void gauge(std::string_view name, const rendered_labels& labels, double value);
+    void counter(std::string_view name, const rendered_labels& labels, std::uint64_t value);
+
+    /**
+     * @brief Write a value histogram from per-bucket counts
+     * @param bounds Ascending upper bounds; +Inf is added
+     * @param counts bounds.size() + 1 non-cumulative counts, the last above every bound
+     */
+    void histogram(std::string_view name, const rendered_labels& labels, std::span<const double> bounds,
+                   std::span<const std::uint64_t> counts, double sum);
+
+    /**
+     * @brief Terminate the exposition (# EOF for OpenMetrics) and return it
+     *
+     * The view stays valid until the next reset().
+     */
+    std::string_view finish();
+
+    std::string_view view() const noexcept { return buffer_; }
+
+private:
+    void append_sample_name(std::string_view name, std::string_view suffix);
+    void append_labels(metric_labels labels, std::string_view extra_name = {},
+                       std::string_view extra_value = {});
+    void append_labels(std::string_view rendered, std::string_view extra_name = {},
+                       std::string_view extra_value = {});
+    void append_label_value(std::string_view value);
+    void append_value(double value);
+    void append_value(std::uint64_t value);
+
+    std::string buffer_;
+    exposition_format format_;
+    bool finished_{false};
+};
+
+} // namespace kcenon::integrated
@@ -0,0 +1,122 @@
+// BSD 3-Clause License
+// Copyright (c) 2025, kcenon
+// See the LICENSE file in the project root for full license information.
+
+/**
+ * @file rate_meter.h
+ * @brief Event rate meter with exponentially weighted and fixed-window rates
+ *
+ * mark() only increments a sharded counter. Rates are folded in by tick(),
+ * once per tick_interval: the events since the previous tick update the
+ * 1/5/15-minute exponentially weighted moving averages and a ring of the
+ * last window_ticks per-tick counts, whose sum is kept incrementally.
+ * Reading a snapshot is a few atomic loads and never scans samples.
+ *
+ * Whoever owns the meter decides when to tick: from a housekeeping thread,
+ * or lazily before reading. Ticks missed in between are caught up at once,
+ * with the events spread evenly across them.
+ */
+
+#pragma once
+
+#include <kcenon/integrated/core/sharded_counter.h>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <span>
+#include <string_view>
+
+namespace kcenon::integrated {
+
+class prometheus_writer;
+
+/**
+ * @brief Rates of one meter, in events per second
+ */
+struct rate_snapshot {
+    std::uint64_t count{0};          // Events since creation
+    double mean_rate{0.0};           // Over the meter's whole lifetime
+    double window_rate{0.0};         // Over the last rate_meter::window_ticks ticks
+    double one_minute_rate{0.0};     // Exponentially weighted moving averages
+    double five_minute_rate{0.0};
+    double fifteen_minute_rate{0.0};
+};
+
+/**
+ * @brief A rate_snapshot labelled with what is being counted
+ */
+struct named_rate {
+    std::string_view event;  // e.g. "submitted"
+    rate_snapshot rates;
+};
+
+/**
+ * @brief Write rates as a Prometheus gauge family (task_rate), labelled by pool, event and window
+ */
+void write_rates_prometheus(prometheus_writer& writer, std::string_view pool,
+                            std::span<const named_rate> rates);
+
+/**
+ * @brief Write rates as a JSON object keyed by event
+ * @param indent Spaces before each nested line; the opening brace is not indented
+ */
+void write_rates_json(std::ostream& out, std::span<const named_rate> rates, int indent = 0);
+
+class rate_meter {
+public:
+    using clock = std::chrono::steady_clock;
+
+    static constexpr std::chrono::seconds tick_interval{1};
+    static constexpr std::size_t window_ticks = 10;
+
+    explicit rate_meter(clock::time_point start = clock::now());
+
+    rate_meter(const rate_meter&) = delete;
+    rate_meter& operator=(const rate_meter&) = delete;
+
+    void mark(std::uint64_t events = 1) noexcept { total_.add(events); }
+
+    std::uint64_t count() const noexcept { return total_.value(); }
+
+    /**
+     * @brief Fold the events since the last tick into the rates
+     *
+     * Does nothing until a full tick_interval has passed. Safe to call from
+     * several threads; only one of them performs a given tick.
+     */
+    void tick(clock::time_point now = clock::now()) noexcept;
+
+    /**
+     * @brief Rates as of the last tick (mean_rate and count are current)
+     */
+    rate_snapshot snapshot(clock::time_point now = clock::now()) const noexcept;
+
+private:
+    struct ewma {
+        double alpha;
+        std::atomic<double> rate{0.0};
+    };
+
+    void fold(std::uint64_t events_per_tick) noexcept;
+
+    sharded_counter total_;
+    const clock::time_point start_;
+
+    std::atomic<bool> ticking_{false};
+    std::atomic<clock::rep> last_tick_;          // Guarded by ticking_ for writes
+    std::uint64_t ticked_total_{0};              // Guarded by ticking_
+    bool seeded_{false};                         // Guarded by ticking_
+
+    std::array<ewma, 3> averages_;
+    std::array<std::uint64_t, window_ticks> window_{};  // Guarded by ticking_
+    std::size_t window_next_{0};                        // Guarded by ticking_
+    std::size_t window_filled_{0};                      // Guarded by ticking_
+    std::uint64_t window_running_{0};                   // Guarded by ticking_
+    std::atomic<double> window_rate_{0.0};
+};
+
+} // namespace kcenon::integrated
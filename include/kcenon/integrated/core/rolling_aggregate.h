@@ -0,0 +1,111 @@
+// BSD 3-Clause License
+// Copyright (c) 2025, kcenon
+// See the LICENSE file in the project root for full license information.
+
+/**
+ * @file rolling_aggregate.h
+ * @brief Sliding-window sum, min, max and quantiles maintained per sample
+ *
+ * Samples are rows of a fixed number of double columns. For every configured
+ * window and column the aggregate keeps, as samples arrive and expire:
+ * - the running sum and count, so the mean is O(1)
+ * - monotonic min/max queues, so min and max are O(1) (amortized O(1) update)
+ * - a log-bucketed quantile sketch (DDSketch-style) whose buckets are
+ *   decremented when a sample expires, so quantiles stay exact to the
+ *   configured relative accuracy without re-reading the window
+ *
+ * Windows trail the newest sample: a window of width w holds the samples with
+ * timestamps in (newest - w, newest]. One ring of the samples themselves is
+ * shared by all windows to know what to expire; it is bounded by max_samples,
+ * beyond which the oldest samples leave every window early.
+ *
+ * Not thread-safe; the owner serializes access.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace kcenon::integrated {
+
+/**
+ * @brief Sum, count and extremes of one column over one window
+ */
+struct rolling_stats {
+    std::uint64_t count{0};
+    double sum{0.0};
+    double min{0.0};
+    double max{0.0};
+
+    double mean() const { return count ? sum / static_cast<double>(count) : 0.0; }
+};
+
+/**
+ * @brief Windows and precision of a rolling_aggregate
+ */
+struct rolling_config {
+    std::size_t columns = 1;
+    std::vector<std::chrono::milliseconds> windows{
+        std::chrono::seconds(10), std::chrono::minutes(1), std::chrono::minutes(5),
+        std::chrono::minutes(15), std::chrono::hours(1)};
+    double relative_accuracy = 0.01;  // Of quantiles, relative to the true value
+    std::size_t max_samples = 65536;  // Samples retained for expiry, across all windows
+};
+
+class rolling_aggregate {
+public:
+    using clock = std::chrono::system_clock;
+
+    explicit rolling_aggregate(const rolling_config& config);
+    ~rolling_aggregate();
+
+    rolling_aggregate(const rolling_aggregate&) = delete;
+    rolling_aggregate& operator=(const rolling_aggregate&) = delete;
+    rolling_aggregate(rolling_aggregate&&) noexcept;
+    rolling_aggregate& operator=(rolling_aggregate&&) noexcept;
+
+    /**
+     * @brief Add a sample and expire what fell out of each window
+     *
+     * values.size() must equal the column count. A timestamp earlier than the
+     * previous sample's is recorded as the previous one. Non-finite values
+     * count as 0.
+     */
+    void add(clock::time_point timestamp, std::span<const double> values);
+
+    /**
+     * @brief Index of the window with exactly this width, if configured
+     */
+    std::optional<std::size_t> find_window(std::chrono::milliseconds width) const;
+
+    std::size_t window_count() const;
+    std::chrono::milliseconds window(std::size_t index) const;
+    std::size_t columns() const;
+
+    /**
+     * @brief Sum, count, min and max of a column in a window; O(1)
+     */
+    rolling_stats stats(std::size_t window, std::size_t column) const;
+
+    /**
+     * @brief Value at a quantile (0.0 - 1.0) of a column in a window
+     *
+     * Within relative_accuracy of the true value and clamped to the window's
+     * min/max; 0 for an empty window. Costs one pass over the sketch's
+     * occupied buckets, which depends on the spread of the values, not on how
+     * many samples the window holds.
+     */
+    double quantile(std::size_t window, std::size_t column, double quantile) const;
+
+private:
+    class impl;
+    std::unique_ptr<impl> pimpl_;
+};
+
+} // namespace kcenon::integrated
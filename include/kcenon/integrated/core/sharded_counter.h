@@ -0,0 +1,82 @@
+// BSD 3-Clause License
+// Copyright (c) 2025, kcenon
+// See the LICENSE file in the project root for full license information.
+
+/**
+ * @file sharded_counter.h
+ * @brief Monotonic counter split across cache-line-padded shards
+ *
+ * Threads are assigned a shard round-robin the first time they touch any
+ * sharded_counter, so up to shard_count() threads increment without ever
+ * sharing a cache line. value() sums the shards and is therefore only
+ * eventually consistent with concurrent add() calls; use it for statistics,
+ * not for synchronization.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace kcenon::integrated {
+
+namespace detail {
+
+/**
+ * @brief Small per-thread index, assigned once per thread
+ */
+std::size_t assign_counter_slot() noexcept;
+
+inline std::size_t counter_slot() noexcept {
+    thread_local const std::size_t slot = assign_counter_slot();
+    return slot;
+}
+
+} // namespace detail
+
+class sharded_counter {
+public:
+    static constexpr std::size_t cache_line_size = 64;
+
+    /**
+     * @param shards Number of shards, rounded up to a power of two;
+     *               0 uses std::thread::hardware_concurrency()
+     */
+    explicit sharded_counter(std::size_t shards = 0);
+
+    sharded_counter(const sharded_counter&) = delete;
+    sharded_counter& operator=(const sharded_counter&) = delete;
+
+    void add(std::uint64_t amount = 1) noexcept {
+        shards_[detail::counter_slot() & mask_].value.fetch_add(amount, std::memory_order_relaxed);
+    }
+
+    sharded_counter& operator++() noexcept {
+        add(1);
+        return *this;
+    }
+
+    /**
+     * @brief Sum of all shards
+     */
+    std::uint64_t value() const noexcept;
+
+    /**
+     * @brief Zero every shard; increments racing with it may survive
+     */
+    void reset() noexcept;
+
+    std::size_t shard_count() const noexcept { return mask_ + 1; }
+
+private:
+    struct alignas(cache_line_size) shard {
+        std::atomic<std::uint64_t> value{0};
+    };
+
+    std::size_t mask_;
+    std::unique_ptr<shard[]> shards_;
+};
+
+} // namespace kcenon::integrated
@@ -0,0 +1,199 @@
+// BSD 3-Clause License
+// Copyright (c) 2025, kcenon
+// See the LICENSE file in the project root for full license information.
+
+/**
+ * @file task_allocator.h
+ * @brief Pooled size-class allocator for task closures and future shared states
+ *
+ * Every submission allocates a task object and a future shared state. This
+ * allocator serves those from per-thread slab caches split into size
+ * classes, so the submit path does not hit malloc/free:
+ * - Allocation pops from the calling thread's free list, or bump-allocates
+ *   from a 64 KiB slab owned by that thread
+ * - A block freed on its owner thread goes straight back to the free list
+ * - A block freed on another thread is chained per owner and size class and
+ *   handed back in batches with a single CAS
+ * - Caches of exited threads are adopted by new threads, never released
+ *
+ * Requests larger than pool_max_block_size go to the global operator new,
+ * aligned like a pooled block so the alignment guarantee does not depend on
+ * the size.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <limits>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace kcenon::integrated {
+
+/**
+ * @brief Process-wide statistics of the pooled task allocator
+ */
+struct task_allocator_stats {
+    std::uint64_t allocations{0};           // Blocks handed out (pooled and oversize)
+    std::uint64_t deallocations{0};         // Blocks returned (pooled and oversize)
+    std::uint64_t remote_deallocations{0};  // Blocks freed on a thread other than their owner
+    std::uint64_t remote_batches{0};        // CAS hand-backs carrying remote frees
+    std::uint64_t oversize_allocations{0};  // Requests served by operator new
+    std::uint64_t slabs{0};                 // Slabs carved so far
+    std::uint64_t bytes_reserved{0};        // Memory held in slabs
+    std::uint64_t thread_caches{0};         // Per-thread caches created
+};
+
+/**
+ * @brief Snapshot allocator statistics summed over all thread caches
+ */
+task_allocator_stats get_task_allocator_stats();
+
+namespace detail {
+
+inline constexpr std::size_t pool_max_block_size = 1024;
+inline constexpr std::size_t pool_block_alignment = 64;
+
+void* pool_allocate(std::size_t bytes);
+void pool_deallocate(void* ptr, std::size_t bytes) noexcept;
+
+/**
+ * @brief Hand pending cross-thread frees of the calling thread back to their owners
+ *
+ * Workers call this before going idle so freed blocks do not sit in a
+ * partially filled batch while the pool is quiet.
+ */
+void pool_flush_thread() noexcept;
+
+/**
+ * @brief Standard allocator adapter over the pooled task allocator
+ */
+template<typename T>
+class pool_allocator {
+public:
+    using value_type = T;
+
+    pool_allocator() noexcept = default;
+
+    template<typename U>
+    pool_allocator(const pool_allocator<U>&) noexcept {}
+
+    T* allocate(std::size_t n) {
+        if (n > std::numeric_limits<std::size_t>::max() / sizeof(T)) {
+            throw std::bad_array_new_length();
+        }
+
+        if constexpr (alignof(T) <= pool_block_alignment) {
+            return static_cast<T*>(pool_allocate(n * sizeof(T)));
+        } else {
+            return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t{alignof(T)}));
+        }
+    }
+
+    void deallocate(T* ptr, std::size_t n) noexcept {
+        if constexpr (alignof(T) <= pool_block_alignment) {
+            pool_deallocate(ptr, n * sizeof(T));
+        } else {
+            ::operator delete(ptr, std::align_val_t{alignof(T)});
+        }
+    }
+
+    template<typename U>
+    bool operator==(const pool_allocator<U>&) const noexcept { return true; }
+};
+
+/**
+ * @brief Set when a pooled task stored an exception in its future
+ *
+ * Pooled tasks never let exceptions escape to the pool, so pool code that
+ * cares about outcomes (failure metrics, the circuit breaker) reads this
+ * through task_outcome_scope instead.
+ */
+inline thread_local bool pooled_task_failed = false;
+
+/**
+ * @brief Observes whether the tasks run inside the scope failed
+ *
+ * Scopes nest: a helper task run while waiting does not leak its outcome
+ * into the enclosing task.
+ */
+class task_outcome_scope {
+public:
+    task_outcome_scope() noexcept : saved_(pooled_task_failed) { pooled_task_failed = false; }
+    ~task_outcome_scope() { pooled_task_failed = saved_; }
+
+    task_outcome_scope(const task_outcome_scope&) = delete;
+    task_outcome_scope& operator=(const task_outcome_scope&) = delete;
+
+    bool failed() const noexcept { return pooled_task_failed; }
+
+private:
+    bool saved_;
+};
+
+/**
+ * @brief Callable paired with the promise it fulfils
+ *
+ * Plays the role of std::packaged_task, whose allocator support was removed
+ * in C++17; std::promise still accepts one for its shared state.
+ */
+template<typename R, typename Fn>
+class pooled_task {
+public:
+    template<typename Alloc>
+    pooled_task(const Alloc& alloc, Fn fn)
+        : promise_(std::allocator_arg, alloc)
+        , fn_(std::move(fn)) {}
+
+    std::future<R> get_future() { return promise_.get_future(); }
+
+    void operator()() {
+        try {
+            if constexpr (std::is_void_v<R>) {
+                fn_();
+                promise_.set_value();
+            } else {
+                promise_.set_value(fn_());
+            }
+        } catch (...) {
+            pooled_task_failed = true;
+            promise_.set_exception(std::current_exception());
+        }
+    }
+
+private:
+    std::promise<R> promise_;
+    Fn fn_;
+};
+
+template<typename R>
+struct pooled_submission {
+    std::function<void()> run;
+    std::future<R> future;
+};
+
+/**
+ * @brief Build a pooled task and its future for the submit path
+ *
+ * The task object, its shared_ptr control block and the promise state all
+ * come from the pooled allocator.
+ */
+template<typename R, typename Fn>
+pooled_submission<R> make_pooled_task(Fn&& fn) {
+    using task_type = pooled_task<R, std::decay_t<Fn>>;
+
+    auto task = std::allocate_shared<task_type>(
+        pool_allocator<task_type>{}, pool_allocator<char>{}, std::forward<Fn>(fn));
+    auto future = task->get_future();
+
+    return {[task]() { (*task)(); }, std::move(future)};
+}
+
+} // namespace detail
+
+} // namespace kcenon::integrated
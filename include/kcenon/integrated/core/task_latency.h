@@ -0,0 +1,154 @@
+// BSD 3-Clause License
+// Copyright (c) 2025, kcenon
+// See the LICENSE file in the project root for full license information.
+
+/**
+ * @file task_latency.h
+ * @brief Per-priority-lane breakdown of where task latency goes
+ *
+ * Each finished task contributes three samples to the lane of its priority:
+ * - queue wait: from the moment it became runnable (enqueued, or due when
+ *   scheduled) until a worker started it
+ * - execution: running time
+ * - end to end: the two together
+ *
+ * Lanes follow the named priority levels; a priority between two levels
+ * belongs to the lower one.
+ */
+
+#pragma once
+
+#include <kcenon/integrated/core/latency_histogram.h>
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace kcenon::integrated {
+
+class prometheus_writer;
+
+inline constexpr std::size_t priority_lane_count = 6;
+
+/**
+ * @brief Lane index (0 = lowest) for a task priority
+ */
+std::size_t priority_lane(int priority) noexcept;
+
+/**
+ * @brief Lane name, matching the priority_level enumerator ("lowest" ... "critical")
+ */
+const char* priority_lane_name(std::size_t lane) noexcept;
+
+/**
+ * @brief Percentile summary of one latency distribution
+ */
+struct latency_summary {
+    std::uint64_t count{0};
+    std::chrono::nanoseconds sum{0};
+    std::chrono::nanoseconds mean{0};
+    std::chrono::nanoseconds p50{0};
+    std::chrono::nanoseconds p95{0};
+    std::chrono::nanoseconds p99{0};
+    std::chrono::nanoseconds p999{0};
+    std::chrono::nanoseconds max{0};
+
+    static latency_summary from(const latency_snapshot& snapshot);
+};
+
+/**
+ * @brief Write one summary as a single-line JSON object
+ */
+void write_latency_summary_json(std::ostream& out, const latency_summary& summary);
+
+/**
+ * @brief Latency breakdown of one priority lane
+ */
+struct lane_latency {
+    std::string lane;
+    latency_summary queue_wait;
+    latency_summary execution;
+    latency_summary end_to_end;
+};
+
+/**
+ * @brief Write lanes as a JSON object keyed by lane name
+ * @param indent Spaces before each nested line; the opening brace is not indented
+ */
+void write_latency_json(std::ostream& out, const std::vector<lane_latency>& lanes, int indent = 0);
+
+/**
+ * @brief Merged histograms of one or more recorders
+ */
+struct task_latency_snapshot {
+    std::array<latency_snapshot, priority_lane_count> queue_wait;
+    std::array<latency_snapshot, priority_lane_count> execution;
+    std::array<latency_snapshot, priority_lane_count> end_to_end;
+
+    /**
+     * @brief Empty every histogram, keeping the buckets for reuse
+     */
+    void clear() noexcept;
+
+    latency_snapshot total_queue_wait() const;
+    latency_snapshot total_execution() const;
+    latency_snapshot total_end_to_end() const;
+
+    /**
+     * @brief Summaries of the lanes that ran at least one task, lowest first
+     */
+    std::vector<lane_latency> lanes() const;
+};
+
+/**
+ * @brief Write a snapshot as Prometheus histograms
+ *
+ * Emits task_queue_wait_seconds, task_execution_seconds and
+ * task_end_to_end_seconds, labelled by pool and priority lane. Lanes that
+ * never ran a task are skipped.
+ */
+void write_latency_prometheus(prometheus_writer& writer, std::string_view pool,
+                              const task_latency_snapshot& snapshot);
+
+/**
+ * @brief Lock-free recorder of queue wait, execution and end-to-end time per lane
+ */
+class task_latency_recorder {
+public:
+    explicit task_latency_recorder(unsigned precision_digits = latency_histogram::default_precision_digits);
+
+    task_latency_recorder(const task_latency_recorder&) = delete;
+    task_latency_recorder& operator=(const task_latency_recorder&) = delete;
+
+    void record(int priority, std::chrono::nanoseconds queue_wait,
+                std::chrono::nanoseconds execution) noexcept;
+
+    /**
+     * @brief Add this recorder's histograms to a snapshot
+     */
+    void merge_into(task_latency_snapshot& snapshot) const;
+
+    task_latency_snapshot snapshot() const;
+
+private:
+    struct lane {
+        explicit lane(unsigned precision_digits)
+            : queue_wait(precision_digits)
+            , execution(precision_digits)
+            , end_to_end(precision_digits) {}
+
+        latency_histogram queue_wait;
+        latency_histogram execution;
+        latency_histogram end_to_end;
+    };
+
+    std::array<std::unique_ptr<lane>, priority_lane_count> lanes_;
+};
+
+} // namespace kcenon::integrated
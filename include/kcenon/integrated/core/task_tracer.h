@@ -0,0 +1,194 @@
+// BSD 3-Clause License
+// Copyright (c) 2025, kcenon
+// See the LICENSE file in the project root for full license information.
+
+/**
+ * @file task_tracer.h
+ * @brief Sampled task spans in per-thread rings, exported as Chrome trace JSON
+ *
+ * Whether a task is traced is decided once, when it is submitted (head
+ * sampling): sample() returns a trace id for a sampled task and 0 otherwise,
+ * and the id travels with the task so that its submit, enqueue, start, end
+ * and steal events are either all recorded or none are.
+ *
+ * Each thread records into its own fixed-size ring, so recording is a few
+ * relaxed stores with no lock and no shared cache line; once a ring is full
+ * its oldest events are overwritten. Every slot is a small seqlock, which
+ * lets write_chrome_json() read the rings while they are being written and
+ * skip slots that are overwritten under it. A thread finds its ring through
+ * a one-entry thread-local cache, so a thread recording into several tracers
+ * in turn pays a locked lookup on each switch.
+ *
+ * The export follows the Chrome Trace Event format, which chrome://tracing
+ * and ui.perfetto.dev open directly: one track per thread with a slice per
+ * task run, a "submit" slice on the submitting thread joined to the run by a
+ * flow arrow, and an async "queued" span for the time spent waiting, which
+ * is where scheduling gaps and convoys show up.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <kcenon/common/patterns/result.h>
+
+namespace kcenon::integrated {
+
+enum class trace_event : std::uint8_t {
+    submit,   // Task handed to the pool
+    enqueue,  // Task visible to workers
+    start,    // Worker started running it; arg = priority
+    end,      // Run finished
+    steal     // Taken from another worker's queue; arg = victim worker
+};
+
+struct trace_config {
+    std::string process_name = "thread_pool";  // Name of the process track
+    double sample_rate = 0.01;                 // Fraction of tasks traced, decided at submission
+    std::size_t events_per_thread = 8192;      // Ring capacity, rounded up to a power of two
+    std::size_t max_threads = 256;             // Threads beyond this record nothing
+};
+
+class task_tracer {
+public:
+    using clock = std::chrono::steady_clock;
+
+    explicit task_tracer(const trace_config& config);
+    ~task_tracer();
+
+    task_tracer(const task_tracer&) = delete;
+    task_tracer& operator=(const task_tracer&) = delete;
+
+    /**
+     * @brief Decide whether to trace a new task
+     * @return A trace id for a sampled task, 0 when it is not traced
+     */
+    std::uint64_t sample() noexcept {
+        if (threshold_ == 0) {
+            return 0;
+        }
+        auto& local = local_state();
+        if (threshold_ != always && next_random(local) >= threshold_) {
+            return 0;
+        }
+        ring* target = local_ring(local);
+        return target ? (static_cast<std::uint64_t>(target->index + 1) << 40) | ++target->next_id : 0;
+    }
+
+    /**
+     * @brief Record an event of a sampled task on the calling thread's ring
+     *
+     * Does nothing for trace id 0.
+     */
+    void record(trace_event event, std::uint64_t trace_id, clock::time_point at,
+                std::uint32_t arg = 0) noexcept {
+        if (trace_id == 0) {
+            return;
+        }
+        ring* target = local_ring(local_state());
+        if (!target) {
+            return;
+        }
+
+        const std::uint64_t position = target->head.load(std::memory_order_relaxed);
+        slot& entry = target->slots[position & target->mask];
+        entry.sequence.store(empty_slot, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        entry.timestamp.store(static_cast<std::uint64_t>((at - epoch_).count()), std::memory_order_relaxed);
+        entry.trace_id.store(trace_id, std::memory_order_relaxed);
+        entry.payload.store(static_cast<std::uint64_t>(event) | (static_cast<std::uint64_t>(arg) << 8),
+                            std::memory_order_relaxed);
+        entry.sequence.store(position, std::memory_order_release);
+        target->head.store(position + 1, std::memory_order_release);
+    }
+
+    /**
+     * @brief Name the calling thread's track, e.g. "worker 3"
+     */
+    void name_thread(std::string name);
+
+    /**
+     * @brief Write the retained events as a Chrome Trace Event JSON document
+     *
+     * Safe to call while other threads record; events recorded meanwhile may
+     * or may not be included.
+     */
+    void write_chrome_json(std::ostream& out) const;
+
+    std::string chrome_json() const;
+
+    /**
+     * @brief Write chrome_json() to a file
+     */
+    common::VoidResult write_chrome_json(const std::string& path) const;
+
+    /**
+     * @brief Events overwritten before they were exported, over all threads
+     */
+    std::uint64_t overwritten() const;
+
+    double sample_rate() const noexcept { return sample_rate_; }
+
+private:
+    static constexpr std::uint64_t always = ~std::uint64_t{0};
+    static constexpr std::uint64_t empty_slot = ~std::uint64_t{0};
+
+    struct slot {
+        std::atomic<std::uint64_t> sequence{empty_slot};  // Position written, or empty_slot mid-write
+        std::atomic<std::uint64_t> timestamp{0};          // ns since the tracer was created
+        std::atomic<std::uint64_t> trace_id{0};
+        std::atomic<std::uint64_t> payload{0};            // event | arg << 8
+    };
+
+    struct ring {
+        std::uint32_t index;
+        std::uint64_t mask;
+        std::unique_ptr<slot[]> slots;
+        std::atomic<std::uint64_t> head{0};  // Written by the owning thread only
+        std::uint64_t next_id = 0;           // Owning thread only
+    };
+
+    struct thread_state {
+        std::uint64_t tracer = 0;  // instance_ of the tracer current belongs to
+        ring* current = nullptr;
+        std::uint64_t random = 0;
+    };
+
+    static thread_state& local_state() noexcept {
+        thread_local thread_state state;
+        return state;
+    }
+
+    static std::uint64_t next_random(thread_state& local) noexcept {
+        // xorshift64*, seeded per thread on first use
+        if (local.random == 0) {
+            local.random = seed_random();
+        }
+        local.random ^= local.random >> 12;
+        local.random ^= local.random << 25;
+        local.random ^= local.random >> 27;
+        return local.random * 0x2545F4914F6CDD1DULL;
+    }
+
+    static std::uint64_t seed_random() noexcept;
+
+    ring* local_ring(thread_state& local) noexcept {
+        return local.tracer == instance_ ? local.current : attach(local);
+    }
+
+    ring* attach(thread_state& local) noexcept;
+
+    class impl;
+    std::unique_ptr<impl> pimpl_;
+    std::uint64_t instance_;  // Never reused, so stale thread-local caches cannot match
+    std::uint64_t threshold_;
+    double sample_rate_;
+    clock::time_point epoch_;
+};
+
+} // namespace kcenon::integrated
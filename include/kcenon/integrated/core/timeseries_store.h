@@ -0,0 +1,129 @@
+// BSD 3-Clause License
+// Copyright (c) 2025, kcenon
+// See the LICENSE file in the project root for full license information.
+
+/**
+ * @file timeseries_store.h
+ * @brief Fixed-capacity compressed time-series store
+ *
+ * Samples are rows of a fixed number of double columns sharing one
+ * timestamp. They are Gorilla-encoded into fixed-size blocks: timestamps as
+ * delta-of-deltas (one bit when the interval is steady), values XORed with the
+ * previous value of their column (one bit when unchanged, the meaningful bits
+ * otherwise). Blocks form a ring that overwrites the oldest block once the
+ * configured capacity is used, so memory is bounded by capacity, not by
+ * sample count.
+ *
+ * Each rollup keeps per-column averages over a coarser step in a ring of its
+ * own, so long ranges stay available after the raw samples are overwritten.
+ * Queries decode only the blocks overlapping the requested range, at the
+ * finest resolution that still covers its start.
+ *
+ * With a path configured, the blocks live in a memory-mapped file and
+ * survive restarts (POSIX only; elsewhere the store stays in memory).
+ *
+ * Not thread-safe; the owner serializes access.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace kcenon::integrated {
+
+/**
+ * @brief A downsampled resolution kept next to the raw samples
+ */
+struct timeseries_rollup {
+    std::chrono::milliseconds step;  // Bucket width; samples are averaged per bucket
+    std::size_t capacity_bytes;
+};
+
+/**
+ * @brief Layout and retention of a timeseries_store
+ */
+struct timeseries_config {
+    std::size_t columns = 1;
+    std::size_t capacity_bytes = 4 * 1024 * 1024;  // Raw samples
+    std::vector<timeseries_rollup> rollups{
+        {std::chrono::minutes(1), 512 * 1024},
+        {std::chrono::hours(1), 64 * 1024}};       // Ascending steps
+    std::size_t block_bytes = 4096;                // Compression unit; the ring overwrites whole blocks
+    std::string path;                              // Memory-mapped persistence; empty keeps it in memory
+};
+
+class timeseries_store {
+public:
+    using clock = std::chrono::system_clock;
+    using visitor = std::function<void(clock::time_point, std::span<const double>)>;
+
+    explicit timeseries_store(const timeseries_config& config);
+    ~timeseries_store();
+
+    timeseries_store(const timeseries_store&) = delete;
+    timeseries_store& operator=(const timeseries_store&) = delete;
+    timeseries_store(timeseries_store&&) noexcept;
+    timeseries_store& operator=(timeseries_store&&) noexcept;
+
+    /**
+     * @brief Append a sample; values.size() must equal the column count
+     *
+     * Timestamps are kept at millisecond precision. A timestamp earlier than
+     * the previous sample's is recorded as the previous one.
+     */
+    void append(clock::time_point timestamp, std::span<const double> values);
+
+    /**
+     * @brief Visit samples with from <= timestamp <= to, oldest first
+     *
+     * Ranges reaching back past the raw samples are answered from the finest
+     * rollup that covers from, followed by finer data for the newer part.
+     */
+    void scan(clock::time_point from, clock::time_point to, const visitor& visit) const;
+
+    /**
+     * @brief Visit one resolution only (0 = raw, i = rollups[i - 1])
+     */
+    void scan(std::size_t resolution, clock::time_point from, clock::time_point to,
+              const visitor& visit) const;
+
+    /**
+     * @brief Number of resolutions, raw included
+     */
+    std::size_t resolutions() const;
+
+    /**
+     * @brief Samples currently retained at a resolution
+     */
+    std::size_t size(std::size_t resolution = 0) const;
+
+    /**
+     * @brief Timestamp of the oldest retained sample at a resolution
+     */
+    clock::time_point oldest(std::size_t resolution = 0) const;
+
+    std::size_t columns() const;
+
+    /**
+     * @brief Bytes reserved for all resolutions (the mapped file size when persistent)
+     */
+    std::size_t capacity_bytes() const;
+
+    /**
+     * @brief Whether samples are backed by a memory-mapped file
+     */
+    bool persistent() const;
+
+private:
+    class impl;
+    std::unique_ptr<impl> pimpl_;
+};
+
+} // namespace kcenon::integrated
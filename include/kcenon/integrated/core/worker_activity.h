@@ -0,0 +1,139 @@
+// BSD 3-Clause License
+// Copyright (c) 2025, kcenon
+// See the LICENSE file in the project root for full license information.
+
+/**
+ * @file worker_activity.h
+ * @brief Where each worker's time goes: busy, spinning, idle or parked
+ *
+ * A worker_clock belongs to one worker, which reports every change of
+ * activity with a timestamp it has already read for other purposes. The
+ * clock adds the time since the previous change to that activity's total,
+ * so the owner pays a handful of relaxed stores per change and nothing per
+ * nanosecond. Readers on other threads get a consistent copy through a
+ * sequence counter, plus the time spent in the current activity so far.
+ *
+ * Utilization is busy time over the time the worker was available (busy,
+ * spinning and idle). Parked time is left out: a parked worker is a spare
+ * standing by, not capacity the pool is paying for.
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <span>
+#include <string_view>
+
+namespace kcenon::integrated {
+
+class prometheus_writer;
+
+enum class worker_activity : std::uint8_t {
+    busy,      // Running a task
+    spinning,  // Looking for work: popping queues, stealing
+    idle,      // Asleep waiting for work
+    parked     // Spare compensating worker, asleep until a worker blocks
+};
+
+inline constexpr std::size_t worker_activity_count = 4;
+
+const char* worker_activity_name(worker_activity activity);
+
+/**
+ * @brief Time one worker spent in each activity
+ */
+struct worker_utilization {
+    std::size_t worker{0};
+    worker_activity state{worker_activity::spinning};  // Activity when read
+    std::array<std::chrono::nanoseconds, worker_activity_count> time{};
+
+    std::chrono::nanoseconds operator[](worker_activity activity) const noexcept {
+        return time[static_cast<std::size_t>(activity)];
+    }
+
+    /**
+     * @brief Busy, spinning and idle time; parked time is not available capacity
+     */
+    std::chrono::nanoseconds available() const noexcept {
+        return (*this)[worker_activity::busy] + (*this)[worker_activity::spinning] +
+               (*this)[worker_activity::idle];
+    }
+
+    /**
+     * @brief Busy share of available(), 0 to 1
+     */
+    double utilization() const noexcept {
+        const auto total = available().count();
+        return total > 0 ? static_cast<double>((*this)[worker_activity::busy].count()) / total : 0.0;
+    }
+};
+
+class worker_clock {
+public:
+    using clock = std::chrono::steady_clock;
+
+    /**
+     * @brief Begin accounting; owner only, once
+     */
+    void start(worker_activity activity, clock::time_point at) noexcept { enter(activity, at); }
+
+    /**
+     * @brief Switch activity at the given time; owner only
+     *
+     * Timestamps earlier than the previous change count as no time.
+     */
+    void enter(worker_activity activity, clock::time_point at) noexcept {
+        const std::uint64_t now = static_cast<std::uint64_t>(at.time_since_epoch().count());
+        const std::uint64_t sequence = sequence_.load(std::memory_order_relaxed);
+        sequence_.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        const std::uint64_t since = since_.load(std::memory_order_relaxed);
+        if (since != 0 && now > since) {
+            auto& total = totals_[current_.load(std::memory_order_relaxed)];
+            total.store(total.load(std::memory_order_relaxed) + (now - since), std::memory_order_relaxed);
+        }
+        if (now > since) {
+            since_.store(now, std::memory_order_relaxed);
+        }
+        current_.store(static_cast<std::uint8_t>(activity), std::memory_order_relaxed);
+
+        sequence_.store(sequence + 2, std::memory_order_release);
+    }
+
+    /**
+     * @brief Totals so far, counting the current activity up to now
+     *
+     * All zero before start(). Safe to call from any thread.
+     */
+    worker_utilization read(clock::time_point now = clock::now()) const noexcept;
+
+private:
+    std::atomic<std::uint64_t> sequence_{0};  // Odd while the owner is updating
+    std::atomic<std::uint64_t> since_{0};     // steady_clock ns of the last change; 0 before start()
+    std::atomic<std::uint8_t> current_{static_cast<std::uint8_t>(worker_activity::spinning)};
+    std::array<std::atomic<std::uint64_t>, worker_activity_count> totals_{};  // ns per activity
+};
+
+/**
+ * @brief Write per-worker time and utilization as Prometheus families
+ *
+ * worker_time_seconds_total (counter, labelled by pool, worker and state)
+ * and worker_utilization (gauge, labelled by pool and worker).
+ */
+void write_utilization_prometheus(prometheus_writer& writer, std::string_view pool,
+                                  std::span<const worker_utilization> workers);
+
+/**
+ * @brief Write per-worker time as a JSON array
+ * @param indent Spaces before each nested line; the opening bracket is not indented
+ */
+void write_utilization_json(std::ostream& out, std::span<const worker_utilization> workers,
+                            int indent = 0);
+
+} // namespace kcenon::integrated
@@ -13,7 +13,14 @@
 #include <memory>
 #include <string>
 #include <unordered_map>
+#include <vector>
 #include <kcenon/common/patterns/result.h>
+#include <kcenon/integrated/core/lock_profiler.h>
+#include <kcenon/integrated/core/perf_counters.h>
+#include <kcenon/integrated/core/prometheus_writer.h>
+#include <kcenon/integrated/core/rate_meter.h>
+#include <kcenon/integrated/core/task_latency.h>
+#include <kcenon/integrated/core/worker_activity.h>
 
 // Forward declarations
 namespace kcenon::integrated::adapters {
@@ -24,6 +31,16 @@ namespace kcenon::integrated::adapters {
 
 namespace kcenon::integrated::extensions {
 
+/**
+ * @brief Task event rates, in tasks per second
+ */
+struct task_rates {
+    rate_snapshot submitted;
+    rate_snapshot completed;
+    rate_snapshot failed;
+    rate_snapshot rejected;
+};
+
 /**
  * @brief Aggregated metrics from all subsystems
  */
@@ -34,6 +51,22 @@ struct aggregated_metrics {
     std::size_t tasks_submitted{0};
     std::size_t tasks_completed{0};
     std::size_t tasks_failed{0};  // Tasks that failed to submit
+    std::size_t tasks_rejected{0};  // Refused before reaching the pool
+    task_rates rates;
+
+    // Per-worker time; empty unless the built-in pool runs the tasks
+    std::vector<worker_utilization> workers;
+    std::size_t active_workers{0};  // Workers running a task
+    double pool_utilization{0.0};   // Busy over available time, all workers
+
+    // Queue wait / execution / end-to-end latency per priority lane
+    std::vector<lane_latency> lane_latencies;
+
+    // Queue lock contention; empty unless the pool profiles its locks
+    std::vector<lock_contention> locks;
+
+    // Hardware counters per task label and lane; empty unless a profiler is set
+    std::vector<task_counters> task_classes;
 
     // Logger metrics
     std::size_t log_messages_written{0};
@@ -64,7 +97,7 @@ struct aggregated_metrics {
  */
 class metrics_aggregator {
 public:
-    metrics_aggregator();
+    explicit metrics_aggregator(unsigned latency_precision_digits = latency_histogram::default_precision_digits);
     ~metrics_aggregator();
 
     metrics_aggregator(const metrics_aggregator&) = delete;
@@ -81,8 +114,26 @@ public:
     void set_logger_adapter(kcenon::integrated::adapters::logger_adapter* adapter);
     void set_monitoring_adapter(kcenon::integrated::adapters::monitoring_adapter* adapter);
 
+    /**
+     * @brief Report the per-task hardware counters of profiler; null to stop
+     */
+    void set_perf_profiler(const perf_profiler* profiler);
+
+    /**
+     * @brief Value of the pool label on exported samples (default "default")
+     */
+    void set_pool_name(std::string name);
+
     common::Result<aggregated_metrics> collect_metrics();
-    std::string export_prometheus_format();
+
+    /**
+     * @brief Prometheus / OpenMetrics exposition of the last collected metrics
+     *
+     * Latency histograms are read live. The writer and scratch buffers are
+     * reused, so calls must not overlap.
+     */
+    std::string export_prometheus_format(exposition_format format = exposition_format::prometheus_text);
+    void export_prometheus(prometheus_writer& writer);
     std::string export_json_format();
 
     /**
@@ -92,6 +143,23 @@ public:
     void increment_tasks_submitted();
     void increment_tasks_completed();
     void increment_tasks_failed();  // Called when task submission fails
+    void increment_tasks_rejected();  // Called when a submission is refused (open breaker, shutdown)
+
+    /**
+     * @brief Current task rates; folds in events since the last call first
+     */
+    task_rates current_rates();
+
+    /**
+     * @brief Record how long a finished task waited to start and how long it ran (thread-safe)
+     */
+    void record_task_latency(int priority, std::chrono::nanoseconds queue_wait,
+                             std::chrono::nanoseconds execution);
+
+    /**
+     * @brief Merged latency histograms of all tasks recorded so far
+     */
+    task_latency_snapshot latency_breakdown() const;
 
 private:
     class impl;
@@ -1,9 +1,17 @@
 #pragma once
 
+#include <algorithm>
+#include <array>
 #include <atomic>
 #include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <limits>
 #include <memory>
+#include <iomanip>
 #include <mutex>
+#include <span>
+#include <sstream>
 #include <string>
 #include <thread>
 #include <unordered_map>
@@ -12,6 +20,13 @@
 #include <kcenon/thread/core/configuration_manager.h>
 #include <kcenon/thread/interfaces/shared_interfaces.h>
 #include <kcenon/monitoring/core/performance_monitor.h>
+#include <kcenon/integrated/core/alert_rule_engine.h>
+#include <kcenon/integrated/core/rolling_aggregate.h>
+#include <kcenon/integrated/core/timeseries_store.h>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <unistd.h>
+#endif
 
 namespace kcenon::integrated {
 
@@ -32,6 +47,7 @@ struct aggregated_metrics {
         std::size_t completed_tasks{0};
         double average_task_duration_ms{0.0};
         double thread_utilization{0.0};
+        double queue_utilization{0.0};  // Percent of config::queue_capacity
     } thread_metrics;
     
     // Logger system metrics
@@ -47,6 +63,7 @@ struct aggregated_metrics {
     struct {
         double cpu_usage_percent{0.0};
         double memory_usage_mb{0.0};
+        double memory_usage_percent{0.0};  // Percent of config::memory_capacity_mb
         std::size_t memory_usage_bytes{0};
         double disk_io_mbps{0.0};
         double network_io_mbps{0.0};
@@ -86,7 +103,10 @@ struct metrics_collected_event : thread_ns::event_base {
 };
 
 /**
- * @brief Metrics threshold alert event
+ * @brief Alert rule state change
+ *
+ * Published when a rule becomes pending, firing or resolved (or drops back
+ * from pending to inactive), never again while its state is unchanged.
  */
 struct metrics_alert_event : thread_ns::event_base {
     enum class alert_type {
@@ -94,22 +114,39 @@ struct metrics_alert_event : thread_ns::event_base {
         memory_high,
         error_rate_high,
         latency_high,
-        throughput_low
+        throughput_low,
+        custom          // Added with metrics_aggregator::add_alert_rule
     };
     
     alert_type type;
     std::string message;
     double current_value;
     double threshold;
+    std::string rule;
+    std::string severity;
+    alert_state state{alert_state::firing};
     
     metrics_alert_event(alert_type t, std::string msg, double current, double thresh)
         : type(t), message(std::move(msg)), current_value(current), threshold(thresh) {}
     
+    metrics_alert_event(alert_type t, std::string msg, double current, double thresh,
+                        std::string rule_name, std::string rule_severity, alert_state new_state)
+        : type(t), message(std::move(msg)), current_value(current), threshold(thresh),
+          rule(std::move(rule_name)), severity(std::move(rule_severity)), state(new_state) {}
+    
     [[nodiscard]] std::string type_name() const override {
         return "MetricsAlertEvent";
     }
 };
 
+/**
+ * @brief What a registered component reports, fixing where its snapshot is aggregated
+ */
+enum class component_kind {
+    thread_pool,     // active/queued/completed tasks and task duration
+    system_monitor   // CPU and memory usage
+};
+
 /**
  * @brief Metrics aggregator for collecting metrics from all systems
  */
@@ -125,14 +162,34 @@ public:
         bool enable_system_metrics{true};
         bool enable_plugin_metrics{true};
         
-        // Alert thresholds
+        // Alert thresholds, evaluated as built-in rules that fire once the
+        // threshold has been exceeded for threshold_duration
         double cpu_threshold{80.0};
         double memory_threshold{80.0};
         double error_rate_threshold{5.0};
         double latency_p99_threshold{1000.0};
         double min_throughput{100.0};
+        std::chrono::milliseconds threshold_duration{0};
+        
+        // What the utilization percentages are relative to: the pool's queue
+        // limit (0 leaves queue_utilization at 0) and the memory available
+        // (0 = physical memory)
+        std::size_t queue_capacity{0};
+        double memory_capacity_mb{0.0};
         
-        std::size_t max_history_size{3600}; // 1 hour at 1s interval
+        // History is kept compressed in a fixed-size ring (see timeseries_store):
+        // raw samples plus averaged rollups for ranges older than the raw ring
+        std::size_t history_bytes{1024 * 1024};
+        std::vector<timeseries_rollup> history_rollups{
+            {std::chrono::minutes(1), 256 * 1024},
+            {std::chrono::hours(1), 64 * 1024}};
+        std::string history_path; // Memory-mapped file; empty keeps history in memory
+        
+        // Windows whose average, min, max and percentiles are maintained as
+        // samples arrive; other durations are computed from the history
+        std::vector<std::chrono::seconds> rolling_windows{
+            std::chrono::seconds(10), std::chrono::seconds(60), std::chrono::seconds(300),
+            std::chrono::seconds(900), std::chrono::seconds(3600)};
     };
     
     /**
@@ -140,14 +197,20 @@ public:
      * @param cfg Configuration
      * @param bus Event bus for notifications
      */
-    explicit metrics_aggregator(const config& cfg = {},
+    explicit metrics_aggregator(const config& cfg,
                                 std::shared_ptr<thread_ns::event_bus> bus = nullptr)
-        : config_(cfg), event_bus_(bus) {
+        : config_(cfg), event_bus_(bus), history_(history_config(cfg)), rolling_(rolling_config_for(cfg)),
+          alerts_(alert_metric_names()),
+          memory_capacity_mb_(cfg.memory_capacity_mb > 0 ? cfg.memory_capacity_mb : physical_memory_mb()) {
         if (!event_bus_) {
             event_bus_ = std::make_shared<thread_ns::event_bus>();
         }
+        add_threshold_rules();
     }
     
+    // config's member initializers are unusable in a default argument here
+    metrics_aggregator() : metrics_aggregator(config{}) {}
+    
     /**
      * @brief Destructor
      */
@@ -158,12 +221,64 @@ public:
     /**
      * @brief Register a monitorable component
      * @param name Component name
+     * @param kind What the component reports
      * @param component Monitorable component
      */
     void register_component(const std::string& name,
+                           component_kind kind,
                            std::shared_ptr<shared::IMonitorable> component) {
         std::lock_guard<std::mutex> lock(components_mutex_);
-        components_[name] = component;
+        components_[name] = registered_component{kind, std::move(component)};
+    }
+    
+    /**
+     * @brief Add an alert rule, e.g. {"saturation", "queue_utilization > 95", 1min, "warning"}
+     * @return Error if the name is taken or the condition does not compile
+     *
+     * Conditions may use the numeric fields of aggregated_metrics by name
+     * (cpu_usage_percent, p99_latency_ms, ...) and the production.json names
+     * cpu_usage, memory_usage and queue_utilization, all percentages; the
+     * latter two are relative to config::memory_capacity_mb and
+     * config::queue_capacity. Durations in the
+     * production.json form ("1m") can be converted with
+     * alert_rule_engine::parse_duration().
+     */
+    common::VoidResult add_alert_rule(const alert_rule_definition& rule) {
+        std::lock_guard<std::mutex> lock(alerts_mutex_);
+        auto added = alerts_.add_rule(rule);
+        if (added.is_err()) {
+            return common::VoidResult::err(added.error().code, added.error().message);
+        }
+        alert_types_.push_back(metrics_alert_event::alert_type::custom);
+        return common::ok();
+    }
+    
+    /**
+     * @brief Add the rules of a configuration file's alerting section (see production.json)
+     * @return Error if the file has no such section, or naming the first rule
+     *         that cannot be added; the rules before it stay added
+     */
+    common::VoidResult load_alert_rules(const std::string& path) {
+        auto rules = alert_rule_engine::load_alerting_section(path);
+        if (rules.is_err()) {
+            return common::VoidResult::err(rules.error().code, rules.error().message);
+        }
+        for (const auto& rule : rules.value()) {
+            auto added = add_alert_rule(rule);
+            if (added.is_err()) {
+                return added;
+            }
+        }
+        return common::ok();
+    }
+    
+    /**
+     * @brief Current state of an alert rule, inactive if there is no such rule
+     */
+    [[nodiscard]] alert_state get_alert_state(const std::string& rule) const {
+        std::lock_guard<std::mutex> lock(alerts_mutex_);
+        auto index = alerts_.find_rule(rule);
+        return index.is_ok() ? alerts_.state(index.value()) : alert_state::inactive;
     }
     
     /**
@@ -207,22 +322,41 @@ public:
         return running_.load();
     }
     
+    /**
+     * @brief Record a sample as if collected: keep it in the history and
+     *        evaluate the alert rules against it
+     *
+     * Rule durations are measured between sample timestamps.
+     */
+    void add_sample(const aggregated_metrics& metrics) {
+        const auto columns = to_history_columns(metrics);
+        {
+            std::lock_guard<std::mutex> lock(metrics_mutex_);
+            latest_ = metrics;
+            history_.append(metrics.timestamp, columns);
+            rolling_.add(metrics.timestamp, columns);
+        }
+        
+        evaluate_alerts(metrics.timestamp, columns);
+    }
+    
     /**
      * @brief Get current aggregated metrics
      * @return Current metrics
      */
     [[nodiscard]] aggregated_metrics get_current_metrics() const {
         std::lock_guard<std::mutex> lock(metrics_mutex_);
-        if (!metrics_history_.empty()) {
-            return metrics_history_.back();
-        }
-        return aggregated_metrics{};
+        return latest_;
     }
     
     /**
      * @brief Get metrics history
      * @param duration How far back to retrieve
-     * @return Vector of historical metrics
+     * @return Vector of historical metrics, oldest first
+     *
+     * Only the blocks overlapping the window are decoded. Ranges older than
+     * the raw history come from rollups, one averaged sample per step.
+     * Plugin maps are not part of the history.
      */
     [[nodiscard]] std::vector<aggregated_metrics> get_history(
         std::chrono::seconds duration = std::chrono::seconds(3600)) const {
@@ -230,14 +364,12 @@ public:
         std::lock_guard<std::mutex> lock(metrics_mutex_);
         
         auto now = std::chrono::system_clock::now();
-        auto cutoff = now - duration;
         
         std::vector<aggregated_metrics> result;
-        for (const auto& metrics : metrics_history_) {
-            if (metrics.timestamp >= cutoff) {
-                result.push_back(metrics);
-            }
-        }
+        history_.scan(now - duration, now,
+                      [&](std::chrono::system_clock::time_point timestamp, std::span<const double> values) {
+                          result.push_back(from_history_columns(timestamp, values));
+                      });
         
         return result;
     }
@@ -246,47 +378,43 @@ public:
      * @brief Calculate average metrics over a time period
      * @param duration Time period
      * @return Average metrics
+     *
+     * O(1) for a configured rolling window; other durations stream over the
+     * history. Rolling windows end at the newest sample.
      */
     [[nodiscard]] aggregated_metrics calculate_average(std::chrono::seconds duration) const {
-        auto history = get_history(duration);
-        if (history.empty()) {
-            return aggregated_metrics{};
-        }
-        
-        aggregated_metrics avg;
-        avg.timestamp = std::chrono::system_clock::now();
-        
-        for (const auto& m : history) {
-            avg.thread_metrics.active_threads += m.thread_metrics.active_threads;
-            avg.thread_metrics.queued_tasks += m.thread_metrics.queued_tasks;
-            avg.thread_metrics.completed_tasks += m.thread_metrics.completed_tasks;
-            avg.thread_metrics.average_task_duration_ms += m.thread_metrics.average_task_duration_ms;
-            avg.thread_metrics.thread_utilization += m.thread_metrics.thread_utilization;
-            
-            avg.system_metrics.cpu_usage_percent += m.system_metrics.cpu_usage_percent;
-            avg.system_metrics.memory_usage_mb += m.system_metrics.memory_usage_mb;
-            
-            avg.performance_metrics.p95_latency_ms += m.performance_metrics.p95_latency_ms;
-            avg.performance_metrics.p99_latency_ms += m.performance_metrics.p99_latency_ms;
-            avg.performance_metrics.throughput_ops += m.performance_metrics.throughput_ops;
-            avg.performance_metrics.error_rate += m.performance_metrics.error_rate;
-        }
-        
-        std::size_t count = history.size();
-        avg.thread_metrics.active_threads /= count;
-        avg.thread_metrics.queued_tasks /= count;
-        avg.thread_metrics.average_task_duration_ms /= count;
-        avg.thread_metrics.thread_utilization /= count;
-        
-        avg.system_metrics.cpu_usage_percent /= count;
-        avg.system_metrics.memory_usage_mb /= count;
-        
-        avg.performance_metrics.p95_latency_ms /= count;
-        avg.performance_metrics.p99_latency_ms /= count;
-        avg.performance_metrics.throughput_ops /= count;
-        avg.performance_metrics.error_rate /= count;
-        
-        return avg;
+        return summarize(duration, [](const rolling_aggregate& rolling, std::size_t window, std::size_t column) {
+            return rolling.stats(window, column).mean();
+        });
+    }
+    
+    /**
+     * @brief Smallest value of each field over a time period
+     */
+    [[nodiscard]] aggregated_metrics calculate_minimum(std::chrono::seconds duration) const {
+        return summarize(duration, [](const rolling_aggregate& rolling, std::size_t window, std::size_t column) {
+            return rolling.stats(window, column).min;
+        });
+    }
+    
+    /**
+     * @brief Largest value of each field over a time period
+     */
+    [[nodiscard]] aggregated_metrics calculate_maximum(std::chrono::seconds duration) const {
+        return summarize(duration, [](const rolling_aggregate& rolling, std::size_t window, std::size_t column) {
+            return rolling.stats(window, column).max;
+        });
+    }
+    
+    /**
+     * @brief Value of each field at a quantile (0.0 - 1.0) over a time period
+     *
+     * Within 1% of the true value.
+     */
+    [[nodiscard]] aggregated_metrics calculate_percentile(std::chrono::seconds duration, double quantile) const {
+        return summarize(duration, [quantile](const rolling_aggregate& rolling, std::size_t window, std::size_t column) {
+            return rolling.quantile(window, column, quantile);
+        });
     }
     
     /**
@@ -304,11 +432,13 @@ public:
         ss << "    \"queued_tasks\": " << metrics.thread_metrics.queued_tasks << ",\n";
         ss << "    \"completed_tasks\": " << metrics.thread_metrics.completed_tasks << ",\n";
         ss << "    \"average_task_duration_ms\": " << metrics.thread_metrics.average_task_duration_ms << ",\n";
-        ss << "    \"thread_utilization\": " << metrics.thread_metrics.thread_utilization << "\n";
+        ss << "    \"thread_utilization\": " << metrics.thread_metrics.thread_utilization << ",\n";
+        ss << "    \"queue_utilization\": " << metrics.thread_metrics.queue_utilization << "\n";
         ss << "  },\n";
         ss << "  \"system\": {\n";
         ss << "    \"cpu_usage_percent\": " << metrics.system_metrics.cpu_usage_percent << ",\n";
-        ss << "    \"memory_usage_mb\": " << metrics.system_metrics.memory_usage_mb << "\n";
+        ss << "    \"memory_usage_mb\": " << metrics.system_metrics.memory_usage_mb << ",\n";
+        ss << "    \"memory_usage_percent\": " << metrics.system_metrics.memory_usage_percent << "\n";
         ss << "  },\n";
         ss << "  \"performance\": {\n";
         ss << "    \"p95_latency_ms\": " << metrics.performance_metrics.p95_latency_ms << ",\n";
@@ -336,16 +466,7 @@ private:
     void collection_loop() {
         while (running_) {
             auto metrics = collect_metrics();
-            
-            {
-                std::lock_guard<std::mutex> lock(metrics_mutex_);
-                if (metrics_history_.size() >= config_.max_history_size) {
-                    metrics_history_.erase(metrics_history_.begin());
-                }
-                metrics_history_.push_back(metrics);
-            }
-            
-            check_thresholds(metrics);
+            add_sample(metrics);
             
             // Publish metrics event
             if (event_bus_) {
@@ -365,78 +486,263 @@ private:
         
         std::lock_guard<std::mutex> lock(components_mutex_);
         
-        for (const auto& [name, component] : components_) {
-            if (!component) continue;
+        for (const auto& [name, entry] : components_) {
+            if (!entry.component) continue;
             
-            auto snapshot = component->get_metrics();
+            auto snapshot = entry.component->get_metrics();
             
-            // Aggregate based on component type
-            if (name.find("thread") != std::string::npos) {
-                metrics.thread_metrics.active_threads = snapshot.active_threads;
-                metrics.thread_metrics.queued_tasks = snapshot.queued_tasks;
-                metrics.thread_metrics.completed_tasks = snapshot.completed_tasks;
-                metrics.thread_metrics.average_task_duration_ms = snapshot.average_task_duration_ms;
+            switch (entry.kind) {
+                case component_kind::thread_pool:
+                    metrics.thread_metrics.active_threads = snapshot.active_threads;
+                    metrics.thread_metrics.queued_tasks = snapshot.queued_tasks;
+                    metrics.thread_metrics.completed_tasks = snapshot.completed_tasks;
+                    metrics.thread_metrics.average_task_duration_ms = snapshot.average_task_duration_ms;
+                    if (config_.queue_capacity > 0) {
+                        metrics.thread_metrics.queue_utilization =
+                            100.0 * static_cast<double>(snapshot.queued_tasks) /
+                            static_cast<double>(config_.queue_capacity);
+                    }
+                    break;
+                case component_kind::system_monitor:
+                    metrics.system_metrics.cpu_usage_percent = snapshot.cpu_usage;
+                    metrics.system_metrics.memory_usage_mb = snapshot.memory_usage_mb;
+                    if (memory_capacity_mb_ > 0) {
+                        metrics.system_metrics.memory_usage_percent =
+                            100.0 * static_cast<double>(snapshot.memory_usage_mb) / memory_capacity_mb_;
+                    }
+                    break;
             }
-            else if (name.find("monitor") != std::string::npos) {
-                metrics.system_metrics.cpu_usage_percent = snapshot.cpu_usage;
-                metrics.system_metrics.memory_usage_mb = snapshot.memory_usage_mb;
-            }
-            // Add more component types as needed
         }
         
         return metrics;
     }
     
-    /**
-     * @brief Check metrics against thresholds
-     */
-    void check_thresholds(const aggregated_metrics& metrics) {
-        if (metrics.system_metrics.cpu_usage_percent > config_.cpu_threshold) {
-            publish_alert(metrics_alert_event::alert_type::cpu_high,
-                         "CPU usage exceeds threshold",
-                         metrics.system_metrics.cpu_usage_percent,
-                         config_.cpu_threshold);
+    // Numeric fields of aggregated_metrics stored per history sample
+    static constexpr std::size_t history_columns = 22;
+    
+    // Columns of the production.json metric names
+    static constexpr std::size_t cpu_usage_column = 10;
+    static constexpr std::size_t memory_usage_column = 20;
+    static constexpr std::size_t queue_utilization_column = 21;
+    
+    static double physical_memory_mb() {
+#if defined(_SC_PHYS_PAGES) && defined(_SC_PAGESIZE)
+        const long pages = ::sysconf(_SC_PHYS_PAGES);
+        const long page_size = ::sysconf(_SC_PAGESIZE);
+        if (pages > 0 && page_size > 0) {
+            return static_cast<double>(pages) * static_cast<double>(page_size) / (1024.0 * 1024.0);
         }
+#endif
+        return 0.0;
+    }
+    
+    static timeseries_config history_config(const config& cfg) {
+        timeseries_config history;
+        history.columns = history_columns;
+        history.capacity_bytes = cfg.history_bytes;
+        history.rollups = cfg.history_rollups;
+        history.path = cfg.history_path;
+        return history;
+    }
+    
+    static rolling_config rolling_config_for(const config& cfg) {
+        rolling_config rolling;
+        rolling.columns = history_columns;
+        rolling.windows.assign(cfg.rolling_windows.begin(), cfg.rolling_windows.end());
         
-        if (metrics.system_metrics.memory_usage_mb > config_.memory_threshold) {
-            publish_alert(metrics_alert_event::alert_type::memory_high,
-                         "Memory usage exceeds threshold",
-                         metrics.system_metrics.memory_usage_mb,
-                         config_.memory_threshold);
+        // Enough samples for the longest window at the collection interval
+        std::chrono::milliseconds longest{0};
+        for (const auto& window : rolling.windows) {
+            longest = std::max(longest, window);
         }
+        const auto interval = std::max<std::int64_t>(cfg.collection_interval.count(), 1);
+        rolling.max_samples = static_cast<std::size_t>(
+            std::clamp<std::int64_t>(longest.count() / interval + 2, 16, 1 << 20));
+        return rolling;
+    }
+    
+    /**
+     * @brief Apply one per-field reduction over a period
+     *
+     * Configured rolling windows are answered from rolling_ directly; any other
+     * duration replays the history window into a one-off aggregate.
+     */
+    template<typename Reduce>
+    aggregated_metrics summarize(std::chrono::seconds duration, Reduce&& reduce) const {
+        std::array<double, history_columns> values{};
+        auto read = [&](const rolling_aggregate& rolling, std::size_t window) {
+            if (rolling.stats(window, 0).count == 0) {
+                return false;
+            }
+            for (std::size_t i = 0; i < history_columns; ++i) {
+                values[i] = reduce(rolling, window, i);
+            }
+            return true;
+        };
         
-        if (metrics.performance_metrics.error_rate > config_.error_rate_threshold) {
-            publish_alert(metrics_alert_event::alert_type::error_rate_high,
-                         "Error rate exceeds threshold",
-                         metrics.performance_metrics.error_rate,
-                         config_.error_rate_threshold);
+        bool found = false;
+        {
+            std::lock_guard<std::mutex> lock(metrics_mutex_);
+            if (const auto window = rolling_.find_window(duration)) {
+                found = read(rolling_, *window);
+            } else {
+                rolling_config adhoc_config;
+                adhoc_config.columns = history_columns;
+                adhoc_config.windows = {std::chrono::milliseconds(duration) + std::chrono::milliseconds(1)};
+                adhoc_config.max_samples = std::numeric_limits<std::size_t>::max();
+                rolling_aggregate adhoc(adhoc_config);
+                
+                const auto now = std::chrono::system_clock::now();
+                history_.scan(now - duration, now,
+                              [&](std::chrono::system_clock::time_point timestamp, std::span<const double> sample) {
+                                  adhoc.add(timestamp, sample);
+                              });
+                found = read(adhoc, 0);
+            }
         }
         
-        if (metrics.performance_metrics.p99_latency_ms > config_.latency_p99_threshold) {
-            publish_alert(metrics_alert_event::alert_type::latency_high,
-                         "P99 latency exceeds threshold",
-                         metrics.performance_metrics.p99_latency_ms,
-                         config_.latency_p99_threshold);
+        if (!found) {
+            return aggregated_metrics{};
         }
+        return from_history_columns(std::chrono::system_clock::now(), values);
+    }
+    
+    static std::array<double, history_columns> to_history_columns(const aggregated_metrics& m) {
+        return {
+            static_cast<double>(m.thread_metrics.active_threads),
+            static_cast<double>(m.thread_metrics.queued_tasks),
+            static_cast<double>(m.thread_metrics.completed_tasks),
+            m.thread_metrics.average_task_duration_ms,
+            m.thread_metrics.thread_utilization,
+            static_cast<double>(m.logger_metrics.messages_logged),
+            static_cast<double>(m.logger_metrics.errors_logged),
+            static_cast<double>(m.logger_metrics.warnings_logged),
+            m.logger_metrics.average_log_latency_ms,
+            static_cast<double>(m.logger_metrics.buffer_usage_bytes),
+            m.system_metrics.cpu_usage_percent,
+            m.system_metrics.memory_usage_mb,
+            static_cast<double>(m.system_metrics.memory_usage_bytes),
+            m.system_metrics.disk_io_mbps,
+            m.system_metrics.network_io_mbps,
+            m.performance_metrics.p50_latency_ms,
+            m.performance_metrics.p95_latency_ms,
+            m.performance_metrics.p99_latency_ms,
+            m.performance_metrics.throughput_ops,
+            m.performance_metrics.error_rate,
+            m.system_metrics.memory_usage_percent,
+            m.thread_metrics.queue_utilization,
+        };
+    }
+    
+    static aggregated_metrics from_history_columns(std::chrono::system_clock::time_point timestamp,
+                                                   std::span<const double> v) {
+        auto count = [](double value) { return static_cast<std::size_t>(std::llround(value)); };
+        
+        aggregated_metrics m;
+        m.timestamp = timestamp;
+        m.thread_metrics.active_threads = count(v[0]);
+        m.thread_metrics.queued_tasks = count(v[1]);
+        m.thread_metrics.completed_tasks = count(v[2]);
+        m.thread_metrics.average_task_duration_ms = v[3];
+        m.thread_metrics.thread_utilization = v[4];
+        m.logger_metrics.messages_logged = count(v[5]);
+        m.logger_metrics.errors_logged = count(v[6]);
+        m.logger_metrics.warnings_logged = count(v[7]);
+        m.logger_metrics.average_log_latency_ms = v[8];
+        m.logger_metrics.buffer_usage_bytes = count(v[9]);
+        m.system_metrics.cpu_usage_percent = v[10];
+        m.system_metrics.memory_usage_mb = v[11];
+        m.system_metrics.memory_usage_bytes = count(v[12]);
+        m.system_metrics.disk_io_mbps = v[13];
+        m.system_metrics.network_io_mbps = v[14];
+        m.performance_metrics.p50_latency_ms = v[15];
+        m.performance_metrics.p95_latency_ms = v[16];
+        m.performance_metrics.p99_latency_ms = v[17];
+        m.performance_metrics.throughput_ops = v[18];
+        m.performance_metrics.error_rate = v[19];
+        m.system_metrics.memory_usage_percent = v[20];
+        m.thread_metrics.queue_utilization = v[21];
+        return m;
+    }
+    
+    static std::vector<std::string> alert_metric_names() {
+        return {
+            "active_threads", "queued_tasks", "completed_tasks", "average_task_duration_ms",
+            "thread_utilization", "messages_logged", "errors_logged", "warnings_logged",
+            "average_log_latency_ms", "buffer_usage_bytes", "cpu_usage_percent", "memory_usage_mb",
+            "memory_usage_bytes", "disk_io_mbps", "network_io_mbps", "p50_latency_ms",
+            "p95_latency_ms", "p99_latency_ms", "throughput_ops", "error_rate",
+            "memory_usage_percent", "queue_utilization"};
+    }
+    
+    static std::string format_threshold(double value) {
+        std::ostringstream out;
+        out << std::setprecision(17) << value;
+        return out.str();
+    }
+    
+    /**
+     * @brief Register the config thresholds as rules, one per alert_type
+     */
+    void add_threshold_rules() {
+        // Names used by the alerting rules in production.json, all percentages
+        alerts_.add_alias("cpu_usage", cpu_usage_column);
+        alerts_.add_alias("memory_usage", memory_usage_column);
         
-        if (metrics.performance_metrics.throughput_ops < config_.min_throughput &&
-            metrics.performance_metrics.throughput_ops > 0) {
-            publish_alert(metrics_alert_event::alert_type::throughput_low,
-                         "Throughput below minimum",
-                         metrics.performance_metrics.throughput_ops,
-                         config_.min_throughput);
+        const struct {
+            metrics_alert_event::alert_type type;
+            const char* name;
+            std::string condition;
+            const char* message;
+        } thresholds[] = {
+            {metrics_alert_event::alert_type::cpu_high, "cpu_high",
+             "cpu_usage_percent > " + format_threshold(config_.cpu_threshold),
+             "CPU usage exceeds threshold"},
+            {metrics_alert_event::alert_type::memory_high, "memory_high",
+             "memory_usage_percent > " + format_threshold(config_.memory_threshold),
+             "Memory usage exceeds threshold"},
+            {metrics_alert_event::alert_type::error_rate_high, "error_rate_high",
+             "error_rate > " + format_threshold(config_.error_rate_threshold),
+             "Error rate exceeds threshold"},
+            {metrics_alert_event::alert_type::latency_high, "latency_high",
+             "p99_latency_ms > " + format_threshold(config_.latency_p99_threshold),
+             "P99 latency exceeds threshold"},
+            {metrics_alert_event::alert_type::throughput_low, "throughput_low",
+             "throughput_ops < " + format_threshold(config_.min_throughput) + " && throughput_ops > 0",
+             "Throughput below minimum"},
+        };
+        
+        for (const auto& threshold : thresholds) {
+            if (alerts_.add_rule({threshold.name, threshold.condition, config_.threshold_duration, "warning"}).is_ok()) {
+                alert_types_.push_back(threshold.type);
+                threshold_messages_.push_back(threshold.message);
+            }
         }
     }
     
     /**
-     * @brief Publish alert event
+     * @brief Advance every alert rule and publish its transitions
      */
-    void publish_alert(metrics_alert_event::alert_type type,
-                      const std::string& message,
-                      double current_value,
-                      double threshold) {
+    void evaluate_alerts(std::chrono::system_clock::time_point now, std::span<const double> columns) {
+        std::vector<metrics_alert_event> events;
+        {
+            std::lock_guard<std::mutex> lock(alerts_mutex_);
+            alerts_.evaluate(now, columns, [&](const alert_transition& transition) {
+                const auto& rule = alerts_.rule(transition.rule);
+                const auto type = alert_types_[transition.rule];
+                std::string message = transition.rule < threshold_messages_.size()
+                                          ? threshold_messages_[transition.rule]
+                                          : rule.condition;
+                events.emplace_back(type, std::move(message), transition.value, transition.threshold,
+                                    rule.name, rule.severity, transition.to);
+            });
+        }
+        
+        // Published outside the lock so handlers may add rules
         if (event_bus_) {
-            event_bus_->publish(metrics_alert_event(type, message, current_value, threshold));
+            for (const auto& event : events) {
+                event_bus_->publish(event);
+            }
         }
     }
     
@@ -445,11 +751,25 @@ private:
     std::atomic<bool> running_{false};
     std::thread collection_thread_;
     
+    struct registered_component {
+        component_kind kind;
+        std::shared_ptr<shared::IMonitorable> component;
+    };
+    
     mutable std::mutex components_mutex_;
-    std::unordered_map<std::string, std::shared_ptr<shared::IMonitorable>> components_;
+    std::unordered_map<std::string, registered_component> components_;
     
     mutable std::mutex metrics_mutex_;
-    std::vector<aggregated_metrics> metrics_history_;
+    aggregated_metrics latest_;
+    timeseries_store history_;
+    rolling_aggregate rolling_;
+    
+    mutable std::mutex alerts_mutex_;
+    alert_rule_engine alerts_;
+    std::vector<metrics_alert_event::alert_type> alert_types_;  // Per rule index
+    std::vector<std::string> threshold_messages_;                // Built-in rules come first
+    
+    double memory_capacity_mb_;
 };
 
 } // namespace kcenon::integrated
\ No newline at end of file
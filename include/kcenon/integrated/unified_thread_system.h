@@ -17,6 +17,7 @@
 
 #pragma once
 
+#include <algorithm>
 #include <future>
 #include <functional>
 #include <memory>
@@ -24,11 +25,24 @@
 #include <string>
 #include <chrono>
 #include <any>
+#include <cstddef>
+#include <cstdint>
 #include <atomic>
 #include <optional>
 #include <concepts>
 #include <iterator>
+#include <span>
+#include <utility>
 #include <kcenon/integrated/core/configuration.h>
+#include <kcenon/integrated/core/event_bus.h>
+#include <kcenon/integrated/core/lock_profiler.h>
+#include <kcenon/integrated/core/perf_counters.h>
+#include <kcenon/integrated/core/metric_registry.h>
+#include <kcenon/integrated/core/prometheus_writer.h>
+#include <kcenon/integrated/core/rate_meter.h>
+#include <kcenon/integrated/core/task_latency.h>
+#include <kcenon/integrated/core/task_allocator.h>
+#include <kcenon/integrated/core/worker_activity.h>
 
 namespace kcenon::integrated {
 
@@ -75,23 +89,55 @@ struct performance_metrics {
     size_t tasks_submitted{0};
     size_t tasks_completed{0};
     size_t tasks_failed{0};
+    size_t tasks_rejected{0};   // Submissions refused (open breaker, full queue, shutdown)
     size_t tasks_cancelled{0};
 
-    // Latency metrics
+    // Latency metrics (execution time)
     std::chrono::nanoseconds average_latency{0};
     std::chrono::nanoseconds min_latency{0};
     std::chrono::nanoseconds max_latency{0};
+    std::chrono::nanoseconds p50_latency{0};
     std::chrono::nanoseconds p95_latency{0};
     std::chrono::nanoseconds p99_latency{0};
+    std::chrono::nanoseconds p999_latency{0};
+
+    // Latency breakdown: time queued before a worker started the task, time
+    // running, and both together; across all lanes and per priority lane
+    latency_summary queue_wait_latency;
+    latency_summary execution_latency;
+    latency_summary end_to_end_latency;
+    std::vector<lane_latency> lane_latencies;  // Lanes that ran at least one task
 
     // Worker and queue metrics
-    size_t active_workers{0};
+    size_t active_workers{0};        // Workers running a task right now
+    size_t blocked_workers{0};       // Workers inside blocking_section()
+    size_t compensating_workers{0};  // Extra workers standing in for blocked ones
     size_t queue_size{0};
     size_t max_queue_size{0};
     double queue_utilization_percent{0.0};
 
+    // Time accounting since measurement_start. With the submission rate these
+    // give Little's law: average_queue_length = arrival rate x mean queue wait.
+    // A task's queued time is counted once it starts.
+    std::vector<worker_utilization> workers;  // Started workers, by id
+    double pool_utilization{0.0};         // Busy share of the workers' available time (0-1)
+    double average_busy_workers{0.0};     // Time-averaged workers running a task
+    double average_queue_length{0.0};     // Time-averaged tasks waiting to start
+    double average_tasks_in_system{0.0};  // Waiting plus running
+
+    // Queue lock contention by lock name; empty unless enable_lock_profiling is set
+    std::vector<lock_contention> locks;
+
+    // Hardware counters by task label and priority lane, with IPC and miss
+    // rates; empty unless enable_perf_counters is set
+    std::vector<task_counters> task_classes;
+
     // Throughput metrics
-    double tasks_per_second{0.0};
+    double tasks_per_second{0.0};  // Completions over the last 10 seconds
+    rate_snapshot submission_rate;
+    rate_snapshot completion_rate;
+    rate_snapshot failure_rate;
+    rate_snapshot rejection_rate;
     std::chrono::steady_clock::time_point measurement_start;
 };
 
@@ -134,11 +180,39 @@ struct config {
     bool enable_circuit_breaker = false;
     size_t circuit_breaker_failure_threshold = 5;
     std::chrono::milliseconds circuit_breaker_reset_timeout{5000};
+    size_t circuit_breaker_window_seconds = 10;      // Sliding window of per-second buckets
+    size_t circuit_breaker_minimum_calls = 20;       // Calls in the window before rates apply
+    double circuit_breaker_failure_rate = 0.5;       // Failure rate that opens the breaker
+    double circuit_breaker_slow_call_rate = 1.0;     // Slow-call rate that opens the breaker
+    std::chrono::milliseconds circuit_breaker_slow_call_duration{0}; // 0 = no slow-call tracking
+    size_t circuit_breaker_half_open_permits = 3;    // Probe tasks admitted while half-open
     size_t max_queue_size = 10000;
     bool enable_work_stealing = true;
     bool enable_dynamic_scaling = false;
     size_t min_threads = 1;
     size_t max_threads = 0; // 0 = no limit
+    bool enable_batch_processing = true; // Drain several queued tasks per lock acquisition
+    size_t batch_size = 64;              // Upper bound on tasks taken per acquisition
+    size_t latency_precision_digits = 2; // Significant digits kept by latency percentiles (1-4)
+    bool enable_io_uring = true;         // Async file I/O backend; falls back to I/O threads
+    size_t io_queue_depth = 256;
+    size_t io_fallback_threads = 2;
+    bool enable_metrics_endpoint = false; // Serve /metrics, /metrics.json and /health over HTTP
+    std::string metrics_bind_address = "127.0.0.1";
+    std::uint16_t metrics_port = 9090;   // 0 picks a free port; see metrics_endpoint_port()
+    size_t max_series_per_metric = 1000; // Label sets per registered metric; more share an overflow series
+    bool enable_tracing = false;         // Record sampled task spans; see export_trace_json()
+    double trace_sample_rate = 0.01;     // Fraction of submitted tasks traced
+    size_t trace_events_per_thread = 8192; // Per-thread trace ring; the oldest events are overwritten
+    bool enable_flight_recorder = true;  // Keep recent scheduler events; see dump_flight_recorder()
+    size_t flight_recorder_events = 4096; // Per-worker ring of 16-byte events
+    std::string flight_recorder_dump_directory; // Automatic dumps on critical health; empty = log_directory
+    bool enable_lock_profiling = false;  // Count and time contended queue lock acquisitions
+    bool enable_perf_counters = false;   // Per-worker perf_event counters by task label; see submit_labeled()
+    size_t perf_counter_interval = 1;    // Measure one task in this many on each worker
+    size_t max_task_labels = 64;         // Labels kept apart, including "default" and "other"
+    std::chrono::milliseconds health_check_interval{1000}; // Age at which cached check and collector results are refreshed
+    std::chrono::milliseconds health_check_timeout{5000};  // Default time a check may run before it counts as failing
 
     // Builder pattern for configuration
     config& set_name(const std::string& n) { name = n; return *this; }
@@ -214,7 +288,12 @@ public:
     performance_metrics get_metrics() const;
 
     /**
-     * @brief Get current health status
+     * @brief Get the latest health status
+     *
+     * Health checks run in the background on the pool; this returns the last
+     * published result without running them. A result changes as soon as a
+     * check reports a different outcome, the circuit breaker opens or is
+     * reset, or at least every config::health_check_interval.
      */
     health_status get_health() const;
 
@@ -226,6 +305,69 @@ public:
         log_internal(level, message, std::forward<Args>(args)...);
     }
 
+    /**
+     * @brief Wait for a future, helping the pool while it is not ready
+     *
+     * When called from one of this system's worker threads, queued tasks are
+     * executed on the calling worker until the awaited future becomes ready,
+     * so fork-join code cannot deadlock a fixed-size pool by having every
+     * worker block in get(). From any other thread this is future.get().
+     *
+     * @param future Future to wait for
+     * @return The future's value (rethrows its stored exception)
+     */
+    template<typename T>
+    T wait(std::future<T>& future);
+
+    template<typename T>
+    T wait(std::future<T>&& future) { return wait(future); }
+
+    /**
+     * @brief Run a blocking operation without losing pool parallelism
+     *
+     * When called from a worker thread, the pool is told that this worker is
+     * about to block (I/O, locks, sleeps) and starts or unparks a compensating
+     * worker so that thread_count workers stay runnable. The compensator
+     * parks again once blocked workers resume. Elsewhere f simply runs.
+     *
+     * @param f Blocking operation to run on the calling thread
+     * @return Result of f
+     */
+    template<typename F>
+        requires std::invocable<F>
+    std::invoke_result_t<F> blocking_section(F&& f);
+
+    /**
+     * @brief Submit a task whose whole body runs inside blocking_section()
+     */
+    template<typename F, typename... Args>
+        requires std::invocable<F, Args...>
+    auto submit_blocking(F&& f, Args&&... args) -> std::future<std::invoke_result_t<F, Args...>>;
+
+    /**
+     * @brief Read from a file descriptor at an offset without occupying a worker
+     *
+     * The read is handed to the kernel through io_uring (or to a dedicated
+     * I/O thread where io_uring is unavailable) and completes into the
+     * returned future. Wait on it with wait() from inside a task. The buffer
+     * must stay valid until the future is ready.
+     *
+     * @return Future with the number of bytes read (0 at end of file);
+     *         holds std::system_error on failure
+     */
+    std::future<size_t> async_read(int fd, std::span<std::byte> buffer, std::uint64_t offset);
+
+    /**
+     * @brief Write to a file descriptor at an offset without occupying a worker
+     * @return Future with the number of bytes written; holds std::system_error on failure
+     */
+    std::future<size_t> async_write(int fd, std::span<const std::byte> buffer, std::uint64_t offset);
+
+    /**
+     * @brief Flush a file descriptor to storage without occupying a worker
+     */
+    std::future<void> async_fsync(int fd);
+
     /**
      * @brief Wait for all currently queued tasks to complete
      */
@@ -257,10 +399,40 @@ public:
     size_t queue_size() const;
 
     /**
-     * @brief Check if system is healthy
+     * @brief Check if the latest health status is healthy; see get_health()
      */
     bool is_healthy() const;
 
+    /**
+     * @brief Register a named health check
+     *
+     * A check returns whether it passed and, if not, why. A failing or
+     * throwing check makes the system critical, with the issue
+     * "<name>: <message>". Registering a name again replaces its check.
+     *
+     * Checks run in parallel as low-priority pool tasks, each at most once
+     * per config::health_check_interval. A check still running after
+     * timeout is reported as failing until it returns, and is not started
+     * again meanwhile.
+     *
+     * @param timeout Zero uses config::health_check_timeout
+     */
+    void add_health_check(const std::string& name, std::function<std::pair<bool, std::string>()> check,
+                          std::chrono::milliseconds timeout = std::chrono::milliseconds::zero());
+
+    /**
+     * @brief Export a value computed by a callback as a gauge
+     *
+     * The collector runs on the pool alongside the health checks, at most
+     * once per config::health_check_interval, and export_metrics() writes
+     * its last result as the gauge name. A collector that throws or hangs
+     * leaves the previous value.
+     *
+     * @throws std::invalid_argument for an invalid metric name, or a name
+     *         already registered with another type
+     */
+    void register_metric_collector(const std::string& name, std::function<double()> collector);
+
     /**
      * @brief Stop accepting new tasks and wait for completion
      */
@@ -281,6 +453,91 @@ public:
      */
     std::string export_metrics_json() const;
     std::string export_metrics_prometheus() const;
+    std::string export_metrics_openmetrics() const;
+
+    /**
+     * @brief Append Prometheus samples to a caller-owned writer
+     *
+     * Reusing one writer across scrapes keeps the exposition allocation-free.
+     * Samples are labelled with the configured pool name.
+     */
+    void export_metrics(prometheus_writer& writer) const;
+
+    /**
+     * @brief Register a counter series exported by export_metrics()
+     *
+     * The handle points at the series' storage: increment() is one relaxed
+     * atomic add, with no name lookup or label formatting. Registering the
+     * same name and labels again returns the same series. Each name accepts
+     * up to config::max_series_per_metric label sets; further ones share a
+     * series labelled overflow="true".
+     *
+     * @throws std::invalid_argument for an invalid name or label, or a name
+     *         already registered with another type
+     */
+    counter_handle register_counter(const std::string& name, metric_labels labels = {});
+
+    /**
+     * @brief Register a gauge series; see register_counter()
+     */
+    gauge_handle register_gauge(const std::string& name, metric_labels labels = {});
+
+    /**
+     * @brief Register a histogram series; see register_counter()
+     * @param bounds Ascending bucket upper bounds, the same for every series of a name
+     */
+    histogram_handle register_histogram(const std::string& name, metric_labels labels = {},
+                                        std::span<const double> bounds = default_histogram_buckets);
+
+    /**
+     * @brief Export get_health() as a JSON document
+     */
+    std::string export_health_json() const;
+
+    /**
+     * @brief Sampled task spans as a Chrome Trace Event JSON document
+     *
+     * With enable_tracing set, trace_sample_rate of the submitted tasks are
+     * traced from submission to completion: a slice per run on the worker's
+     * track, the submitting call on the caller's track joined to it by a flow
+     * arrow, an async span for the time spent queued, and steals. Open the
+     * document in ui.perfetto.dev or chrome://tracing.
+     *
+     * @throws std::runtime_error if enable_tracing is not set
+     */
+    std::string export_trace_json() const;
+
+    /**
+     * @brief Write export_trace_json() to a file
+     * @throws std::runtime_error if enable_tracing is not set or the file cannot be written
+     */
+    void export_trace(const std::string& path) const;
+
+    /**
+     * @brief Write the flight recorder's scheduler events to a binary file
+     *
+     * With enable_flight_recorder set, every worker keeps its last
+     * flight_recorder_events scheduler events (enqueue, dequeue, start,
+     * finish, park, unpark, steal, reject) in a ring that is never switched
+     * off. The same dump is written automatically into
+     * flight_recorder_dump_directory when get_health() turns critical, at
+     * most once a minute. Read dumps with flight_recorder::load().
+     *
+     * @throws std::runtime_error if enable_flight_recorder is not set or the file cannot be written
+     */
+    void dump_flight_recorder(const std::string& path) const;
+
+    /**
+     * @brief Port the built-in metrics endpoint listens on
+     *
+     * With enable_metrics_endpoint set, the system serves export_metrics()
+     * at /metrics, export_metrics_json() at /metrics.json and
+     * export_health_json() at /health (503 unless healthy) from one
+     * epoll-driven thread.
+     *
+     * @return The bound port, or 0 when the endpoint is not running
+     */
+    std::uint16_t metrics_endpoint_port() const;
 
     /**
      * @brief Enhanced task submission with priority
@@ -306,6 +563,33 @@ public:
         return submit_with_priority(priority_level::low, std::forward<F>(f), std::forward<Args>(args)...);
     }
 
+    /**
+     * @brief Name a class of tasks for per-label performance counters
+     *
+     * Registering a name again returns the same label. Once
+     * config::max_task_labels names are in use, further names share the
+     * "other" label. Without config::enable_perf_counters every name maps
+     * to the default label.
+     *
+     * @throws std::invalid_argument if name is empty
+     */
+    task_label register_task_label(const std::string& name);
+
+    /**
+     * @brief Submit a task whose counters are reported under label
+     */
+    template<typename F, typename... Args>
+        requires std::invocable<F, Args...>
+    auto submit_labeled(task_label label, F&& f, Args&&... args)
+        -> std::future<std::invoke_result_t<F, Args...>> {
+        return submit_labeled(label, priority_level::normal, std::forward<F>(f), std::forward<Args>(args)...);
+    }
+
+    template<typename F, typename... Args>
+        requires std::invocable<F, Args...>
+    auto submit_labeled(task_label label, priority_level priority, F&& f, Args&&... args)
+        -> std::future<std::invoke_result_t<F, Args...>>;
+
     /**
      * @brief Create a new cancellation token
      * @return Token that can be used to cancel operations
@@ -367,9 +651,15 @@ public:
 
     /**
      * @brief Event subscription for monitoring
+     *
+     * Emitting never takes a lock. With event_delivery::async the callback
+     * runs on a dispatcher thread of its own behind a bounded ring, so a slow
+     * subscriber cannot stall workers; events that do not fit are dropped.
      */
     using event_callback = std::function<void(const std::string&, const std::any&)>;
     size_t subscribe_to_events(const std::string& event_type, event_callback callback);
+    size_t subscribe_to_events(const std::string& event_type, event_callback callback,
+                               event_delivery delivery);
     void unsubscribe_from_events(size_t subscription_id);
 
     /**
@@ -399,9 +689,14 @@ private:
     // Internal methods
     void submit_internal(std::function<void()> task);
     void submit_priority_internal(int priority, std::function<void()> task);
+    void submit_labeled_internal(task_label label, int priority, std::function<void()> task);
     void submit_cancellable_internal(std::shared_ptr<void> token, std::function<void()> task);
     void schedule_internal(std::chrono::milliseconds delay, std::function<void()> task);
     size_t schedule_recurring_internal(std::chrono::milliseconds interval, std::function<void()> task);
+    bool is_worker_thread() const;
+    bool run_pending_task();
+    bool begin_blocking();
+    void end_blocking();
     template<typename... Args>
     void log_internal(log_level level, const std::string& message, Args&&... args) {
         // Simple implementation for template
@@ -418,16 +713,13 @@ template<typename F, typename... Args>
 auto unified_thread_system::submit(F&& f, Args&&... args) -> std::future<std::invoke_result_t<F, Args...>> {
     using return_type = std::invoke_result_t<F, Args...>;
 
-    auto task = std::make_shared<std::packaged_task<return_type()>>(
+    auto task = detail::make_pooled_task<return_type>(
         std::bind(std::forward<F>(f), std::forward<Args>(args)...)
     );
 
-    auto result = task->get_future();
-
-    // Implementation will be in the .cpp file
-    submit_internal([task]() { (*task)(); });
+    submit_internal(std::move(task.run));
 
-    return result;
+    return std::move(task.future);
 }
 
 template<typename F, typename... Args>
@@ -436,16 +728,29 @@ auto unified_thread_system::submit_with_priority(priority_level priority, F&& f,
     -> std::future<std::invoke_result_t<F, Args...>> {
     using return_type = std::invoke_result_t<F, Args...>;
 
-    auto task = std::make_shared<std::packaged_task<return_type()>>(
+    auto task = detail::make_pooled_task<return_type>(
         std::bind(std::forward<F>(f), std::forward<Args>(args)...)
     );
 
-    auto result = task->get_future();
-
     // Submit with priority to internal implementation
-    submit_priority_internal(static_cast<int>(priority), [task]() { (*task)(); });
+    submit_priority_internal(static_cast<int>(priority), std::move(task.run));
 
-    return result;
+    return std::move(task.future);
+}
+
+template<typename F, typename... Args>
+    requires std::invocable<F, Args...>
+auto unified_thread_system::submit_labeled(task_label label, priority_level priority, F&& f, Args&&... args)
+    -> std::future<std::invoke_result_t<F, Args...>> {
+    using return_type = std::invoke_result_t<F, Args...>;
+
+    auto task = detail::make_pooled_task<return_type>(
+        std::bind(std::forward<F>(f), std::forward<Args>(args)...)
+    );
+
+    submit_labeled_internal(label, static_cast<int>(priority), std::move(task.run));
+
+    return std::move(task.future);
 }
 
 template<typename F, typename... Args>
@@ -454,7 +759,7 @@ auto unified_thread_system::submit_cancellable(cancellation_token& token, F&& f,
     -> std::future<std::invoke_result_t<F, Args...>> {
     using return_type = std::invoke_result_t<F, Args...>;
 
-    auto task = std::make_shared<std::packaged_task<return_type()>>(
+    auto task = detail::make_pooled_task<return_type>(
         [token, func = std::bind(std::forward<F>(f), std::forward<Args>(args)...)]() -> return_type {
             if (token.is_cancelled()) {
                 if constexpr (std::is_void_v<return_type>) {
@@ -467,10 +772,9 @@ auto unified_thread_system::submit_cancellable(cancellation_token& token, F&& f,
         }
     );
 
-    auto result = task->get_future();
-    submit_internal([task]() { (*task)(); });
+    submit_internal(std::move(task.run));
 
-    return result;
+    return std::move(task.future);
 }
 
 template<typename F, typename... Args>
@@ -479,15 +783,13 @@ auto unified_thread_system::submit_cancellable(std::shared_ptr<void> token, F&&
     -> std::future<std::invoke_result_t<F, Args...>> {
     using return_type = std::invoke_result_t<F, Args...>;
 
-    auto task = std::make_shared<std::packaged_task<return_type()>>(
+    auto task = detail::make_pooled_task<return_type>(
         std::bind(std::forward<F>(f), std::forward<Args>(args)...)
     );
 
-    auto result = task->get_future();
+    submit_cancellable_internal(token, std::move(task.run));
 
-    submit_cancellable_internal(token, [task]() { (*task)(); });
-
-    return result;
+    return std::move(task.future);
 }
 
 template<typename F, typename... Args>
@@ -496,15 +798,13 @@ auto unified_thread_system::schedule(std::chrono::milliseconds delay, F&& f, Arg
     -> std::future<std::invoke_result_t<F, Args...>> {
     using return_type = std::invoke_result_t<F, Args...>;
 
-    auto task = std::make_shared<std::packaged_task<return_type()>>(
+    auto task = detail::make_pooled_task<return_type>(
         std::bind(std::forward<F>(f), std::forward<Args>(args)...)
     );
 
-    auto result = task->get_future();
-
-    schedule_internal(delay, [task]() { (*task)(); });
+    schedule_internal(delay, std::move(task.run));
 
-    return result;
+    return std::move(task.future);
 }
 
 template<VoidCallable F>
@@ -526,22 +826,69 @@ auto unified_thread_system::submit_batch(Iterator first, Iterator last, F&& func
     return futures;
 }
 
+template<typename T>
+T unified_thread_system::wait(std::future<T>& future) {
+    if (is_worker_thread()) {
+        constexpr std::chrono::microseconds max_backoff{1000};
+        std::chrono::microseconds backoff{1};
+
+        while (future.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+            if (run_pending_task()) {
+                backoff = std::chrono::microseconds{1};
+                continue;
+            }
+
+            // Nothing runnable here; the awaited task is running elsewhere
+            future.wait_for(backoff);
+            backoff = std::min(backoff * 2, max_backoff);
+        }
+    }
+
+    return future.get();
+}
+
+template<typename F>
+    requires std::invocable<F>
+std::invoke_result_t<F> unified_thread_system::blocking_section(F&& f) {
+    struct blocking_scope {
+        unified_thread_system& system;
+        bool compensated;
+        ~blocking_scope() {
+            if (compensated) {
+                system.end_blocking();
+            }
+        }
+    } scope{*this, begin_blocking()};
+
+    return std::invoke(std::forward<F>(f));
+}
+
+template<typename F, typename... Args>
+    requires std::invocable<F, Args...>
+auto unified_thread_system::submit_blocking(F&& f, Args&&... args)
+    -> std::future<std::invoke_result_t<F, Args...>> {
+    return submit([this, task = std::bind(std::forward<F>(f), std::forward<Args>(args)...)]() mutable {
+        return blocking_section(task);
+    });
+}
+
 template<typename Iterator, typename MapFunc, typename ReduceFunc, typename T>
 auto unified_thread_system::map_reduce(Iterator first, Iterator last, MapFunc&& map_func,
                                ReduceFunc&& reduce_func, T initial)
     -> std::future<T> {
 
-    auto promise = std::make_shared<std::promise<T>>();
+    auto promise = std::allocate_shared<std::promise<T>>(
+        detail::pool_allocator<std::promise<T>>{}, std::allocator_arg, detail::pool_allocator<T>{});
     auto future = promise->get_future();
 
     // Submit map phase
     auto map_futures = submit_batch(first, last, std::forward<MapFunc>(map_func));
 
-    // Submit reduce phase
-    submit([promise, futures = std::move(map_futures), reduce_func, initial]() mutable {
+    // Submit reduce phase; waits help the pool so map tasks cannot be starved
+    submit([this, promise, futures = std::move(map_futures), reduce_func, initial]() mutable {
         T result = initial;
         for (auto& f : futures) {
-            result = reduce_func(result, f.get());
+            result = reduce_func(result, wait(f));
         }
         promise->set_value(result);
     });
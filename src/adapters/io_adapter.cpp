@@ -0,0 +1,639 @@
+// BSD 3-Clause License
+// Copyright (c) 2025, kcenon
+// See the LICENSE file in the project root for full license information.
+
+#include <kcenon/integrated/adapters/io_adapter.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#include <io.h>
+#else
+#include <sys/types.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#define INTEGRATED_HAS_IO_URING 1
+#else
+#define INTEGRATED_HAS_IO_URING 0
+#endif
+
+namespace kcenon::integrated::adapters {
+
+namespace {
+
+enum class io_opcode { read, write, fsync };
+
+struct io_request {
+    io_opcode opcode;
+    int fd;
+    void* data;
+    std::size_t length;
+    std::uint64_t offset;
+#if !defined(_WIN32)
+    iovec vector;  // Referenced by the kernel until completion
+#endif
+    std::promise<std::size_t> transferred;  // read / write
+    std::promise<void> flushed;             // fsync
+};
+
+const char* opcode_name(io_opcode opcode) {
+    switch (opcode) {
+        case io_opcode::read: return "async read";
+        case io_opcode::write: return "async write";
+        case io_opcode::fsync: return "async fsync";
+    }
+    return "async I/O";
+}
+
+// result follows the kernel convention: byte count, or negated errno
+void complete(io_request& request, std::int64_t result) {
+    if (result < 0) {
+        auto error = std::make_exception_ptr(std::system_error(
+            static_cast<int>(-result), std::generic_category(), opcode_name(request.opcode)));
+        if (request.opcode == io_opcode::fsync) {
+            request.flushed.set_exception(error);
+        } else {
+            request.transferred.set_exception(error);
+        }
+        return;
+    }
+
+    if (request.opcode == io_opcode::fsync) {
+        request.flushed.set_value();
+    } else {
+        request.transferred.set_value(static_cast<std::size_t>(result));
+    }
+}
+
+// Executes a request with blocking system calls (fallback backend)
+std::int64_t run_blocking(io_request& request) {
+#if defined(_WIN32)
+    HANDLE handle = reinterpret_cast<HANDLE>(_get_osfhandle(request.fd));
+    if (handle == INVALID_HANDLE_VALUE) {
+        return -EBADF;
+    }
+
+    if (request.opcode == io_opcode::fsync) {
+        return FlushFileBuffers(handle) ? 0 : -EIO;
+    }
+
+    OVERLAPPED position{};
+    position.Offset = static_cast<DWORD>(request.offset & 0xFFFFFFFFu);
+    position.OffsetHigh = static_cast<DWORD>(request.offset >> 32);
+
+    const DWORD length = static_cast<DWORD>(std::min<std::size_t>(request.length, MAXDWORD));
+    DWORD transferred = 0;
+    const BOOL ok = request.opcode == io_opcode::read
+        ? ReadFile(handle, request.data, length, &transferred, &position)
+        : WriteFile(handle, request.data, length, &transferred, &position);
+    if (!ok) {
+        return GetLastError() == ERROR_HANDLE_EOF ? 0 : -EIO;
+    }
+    return transferred;
+#else
+    while (true) {
+        ssize_t result = 0;
+        switch (request.opcode) {
+            case io_opcode::read:
+                result = ::pread(request.fd, request.data, request.length,
+                                 static_cast<off_t>(request.offset));
+                break;
+            case io_opcode::write:
+                result = ::pwrite(request.fd, request.data, request.length,
+                                  static_cast<off_t>(request.offset));
+                break;
+            case io_opcode::fsync:
+                result = ::fsync(request.fd);
+                break;
+        }
+
+        if (result >= 0) {
+            return result;
+        }
+        if (errno != EINTR) {
+            return -errno;
+        }
+    }
+#endif
+}
+
+#if INTEGRATED_HAS_IO_URING
+/**
+ * @brief Minimal io_uring ring driven through raw system calls
+ *
+ * One submitter at a time (callers serialize on their own mutex) and a
+ * single completion reaper thread.
+ */
+class uring {
+public:
+    uring() = default;
+    uring(const uring&) = delete;
+    uring& operator=(const uring&) = delete;
+
+    ~uring() { close(); }
+
+    bool open(unsigned entries) {
+        io_uring_params params{};
+        const long fd = ::syscall(__NR_io_uring_setup, entries, &params);
+        if (fd < 0) {
+            return false;
+        }
+        ring_fd_ = static_cast<int>(fd);
+
+        sq_map_size_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        cq_map_size_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        const bool single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+        if (single_mmap) {
+            sq_map_size_ = cq_map_size_ = std::max(sq_map_size_, cq_map_size_);
+        }
+
+        sq_map_ = ::mmap(nullptr, sq_map_size_, PROT_READ | PROT_WRITE,
+                         MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_SQ_RING);
+        if (sq_map_ == MAP_FAILED) {
+            sq_map_ = nullptr;
+            close();
+            return false;
+        }
+
+        if (single_mmap) {
+            cq_map_ = sq_map_;
+        } else {
+            cq_map_ = ::mmap(nullptr, cq_map_size_, PROT_READ | PROT_WRITE,
+                             MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_CQ_RING);
+            if (cq_map_ == MAP_FAILED) {
+                cq_map_ = nullptr;
+                close();
+                return false;
+            }
+        }
+
+        sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+        void* sqes = ::mmap(nullptr, sqes_size_, PROT_READ | PROT_WRITE,
+                            MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_SQES);
+        if (sqes == MAP_FAILED) {
+            close();
+            return false;
+        }
+        sqes_ = static_cast<io_uring_sqe*>(sqes);
+
+        auto* sq = static_cast<char*>(sq_map_);
+        sq_head_ = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+        sq_tail_ = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+        sq_mask_ = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+        sq_array_ = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+        sq_entries_ = params.sq_entries;
+
+        auto* cq = static_cast<char*>(cq_map_);
+        cq_head_ = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+        cq_tail_ = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+        cq_mask_ = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+        cqes_ = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+        return true;
+    }
+
+    void close() {
+        if (sqes_) {
+            ::munmap(sqes_, sqes_size_);
+            sqes_ = nullptr;
+        }
+        if (cq_map_ && cq_map_ != sq_map_) {
+            ::munmap(cq_map_, cq_map_size_);
+        }
+        cq_map_ = nullptr;
+        if (sq_map_) {
+            ::munmap(sq_map_, sq_map_size_);
+            sq_map_ = nullptr;
+        }
+        if (ring_fd_ >= 0) {
+            ::close(ring_fd_);
+            ring_fd_ = -1;
+        }
+    }
+
+    unsigned capacity() const { return sq_entries_; }
+
+    /**
+     * @brief Queue one SQE and enter the kernel; caller holds the submit lock
+     * @return false if the submission queue is full
+     */
+    bool submit(io_request* request) {
+        const unsigned tail = *sq_tail_;
+        const unsigned head = std::atomic_ref<unsigned>(*sq_head_).load(std::memory_order_acquire);
+        if (tail - head >= sq_entries_) {
+            return false;
+        }
+
+        const unsigned index = tail & sq_mask_;
+        io_uring_sqe& sqe = sqes_[index];
+        std::memset(&sqe, 0, sizeof(sqe));
+        sqe.user_data = reinterpret_cast<std::uint64_t>(request);
+
+        if (!request) {
+            sqe.opcode = IORING_OP_NOP;
+        } else if (request->opcode == io_opcode::fsync) {
+            sqe.opcode = IORING_OP_FSYNC;
+            sqe.fd = request->fd;
+        } else {
+            // READV/WRITEV work on every io_uring kernel (5.1+)
+            request->vector.iov_base = request->data;
+            request->vector.iov_len = request->length;
+            sqe.opcode = request->opcode == io_opcode::read ? IORING_OP_READV : IORING_OP_WRITEV;
+            sqe.fd = request->fd;
+            sqe.addr = reinterpret_cast<std::uint64_t>(&request->vector);
+            sqe.len = 1;
+            sqe.off = request->offset;
+        }
+
+        sq_array_[index] = index;
+        std::atomic_ref<unsigned>(*sq_tail_).store(tail + 1, std::memory_order_release);
+
+        // Submit everything the kernel has not consumed yet, including entries
+        // left behind by an earlier interrupted enter
+        const unsigned pending = tail + 1 - head;
+        while (::syscall(__NR_io_uring_enter, ring_fd_, pending, 0, 0, nullptr, 0) < 0) {
+            if (errno != EINTR) {
+                break;  // EAGAIN/EBUSY: the next enter submits it
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief Block until at least one completion is available
+     */
+    void wait() {
+        while (::syscall(__NR_io_uring_enter, ring_fd_, 0, 1, IORING_ENTER_GETEVENTS, nullptr, 0) < 0) {
+            if (errno != EINTR) {
+                std::this_thread::yield();
+                return;
+            }
+        }
+    }
+
+    /**
+     * @brief Hand every available completion to visit(user_data, result)
+     */
+    template<typename Visitor>
+    void drain(Visitor&& visit) {
+        unsigned head = *cq_head_;
+        const unsigned tail = std::atomic_ref<unsigned>(*cq_tail_).load(std::memory_order_acquire);
+        while (head != tail) {
+            const io_uring_cqe& cqe = cqes_[head & cq_mask_];
+            visit(cqe.user_data, cqe.res);
+            ++head;
+        }
+        std::atomic_ref<unsigned>(*cq_head_).store(head, std::memory_order_release);
+    }
+
+private:
+    int ring_fd_ = -1;
+
+    void* sq_map_ = nullptr;
+    void* cq_map_ = nullptr;
+    std::size_t sq_map_size_ = 0;
+    std::size_t cq_map_size_ = 0;
+    std::size_t sqes_size_ = 0;
+
+    unsigned* sq_head_ = nullptr;
+    unsigned* sq_tail_ = nullptr;
+    unsigned* sq_array_ = nullptr;
+    unsigned sq_mask_ = 0;
+    unsigned sq_entries_ = 0;
+    io_uring_sqe* sqes_ = nullptr;
+
+    unsigned* cq_head_ = nullptr;
+    unsigned* cq_tail_ = nullptr;
+    unsigned cq_mask_ = 0;
+    io_uring_cqe* cqes_ = nullptr;
+};
+#endif
+
+} // namespace
+
+/**
+ * @brief Implementation details for io_adapter
+ */
+class io_adapter::impl {
+public:
+    explicit impl(const io_config& config)
+        : config_(config) {
+    }
+
+    ~impl() {
+        if (initialized_) {
+            shutdown();
+        }
+    }
+
+    common::VoidResult initialize() {
+        if (initialized_) {
+            return common::ok();
+        }
+
+        stopping_ = false;
+        backend_ = io_backend::threads;
+
+#if INTEGRATED_HAS_IO_URING
+        if (config_.enable_io_uring) {
+            const unsigned depth = static_cast<unsigned>(std::clamp<std::size_t>(config_.queue_depth, 1, 4096));
+            auto ring = std::make_unique<uring>();
+            if (ring->open(depth)) {
+                ring_ = std::move(ring);
+                backend_ = io_backend::io_uring;
+                reaper_ = std::thread([this] { reap_completions(); });
+            }
+        }
+#endif
+
+        if (backend_ == io_backend::threads) {
+            try {
+                const std::size_t count = std::max<std::size_t>(config_.fallback_threads, 1);
+                for (std::size_t i = 0; i < count; ++i) {
+                    io_threads_.emplace_back([this] { run_fallback(); });
+                }
+            } catch (const std::exception& e) {
+                stop_fallback();
+                return common::VoidResult::err(
+                    common::error_codes::INTERNAL_ERROR,
+                    std::string("I/O adapter initialization failed: ") + e.what()
+                );
+            }
+        }
+
+        initialized_ = true;
+        return common::ok();
+    }
+
+    common::VoidResult shutdown() {
+        if (!initialized_) {
+            return common::ok();
+        }
+
+        {
+            std::unique_lock<std::mutex> lock(submit_mutex_);
+            stopping_ = true;
+        }
+
+#if INTEGRATED_HAS_IO_URING
+        if (ring_) {
+            capacity_cv_.notify_all();
+
+            // Wake the reaper; it exits once every in-flight request completed
+            {
+                std::unique_lock<std::mutex> lock(submit_mutex_);
+                while (!ring_->submit(nullptr)) {
+                    lock.unlock();
+                    std::this_thread::yield();
+                    lock.lock();
+                }
+            }
+            if (reaper_.joinable()) {
+                reaper_.join();
+            }
+            ring_.reset();
+        }
+#endif
+
+        stop_fallback();
+
+        initialized_ = false;
+        return common::ok();
+    }
+
+    bool is_initialized() const {
+        return initialized_;
+    }
+
+    io_backend backend() const {
+        return backend_;
+    }
+
+    std::future<std::size_t> read(int fd, std::span<std::byte> buffer, std::uint64_t offset) {
+        auto request = make_request(io_opcode::read, fd, buffer.data(), buffer.size(), offset);
+        auto future = request->transferred.get_future();
+        submit(std::move(request));
+        return future;
+    }
+
+    std::future<std::size_t> write(int fd, std::span<const std::byte> buffer, std::uint64_t offset) {
+        // The kernel only reads from the buffer for writes
+        auto request = make_request(io_opcode::write, fd, const_cast<std::byte*>(buffer.data()),
+                                    buffer.size(), offset);
+        auto future = request->transferred.get_future();
+        submit(std::move(request));
+        return future;
+    }
+
+    std::future<void> fsync(int fd) {
+        auto request = make_request(io_opcode::fsync, fd, nullptr, 0, 0);
+        auto future = request->flushed.get_future();
+        submit(std::move(request));
+        return future;
+    }
+
+    std::size_t in_flight() const {
+        return in_flight_.load();
+    }
+
+private:
+    static std::unique_ptr<io_request> make_request(io_opcode opcode, int fd, void* data,
+                                                    std::size_t length, std::uint64_t offset) {
+        auto request = std::make_unique<io_request>();
+        request->opcode = opcode;
+        request->fd = fd;
+        request->data = data;
+        request->length = length;
+        request->offset = offset;
+        return request;
+    }
+
+    void submit(std::unique_ptr<io_request> request) {
+        std::unique_lock<std::mutex> lock(submit_mutex_);
+        if (!initialized_ || stopping_) {
+            lock.unlock();
+            complete(*request, -ECANCELED);
+            return;
+        }
+
+#if INTEGRATED_HAS_IO_URING
+        if (ring_) {
+            // Bound in-flight requests by the ring size so completions cannot overflow
+            capacity_cv_.wait(lock, [this] {
+                return stopping_ || in_flight_.load() < ring_->capacity();
+            });
+            if (stopping_) {
+                lock.unlock();
+                complete(*request, -ECANCELED);
+                return;
+            }
+            in_flight_.fetch_add(1);
+            io_request* raw = request.release();
+            while (!ring_->submit(raw)) {
+                lock.unlock();
+                std::this_thread::yield();
+                lock.lock();
+            }
+            return;
+        }
+#endif
+
+        in_flight_.fetch_add(1);
+        fallback_queue_.push_back(std::move(request));
+        lock.unlock();
+        fallback_cv_.notify_one();
+    }
+
+#if INTEGRATED_HAS_IO_URING
+    void reap_completions() {
+        std::vector<std::pair<io_request*, std::int32_t>> completed;
+        while (true) {
+            ring_->wait();
+
+            completed.clear();
+            ring_->drain([&completed](std::uint64_t user_data, std::int32_t result) {
+                if (user_data != 0) {  // 0 is the shutdown wake-up
+                    completed.emplace_back(reinterpret_cast<io_request*>(user_data), result);
+                }
+            });
+
+            bool exit = false;
+            {
+                // Pairs with the submitter's critical section, so the request is
+                // fully published before it is touched here
+                std::lock_guard<std::mutex> lock(submit_mutex_);
+                in_flight_.fetch_sub(completed.size());
+                exit = stopping_ && in_flight_.load() == 0;
+            }
+            capacity_cv_.notify_all();
+
+            for (auto& [raw, result] : completed) {
+                std::unique_ptr<io_request> request(raw);
+                complete(*request, result);
+            }
+
+            if (exit) {
+                return;
+            }
+        }
+    }
+#endif
+
+    void run_fallback() {
+        while (true) {
+            std::unique_ptr<io_request> request;
+            {
+                std::unique_lock<std::mutex> lock(submit_mutex_);
+                fallback_cv_.wait(lock, [this] {
+                    return stopping_ || !fallback_queue_.empty();
+                });
+                if (fallback_queue_.empty()) {
+                    return;  // Stopping and drained
+                }
+                request = std::move(fallback_queue_.front());
+                fallback_queue_.pop_front();
+            }
+
+            complete(*request, run_blocking(*request));
+            in_flight_.fetch_sub(1);
+        }
+    }
+
+    void stop_fallback() {
+        {
+            std::unique_lock<std::mutex> lock(submit_mutex_);
+            stopping_ = true;
+        }
+        fallback_cv_.notify_all();
+
+        for (auto& thread : io_threads_) {
+            if (thread.joinable()) {
+                thread.join();
+            }
+        }
+        io_threads_.clear();
+    }
+
+    io_config config_;
+    std::atomic<bool> initialized_{false};
+    io_backend backend_ = io_backend::threads;
+
+    // Guards submission, stopping_ and the fallback queue
+    std::mutex submit_mutex_;
+    bool stopping_ = false;
+    std::atomic<std::size_t> in_flight_{0};
+
+#if INTEGRATED_HAS_IO_URING
+    std::unique_ptr<uring> ring_;
+    std::thread reaper_;
+    std::condition_variable capacity_cv_;
+#endif
+
+    std::deque<std::unique_ptr<io_request>> fallback_queue_;
+    std::condition_variable fallback_cv_;
+    std::vector<std::thread> io_threads_;
+};
+
+// io_adapter implementation
+
+io_adapter::io_adapter(const io_config& config)
+    : pimpl_(std::make_unique<impl>(config)) {
+}
+
+io_adapter::~io_adapter() = default;
+
+io_adapter::io_adapter(io_adapter&&) noexcept = default;
+io_adapter& io_adapter::operator=(io_adapter&&) noexcept = default;
+
+common::VoidResult io_adapter::initialize() {
+    return pimpl_->initialize();
+}
+
+common::VoidResult io_adapter::shutdown() {
+    return pimpl_->shutdown();
+}
+
+bool io_adapter::is_initialized() const {
+    return pimpl_->is_initialized();
+}
+
+io_backend io_adapter::backend() const {
+    return pimpl_->backend();
+}
+
+std::future<std::size_t> io_adapter::read(int fd, std::span<std::byte> buffer, std::uint64_t offset) {
+    return pimpl_->read(fd, buffer, offset);
+}
+
+std::future<std::size_t> io_adapter::write(int fd, std::span<const std::byte> buffer, std::uint64_t offset) {
+    return pimpl_->write(fd, buffer, offset);
+}
+
+std::future<void> io_adapter::fsync(int fd) {
+    return pimpl_->fsync(fd);
+}
+
+std::size_t io_adapter::in_flight() const {
+    return pimpl_->in_flight();
+}
+
+} // namespace kcenon::integrated::adapters
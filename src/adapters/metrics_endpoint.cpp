@@ -0,0 +1,596 @@
+// BSD 3-Clause License
+// Copyright (c) 2025, kcenon
+// See the LICENSE file in the project root for full license information.
+
+#include <kcenon/integrated/adapters/metrics_endpoint.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cctype>
+#include <cerrno>
+#include <charconv>
+#include <chrono>
+#include <cstring>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#if defined(__linux__) && defined(ENABLE_WEB_DASHBOARD)
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#define INTEGRATED_HAS_METRICS_ENDPOINT 1
+#else
+#define INTEGRATED_HAS_METRICS_ENDPOINT 0
+#endif
+
+namespace kcenon::integrated::adapters {
+
+#if INTEGRATED_HAS_METRICS_ENDPOINT
+
+namespace {
+
+// Requests are header-only; anything longer is refused with 431
+constexpr std::size_t max_request_size = 8192;
+constexpr std::size_t read_chunk_size = 4096;
+constexpr int max_events = 64;
+
+struct http_request {
+    std::string_view method;
+    std::string_view path;
+    bool keep_alive = true;
+    bool wants_openmetrics = false;
+    bool has_body = false;
+};
+
+enum class parse_result { complete, incomplete, malformed };
+
+bool iequals(std::string_view a, std::string_view b) {
+    return a.size() == b.size() &&
+           std::equal(a.begin(), a.end(), b.begin(), [](char x, char y) {
+               return std::tolower(static_cast<unsigned char>(x)) ==
+                      std::tolower(static_cast<unsigned char>(y));
+           });
+}
+
+bool icontains(std::string_view haystack, std::string_view needle) {
+    if (needle.size() > haystack.size()) {
+        return false;
+    }
+    for (std::size_t i = 0; i + needle.size() <= haystack.size(); ++i) {
+        if (iequals(haystack.substr(i, needle.size()), needle)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+std::string_view trim(std::string_view value) {
+    while (!value.empty() && (value.front() == ' ' || value.front() == '\t')) {
+        value.remove_prefix(1);
+    }
+    while (!value.empty() && (value.back() == ' ' || value.back() == '\t')) {
+        value.remove_suffix(1);
+    }
+    return value;
+}
+
+// Parses the head of the first request in input; length receives its size
+parse_result parse_request(std::string_view input, http_request& request, std::size_t& length) {
+    const auto end = input.find("\r\n\r\n");
+    if (end == std::string_view::npos) {
+        return parse_result::incomplete;
+    }
+    length = end + 4;
+
+    std::string_view head = input.substr(0, end);
+    auto next_line = [&head]() {
+        const auto eol = head.find("\r\n");
+        std::string_view line = head.substr(0, eol);
+        head.remove_prefix(eol == std::string_view::npos ? head.size() : eol + 2);
+        return line;
+    };
+
+    // Request line: METHOD SP target SP version
+    std::string_view line = next_line();
+    const auto first_space = line.find(' ');
+    const auto last_space = line.rfind(' ');
+    if (first_space == std::string_view::npos || first_space == last_space) {
+        return parse_result::malformed;
+    }
+    request.method = line.substr(0, first_space);
+    std::string_view target = line.substr(first_space + 1, last_space - first_space - 1);
+    const std::string_view version = line.substr(last_space + 1);
+    if (version == "HTTP/1.1") {
+        request.keep_alive = true;
+    } else if (version == "HTTP/1.0") {
+        request.keep_alive = false;
+    } else {
+        return parse_result::malformed;
+    }
+    request.path = target.substr(0, target.find('?'));
+
+    while (!head.empty()) {
+        line = next_line();
+        const auto colon = line.find(':');
+        if (colon == std::string_view::npos) {
+            return parse_result::malformed;
+        }
+        const std::string_view name = line.substr(0, colon);
+        const std::string_view value = trim(line.substr(colon + 1));
+
+        if (iequals(name, "connection")) {
+            if (icontains(value, "close")) {
+                request.keep_alive = false;
+            } else if (icontains(value, "keep-alive")) {
+                request.keep_alive = true;
+            }
+        } else if (iequals(name, "accept")) {
+            request.wants_openmetrics = icontains(value, "application/openmetrics-text");
+        } else if (iequals(name, "transfer-encoding") ||
+                   (iequals(name, "content-length") && value != "0")) {
+            request.has_body = true;
+        }
+    }
+    return parse_result::complete;
+}
+
+const char* reason_phrase(int status) {
+    switch (status) {
+        case 200: return "OK";
+        case 400: return "Bad Request";
+        case 404: return "Not Found";
+        case 405: return "Method Not Allowed";
+        case 431: return "Request Header Fields Too Large";
+        case 500: return "Internal Server Error";
+        case 503: return "Service Unavailable";
+    }
+    return "Unknown";
+}
+
+} // namespace
+
+class metrics_endpoint::impl {
+public:
+    impl(const metrics_endpoint_config& config, metrics_endpoint_handlers handlers)
+        : config_(config)
+        , handlers_(std::move(handlers))
+        , json_path_(config.metrics_path + ".json") {
+    }
+
+    ~impl() {
+        shutdown();
+    }
+
+    common::VoidResult initialize() {
+        if (running_) {
+            return common::ok();
+        }
+
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_port = htons(config_.port);
+        if (::inet_pton(AF_INET, config_.bind_address.c_str(), &address.sin_addr) != 1) {
+            return common::VoidResult::err(
+                common::error_codes::INVALID_ARGUMENT,
+                "Invalid metrics endpoint bind address: " + config_.bind_address
+            );
+        }
+
+        listen_fd_ = ::socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (listen_fd_ < 0) {
+            return fail("socket");
+        }
+
+        const int enable = 1;
+        ::setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(enable));
+        if (::bind(listen_fd_, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+            return fail("bind " + config_.bind_address + ":" + std::to_string(config_.port));
+        }
+        if (::listen(listen_fd_, SOMAXCONN) != 0) {
+            return fail("listen");
+        }
+
+        socklen_t length = sizeof(address);
+        ::getsockname(listen_fd_, reinterpret_cast<sockaddr*>(&address), &length);
+        port_ = ntohs(address.sin_port);
+
+        epoll_fd_ = ::epoll_create1(EPOLL_CLOEXEC);
+        wake_fd_ = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (epoll_fd_ < 0 || wake_fd_ < 0 ||
+            !watch(listen_fd_, EPOLLIN, EPOLL_CTL_ADD) || !watch(wake_fd_, EPOLLIN, EPOLL_CTL_ADD)) {
+            return fail("epoll");
+        }
+
+        running_ = true;
+        thread_ = std::thread([this] { run(); });
+        return common::ok();
+    }
+
+    common::VoidResult shutdown() {
+        if (thread_.joinable()) {
+            const std::uint64_t one = 1;
+            [[maybe_unused]] auto written = ::write(wake_fd_, &one, sizeof(one));
+            thread_.join();
+        }
+        running_ = false;
+
+        for (auto& [fd, connection] : connections_) {
+            ::close(fd);
+        }
+        connections_.clear();
+        close_descriptors();
+        return common::ok();
+    }
+
+    bool is_initialized() const { return running_; }
+    std::uint16_t port() const { return running_ ? port_ : 0; }
+    std::uint64_t requests_served() const { return requests_served_.load(std::memory_order_relaxed); }
+
+private:
+    struct connection {
+        std::string input;
+        std::string output;
+        std::size_t sent = 0;
+        bool close_after_write = false;
+        bool writing = false;  // registered for EPOLLOUT instead of EPOLLIN
+        std::chrono::steady_clock::time_point last_active;
+    };
+
+    common::VoidResult fail(const std::string& operation) {
+        const std::string message = "Metrics endpoint " + operation + " failed: " + std::strerror(errno);
+        close_descriptors();
+        return common::VoidResult::err(common::error_codes::INTERNAL_ERROR, message);
+    }
+
+    void close_descriptors() {
+        for (int* fd : {&listen_fd_, &epoll_fd_, &wake_fd_}) {
+            if (*fd >= 0) {
+                ::close(*fd);
+                *fd = -1;
+            }
+        }
+    }
+
+    bool watch(int fd, std::uint32_t events, int operation) {
+        epoll_event event{};
+        event.events = events;
+        event.data.fd = fd;
+        return ::epoll_ctl(epoll_fd_, operation, fd, &event) == 0;
+    }
+
+    void run() {
+        std::array<epoll_event, max_events> events{};
+        const auto sweep_interval = std::clamp<std::chrono::milliseconds>(
+            config_.idle_timeout / 2, std::chrono::milliseconds(10), std::chrono::milliseconds(1000));
+        auto last_sweep = std::chrono::steady_clock::now();
+
+        while (true) {
+            const int count = ::epoll_wait(epoll_fd_, events.data(), max_events,
+                                           static_cast<int>(sweep_interval.count()));
+            if (count < 0 && errno != EINTR) {
+                break;
+            }
+
+            const auto now = std::chrono::steady_clock::now();
+            for (int i = 0; i < count; ++i) {
+                const int fd = events[i].data.fd;
+                if (fd == wake_fd_) {
+                    return;
+                }
+                if (fd == listen_fd_) {
+                    accept_connections(now);
+                    continue;
+                }
+
+                auto it = connections_.find(fd);
+                if (it == connections_.end()) {
+                    continue;
+                }
+                connection& conn = *it->second;
+                conn.last_active = now;
+
+                bool open = true;
+                if (events[i].events & (EPOLLERR | EPOLLHUP)) {
+                    open = false;
+                } else if (events[i].events & EPOLLOUT) {
+                    // Answer requests that arrived while the previous response drained
+                    open = flush(fd, conn) && (conn.writing || serve(fd, conn));
+                } else if (events[i].events & EPOLLIN) {
+                    open = receive(fd, conn) && serve(fd, conn);
+                }
+                if (!open) {
+                    close_connection(fd);
+                }
+            }
+
+            if (now - last_sweep >= sweep_interval) {
+                last_sweep = now;
+                close_idle(now);
+            }
+        }
+    }
+
+    void accept_connections(std::chrono::steady_clock::time_point now) {
+        while (true) {
+            const int fd = ::accept4(listen_fd_, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+            if (fd < 0) {
+                return;  // EAGAIN, or a transient error such as EMFILE
+            }
+
+            if (connections_.size() >= config_.max_connections || !watch(fd, EPOLLIN, EPOLL_CTL_ADD)) {
+                ::close(fd);
+                continue;
+            }
+
+            const int enable = 1;
+            ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &enable, sizeof(enable));
+
+            // Reuse a closed connection's buffers when one is available
+            std::unique_ptr<connection> conn;
+            if (!spare_.empty()) {
+                conn = std::move(spare_.back());
+                spare_.pop_back();
+            } else {
+                conn = std::make_unique<connection>();
+            }
+            conn->last_active = now;
+            connections_.emplace(fd, std::move(conn));
+        }
+    }
+
+    void close_connection(int fd) {
+        auto it = connections_.find(fd);
+        if (it == connections_.end()) {
+            return;
+        }
+
+        ::epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, fd, nullptr);
+        ::close(fd);
+
+        auto conn = std::move(it->second);
+        connections_.erase(it);
+        if (spare_.size() < config_.max_connections) {
+            conn->input.clear();
+            conn->output.clear();
+            conn->sent = 0;
+            conn->close_after_write = false;
+            conn->writing = false;
+            spare_.push_back(std::move(conn));
+        }
+    }
+
+    void close_idle(std::chrono::steady_clock::time_point now) {
+        std::vector<int> idle;
+        for (const auto& [fd, conn] : connections_) {
+            if (now - conn->last_active >= config_.idle_timeout) {
+                idle.push_back(fd);
+            }
+        }
+        for (int fd : idle) {
+            close_connection(fd);
+        }
+    }
+
+    // Reads what the socket has; false when the peer is gone
+    bool receive(int fd, connection& conn) {
+        char chunk[read_chunk_size];
+        while (true) {
+            const ssize_t received = ::recv(fd, chunk, sizeof(chunk), 0);
+            if (received > 0) {
+                conn.input.append(chunk, static_cast<std::size_t>(received));
+                if (conn.input.size() > max_request_size * 4) {
+                    return true;  // Enough to answer; the rest waits in the socket
+                }
+                continue;
+            }
+            if (received == 0) {
+                return false;
+            }
+            return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+        }
+    }
+
+    // Answers every complete request in the input buffer, then writes.
+    // Returns false when the connection should be closed.
+    bool serve(int fd, connection& conn) {
+        std::size_t consumed = 0;
+        while (!conn.close_after_write) {
+            http_request request;
+            std::size_t length = 0;
+            const std::string_view pending = std::string_view(conn.input).substr(consumed);
+            const auto result = parse_request(pending, request, length);
+
+            if (result == parse_result::incomplete) {
+                if (pending.size() > max_request_size) {
+                    respond(conn, 431, false, "text/plain", "Request too large\n", false);
+                }
+                break;
+            }
+            if (result == parse_result::malformed || request.has_body) {
+                respond(conn, 400, false, "text/plain", "Bad request\n", false);
+                break;
+            }
+
+            handle(conn, request);
+            consumed += length;
+        }
+        conn.input.erase(0, consumed);
+
+        return flush(fd, conn);
+    }
+
+    void handle(connection& conn, const http_request& request) {
+        requests_served_.fetch_add(1, std::memory_order_relaxed);
+
+        const bool head = request.method == "HEAD";
+        if (!head && request.method != "GET") {
+            respond(conn, 405, request.keep_alive, "text/plain", "Method not allowed\n", false,
+                    "Allow: GET, HEAD\r\n");
+            return;
+        }
+
+        try {
+            if (request.path == config_.metrics_path && handlers_.write_metrics) {
+                const auto format = request.wants_openmetrics
+                    ? exposition_format::openmetrics
+                    : exposition_format::prometheus_text;
+                writer_.reset(format);
+                handlers_.write_metrics(writer_);
+                respond(conn, 200, request.keep_alive, prometheus_writer::content_type(format),
+                        writer_.finish(), head);
+            } else if (request.path == json_path_ && handlers_.metrics_json) {
+                respond(conn, 200, request.keep_alive, "application/json",
+                        handlers_.metrics_json(), head);
+            } else if (request.path == config_.health_path && handlers_.health) {
+                const health_response health = handlers_.health();
+                respond(conn, health.healthy ? 200 : 503, request.keep_alive, "application/json",
+                        health.body, head);
+            } else {
+                respond(conn, 404, request.keep_alive, "text/plain", "Not found\n", head);
+            }
+        } catch (const std::exception& e) {
+            respond(conn, 500, request.keep_alive, "text/plain", e.what(), head);
+        }
+    }
+
+    void respond(connection& conn, int status, bool keep_alive, std::string_view content_type,
+                 std::string_view body, bool head, std::string_view extra_headers = {}) {
+        std::array<char, 24> number{};
+
+        auto& out = conn.output;
+        out += "HTTP/1.1 ";
+        auto end = std::to_chars(number.data(), number.data() + number.size(), status).ptr;
+        out.append(number.data(), end);
+        out += ' ';
+        out += reason_phrase(status);
+        out += "\r\nContent-Type: ";
+        out += content_type;
+        out += "\r\nContent-Length: ";
+        end = std::to_chars(number.data(), number.data() + number.size(), body.size()).ptr;
+        out.append(number.data(), end);
+        out += keep_alive ? "\r\nConnection: keep-alive\r\n" : "\r\nConnection: close\r\n";
+        out += extra_headers;
+        out += "\r\n";
+        if (!head) {
+            out += body;
+        }
+
+        if (!keep_alive) {
+            conn.close_after_write = true;
+        }
+    }
+
+    // Sends buffered output; false when the connection should be closed
+    bool flush(int fd, connection& conn) {
+        while (conn.sent < conn.output.size()) {
+            const ssize_t sent = ::send(fd, conn.output.data() + conn.sent,
+                                        conn.output.size() - conn.sent, MSG_NOSIGNAL);
+            if (sent > 0) {
+                conn.sent += static_cast<std::size_t>(sent);
+                continue;
+            }
+            if (sent < 0 && errno == EINTR) {
+                continue;
+            }
+            if (sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+                // Stop reading until the client has taken this response
+                if (!conn.writing) {
+                    conn.writing = watch(fd, EPOLLOUT, EPOLL_CTL_MOD);
+                    return conn.writing;
+                }
+                return true;
+            }
+            return false;
+        }
+
+        conn.output.clear();
+        conn.sent = 0;
+        if (conn.close_after_write) {
+            return false;
+        }
+        if (conn.writing) {
+            conn.writing = false;
+            return watch(fd, EPOLLIN, EPOLL_CTL_MOD);
+        }
+        return true;
+    }
+
+    metrics_endpoint_config config_;
+    metrics_endpoint_handlers handlers_;
+    std::string json_path_;
+
+    int listen_fd_ = -1;
+    int epoll_fd_ = -1;
+    int wake_fd_ = -1;
+    std::uint16_t port_ = 0;
+    std::atomic<bool> running_{false};
+    std::atomic<std::uint64_t> requests_served_{0};
+    std::thread thread_;
+
+    // Owned by the server thread
+    std::unordered_map<int, std::unique_ptr<connection>> connections_;
+    std::vector<std::unique_ptr<connection>> spare_;
+    prometheus_writer writer_;
+};
+
+#else
+
+class metrics_endpoint::impl {
+public:
+    impl(const metrics_endpoint_config&, metrics_endpoint_handlers) {}
+
+    common::VoidResult initialize() {
+        return common::VoidResult::err(
+            common::error_codes::INTERNAL_ERROR,
+            "Metrics endpoint requires Linux and a build with ENABLE_WEB_DASHBOARD"
+        );
+    }
+
+    common::VoidResult shutdown() { return common::ok(); }
+    bool is_initialized() const { return false; }
+    std::uint16_t port() const { return 0; }
+    std::uint64_t requests_served() const { return 0; }
+};
+
+#endif
+
+// metrics_endpoint implementation
+
+metrics_endpoint::metrics_endpoint(const metrics_endpoint_config& config, metrics_endpoint_handlers handlers)
+    : pimpl_(std::make_unique<impl>(config, std::move(handlers))) {
+}
+
+metrics_endpoint::~metrics_endpoint() = default;
+
+metrics_endpoint::metrics_endpoint(metrics_endpoint&&) noexcept = default;
+metrics_endpoint& metrics_endpoint::operator=(metrics_endpoint&&) noexcept = default;
+
+common::VoidResult metrics_endpoint::initialize() {
+    return pimpl_->initialize();
+}
+
+common::VoidResult metrics_endpoint::shutdown() {
+    return pimpl_->shutdown();
+}
+
+bool metrics_endpoint::is_initialized() const {
+    return pimpl_->is_initialized();
+}
+
+std::uint16_t metrics_endpoint::port() const {
+    return pimpl_->port();
+}
+
+std::uint64_t metrics_endpoint::requests_served() const {
+    return pimpl_->requests_served();
+}
+
+} // namespace kcenon::integrated::adapters
@@ -3,6 +3,8 @@
 // See the LICENSE file in the project root for full license information.
 
 #include <kcenon/integrated/adapters/thread_adapter.h>
+#include <kcenon/integrated/core/task_allocator.h>
+#include <kcenon/integrated/core/worker_activity.h>
 
 #if EXTERNAL_SYSTEMS_AVAILABLE
 // Use external thread_system's thread_pool
@@ -31,10 +33,15 @@
 #endif
 #else
 // Fallback to built-in implementation
+#include <algorithm>
+#include <atomic>
+#include <deque>
 #include <thread>
 #include <queue>
+#include <vector>
 #include <mutex>
 #include <condition_variable>
+#include <kcenon/integrated/core/lock_profiler.h>
 #endif
 
 namespace kcenon::integrated::adapters {
@@ -63,6 +70,28 @@ inline kcenon::thread::job_types map_priority_to_job_type(int priority) {
         return kcenon::thread::job_types::Background;
     }
 }
+#else
+namespace {
+
+struct pool_task {
+    std::function<void()> fn;
+    bool tracked = true;  // Counted by wait_for_completion()
+};
+
+// Identifies the built-in pool worker running on the current thread, if any
+struct worker_binding {
+    const void* owner = nullptr;
+    std::deque<pool_task>* batch = nullptr;
+    worker_clock* activity = nullptr;
+    std::size_t help_depth = 0;
+};
+
+thread_local worker_binding current_worker;
+
+// Nested run_pending_task() calls allowed per worker before waits must block
+constexpr std::size_t max_help_depth = 64;
+
+} // namespace
 #endif
 
 /**
@@ -81,6 +110,12 @@ public:
         , shutdown_(false)
 #endif
     {
+#if !EXTERNAL_SYSTEMS_AVAILABLE
+        if (config_.enable_lock_profiling) {
+            lock_profiler_ = std::make_unique<lock_profiler>();
+            queue_lock_profile_ = lock_profiler_->add("queue");
+        }
+#endif
     }
 
     ~impl() {
@@ -186,9 +221,14 @@ public:
                 }
             }
 
-            workers_.reserve(thread_count);
+            worker_count_ = thread_count;
+            max_workers_ = thread_count + compensator_capacity(thread_count);
+            compensation_closed_ = false;
+            worker_clocks_ = std::make_unique<worker_clock[]>(max_workers_);
+            started_workers_.store(thread_count);
+            workers_.reserve(max_workers_);
             for (std::size_t i = 0; i < thread_count; ++i) {
-                workers_.emplace_back([this] { worker_thread(); });
+                workers_.emplace_back([this, i] { worker_thread(i, false); });
             }
 
             initialized_ = true;
@@ -232,10 +272,16 @@ public:
 #else
         // Built-in implementation shutdown
         {
-            std::unique_lock<std::mutex> lock(queue_mutex_);
+            profiled_lock lock(queue_mutex_, queue_lock_profile_);
             shutdown_ = true;
         }
         condition_.notify_all();
+        {
+            // Also stops further compensator spawns, so workers_ is stable below
+            std::lock_guard<std::mutex> lock(compensation_mutex_);
+            compensation_closed_ = true;
+            spare_cv_.notify_all();
+        }
 
         for (auto& worker : workers_) {
             if (worker.joinable()) {
@@ -253,7 +299,7 @@ public:
         return initialized_;
     }
 
-    common::VoidResult execute(std::function<void()> task) {
+    common::VoidResult execute(std::function<void()> task, bool tracked = true) {
         if (!initialized_) {
             return common::VoidResult::err(
                 common::error_codes::INVALID_ARGUMENT,
@@ -262,7 +308,8 @@ public:
         }
 
 #if EXTERNAL_SYSTEMS_AVAILABLE
-        // Use thread_system's simplified submit_task API
+        // Use thread_system's simplified submit_task API; it counts every task
+        (void)tracked;
         bool success = thread_pool_->submit_task(std::move(task));
         if (!success) {
             return common::VoidResult::err(
@@ -274,7 +321,7 @@ public:
 #else
         // Built-in implementation
         {
-            std::unique_lock<std::mutex> lock(queue_mutex_);
+            profiled_lock lock(queue_mutex_, queue_lock_profile_);
 
             if (shutdown_) {
                 return common::VoidResult::err(
@@ -290,7 +337,10 @@ public:
                 );
             }
 
-            task_queue_.push(std::move(task));
+            task_queue_.push({std::move(task), tracked});
+            if (!tracked) {
+                ++untracked_queued_;
+            }
         }
         condition_.notify_one();
 
@@ -360,7 +410,8 @@ public:
 #if EXTERNAL_SYSTEMS_AVAILABLE
         return thread_pool_ ? thread_pool_->get_thread_count() : 0;
 #else
-        return workers_.size();
+        // Compensating workers are excluded: they only stand in for blocked ones
+        return initialized_ ? worker_count_ : 0;
 #endif
     }
 
@@ -368,7 +419,7 @@ public:
 #if EXTERNAL_SYSTEMS_AVAILABLE
         return thread_pool_ ? thread_pool_->get_pending_task_count() : 0;
 #else
-        std::unique_lock<std::mutex> lock(queue_mutex_);
+        profiled_lock lock(queue_mutex_, queue_lock_profile_);
         return task_queue_.size();
 #endif
     }
@@ -381,10 +432,8 @@ public:
             std::this_thread::sleep_for(std::chrono::milliseconds(10));
         }
 #else
-        std::unique_lock<std::mutex> lock(queue_mutex_);
-        completion_cv_.wait(lock, [this] {
-            return task_queue_.empty() && active_tasks_ == 0;
-        });
+        profiled_lock lock(queue_mutex_, queue_lock_profile_);
+        completion_cv_.wait(lock.for_wait(), [this] { return drained(); });
 #endif
     }
 
@@ -401,10 +450,8 @@ public:
         }
         return true;
 #else
-        std::unique_lock<std::mutex> lock(queue_mutex_);
-        return completion_cv_.wait_for(lock, timeout, [this] {
-            return task_queue_.empty() && active_tasks_ == 0;
-        });
+        profiled_lock lock(queue_mutex_, queue_lock_profile_);
+        return completion_cv_.wait_for(lock.for_wait(), timeout, [this] { return drained(); });
 #endif
     }
 
@@ -466,43 +513,275 @@ public:
 #endif
     }
 
+    bool begin_blocking() {
+#if EXTERNAL_SYSTEMS_AVAILABLE
+        // thread_system sizes its own pool; blocking sections run uncompensated
+        return false;
+#else
+        if (current_worker.owner != this) {
+            return false;
+        }
+
+        std::lock_guard<std::mutex> lock(compensation_mutex_);
+        const std::size_t blocked = blocked_workers_.fetch_add(1) + 1;
+        if (compensation_closed_ || running_compensators_.load() >= blocked) {
+            return true;
+        }
+
+        if (parked_compensators_ > 0) {
+            --parked_compensators_;
+            ++spare_wakeups_;
+            running_compensators_.fetch_add(1);
+            spare_cv_.notify_one();
+        } else if (workers_.size() < max_workers_) {
+            running_compensators_.fetch_add(1);
+            workers_.emplace_back([this, index = workers_.size()] { worker_thread(index, true); });
+            started_workers_.store(workers_.size());
+        }
+        return true;
+#endif
+    }
+
+    void end_blocking() {
+#if !EXTERNAL_SYSTEMS_AVAILABLE
+        blocked_workers_.fetch_sub(1);
+#endif
+    }
+
+    std::size_t blocked_worker_count() const {
+#if EXTERNAL_SYSTEMS_AVAILABLE
+        return 0;
+#else
+        return blocked_workers_.load();
+#endif
+    }
+
+    std::size_t compensating_worker_count() const {
+#if EXTERNAL_SYSTEMS_AVAILABLE
+        return 0;
+#else
+        return running_compensators_.load();
+#endif
+    }
+
+    const lock_profiler* lock_profiling() const {
+#if EXTERNAL_SYSTEMS_AVAILABLE
+        // thread_system's queues are not instrumented
+        return nullptr;
+#else
+        return lock_profiler_.get();
+#endif
+    }
+
+    void read_workers(std::vector<worker_utilization>& out, std::chrono::steady_clock::time_point now) const {
+        out.clear();
+#if !EXTERNAL_SYSTEMS_AVAILABLE
+        // Started workers only; compensator slots that never ran are left out
+        const std::size_t started = initialized_ ? started_workers_.load() : 0;
+        out.reserve(started);
+        for (std::size_t i = 0; i < started; ++i) {
+            auto entry = worker_clocks_[i].read(now);
+            entry.worker = i;
+            out.push_back(entry);
+        }
+#endif
+    }
+
+    bool is_worker_thread() const {
+#if EXTERNAL_SYSTEMS_AVAILABLE
+        // thread_system does not expose the identity of its workers
+        return false;
+#else
+        return current_worker.owner == this;
+#endif
+    }
+
+    bool run_pending_task() {
+#if EXTERNAL_SYSTEMS_AVAILABLE
+        return false;
+#else
+        if (current_worker.owner != this || current_worker.help_depth >= max_help_depth) {
+            return false;
+        }
+
+        // The worker's own batch first: it is invisible to every other thread,
+        // and its tracked tasks are retired with the rest of the batch
+        pool_task task;
+        bool retire = false;
+        if (!current_worker.batch->empty()) {
+            task = std::move(current_worker.batch->front());
+            current_worker.batch->pop_front();
+        } else {
+            profiled_lock lock(queue_mutex_, queue_lock_profile_);
+            if (task_queue_.empty()) {
+                return false;
+            }
+            task = take_front();
+            if (task.tracked) {
+                ++active_tasks_;
+                retire = true;
+            }
+        }
+
+        ++current_worker.help_depth;
+        try {
+            task.fn();
+        } catch (...) {
+            // Swallow exceptions to match worker behavior
+        }
+        --current_worker.help_depth;
+
+        if (retire) {
+            profiled_lock lock(queue_mutex_, queue_lock_profile_);
+            --active_tasks_;
+            if (drained()) {
+                completion_cv_.notify_all();
+            }
+        }
+        return true;
+#endif
+    }
+
 private:
 #if !EXTERNAL_SYSTEMS_AVAILABLE
-    void worker_thread() {
-        while (true) {
-            std::function<void()> task;
+    void worker_thread(std::size_t index, bool compensator) {
+        // Tasks left in the batch stay reachable by run_pending_task(), so a task
+        // waiting on a later task of its own batch can still make progress
+        std::deque<pool_task> batch;
+        std::size_t finished = 0;  // Tracked tasks in the batch
+        worker_clock& activity = worker_clocks_[index];
+        activity.start(worker_activity::spinning, std::chrono::steady_clock::now());
+        current_worker = {this, &batch, &activity, 0};
+        if (config_.on_worker_start) {
+            config_.on_worker_start(index);
+        }
 
+        while (true) {
             {
-                std::unique_lock<std::mutex> lock(queue_mutex_);
-                condition_.wait(lock, [this] {
-                    return shutdown_ || !task_queue_.empty();
-                });
+                profiled_lock lock(queue_mutex_, queue_lock_profile_);
+
+                // Retire the previous batch under the same lock used to take the next one
+                if (finished > 0) {
+                    active_tasks_ -= finished;
+                    finished = 0;
+                    if (drained()) {
+                        completion_cv_.notify_all();
+                    }
+                }
+
+                if (task_queue_.empty()) {
+                    // Return cross-thread frees before sleeping so their owners can reuse them
+                    detail::pool_flush_thread();
+                    activity.enter(worker_activity::idle, std::chrono::steady_clock::now());
+                    condition_.wait(lock.for_wait(), [this] {
+                        return shutdown_ || !task_queue_.empty();
+                    });
+                    activity.enter(worker_activity::spinning, std::chrono::steady_clock::now());
+                }
 
                 if (shutdown_ && task_queue_.empty()) {
+                    current_worker = {};
                     return;
                 }
 
-                if (!task_queue_.empty()) {
-                    task = std::move(task_queue_.front());
-                    task_queue_.pop();
-                    ++active_tasks_;
+                const std::size_t count = batch_share();
+                for (std::size_t i = 0; i < count && !task_queue_.empty(); ++i) {
+                    batch.push_back(take_front());
+                    finished += batch.back().tracked ? 1 : 0;
                 }
+                active_tasks_ += finished;
             }
 
-            if (task) {
+            // Tasks run by run_pending_task() from inside these count towards
+            // this busy time, not on top of it
+            activity.enter(worker_activity::busy, std::chrono::steady_clock::now());
+            while (!batch.empty()) {
+                auto task = std::move(batch.front().fn);
+                batch.pop_front();
                 try {
                     task();
                 } catch (...) {
                     // Swallow exceptions to prevent worker thread termination
                 }
+            }
+            activity.enter(worker_activity::spinning, std::chrono::steady_clock::now());
 
-                {
-                    std::unique_lock<std::mutex> lock(queue_mutex_);
-                    --active_tasks_;
-                }
+            if (compensator && !park_if_surplus(finished)) {
+                current_worker = {};
+                return;
+            }
+        }
+    }
+
+    // Extra workers allowed beyond thread_count: up to max_threads when it is
+    // set, otherwise as many again as the base pool
+    std::size_t compensator_capacity(std::size_t thread_count) const {
+        if (config_.max_threads == 0) {
+            return thread_count;
+        }
+        return config_.max_threads > thread_count ? config_.max_threads - thread_count : 0;
+    }
+
+    // Parks a compensating worker once the blocked workers it stood in for have
+    // resumed. Retires its finished batch first so completion waits are not held
+    // up by a parked thread. Returns false when the pool is shutting down.
+    bool park_if_surplus(std::size_t& finished) {
+        if (running_compensators_.load() <= blocked_workers_.load()) {
+            return true;
+        }
+
+        std::unique_lock<std::mutex> lock(compensation_mutex_);
+        if (running_compensators_.load() <= blocked_workers_.load()) {
+            return true;
+        }
+
+        if (finished > 0) {
+            profiled_lock queue_lock(queue_mutex_, queue_lock_profile_);
+            active_tasks_ -= finished;
+            finished = 0;
+            if (drained()) {
                 completion_cv_.notify_all();
             }
         }
+
+        running_compensators_.fetch_sub(1);
+        ++parked_compensators_;
+        detail::pool_flush_thread();
+        current_worker.activity->enter(worker_activity::parked, std::chrono::steady_clock::now());
+        spare_cv_.wait(lock, [this] { return compensation_closed_ || spare_wakeups_ > 0; });
+        current_worker.activity->enter(worker_activity::spinning, std::chrono::steady_clock::now());
+        if (compensation_closed_) {
+            return false;
+        }
+        --spare_wakeups_;
+        return true;
+    }
+
+    // Requires queue_mutex_. Nothing tracked is queued or running; untracked
+    // tasks such as health probes may be.
+    bool drained() const {
+        return task_queue_.size() == untracked_queued_ && active_tasks_ == 0;
+    }
+
+    // Requires queue_mutex_ and a non-empty queue
+    pool_task take_front() {
+        pool_task task = std::move(task_queue_.front());
+        task_queue_.pop();
+        if (!task.tracked) {
+            --untracked_queued_;
+        }
+        return task;
+    }
+
+    // Requires queue_mutex_. Takes at most an even share of the backlog so a
+    // single worker cannot hoard tasks while its peers sit idle.
+    std::size_t batch_share() const {
+        if (!config_.enable_batch_processing || config_.batch_size <= 1) {
+            return 1;
+        }
+
+        const std::size_t fair_share = task_queue_.size() / worker_count_;
+        return std::clamp<std::size_t>(fair_share, 1, config_.batch_size);
     }
 #endif
 
@@ -527,10 +806,26 @@ private:
     // Built-in implementation
     bool shutdown_;
     std::vector<std::thread> workers_;
-    std::queue<std::function<void()>> task_queue_;
+    std::size_t worker_count_ = 1;
+    std::size_t max_workers_ = 1;  // worker_count_ plus compensator slots
+    std::unique_ptr<worker_clock[]> worker_clocks_;  // One per slot, indexed like workers_
+    std::atomic<std::size_t> started_workers_{0};    // worker_clocks_ slots in use
+
+    // Managed blocking: compensating workers keep worker_count_ runnable
+    std::mutex compensation_mutex_;
+    std::condition_variable spare_cv_;
+    std::atomic<std::size_t> blocked_workers_{0};
+    std::atomic<std::size_t> running_compensators_{0};
+    std::size_t parked_compensators_ = 0;  // guarded by compensation_mutex_
+    std::size_t spare_wakeups_ = 0;        // guarded by compensation_mutex_
+    bool compensation_closed_ = false;     // guarded by compensation_mutex_
+    std::queue<pool_task> task_queue_;
+    std::size_t untracked_queued_ = 0;  // Queued tasks that completion waits ignore
     mutable std::mutex queue_mutex_;
     std::condition_variable condition_;
     std::condition_variable completion_cv_;
+    std::unique_ptr<lock_profiler> lock_profiler_;  // null unless lock profiling is enabled
+    lock_profile* queue_lock_profile_ = nullptr;
     std::size_t active_tasks_ = 0;
 #endif
 };
@@ -562,6 +857,43 @@ common::VoidResult thread_adapter::execute(std::function<void()> task) {
     return pimpl_->execute(std::move(task));
 }
 
+common::VoidResult thread_adapter::execute_untracked(std::function<void()> task) {
+    return pimpl_->execute(std::move(task), false);
+}
+
+bool thread_adapter::begin_blocking() {
+    return pimpl_->begin_blocking();
+}
+
+void thread_adapter::end_blocking() {
+    pimpl_->end_blocking();
+}
+
+std::size_t thread_adapter::blocked_worker_count() const {
+    return pimpl_->blocked_worker_count();
+}
+
+std::size_t thread_adapter::compensating_worker_count() const {
+    return pimpl_->compensating_worker_count();
+}
+
+const lock_profiler* thread_adapter::lock_profiling() const {
+    return pimpl_->lock_profiling();
+}
+
+void thread_adapter::read_workers(std::vector<worker_utilization>& out,
+                                  std::chrono::steady_clock::time_point now) const {
+    pimpl_->read_workers(out, now);
+}
+
+bool thread_adapter::is_worker_thread() const {
+    return pimpl_->is_worker_thread();
+}
+
+bool thread_adapter::run_pending_task() {
+    return pimpl_->run_pending_task();
+}
+
 common::VoidResult thread_adapter::execute_with_priority(int priority, std::function<void()> task) {
     return pimpl_->execute_with_priority(priority, std::move(task));
 }
@@ -0,0 +1,484 @@
+// BSD 3-Clause License
+// Copyright (c) 2025, kcenon
+// See the LICENSE file in the project root for full license information.
+
+#include <kcenon/integrated/core/alert_rule_engine.h>
+
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <fstream>
+#include <sstream>
+#include <utility>
+
+#include <nlohmann/json.hpp>
+
+namespace kcenon::integrated {
+
+namespace {
+
+bool is_identifier_start(char c) {
+    return std::isalpha(static_cast<unsigned char>(c)) || c == '_';
+}
+
+bool is_identifier_char(char c) {
+    return std::isalnum(static_cast<unsigned char>(c)) || c == '_' || c == '.';
+}
+
+// Depth-first, so the outermost "alerting" object wins
+const nlohmann::ordered_json* find_alerting_section(const nlohmann::ordered_json& node) {
+    if (!node.is_object()) {
+        return nullptr;
+    }
+    if (auto it = node.find("alerting"); it != node.end() && it->is_object()) {
+        return &*it;
+    }
+    for (const auto& [key, child] : node.items()) {
+        if (const auto* found = find_alerting_section(child)) {
+            return found;
+        }
+    }
+    return nullptr;
+}
+
+} // namespace
+
+const char* alert_state_name(alert_state state) {
+    switch (state) {
+        case alert_state::inactive: return "inactive";
+        case alert_state::pending: return "pending";
+        case alert_state::firing: return "firing";
+        case alert_state::resolved: return "resolved";
+    }
+    return "unknown";
+}
+
+/**
+ * Recursive descent over the condition, emitting postfix instructions:
+ *
+ *     or         := and (("||" | "or") and)*
+ *     and        := unary (("&&" | "and") unary)*
+ *     unary      := ("!" | "not") unary | "(" or ")" | comparison
+ *     comparison := term (">" | ">=" | "<" | "<=" | "==" | "!=") term
+ *     term       := metric | number
+ */
+class alert_rule_engine::parser {
+public:
+    parser(const alert_rule_engine& engine, std::string_view text) : engine_(engine), text_(text) {}
+
+    common::VoidResult parse(std::vector<instruction>& program, std::size_t& depth) {
+        program_ = &program;
+        parse_or();
+        skip_spaces();
+        if (error_.empty() && position_ != text_.size()) {
+            fail("unexpected '" + std::string(text_.substr(position_, 1)) + "'");
+        }
+        if (!error_.empty()) {
+            return common::VoidResult::err(common::error_codes::INVALID_ARGUMENT, error_);
+        }
+        depth = max_depth_;
+        return common::ok();
+    }
+
+private:
+    void parse_or() {
+        parse_and();
+        while (error_.empty() && (match("||") || match_word("or"))) {
+            parse_and();
+            emit_binary(opcode::logical_or);
+        }
+    }
+
+    void parse_and() {
+        parse_unary();
+        while (error_.empty() && (match("&&") || match_word("and"))) {
+            parse_unary();
+            emit_binary(opcode::logical_and);
+        }
+    }
+
+    void parse_unary() {
+        if (!error_.empty()) {
+            return;
+        }
+        if ((!peek("!=") && match("!")) || match_word("not")) {
+            parse_unary();
+            program_->push_back({opcode::logical_not, {}, {}, {}});
+        } else if (match("(")) {
+            parse_or();
+            if (error_.empty() && !match(")")) {
+                fail("expected ')'");
+            }
+        } else {
+            parse_comparison();
+        }
+    }
+
+    void parse_comparison() {
+        instruction compare{opcode::compare, {}, {}, {}};
+        if (!parse_term(compare.lhs)) {
+            return;
+        }
+
+        static constexpr std::pair<std::string_view, comparison> operators[] = {
+            {">=", comparison::greater_equal}, {"<=", comparison::less_equal},
+            {"==", comparison::equal}, {"!=", comparison::not_equal},
+            {">", comparison::greater}, {"<", comparison::less}};
+        bool found = false;
+        for (const auto& [symbol, cmp] : operators) {
+            if (match(symbol)) {
+                compare.cmp = cmp;
+                found = true;
+                break;
+            }
+        }
+        if (!found) {
+            fail("expected a comparison operator");
+            return;
+        }
+
+        if (!parse_term(compare.rhs)) {
+            return;
+        }
+        if (!compare.lhs.is_metric && !compare.rhs.is_metric) {
+            fail("comparison of two numbers");
+            return;
+        }
+
+        program_->push_back(compare);
+        max_depth_ = std::max(max_depth_, ++depth_);
+    }
+
+    bool parse_term(operand& out) {
+        skip_spaces();
+        if (position_ < text_.size() && is_identifier_start(text_[position_])) {
+            const std::size_t start = position_;
+            while (position_ < text_.size() && is_identifier_char(text_[position_])) {
+                ++position_;
+            }
+            const auto name = text_.substr(start, position_ - start);
+            const auto it = std::find(engine_.names_.begin(), engine_.names_.end(), name);
+            if (it == engine_.names_.end()) {
+                fail("unknown metric '" + std::string(name) + "'");
+                return false;
+            }
+            out = {true, engine_.columns_[static_cast<std::size_t>(it - engine_.names_.begin())], 0.0};
+            return true;
+        }
+
+        double value = 0.0;
+        const char* begin = text_.data() + position_;
+        const auto [end, ec] = std::from_chars(begin, text_.data() + text_.size(), value);
+        if (ec != std::errc{}) {
+            fail("expected a metric or a number");
+            return false;
+        }
+        position_ += static_cast<std::size_t>(end - begin);
+        out = {false, 0, value};
+        return true;
+    }
+
+    void emit_binary(opcode op) {
+        if (error_.empty()) {
+            program_->push_back({op, {}, {}, {}});
+            --depth_;
+        }
+    }
+
+    void skip_spaces() {
+        while (position_ < text_.size() && std::isspace(static_cast<unsigned char>(text_[position_]))) {
+            ++position_;
+        }
+    }
+
+    bool peek(std::string_view symbol) {
+        skip_spaces();
+        return text_.substr(position_, symbol.size()) == symbol;
+    }
+
+    bool match(std::string_view symbol) {
+        if (!peek(symbol)) {
+            return false;
+        }
+        position_ += symbol.size();
+        return true;
+    }
+
+    bool match_word(std::string_view word) {
+        if (!peek(word)) {
+            return false;
+        }
+        const std::size_t end = position_ + word.size();
+        if (end < text_.size() && is_identifier_char(text_[end])) {
+            return false;  // Prefix of a metric name
+        }
+        position_ = end;
+        return true;
+    }
+
+    void fail(std::string message) {
+        if (error_.empty()) {
+            error_ = message + " at offset " + std::to_string(position_);
+        }
+    }
+
+    const alert_rule_engine& engine_;
+    std::string_view text_;
+    std::size_t position_ = 0;
+    std::vector<instruction>* program_ = nullptr;
+    std::size_t depth_ = 0;
+    std::size_t max_depth_ = 0;
+    std::string error_;
+};
+
+alert_rule_engine::alert_rule_engine(std::vector<std::string> metrics)
+    : names_(std::move(metrics)), metric_count_(names_.size()) {
+    columns_.resize(names_.size());
+    for (std::size_t i = 0; i < columns_.size(); ++i) {
+        columns_[i] = i;
+    }
+}
+
+void alert_rule_engine::add_alias(std::string alias, std::size_t column) {
+    if (column < metric_count_) {
+        names_.push_back(std::move(alias));
+        columns_.push_back(column);
+    }
+}
+
+common::Result<std::size_t> alert_rule_engine::add_rule(const alert_rule_definition& rule) {
+    if (rule.name.empty()) {
+        return common::Result<std::size_t>::err(common::error_codes::INVALID_ARGUMENT,
+                                                "Alert rule needs a name");
+    }
+    if (find_rule(rule.name).is_ok()) {
+        return common::Result<std::size_t>::err(common::error_codes::INVALID_ARGUMENT,
+                                                "Alert rule '" + rule.name + "' already exists");
+    }
+
+    compiled_rule compiled{rule, {}, 0};
+    auto parsed = parser(*this, rule.condition).parse(compiled.program, compiled.depth);
+    if (parsed.is_err()) {
+        return common::Result<std::size_t>::err(
+            common::error_codes::INVALID_ARGUMENT,
+            "Alert rule '" + rule.name + "': " + parsed.error().message);
+    }
+
+    stack_.resize(std::max(stack_.size(), compiled.depth));
+    rules_.push_back(std::move(compiled));
+    return common::Result<std::size_t>::ok(rules_.size() - 1);
+}
+
+void alert_rule_engine::clear() {
+    rules_.clear();
+}
+
+common::Result<std::size_t> alert_rule_engine::find_rule(std::string_view name) const {
+    for (std::size_t i = 0; i < rules_.size(); ++i) {
+        if (rules_[i].definition.name == name) {
+            return common::Result<std::size_t>::ok(i);
+        }
+    }
+    return common::Result<std::size_t>::err(common::error_codes::INVALID_ARGUMENT,
+                                            "No alert rule named '" + std::string(name) + "'");
+}
+
+void alert_rule_engine::evaluate(clock::time_point now, std::span<const double> values,
+                                 const transition_handler& on_transition) {
+    if (values.size() != metric_count_) {
+        return;
+    }
+
+    for (std::size_t i = 0; i < rules_.size(); ++i) {
+        auto& rule = rules_[i];
+        const bool holds = run(rule, values);
+        const alert_state from = rule.state;
+
+        switch (rule.state) {
+            case alert_state::inactive:
+            case alert_state::resolved:
+                if (holds) {
+                    rule.since = now;
+                    rule.state = rule.definition.duration.count() <= 0 ? alert_state::firing
+                                                                         : alert_state::pending;
+                }
+                break;
+            case alert_state::pending:
+                if (!holds) {
+                    rule.state = alert_state::inactive;
+                    rule.since = now;
+                } else if (now - rule.since >= rule.definition.duration) {
+                    rule.state = alert_state::firing;
+                }
+                break;
+            case alert_state::firing:
+                if (!holds) {
+                    rule.state = alert_state::resolved;
+                    rule.since = now;
+                }
+                break;
+        }
+
+        if (rule.state != from && on_transition) {
+            // Report the first comparison's metric and what it is compared with
+            const auto& first = rule.program.front();
+            const bool metric_left = first.lhs.is_metric;
+            on_transition({i, from, rule.state, rule.since,
+                           load(metric_left ? first.lhs : first.rhs, values),
+                           load(metric_left ? first.rhs : first.lhs, values)});
+        }
+    }
+}
+
+double alert_rule_engine::load(const operand& source, std::span<const double> values) {
+    return source.is_metric ? values[source.column] : source.constant;
+}
+
+bool alert_rule_engine::run(const compiled_rule& rule, std::span<const double> values) {
+    std::size_t top = 0;
+    for (const auto& step : rule.program) {
+        switch (step.op) {
+            case opcode::compare: {
+                const double lhs = load(step.lhs, values);
+                const double rhs = load(step.rhs, values);
+                bool result = false;
+                switch (step.cmp) {
+                    case comparison::greater: result = lhs > rhs; break;
+                    case comparison::greater_equal: result = lhs >= rhs; break;
+                    case comparison::less: result = lhs < rhs; break;
+                    case comparison::less_equal: result = lhs <= rhs; break;
+                    case comparison::equal: result = lhs == rhs; break;
+                    case comparison::not_equal: result = lhs != rhs; break;
+                }
+                stack_[top++] = result;
+                break;
+            }
+            case opcode::logical_and:
+                --top;
+                stack_[top - 1] = stack_[top - 1] && stack_[top];
+                break;
+            case opcode::logical_or:
+                --top;
+                stack_[top - 1] = stack_[top - 1] || stack_[top];
+                break;
+            case opcode::logical_not:
+                stack_[top - 1] = !stack_[top - 1];
+                break;
+        }
+    }
+    return top == 1 && stack_[0];
+}
+
+common::Result<std::chrono::milliseconds> alert_rule_engine::parse_duration(std::string_view text) {
+    auto invalid = [&] {
+        return common::Result<std::chrono::milliseconds>::err(
+            common::error_codes::INVALID_ARGUMENT, "Invalid duration '" + std::string(text) + "'");
+    };
+
+    while (!text.empty() && std::isspace(static_cast<unsigned char>(text.front()))) text.remove_prefix(1);
+    while (!text.empty() && std::isspace(static_cast<unsigned char>(text.back()))) text.remove_suffix(1);
+    if (text.empty()) {
+        return invalid();
+    }
+
+    static constexpr std::pair<std::string_view, double> units[] = {
+        {"ms", 1.0}, {"s", 1e3}, {"m", 60e3}, {"h", 3600e3}, {"d", 86400e3}};
+
+    double total = 0.0;
+    std::string_view rest = text;
+    while (!rest.empty()) {
+        double amount = 0.0;
+        const auto [end, ec] = std::from_chars(rest.data(), rest.data() + rest.size(), amount);
+        if (ec != std::errc{} || amount < 0) {
+            return invalid();
+        }
+        rest.remove_prefix(static_cast<std::size_t>(end - rest.data()));
+
+        double scale = 1e3;  // Bare numbers are seconds
+        if (!rest.empty()) {
+            bool found = false;
+            for (const auto& [unit, unit_scale] : units) {
+                if (rest.substr(0, unit.size()) == unit) {
+                    scale = unit_scale;
+                    rest.remove_prefix(unit.size());
+                    found = true;
+                    break;
+                }
+            }
+            if (!found) {
+                return invalid();
+            }
+        }
+        total += amount * scale;
+    }
+    return common::Result<std::chrono::milliseconds>::ok(
+        std::chrono::milliseconds(static_cast<std::int64_t>(total)));
+}
+
+common::Result<std::vector<alert_rule_definition>> alert_rule_engine::parse_alerting_section(std::string_view json) {
+    using result = common::Result<std::vector<alert_rule_definition>>;
+
+    const auto document = nlohmann::ordered_json::parse(json.begin(), json.end(), nullptr, false);
+    if (document.is_discarded()) {
+        return result::err(common::error_codes::INVALID_ARGUMENT, "Alerting configuration is not valid JSON");
+    }
+    const auto* section = find_alerting_section(document);
+    if (!section) {
+        return result::err(common::error_codes::NOT_FOUND, "No alerting section");
+    }
+
+    std::vector<alert_rule_definition> rules;
+    if (!section->value("enabled", true)) {
+        return result::ok(std::move(rules));
+    }
+
+    const auto found = section->find("rules");
+    if (found == section->end()) {
+        return result::ok(std::move(rules));
+    }
+    if (!found->is_object()) {
+        return result::err(common::error_codes::INVALID_ARGUMENT, "Alerting rules must be an object");
+    }
+
+    for (const auto& [name, entry] : found->items()) {
+        const auto condition = entry.find("condition");
+        if (!entry.is_object() || condition == entry.end() || !condition->is_string()) {
+            return result::err(common::error_codes::INVALID_ARGUMENT,
+                               "Alert rule '" + name + "' needs a condition");
+        }
+
+        alert_rule_definition rule;
+        rule.name = name;
+        rule.condition = condition->get<std::string>();
+        if (const auto severity = entry.find("severity"); severity != entry.end() && severity->is_string()) {
+            rule.severity = severity->get<std::string>();
+        }
+        if (const auto duration = entry.find("duration"); duration != entry.end()) {
+            if (!duration->is_string()) {
+                return result::err(common::error_codes::INVALID_ARGUMENT,
+                                   "Alert rule '" + name + "': duration must be a string such as \"1m\"");
+            }
+            auto parsed = parse_duration(duration->get<std::string>());
+            if (parsed.is_err()) {
+                return result::err(common::error_codes::INVALID_ARGUMENT,
+                                   "Alert rule '" + name + "': " + parsed.error().message);
+            }
+            rule.duration = parsed.value();
+        }
+        rules.push_back(std::move(rule));
+    }
+    return result::ok(std::move(rules));
+}
+
+common::Result<std::vector<alert_rule_definition>> alert_rule_engine::load_alerting_section(const std::string& path) {
+    std::ifstream file(path);
+    if (!file) {
+        return common::Result<std::vector<alert_rule_definition>>::err(
+            common::error_codes::NOT_FOUND, "Cannot open '" + path + "'");
+    }
+    std::ostringstream contents;
+    contents << file.rdbuf();
+    return parse_alerting_section(contents.str());
+}
+
+} // namespace kcenon::integrated
@@ -0,0 +1,241 @@
+// BSD 3-Clause License
+// Copyright (c) 2025, kcenon
+// See the LICENSE file in the project root for full license information.
+
+#include <kcenon/integrated/core/circuit_breaker.h>
+
+#include <algorithm>
+
+namespace kcenon::integrated {
+
+namespace {
+
+constexpr std::int64_t ns_per_second = 1'000'000'000;
+
+// Layout of the probe words: round << probe_count_bits | count
+constexpr unsigned probe_count_bits = 24;
+constexpr std::uint64_t probe_count_mask = (std::uint64_t{1} << probe_count_bits) - 1;
+
+constexpr std::uint64_t probe_round(std::uint64_t word) noexcept {
+    return word >> probe_count_bits;
+}
+
+constexpr std::uint64_t probe_count(std::uint64_t word) noexcept {
+    return word & probe_count_mask;
+}
+
+constexpr std::uint64_t probe_word(std::uint64_t round, std::uint64_t count) noexcept {
+    return (round << probe_count_bits) | (count & probe_count_mask);
+}
+
+} // namespace
+
+circuit_breaker::circuit_breaker(const circuit_breaker_config& config)
+    : config_(config)
+    , bucket_count_(std::clamp<std::size_t>(config.window_seconds, 1, 3600))
+    , slow_call_ns_(std::chrono::duration_cast<std::chrono::nanoseconds>(config.slow_call_duration).count())
+    , buckets_(std::make_unique<bucket[]>(bucket_count_)) {
+}
+
+std::int64_t circuit_breaker::now_ns() noexcept {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        clock::now().time_since_epoch()).count();
+}
+
+std::optional<circuit_permit> circuit_breaker::acquire_slow() noexcept {
+    auto state = state_.load(std::memory_order_acquire);
+
+    if (state == circuit_state::open) {
+        if (now_ns() < open_until_.load(std::memory_order_acquire)) {
+            return std::nullopt;
+        }
+
+        // trip() already started a new round with no permits, so callers that
+        // see half-open before the permits are armed are simply rejected
+        if (state_.compare_exchange_strong(state, circuit_state::half_open, std::memory_order_acq_rel)) {
+            const std::uint64_t round = probe_round(probe_permits_.load(std::memory_order_acquire));
+            const std::uint64_t permits = std::clamp<std::uint64_t>(config_.half_open_permits, 1, probe_count_mask);
+            probe_successes_.store(probe_word(round, 0), std::memory_order_release);
+            probe_permits_.store(probe_word(round, permits), std::memory_order_release);
+        }
+        state = state_.load(std::memory_order_acquire);
+    }
+
+    if (state == circuit_state::half_open) {
+        std::uint64_t word = probe_permits_.load(std::memory_order_acquire);
+        while (probe_count(word) > 0) {
+            if (probe_permits_.compare_exchange_weak(word, word - 1, std::memory_order_acq_rel)) {
+                return circuit_permit{probe_round(word)};
+            }
+        }
+        return std::nullopt;
+    }
+
+    if (state == circuit_state::closed) {
+        return circuit_permit{};
+    }
+    return std::nullopt;
+}
+
+void circuit_breaker::release(const circuit_permit& permit) noexcept {
+    if (!permit.is_probe()) {
+        return;
+    }
+
+    // Only into the round that issued it; a later round has its own permits
+    std::uint64_t word = probe_permits_.load(std::memory_order_acquire);
+    while (probe_round(word) == permit.probe_round) {
+        if (probe_permits_.compare_exchange_weak(word, word + 1, std::memory_order_acq_rel)) {
+            return;
+        }
+    }
+}
+
+bool circuit_breaker::record_probe(const circuit_permit& permit, bool success, bool slow,
+                                   std::int64_t now) noexcept {
+    if (state_.load(std::memory_order_acquire) != circuit_state::half_open ||
+        probe_round(probe_permits_.load(std::memory_order_acquire)) != permit.probe_round) {
+        // Its round already ended
+        return false;
+    }
+
+    if (!success || slow) {
+        return trip(circuit_state::half_open, now);
+    }
+
+    const std::uint64_t permits = std::clamp<std::uint64_t>(config_.half_open_permits, 1, probe_count_mask);
+    std::uint64_t word = probe_successes_.load(std::memory_order_acquire);
+    while (probe_round(word) == permit.probe_round) {
+        if (!probe_successes_.compare_exchange_weak(word, word + 1, std::memory_order_acq_rel)) {
+            continue;
+        }
+        if (probe_count(word) + 1 >= permits) {
+            auto expected = circuit_state::half_open;
+            if (state_.compare_exchange_strong(expected, circuit_state::closed, std::memory_order_acq_rel)) {
+                clear_window();
+                consecutive_failures_.store(0, std::memory_order_relaxed);
+            }
+        }
+        break;
+    }
+    return false;
+}
+
+bool circuit_breaker::record(const circuit_permit& permit, bool success, std::chrono::nanoseconds duration) noexcept {
+    const bool slow = slow_call_ns_ > 0 && duration.count() >= slow_call_ns_;
+    const std::int64_t now = now_ns();
+
+    if (permit.is_probe()) {
+        return record_probe(permit, success, slow, now);
+    }
+
+    if (state_.load(std::memory_order_acquire) != circuit_state::closed) {
+        // Admitted while closed; only probes decide an open or half-open breaker
+        return false;
+    }
+
+    const std::int64_t second = now / ns_per_second;
+    bucket& slot = bucket_for(second);
+    slot.calls.add();
+    if (!success) {
+        slot.failures.add();
+    }
+    if (slow) {
+        slot.slow_calls.add();
+    }
+
+    if (success) {
+        // Avoid dirtying the shared line on the common path
+        if (consecutive_failures_.load(std::memory_order_relaxed) != 0) {
+            consecutive_failures_.store(0, std::memory_order_relaxed);
+        }
+        if (!slow) {
+            return false;
+        }
+    } else if (config_.failure_threshold > 0 &&
+               consecutive_failures_.fetch_add(1, std::memory_order_relaxed) + 1 >= config_.failure_threshold) {
+        return trip(circuit_state::closed, now);
+    }
+
+    return should_trip(second) && trip(circuit_state::closed, now);
+}
+
+bool circuit_breaker::trip(circuit_state from, std::int64_t now) noexcept {
+    const auto timeout = std::chrono::duration_cast<std::chrono::nanoseconds>(config_.reset_timeout).count();
+    open_until_.store(now + timeout, std::memory_order_release);
+    if (!state_.compare_exchange_strong(from, circuit_state::open, std::memory_order_acq_rel)) {
+        return false;
+    }
+
+    // Start the next round without permits; outstanding probes become stale
+    const std::uint64_t round = probe_round(probe_permits_.load(std::memory_order_acquire)) + 1;
+    probe_permits_.store(probe_word(round, 0), std::memory_order_release);
+    return true;
+}
+
+bool circuit_breaker::should_trip(std::int64_t now_second) const noexcept {
+    const auto stats = sum_window(now_second);
+    if (stats.calls == 0 || stats.calls < config_.minimum_calls) {
+        return false;
+    }
+
+    const double calls = static_cast<double>(stats.calls);
+    if (static_cast<double>(stats.failures) / calls >= config_.failure_rate_threshold) {
+        return true;
+    }
+    return slow_call_ns_ > 0 &&
+           static_cast<double>(stats.slow_calls) / calls >= config_.slow_call_rate_threshold;
+}
+
+circuit_breaker::bucket& circuit_breaker::bucket_for(std::int64_t second) noexcept {
+    bucket& slot = buckets_[static_cast<std::size_t>(second) % bucket_count_];
+
+    std::int64_t current = slot.second.load(std::memory_order_acquire);
+    if (current < second && slot.second.compare_exchange_strong(current, second, std::memory_order_acq_rel)) {
+        // Recycled from an older second; racing records may land in either epoch
+        slot.calls.reset();
+        slot.failures.reset();
+        slot.slow_calls.reset();
+    }
+    return slot;
+}
+
+circuit_window_stats circuit_breaker::sum_window(std::int64_t now_second) const noexcept {
+    const auto oldest = now_second - static_cast<std::int64_t>(bucket_count_);
+
+    circuit_window_stats stats;
+    for (std::size_t i = 0; i < bucket_count_; ++i) {
+        const bucket& slot = buckets_[i];
+        const auto second = slot.second.load(std::memory_order_acquire);
+        if (second <= oldest || second > now_second) {
+            continue;
+        }
+        stats.calls += slot.calls.value();
+        stats.failures += slot.failures.value();
+        stats.slow_calls += slot.slow_calls.value();
+    }
+    return stats;
+}
+
+circuit_window_stats circuit_breaker::window_stats() const noexcept {
+    return sum_window(now_ns() / ns_per_second);
+}
+
+void circuit_breaker::clear_window() noexcept {
+    for (std::size_t i = 0; i < bucket_count_; ++i) {
+        buckets_[i].second.store(-1, std::memory_order_release);
+        buckets_[i].calls.reset();
+        buckets_[i].failures.reset();
+        buckets_[i].slow_calls.reset();
+    }
+}
+
+void circuit_breaker::reset() noexcept {
+    clear_window();
+    consecutive_failures_.store(0, std::memory_order_relaxed);
+    const std::uint64_t round = probe_round(probe_permits_.load(std::memory_order_acquire)) + 1;
+    probe_permits_.store(probe_word(round, 0), std::memory_order_release);
+    state_.store(circuit_state::closed, std::memory_order_release);
+}
+
+} // namespace kcenon::integrated
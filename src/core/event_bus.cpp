@@ -0,0 +1,340 @@
+// BSD 3-Clause License
+// Copyright (c) 2025, kcenon
+// See the LICENSE file in the project root for full license information.
+
+#include <kcenon/integrated/core/event_bus.h>
+
+#include <algorithm>
+#include <bit>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+
+namespace kcenon::integrated {
+
+namespace {
+
+struct event_record {
+    event_type_id type{0};
+    std::any payload;
+};
+
+/**
+ * @brief Bounded multi-producer ring (Vyukov), consumed by one dispatcher
+ */
+class event_ring {
+public:
+    explicit event_ring(std::size_t capacity)
+        : mask_(std::bit_ceil(std::max<std::size_t>(capacity, 2)) - 1)
+        , cells_(std::make_unique<cell[]>(mask_ + 1)) {
+        for (std::size_t i = 0; i <= mask_; ++i) {
+            cells_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    bool try_push(event_type_id type, const std::any& payload) {
+        std::size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+        while (true) {
+            cell& slot = cells_[pos & mask_];
+            const std::size_t sequence = slot.sequence.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(pos);
+            if (diff == 0) {
+                if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    slot.value.type = type;
+                    slot.value.payload = payload;
+                    slot.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;  // Full
+            } else {
+                pos = enqueue_pos_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    bool try_pop(event_record& out) {
+        const std::size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+        cell& slot = cells_[pos & mask_];
+        const std::size_t sequence = slot.sequence.load(std::memory_order_acquire);
+        if (static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(pos + 1) < 0) {
+            return false;  // Empty
+        }
+
+        out = std::move(slot.value);
+        slot.value.payload.reset();
+        dequeue_pos_.store(pos + 1, std::memory_order_relaxed);
+        slot.sequence.store(pos + mask_ + 1, std::memory_order_release);
+        return true;
+    }
+
+private:
+    struct cell {
+        std::atomic<std::size_t> sequence{0};
+        event_record value;
+    };
+
+    std::size_t mask_;
+    std::unique_ptr<cell[]> cells_;
+    alignas(64) std::atomic<std::size_t> enqueue_pos_{0};
+    alignas(64) std::atomic<std::size_t> dequeue_pos_{0};  // Dispatcher only
+};
+
+} // namespace
+
+struct event_bus::counters {
+    std::atomic<std::uint64_t> dropped{0};
+    std::atomic<std::uint64_t> callback_errors{0};
+};
+
+struct event_bus::subscriber {
+    std::size_t id{0};
+    callback cb;
+    event_delivery delivery{event_delivery::sync};
+    std::string type_name;  // Copied: a detached dispatcher may outlive the bus
+
+    // Async delivery only
+    std::unique_ptr<event_ring> ring;
+    std::atomic<std::uint32_t> signal{0};
+    std::atomic<bool> stopping{false};
+    std::thread dispatcher;
+};
+
+struct event_bus::type_slot {
+    std::string name;
+    std::atomic<std::size_t> subscriber_count{0};
+
+#if defined(__cpp_lib_atomic_shared_ptr)
+    std::atomic<std::shared_ptr<const subscriber_list>> list;
+
+    std::shared_ptr<const subscriber_list> load() const {
+        return list.load(std::memory_order_acquire);
+    }
+    void store(std::shared_ptr<const subscriber_list> next) {
+        list.store(std::move(next), std::memory_order_release);
+    }
+#else
+    std::shared_ptr<const subscriber_list> list;
+
+    std::shared_ptr<const subscriber_list> load() const {
+        return std::atomic_load_explicit(&list, std::memory_order_acquire);
+    }
+    void store(std::shared_ptr<const subscriber_list> next) {
+        std::atomic_store_explicit(&list, std::move(next), std::memory_order_release);
+    }
+#endif
+};
+
+namespace {
+
+template<typename Counters>
+void invoke(const event_bus::callback& cb, const std::string& name, const std::any& payload,
+            Counters& counters) {
+    try {
+        cb(name, payload);
+    } catch (...) {
+        counters.callback_errors.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+} // namespace
+
+event_bus::event_bus()
+    : slots_(std::make_unique<type_slot[]>(max_event_types))
+    , counters_(std::make_shared<counters>()) {
+}
+
+event_bus::~event_bus() {
+    shutdown();
+}
+
+event_type_id event_bus::intern(std::string_view type) {
+    std::lock_guard<std::mutex> lock(write_mutex_);
+
+    std::string key(type);
+    auto it = type_ids_.find(key);
+    if (it != type_ids_.end()) {
+        return it->second;
+    }
+
+    const std::size_t index = type_count_.load(std::memory_order_relaxed);
+    if (index >= max_event_types) {
+        throw std::runtime_error("Too many event types");
+    }
+
+    slots_[index].name = key;
+    type_ids_.emplace(std::move(key), static_cast<event_type_id>(index));
+    type_count_.store(index + 1, std::memory_order_release);
+    return static_cast<event_type_id>(index);
+}
+
+const std::string& event_bus::name(event_type_id id) const {
+    if (id >= type_count_.load(std::memory_order_acquire)) {
+        throw std::out_of_range("Unknown event type id");
+    }
+    return slots_[id].name;
+}
+
+std::size_t event_bus::subscribe(event_type_id type, callback cb,
+                                 event_delivery delivery, std::size_t queue_capacity) {
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    if (type >= type_count_.load(std::memory_order_relaxed)) {
+        throw std::out_of_range("Unknown event type id");
+    }
+
+    type_slot& slot = slots_[type];
+
+    auto sub = std::make_shared<subscriber>();
+    sub->id = next_subscription_id_++;
+    sub->cb = std::move(cb);
+    sub->delivery = delivery;
+    sub->type_name = slot.name;
+
+    if (delivery == event_delivery::async) {
+        sub->ring = std::make_unique<event_ring>(queue_capacity);
+
+        // The dispatcher owns a reference so an unsubscribe from inside its
+        // own callback cannot free it underneath
+        sub->dispatcher = std::thread([sub, stats = counters_]() {
+            event_record record;
+            while (true) {
+                const auto seen = sub->signal.load(std::memory_order_acquire);
+                while (sub->ring->try_pop(record)) {
+                    invoke(sub->cb, sub->type_name, record.payload, *stats);
+                }
+                if (sub->stopping.load(std::memory_order_acquire)) {
+                    // Deliver what was queued before the stop; events pushed by
+                    // emitters racing with it are discarded with the subscriber
+                    while (sub->ring->try_pop(record)) {
+                        invoke(sub->cb, sub->type_name, record.payload, *stats);
+                    }
+                    return;
+                }
+                sub->signal.wait(seen, std::memory_order_acquire);
+            }
+        });
+    }
+
+    auto current = slot.load();
+    auto next = current ? std::make_shared<subscriber_list>(*current)
+                        : std::make_shared<subscriber_list>();
+    next->push_back(sub);
+    slot.store(std::move(next));
+    slot.subscriber_count.fetch_add(1, std::memory_order_release);
+
+    subscription_types_.emplace(sub->id, type);
+    return sub->id;
+}
+
+bool event_bus::unsubscribe(std::size_t subscription_id) {
+    std::shared_ptr<subscriber> removed;
+    {
+        std::lock_guard<std::mutex> lock(write_mutex_);
+        auto it = subscription_types_.find(subscription_id);
+        if (it == subscription_types_.end()) {
+            return false;
+        }
+
+        type_slot& slot = slots_[it->second];
+        subscription_types_.erase(it);
+
+        auto current = slot.load();
+        auto next = std::make_shared<subscriber_list>();
+        next->reserve(current->size());
+        for (const auto& sub : *current) {
+            if (sub->id == subscription_id) {
+                removed = sub;
+            } else {
+                next->push_back(sub);
+            }
+        }
+        slot.store(std::move(next));
+        slot.subscriber_count.fetch_sub(1, std::memory_order_release);
+    }
+
+    if (removed) {
+        stop_subscriber(*removed);
+    }
+    return true;
+}
+
+void event_bus::stop_subscriber(subscriber& sub) {
+    if (!sub.dispatcher.joinable()) {
+        return;
+    }
+
+    sub.stopping.store(true, std::memory_order_release);
+    sub.signal.fetch_add(1, std::memory_order_release);
+    sub.signal.notify_one();
+
+    if (sub.dispatcher.get_id() == std::this_thread::get_id()) {
+        sub.dispatcher.detach();  // Unsubscribed from its own callback
+    } else {
+        sub.dispatcher.join();
+    }
+}
+
+bool event_bus::has_subscribers(event_type_id type) const noexcept {
+    return type < max_event_types &&
+           slots_[type].subscriber_count.load(std::memory_order_acquire) != 0;
+}
+
+void event_bus::emit(event_type_id type, const std::any& payload) {
+    if (!has_subscribers(type)) {
+        return;
+    }
+
+    const auto list = slots_[type].load();
+    if (!list) {
+        return;
+    }
+
+    for (const auto& sub : *list) {
+        if (sub->delivery == event_delivery::sync) {
+            invoke(sub->cb, sub->type_name, payload, *counters_);
+            continue;
+        }
+
+        if (sub->stopping.load(std::memory_order_relaxed) || !sub->ring->try_push(type, payload)) {
+            counters_->dropped.fetch_add(1, std::memory_order_relaxed);
+            continue;
+        }
+        sub->signal.fetch_add(1, std::memory_order_release);
+        sub->signal.notify_one();
+    }
+}
+
+void event_bus::shutdown() {
+    std::vector<std::shared_ptr<subscriber>> removed;
+    {
+        std::lock_guard<std::mutex> lock(write_mutex_);
+        const std::size_t count = type_count_.load(std::memory_order_relaxed);
+        for (std::size_t i = 0; i < count; ++i) {
+            type_slot& slot = slots_[i];
+            if (auto current = slot.load()) {
+                removed.insert(removed.end(), current->begin(), current->end());
+            }
+            slot.store(nullptr);
+            slot.subscriber_count.store(0, std::memory_order_release);
+        }
+        subscription_types_.clear();
+    }
+
+    for (auto& sub : removed) {
+        stop_subscriber(*sub);
+    }
+}
+
+event_bus_stats event_bus::stats() const {
+    event_bus_stats stats;
+    {
+        std::lock_guard<std::mutex> lock(write_mutex_);
+        stats.event_types = type_count_.load(std::memory_order_relaxed);
+        stats.subscribers = subscription_types_.size();
+    }
+    stats.dropped = counters_->dropped.load(std::memory_order_relaxed);
+    stats.callback_errors = counters_->callback_errors.load(std::memory_order_relaxed);
+    return stats;
+}
+
+} // namespace kcenon::integrated
@@ -0,0 +1,204 @@
+// BSD 3-Clause License
+// Copyright (c) 2025, kcenon
+// See the LICENSE file in the project root for full license information.
+
+#include <kcenon/integrated/core/flight_recorder.h>
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <fstream>
+
+namespace kcenon::integrated {
+
+namespace {
+
+constexpr std::size_t min_events_per_ring = 16;
+constexpr std::size_t max_events_per_ring = std::size_t{1} << 20;
+
+constexpr char file_magic[8] = {'K', 'C', 'F', 'L', 'I', 'G', 'H', 'T'};
+constexpr std::uint32_t file_version = 1;
+
+template <typename T>
+void write_value(std::ostream& out, const T& value) {
+    out.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+template <typename T>
+bool read_value(std::istream& in, T& value) {
+    return static_cast<bool>(in.read(reinterpret_cast<char*>(&value), sizeof(value)));
+}
+
+} // namespace
+
+const char* flight_event_name(flight_event_kind kind) {
+    switch (kind) {
+        case flight_event_kind::enqueue: return "enqueue";
+        case flight_event_kind::dequeue: return "dequeue";
+        case flight_event_kind::start: return "start";
+        case flight_event_kind::finish: return "finish";
+        case flight_event_kind::park: return "park";
+        case flight_event_kind::unpark: return "unpark";
+        case flight_event_kind::steal: return "steal";
+        case flight_event_kind::reject: return "reject";
+    }
+    return "unknown";
+}
+
+flight_recorder::flight_recorder(std::size_t workers, std::size_t events_per_ring)
+    : workers_(workers)
+    , epoch_(clock::now())
+    , system_epoch_(std::chrono::system_clock::now()) {
+    const std::size_t capacity =
+        std::bit_ceil(std::clamp(events_per_ring, min_events_per_ring, max_events_per_ring));
+    mask_ = capacity - 1;
+    shift_ = static_cast<unsigned>(std::countr_zero(capacity));
+
+    rings_ = std::make_unique<ring[]>(workers_ + 1);
+    for (std::size_t i = 0; i <= workers_; ++i) {
+        // All ones is lap 0xFFFF, which never matches a slot's first lap, so a
+        // slot reserved on the shared ring but not yet written is skipped
+        rings_[i].words = std::make_unique<std::atomic<std::uint64_t>[]>(capacity * 2);
+        for (std::size_t word = 0; word < capacity * 2; ++word) {
+            rings_[i].words[word].store(~std::uint64_t{0}, std::memory_order_relaxed);
+        }
+    }
+}
+
+flight_recorder::~flight_recorder() = default;
+
+std::vector<flight_event> flight_recorder::events(std::size_t index) const {
+    if (index > workers_) {
+        return {};
+    }
+    return events(index, rings_[index].head.load(std::memory_order_acquire));
+}
+
+std::vector<std::uint64_t> flight_recorder::heads() const {
+    std::vector<std::uint64_t> result(workers_ + 1);
+    for (std::size_t i = 0; i <= workers_; ++i) {
+        result[i] = rings_[i].head.load(std::memory_order_acquire);
+    }
+    return result;
+}
+
+std::vector<flight_event> flight_recorder::events(std::size_t index, std::uint64_t head) const {
+    std::vector<flight_event> result;
+    const ring& source = rings_[index];
+    const std::uint64_t capacity = mask_ + 1;
+    const std::uint64_t first = head > capacity ? head - capacity : 0;
+    result.reserve(static_cast<std::size_t>(head - first));
+
+    for (std::uint64_t position = first; position < head; ++position) {
+        const std::uint64_t slot = (position & mask_) * 2;
+        const std::uint64_t stamp = source.words[slot].load(std::memory_order_relaxed);
+        const std::uint64_t meta = source.words[slot + 1].load(std::memory_order_relaxed);
+
+        // Keep the event only if both words were written for this position;
+        // anything else was overwritten, or is still being written
+        const std::uint16_t expected = lap(position);
+        if (static_cast<std::uint16_t>(meta >> 32) != expected ||
+            static_cast<std::uint8_t>(stamp >> 56) != static_cast<std::uint8_t>(expected)) {
+            continue;
+        }
+
+        flight_event event{};
+        event.timestamp_ns = stamp & timestamp_mask;
+        event.arg = static_cast<std::uint32_t>(meta);
+        event.lap = expected;
+        event.kind = static_cast<flight_event_kind>(meta >> 48);
+        result.push_back(event);
+    }
+    return result;
+}
+
+common::VoidResult flight_recorder::dump(const std::string& path) const {
+    return dump(path, heads());
+}
+
+common::VoidResult flight_recorder::dump(const std::string& path, const std::vector<std::uint64_t>& heads) const {
+    if (heads.size() != workers_ + 1) {
+        return common::VoidResult::err(common::error_codes::INVALID_ARGUMENT,
+                                       "Flight recorder heads do not match its rings");
+    }
+
+    std::ofstream file(path, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!file) {
+        return common::VoidResult::err(common::error_codes::INTERNAL_ERROR,
+                                       "Cannot open flight recorder file '" + path + "'");
+    }
+
+    file.write(file_magic, sizeof(file_magic));
+    write_value(file, file_version);
+    write_value(file, static_cast<std::uint32_t>(workers_ + 1));
+    write_value(file, static_cast<std::int64_t>(
+                          std::chrono::duration_cast<std::chrono::nanoseconds>(
+                              system_epoch_.time_since_epoch()).count()));
+
+    for (std::size_t i = 0; i <= workers_; ++i) {
+        const auto recorded = events(i, heads[i]);
+        write_value(file, i == workers_ ? shared_ring_id : static_cast<std::uint32_t>(i));
+        write_value(file, static_cast<std::uint32_t>(recorded.size()));
+        file.write(reinterpret_cast<const char*>(recorded.data()),
+                   static_cast<std::streamsize>(recorded.size() * sizeof(flight_event)));
+    }
+
+    file.flush();
+    if (!file) {
+        return common::VoidResult::err(common::error_codes::INTERNAL_ERROR,
+                                       "Failed to write flight recorder file '" + path + "'");
+    }
+    return common::ok();
+}
+
+common::Result<flight_recorder_dump> flight_recorder::load(const std::string& path) {
+    std::ifstream file(path, std::ios::in | std::ios::binary);
+    if (!file) {
+        return common::Result<flight_recorder_dump>::err(
+            common::error_codes::NOT_FOUND, "Cannot open flight recorder file '" + path + "'");
+    }
+
+    const auto malformed = [&path](const std::string& what) {
+        return common::Result<flight_recorder_dump>::err(
+            common::error_codes::INVALID_ARGUMENT,
+            "Malformed flight recorder file '" + path + "': " + what);
+    };
+
+    char magic[sizeof(file_magic)];
+    std::uint32_t version = 0;
+    std::uint32_t ring_count = 0;
+    std::int64_t epoch_ns = 0;
+    if (!file.read(magic, sizeof(magic)) || std::memcmp(magic, file_magic, sizeof(magic)) != 0) {
+        return malformed("bad magic");
+    }
+    if (!read_value(file, version) || version != file_version) {
+        return malformed("unsupported version");
+    }
+    if (!read_value(file, ring_count) || !read_value(file, epoch_ns)) {
+        return malformed("truncated header");
+    }
+
+    flight_recorder_dump result;
+    result.epoch = std::chrono::system_clock::time_point(
+        std::chrono::duration_cast<std::chrono::system_clock::duration>(
+            std::chrono::nanoseconds(epoch_ns)));
+    result.rings.reserve(std::min<std::uint32_t>(ring_count, 4096));
+
+    for (std::uint32_t i = 0; i < ring_count; ++i) {
+        flight_ring_dump ring_dump;
+        std::uint32_t count = 0;
+        if (!read_value(file, ring_dump.id) || !read_value(file, count) ||
+            count > max_events_per_ring) {
+            return malformed("bad ring header");
+        }
+        ring_dump.events.resize(count);
+        if (!file.read(reinterpret_cast<char*>(ring_dump.events.data()),
+                       static_cast<std::streamsize>(count * sizeof(flight_event)))) {
+            return malformed("truncated ring");
+        }
+        result.rings.push_back(std::move(ring_dump));
+    }
+    return common::Result<flight_recorder_dump>::ok(std::move(result));
+}
+
+} // namespace kcenon::integrated
@@ -0,0 +1,168 @@
+// BSD 3-Clause License
+// Copyright (c) 2025, kcenon
+// See the LICENSE file in the project root for full license information.
+
+#include <kcenon/integrated/core/health_probes.h>
+
+#include <exception>
+#include <map>
+#include <mutex>
+#include <optional>
+
+namespace kcenon::integrated {
+
+struct health_probes::probe {
+    std::string name;
+    check_fn check;                   // Set for checks
+    collector_fn collector;           // Set for collectors
+    std::optional<gauge_handle> gauge;
+    std::chrono::milliseconds timeout{0};
+
+    // Guarded by state::mutex
+    bool running = false;
+    bool timed_out = false;
+    clock::time_point started{};      // Of the last run; epoch = never started
+    std::string issue;                // Empty while the check passes
+};
+
+struct health_probes::state {
+    mutable std::mutex mutex;
+    std::map<std::string, std::shared_ptr<probe>> checks;
+    std::map<std::string, std::shared_ptr<probe>> collectors;
+
+    // Held while on_change runs, so the destructor can wait it out
+    std::mutex callback_mutex;
+    std::function<void()> on_change;
+};
+
+health_probes::health_probes(std::chrono::milliseconds ttl, std::chrono::milliseconds default_timeout,
+                             std::function<void()> on_change)
+    : state_(std::make_shared<state>())
+    , ttl_(ttl)
+    , default_timeout_(default_timeout) {
+    state_->on_change = std::move(on_change);
+}
+
+health_probes::~health_probes() {
+    std::lock_guard<std::mutex> lock(state_->callback_mutex);
+    state_->on_change = nullptr;
+}
+
+void health_probes::add_check(const std::string& name, check_fn check, std::chrono::milliseconds timeout) {
+    auto entry = std::make_shared<probe>();
+    entry->name = name;
+    entry->check = std::move(check);
+    entry->timeout = timeout > std::chrono::milliseconds::zero() ? timeout : default_timeout_;
+
+    // A replaced check that is still running completes into its own, detached entry
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    state_->checks[name] = std::move(entry);
+}
+
+void health_probes::add_collector(const std::string& name, collector_fn collector, gauge_handle gauge) {
+    auto entry = std::make_shared<probe>();
+    entry->name = name;
+    entry->collector = std::move(collector);
+    entry->gauge = gauge;
+    entry->timeout = default_timeout_;
+
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    state_->collectors[name] = std::move(entry);
+}
+
+bool health_probes::poll(clock::time_point now, const executor& run) {
+    std::vector<std::shared_ptr<probe>> due;
+    bool timed_out = false;
+    {
+        std::lock_guard<std::mutex> lock(state_->mutex);
+        auto visit = [&](const std::shared_ptr<probe>& entry) {
+            if (entry->running) {
+                if (entry->check && !entry->timed_out && now - entry->started >= entry->timeout) {
+                    entry->timed_out = true;
+                    timed_out = true;
+                }
+            } else if (entry->started == clock::time_point{} || now - entry->started >= ttl_) {
+                entry->running = true;
+                entry->started = now;
+                due.push_back(entry);
+            }
+        };
+        for (const auto& [name, entry] : state_->checks) {
+            visit(entry);
+        }
+        for (const auto& [name, entry] : state_->collectors) {
+            visit(entry);
+        }
+    }
+
+    for (const auto& entry : due) {
+        bool accepted = false;
+        try {
+            accepted = run([shared = state_, entry] {
+                if (entry->check) {
+                    std::string issue;
+                    try {
+                        auto [healthy, message] = entry->check();
+                        if (!healthy) {
+                            issue = entry->name + ": " + message;
+                        }
+                    } catch (const std::exception& e) {
+                        issue = entry->name + " check failed: " + std::string(e.what());
+                    } catch (...) {
+                        issue = entry->name + " check failed";
+                    }
+                    complete(shared, entry, std::move(issue));
+                } else {
+                    try {
+                        entry->gauge->set(entry->collector());
+                    } catch (...) {
+                        // The gauge keeps its last value
+                    }
+                    complete(shared, entry, {});
+                }
+            });
+        } catch (...) {
+            // Rejected by the pool, like a false return
+        }
+        if (!accepted) {
+            // Retried on the next poll
+            std::lock_guard<std::mutex> lock(state_->mutex);
+            entry->running = false;
+            entry->started = {};
+        }
+    }
+    return timed_out;
+}
+
+void health_probes::complete(const std::shared_ptr<state>& shared, const std::shared_ptr<probe>& target,
+                             std::string issue) {
+    bool changed = false;
+    {
+        std::lock_guard<std::mutex> lock(shared->mutex);
+        changed = target->timed_out || issue != target->issue;
+        target->running = false;
+        target->timed_out = false;
+        target->issue = std::move(issue);
+    }
+    if (changed && target->check) {
+        std::lock_guard<std::mutex> lock(shared->callback_mutex);
+        if (shared->on_change) {
+            shared->on_change();
+        }
+    }
+}
+
+std::vector<std::string> health_probes::issues() const {
+    std::vector<std::string> result;
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    for (const auto& [name, entry] : state_->checks) {
+        if (entry->timed_out) {
+            result.push_back(name + ": timed out after " + std::to_string(entry->timeout.count()) + " ms");
+        } else if (!entry->issue.empty()) {
+            result.push_back(entry->issue);
+        }
+    }
+    return result;
+}
+
+} // namespace kcenon::integrated
@@ -0,0 +1,41 @@
+// BSD 3-Clause License
+// Copyright (c) 2025, kcenon
+// See the LICENSE file in the project root for full license information.
+
+#include "core/json_format.h"
+
+#include <kcenon/integrated/unified_thread_system.h>
+
+namespace kcenon::integrated::detail {
+
+void write_json_string(std::ostream& out, std::string_view value) {
+    static constexpr char hex[] = "0123456789abcdef";
+    out << '"';
+    for (const char c : value) {
+        switch (c) {
+            case '"': out << "\\\""; break;
+            case '\\': out << "\\\\"; break;
+            case '\n': out << "\\n"; break;
+            case '\t': out << "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    out << "\\u00" << hex[(c >> 4) & 0xF] << hex[c & 0xF];
+                } else {
+                    out << c;
+                }
+        }
+    }
+    out << '"';
+}
+
+const char* health_level_name(health_level level) noexcept {
+    switch (level) {
+        case health_level::healthy: return "healthy";
+        case health_level::degraded: return "degraded";
+        case health_level::critical: return "critical";
+        case health_level::failed: return "failed";
+    }
+    return "unknown";
+}
+
+} // namespace kcenon::integrated::detail
@@ -0,0 +1,35 @@
+// BSD 3-Clause License
+// Copyright (c) 2025, kcenon
+// See the LICENSE file in the project root for full license information.
+
+/**
+ * @file json_format.h
+ * @brief JSON pieces shared by the hand-written exporters (health, traces,
+ *        performance counters)
+ */
+
+#pragma once
+
+#include <ostream>
+#include <string_view>
+
+namespace kcenon::integrated {
+
+enum class health_level;
+
+namespace detail {
+
+/**
+ * @brief Write value as a quoted JSON string, escaping quotes, backslashes
+ *        and control characters
+ */
+void write_json_string(std::ostream& out, std::string_view value);
+
+/**
+ * @brief Lower-case name of a health level ("healthy" ... "failed")
+ */
+const char* health_level_name(health_level level) noexcept;
+
+} // namespace detail
+
+} // namespace kcenon::integrated
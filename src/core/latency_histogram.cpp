@@ -0,0 +1,243 @@
+// BSD 3-Clause License
+// Copyright (c) 2025, kcenon
+// See the LICENSE file in the project root for full license information.
+
+#include <kcenon/integrated/core/latency_histogram.h>
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <new>
+
+namespace kcenon::integrated {
+
+namespace {
+
+// Sub-buckets per octave so that reporting a bucket's midpoint stays within
+// 10^-digits: the midpoint error is at most 1 / (2 * 2^p)
+unsigned sub_bucket_bits_for(unsigned digits) {
+    digits = std::clamp(digits, 1u, 4u);
+    std::uint64_t needed = 1;
+    for (unsigned i = 0; i < digits; ++i) {
+        needed *= 10;
+    }
+    needed = (needed + 1) / 2;
+    return static_cast<unsigned>(std::bit_width(needed - 1));
+}
+
+// Representative value of a bucket: exact in the linear range, else the midpoint
+std::uint64_t bucket_value(std::size_t index, unsigned sub_bucket_bits) {
+    const std::uint64_t sub_buckets = std::uint64_t{1} << sub_bucket_bits;
+    if (index < 2 * sub_buckets) {
+        return index;
+    }
+
+    const std::uint64_t shift = index / sub_buckets - 1;
+    const std::uint64_t sub = index - shift * sub_buckets;
+    const std::uint64_t width = std::uint64_t{1} << shift;
+    return (sub << shift) + (width - 1) / 2;
+}
+
+void update_min(std::atomic<std::uint64_t>& target, std::uint64_t value) noexcept {
+    auto current = target.load(std::memory_order_relaxed);
+    while (value < current &&
+           !target.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+    }
+}
+
+void update_max(std::atomic<std::uint64_t>& target, std::uint64_t value) noexcept {
+    auto current = target.load(std::memory_order_relaxed);
+    while (value > current &&
+           !target.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+    }
+}
+
+} // namespace
+
+// latency_snapshot
+
+std::chrono::nanoseconds latency_snapshot::mean() const {
+    return std::chrono::nanoseconds(count_ ? sum_ / count_ : 0);
+}
+
+std::chrono::nanoseconds latency_snapshot::percentile(double quantile) const {
+    if (count_ == 0) {
+        return std::chrono::nanoseconds(0);
+    }
+
+    quantile = std::clamp(quantile, 0.0, 1.0);
+    const auto rank = std::clamp<std::uint64_t>(
+        static_cast<std::uint64_t>(std::ceil(quantile * static_cast<double>(count_))), 1, count_);
+
+    std::uint64_t seen = 0;
+    for (std::size_t i = 0; i < counts_.size(); ++i) {
+        seen += counts_[i];
+        if (seen >= rank) {
+            if (i + 1 == counts_.size()) {
+                return max();  // Top bucket also collects values beyond max_value
+            }
+            const auto value = std::clamp(bucket_value(i, sub_bucket_bits_), min_, max_);
+            return std::chrono::nanoseconds(value);
+        }
+    }
+    return max();
+}
+
+void latency_snapshot::clear() noexcept {
+    std::fill(counts_.begin(), counts_.end(), 0);
+    count_ = 0;
+    sum_ = 0;
+    min_ = 0;
+    max_ = 0;
+}
+
+void latency_snapshot::cumulative_counts(std::span<const std::chrono::nanoseconds> bounds,
+                                         std::span<std::uint64_t> out) const {
+    std::size_t bound = 0;
+    std::uint64_t seen = 0;
+    for (std::size_t i = 0; i < counts_.size() && bound < bounds.size(); ++i) {
+        if (counts_[i] == 0) {
+            continue;
+        }
+        const auto value = i + 1 == counts_.size()
+            ? max_  // Top bucket also collects values beyond max_value
+            : std::clamp(bucket_value(i, sub_bucket_bits_), min_, max_);
+        while (bound < bounds.size() && static_cast<std::int64_t>(value) > bounds[bound].count()) {
+            out[bound++] = seen;
+        }
+        seen += counts_[i];
+    }
+    while (bound < bounds.size()) {
+        out[bound++] = seen;
+    }
+}
+
+void latency_snapshot::merge(const latency_snapshot& other) {
+    if (other.count_ == 0) {
+        return;
+    }
+    if (counts_.empty()) {
+        sub_bucket_bits_ = other.sub_bucket_bits_;
+    }
+    if (counts_.size() < other.counts_.size()) {
+        counts_.resize(other.counts_.size(), 0);
+    }
+    for (std::size_t i = 0; i < other.counts_.size(); ++i) {
+        counts_[i] += other.counts_[i];
+    }
+
+    min_ = count_ ? std::min(min_, other.min_) : other.min_;
+    max_ = std::max(max_, other.max_);
+    count_ += other.count_;
+    sum_ += other.sum_;
+}
+
+// latency_histogram
+
+latency_histogram::latency_histogram(unsigned precision_digits, std::chrono::nanoseconds max_value)
+    : sub_bucket_bits_(sub_bucket_bits_for(precision_digits)) {
+    const std::uint64_t sub_buckets = std::uint64_t{1} << sub_bucket_bits_;
+    const auto largest = static_cast<std::uint64_t>(std::max<std::int64_t>(max_value.count(), 1));
+    const auto top_bit = static_cast<unsigned>(std::bit_width(largest) - 1);
+
+    bucket_count_ = top_bit <= sub_bucket_bits_
+        ? 2 * sub_buckets
+        : (top_bit - sub_bucket_bits_ + 2) * sub_buckets;
+}
+
+latency_histogram::~latency_histogram() {
+    delete[] counts_.load(std::memory_order_acquire);
+}
+
+std::atomic<std::uint64_t>* latency_histogram::allocate_counts() noexcept {
+    auto* fresh = new (std::nothrow) std::atomic<std::uint64_t>[bucket_count_]();
+    if (!fresh) {
+        return nullptr;
+    }
+
+    std::atomic<std::uint64_t>* expected = nullptr;
+    if (counts_.compare_exchange_strong(expected, fresh, std::memory_order_acq_rel)) {
+        return fresh;
+    }
+    delete[] fresh;  // Another recorder got there first
+    return expected;
+}
+
+std::size_t latency_histogram::index_of(std::uint64_t value) const noexcept {
+    const std::uint64_t sub_buckets = std::uint64_t{1} << sub_bucket_bits_;
+    if (value < 2 * sub_buckets) {
+        return static_cast<std::size_t>(value);
+    }
+
+    const auto shift = static_cast<unsigned>(std::bit_width(value) - 1) - sub_bucket_bits_;
+    const auto index = static_cast<std::size_t>(shift * sub_buckets + (value >> shift));
+    return std::min(index, bucket_count_ - 1);
+}
+
+void latency_histogram::record(std::chrono::nanoseconds value) noexcept {
+    const auto ns = static_cast<std::uint64_t>(std::max<std::int64_t>(value.count(), 0));
+
+    auto* counts = counts_.load(std::memory_order_acquire);
+    if (!counts && !(counts = allocate_counts())) {
+        return;  // Out of memory: drop the sample rather than fail the task
+    }
+
+    counts[index_of(ns)].fetch_add(1, std::memory_order_relaxed);
+    sum_.fetch_add(ns, std::memory_order_relaxed);
+    update_min(min_, ns);
+    update_max(max_, ns);
+}
+
+void latency_histogram::merge_into(latency_snapshot& snapshot) const {
+    const auto* counts = counts_.load(std::memory_order_acquire);
+    if (!counts) {
+        return;
+    }
+
+    if (snapshot.counts_.empty()) {
+        snapshot.sub_bucket_bits_ = sub_bucket_bits_;
+    }
+    if (snapshot.counts_.size() < bucket_count_) {
+        snapshot.counts_.resize(bucket_count_, 0);
+    }
+
+    // Take count from the buckets so percentiles always add up
+    std::uint64_t added = 0;
+    for (std::size_t i = 0; i < bucket_count_; ++i) {
+        const auto n = counts[i].load(std::memory_order_relaxed);
+        snapshot.counts_[i] += n;
+        added += n;
+    }
+    if (added == 0) {
+        return;
+    }
+
+    const auto min = min_.load(std::memory_order_relaxed);
+    const auto max = max_.load(std::memory_order_relaxed);
+    snapshot.min_ = snapshot.count_ ? std::min(snapshot.min_, min) : min;
+    snapshot.max_ = std::max(snapshot.max_, max);
+    snapshot.count_ += added;
+    snapshot.sum_ += sum_.load(std::memory_order_relaxed);
+
+    // A record() racing with this merge may not have published min/max yet
+    snapshot.min_ = std::min(snapshot.min_, snapshot.max_);
+}
+
+latency_snapshot latency_histogram::snapshot() const {
+    latency_snapshot result;
+    merge_into(result);
+    return result;
+}
+
+void latency_histogram::reset() noexcept {
+    if (auto* counts = counts_.load(std::memory_order_acquire)) {
+        for (std::size_t i = 0; i < bucket_count_; ++i) {
+            counts[i].store(0, std::memory_order_relaxed);
+        }
+    }
+    sum_.store(0, std::memory_order_relaxed);
+    min_.store(std::numeric_limits<std::uint64_t>::max(), std::memory_order_relaxed);
+    max_.store(0, std::memory_order_relaxed);
+}
+
+} // namespace kcenon::integrated
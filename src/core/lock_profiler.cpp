@@ -0,0 +1,110 @@
+// BSD 3-Clause License
+// Copyright (c) 2025, kcenon
+// See the LICENSE file in the project root for full license information.
+
+#include <kcenon/integrated/core/lock_profiler.h>
+#include <kcenon/integrated/core/prometheus_writer.h>
+
+#include <algorithm>
+#include <bit>
+#include <iterator>
+#include <utility>
+
+namespace kcenon::integrated {
+
+lock_profile::lock_profile(std::string name, std::uint64_t hold_sample_mask, unsigned precision_digits)
+    : name_(std::move(name))
+    , hold_sample_mask_(hold_sample_mask)
+    , wait_(precision_digits)
+    , hold_(precision_digits) {}
+
+struct lock_profiler::merged {
+    const std::string* name;
+    std::uint64_t acquisitions;
+    std::uint64_t contended;
+    latency_snapshot wait;
+    latency_snapshot hold;
+};
+
+lock_profiler::lock_profiler(std::size_t hold_sample_interval, unsigned precision_digits)
+    : hold_sample_mask_(std::bit_ceil(std::max<std::uint64_t>(hold_sample_interval, 1)) - 1)
+    , precision_digits_(precision_digits) {}
+
+lock_profiler::~lock_profiler() = default;
+
+lock_profile* lock_profiler::add(std::string name) {
+    profiles_.push_back(std::make_unique<lock_profile>(std::move(name), hold_sample_mask_, precision_digits_));
+    return profiles_.back().get();
+}
+
+std::vector<lock_profiler::merged> lock_profiler::merge() const {
+    std::vector<merged> result;
+    for (const auto& profile : profiles_) {
+        auto it = std::find_if(result.begin(), result.end(),
+                               [&profile](const merged& m) { return *m.name == profile->name(); });
+        if (it == result.end()) {
+            result.push_back({&profile->name(), 0, 0, {}, {}});
+            it = std::prev(result.end());
+        }
+        it->acquisitions += profile->acquisitions_.load(std::memory_order_relaxed);
+        it->contended += profile->contended_.load(std::memory_order_relaxed);
+        profile->wait_.merge_into(it->wait);
+        profile->hold_.merge_into(it->hold);
+    }
+    return result;
+}
+
+std::vector<lock_contention> lock_profiler::snapshot() const {
+    std::vector<lock_contention> result;
+    for (const auto& entry : merge()) {
+        result.push_back({*entry.name, entry.acquisitions, entry.contended,
+                          latency_summary::from(entry.wait), latency_summary::from(entry.hold)});
+    }
+    return result;
+}
+
+void lock_profiler::write_prometheus(prometheus_writer& writer, std::string_view pool) const {
+    const auto locks = merge();
+
+    writer.family("lock_acquisitions", metric_type::counter, "Times each lock was acquired");
+    for (const auto& entry : locks) {
+        writer.counter("lock_acquisitions", {{"pool", pool}, {"lock", *entry.name}}, entry.acquisitions);
+    }
+    writer.family("lock_contended_acquisitions", metric_type::counter,
+                  "Acquisitions that found the lock held and had to wait");
+    for (const auto& entry : locks) {
+        writer.counter("lock_contended_acquisitions", {{"pool", pool}, {"lock", *entry.name}}, entry.contended);
+    }
+    writer.family("lock_wait_seconds", metric_type::histogram, "Time contended acquisitions waited for the lock");
+    for (const auto& entry : locks) {
+        writer.histogram("lock_wait_seconds", {{"pool", pool}, {"lock", *entry.name}}, entry.wait,
+                         lock_time_buckets);
+    }
+    writer.family("lock_hold_seconds", metric_type::histogram,
+                  "Time the lock was held, over a sample of acquisitions");
+    for (const auto& entry : locks) {
+        writer.histogram("lock_hold_seconds", {{"pool", pool}, {"lock", *entry.name}}, entry.hold,
+                         lock_time_buckets);
+    }
+}
+
+void write_lock_contention_json(std::ostream& out, std::span<const lock_contention> locks, int indent) {
+    const std::string pad(static_cast<std::size_t>(std::max(indent, 0)), ' ');
+
+    out << "[";
+    for (std::size_t i = 0; i < locks.size(); ++i) {
+        const auto& entry = locks[i];
+        out << (i == 0 ? "\n" : ",\n");
+        out << pad << "  {\"lock\": \"" << entry.name << "\""
+            << ", \"acquisitions\": " << entry.acquisitions
+            << ", \"contended\": " << entry.contended
+            << ", \"wait\": ";
+        write_latency_summary_json(out, entry.wait);
+        out << ", \"hold\": ";
+        write_latency_summary_json(out, entry.hold);
+        out << "}";
+    }
+    out << (locks.empty() ? "]" : "\n" + pad + "]");
+}
+
+} // namespace kcenon::integrated
@@ -0,0 +1,246 @@
+// BSD 3-Clause License
+// Copyright (c) 2025, kcenon
+// See the LICENSE file in the project root for full license information.
+
+#include <kcenon/integrated/core/metric_registry.h>
+
+#include <algorithm>
+#include <cctype>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace kcenon::integrated {
+
+namespace {
+
+bool valid_name(std::string_view name, bool allow_colon) {
+    if (name.empty()) {
+        return false;
+    }
+    for (std::size_t i = 0; i < name.size(); ++i) {
+        const auto c = static_cast<unsigned char>(name[i]);
+        const bool ok = std::isalpha(c) || c == '_' || (allow_colon && c == ':') || (i > 0 && std::isdigit(c));
+        if (!ok) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template<typename T>
+common::Result<T> invalid(std::string message) {
+    return common::Result<T>::err(common::error_codes::INVALID_ARGUMENT, std::move(message));
+}
+
+struct series {
+    rendered_labels labels;
+    std::unique_ptr<sharded_counter> counter;
+    std::atomic<double> gauge{0.0};
+    detail::histogram_cells histogram;
+};
+
+struct family {
+    std::string name;
+    std::string help;
+    metric_type type;
+    std::vector<double> bounds;  // Histograms only
+
+    std::deque<series> entries;  // Stable addresses for handles
+    std::unordered_map<std::string, series*> by_labels;
+    series* overflow = nullptr;
+};
+
+} // namespace
+
+class metric_registry::impl {
+public:
+    impl(std::string pool, std::size_t max_series)
+        : pool_(std::move(pool)), max_series_(std::max<std::size_t>(max_series, 1)) {}
+
+    common::Result<series*> find_or_add(std::string_view name, metric_type type, metric_labels labels,
+                                        std::span<const double> bounds, std::string_view help) {
+        if (!valid_name(name, true)) {
+            return invalid<series*>("Invalid metric name '" + std::string(name) + "'");
+        }
+        for (const auto& label : labels) {
+            if (!valid_name(label.name, false) || label.name.starts_with("__") || label.name == "pool" ||
+                (type == metric_type::histogram && label.name == "le")) {
+                return invalid<series*>("Invalid or reserved label '" + std::string(label.name) +
+                                        "' on metric '" + std::string(name) + "'");
+            }
+        }
+
+        std::vector<metric_label> all_labels;
+        all_labels.reserve(labels.size() + 1);
+        all_labels.push_back({"pool", pool_});
+        all_labels.insert(all_labels.end(), labels.begin(), labels.end());
+        rendered_labels rendered(all_labels);
+
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        auto it = families_.find(name);
+        if (it == families_.end()) {
+            if (type == metric_type::histogram) {
+                if (bounds.size() > max_histogram_buckets || !std::is_sorted(bounds.begin(), bounds.end())) {
+                    return invalid<series*>("Histogram '" + std::string(name) +
+                                            "' needs at most 64 ascending bounds");
+                }
+            }
+            auto created = std::make_unique<family>();
+            created->name = std::string(name);
+            created->help = help.empty() ? std::string(name) : std::string(help);
+            created->type = type;
+            if (type == metric_type::histogram) {
+                created->bounds.assign(bounds.begin(), bounds.end());
+            }
+            it = families_.emplace(created->name, std::move(created)).first;
+        }
+
+        family& target = *it->second;
+        if (target.type != type) {
+            return invalid<series*>("Metric '" + std::string(name) + "' is already registered with another type");
+        }
+        if (type == metric_type::histogram &&
+            !std::equal(bounds.begin(), bounds.end(), target.bounds.begin(), target.bounds.end())) {
+            return invalid<series*>("Histogram '" + std::string(name) + "' is already registered with other bounds");
+        }
+
+        const std::string key(rendered.view());
+        if (const auto existing = target.by_labels.find(key); existing != target.by_labels.end()) {
+            return common::Result<series*>::ok(existing->second);
+        }
+
+        if (target.by_labels.size() >= max_series_) {
+            ++rejected_;
+            if (!target.overflow) {
+                all_labels.resize(1);
+                all_labels.push_back({"overflow", "true"});
+                target.overflow = &add_series(target, rendered_labels(all_labels));
+            }
+            return common::Result<series*>::ok(target.overflow);
+        }
+
+        series& added = add_series(target, std::move(rendered));
+        target.by_labels.emplace(key, &added);
+        return common::Result<series*>::ok(&added);
+    }
+
+    void write(prometheus_writer& writer) const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::array<std::uint64_t, max_histogram_buckets + 1> counts{};
+
+        for (const auto& [name, target] : families_) {
+            writer.family(name, target->type, target->help);
+            for (const auto& entry : target->entries) {
+                switch (target->type) {
+                    case metric_type::counter:
+                        writer.counter(name, entry.labels, entry.counter->value());
+                        break;
+                    case metric_type::gauge:
+                        writer.gauge(name, entry.labels, entry.gauge.load(std::memory_order_relaxed));
+                        break;
+                    case metric_type::histogram: {
+                        const std::size_t buckets = target->bounds.size() + 1;
+                        for (std::size_t i = 0; i < buckets; ++i) {
+                            counts[i] = entry.histogram.counts[i].load(std::memory_order_relaxed);
+                        }
+                        writer.histogram(name, entry.labels, target->bounds,
+                                         std::span<const std::uint64_t>(counts).first(buckets),
+                                         entry.histogram.sum.load(std::memory_order_relaxed));
+                        break;
+                    }
+                }
+            }
+        }
+    }
+
+    std::size_t series_count() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::size_t count = 0;
+        for (const auto& [name, target] : families_) {
+            count += target->entries.size();
+        }
+        return count;
+    }
+
+    std::uint64_t rejected_series() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return rejected_;
+    }
+
+private:
+    series& add_series(family& target, rendered_labels labels) {
+        series& added = target.entries.emplace_back();
+        added.labels = std::move(labels);
+        switch (target.type) {
+            case metric_type::counter:
+                added.counter = std::make_unique<sharded_counter>();
+                break;
+            case metric_type::gauge:
+                break;
+            case metric_type::histogram:
+                added.histogram.bounds = target.bounds;
+                added.histogram.counts = std::make_unique<std::atomic<std::uint64_t>[]>(target.bounds.size() + 1);
+                break;
+        }
+        return added;
+    }
+
+    std::string pool_;
+    std::size_t max_series_;
+
+    mutable std::mutex mutex_;
+    std::map<std::string, std::unique_ptr<family>, std::less<>> families_;
+    std::uint64_t rejected_ = 0;
+};
+
+metric_registry::metric_registry(std::string pool, std::size_t max_series_per_family)
+    : pimpl_(std::make_unique<impl>(std::move(pool), max_series_per_family)) {
+}
+
+metric_registry::~metric_registry() = default;
+
+common::Result<counter_handle> metric_registry::register_counter(std::string_view name, metric_labels labels,
+                                                                 std::string_view help) {
+    auto found = pimpl_->find_or_add(name, metric_type::counter, labels, {}, help);
+    if (found.is_err()) {
+        return common::Result<counter_handle>::err(found.error().code, found.error().message);
+    }
+    return common::Result<counter_handle>::ok(counter_handle(found.value()->counter.get()));
+}
+
+common::Result<gauge_handle> metric_registry::register_gauge(std::string_view name, metric_labels labels,
+                                                             std::string_view help) {
+    auto found = pimpl_->find_or_add(name, metric_type::gauge, labels, {}, help);
+    if (found.is_err()) {
+        return common::Result<gauge_handle>::err(found.error().code, found.error().message);
+    }
+    return common::Result<gauge_handle>::ok(gauge_handle(&found.value()->gauge));
+}
+
+common::Result<histogram_handle> metric_registry::register_histogram(std::string_view name, metric_labels labels,
+                                                                     std::span<const double> bounds,
+                                                                     std::string_view help) {
+    auto found = pimpl_->find_or_add(name, metric_type::histogram, labels, bounds, help);
+    if (found.is_err()) {
+        return common::Result<histogram_handle>::err(found.error().code, found.error().message);
+    }
+    return common::Result<histogram_handle>::ok(histogram_handle(&found.value()->histogram));
+}
+
+void metric_registry::write(prometheus_writer& writer) const {
+    pimpl_->write(writer);
+}
+
+std::size_t metric_registry::series_count() const {
+    return pimpl_->series_count();
+}
+
+std::uint64_t metric_registry::rejected_series() const {
+    return pimpl_->rejected_series();
+}
+
+} // namespace kcenon::integrated
@@ -0,0 +1,472 @@
+// BSD 3-Clause License
+// Copyright (c) 2025, kcenon
+// See the LICENSE file in the project root for full license information.
+
+#include <kcenon/integrated/core/perf_counters.h>
+#include <kcenon/integrated/core/prometheus_writer.h>
+#include <kcenon/integrated/core/task_latency.h>
+
+#include "core/json_format.h"
+
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace kcenon::integrated {
+
+namespace {
+
+using detail::write_json_string;
+
+std::atomic<std::uint64_t> next_instance{1};
+
+constexpr std::size_t hardware_event_count = 4;
+constexpr std::uint8_t software_events =
+    (1u << static_cast<unsigned>(perf_event::context_switches)) |
+    (1u << static_cast<unsigned>(perf_event::cpu_time_ns));
+
+#if defined(__linux__)
+constexpr std::array<std::uint64_t, hardware_event_count> hardware_configs{
+    PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+    PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES};
+
+// User-space counts of the calling thread on any CPU, read as one group
+int open_counter(std::uint64_t config, int group_fd) {
+    perf_event_attr attr{};
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = config;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP;
+    return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, group_fd, PERF_FLAG_FD_CLOEXEC));
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+inline std::uint64_t read_pmc(std::uint32_t counter) noexcept {
+    std::uint32_t low = 0;
+    std::uint32_t high = 0;
+    asm volatile("rdpmc" : "=a"(low), "=d"(high) : "c"(counter));
+    return low | (static_cast<std::uint64_t>(high) << 32);
+}
+
+// The self-monitoring protocol of perf_event_mmap_page: retry while the
+// kernel updates the page, and give up when the event is not on a counter
+bool read_mapped(const void* mapped, std::uint64_t& value) noexcept {
+    const volatile auto* page = static_cast<const volatile perf_event_mmap_page*>(mapped);
+    std::uint32_t sequence = 0;
+    std::uint64_t count = 0;
+    do {
+        sequence = page->lock;
+        std::atomic_signal_fence(std::memory_order_acq_rel);
+        const std::uint32_t index = page->index;
+        if (!page->cap_user_rdpmc || index == 0) {
+            return false;
+        }
+        const unsigned width = page->pmc_width;
+        auto pmc = static_cast<std::int64_t>(read_pmc(index - 1));
+        pmc = (pmc << (64 - width)) >> (64 - width);  // Sign-extend from the counter width
+        count = page->offset + static_cast<std::uint64_t>(pmc);
+        std::atomic_signal_fence(std::memory_order_acq_rel);
+    } while (page->lock != sequence);
+    value = count;
+    return true;
+}
+#else
+bool read_mapped(const void*, std::uint64_t&) noexcept {
+    return false;
+}
+#endif
+#endif
+
+} // namespace
+
+const char* perf_event_name(perf_event event) {
+    switch (event) {
+        case perf_event::cycles: return "cycles";
+        case perf_event::instructions: return "instructions";
+        case perf_event::llc_misses: return "llc_misses";
+        case perf_event::branch_misses: return "branch_misses";
+        case perf_event::context_switches: return "context_switches";
+        case perf_event::cpu_time_ns: return "cpu_time_ns";
+    }
+    return "unknown";
+}
+
+const char* perf_counter_source_name(perf_counter_source source) {
+    switch (source) {
+        case perf_counter_source::none: return "none";
+        case perf_counter_source::software: return "software";
+        case perf_counter_source::read: return "read";
+        case perf_counter_source::rdpmc: return "rdpmc";
+    }
+    return "unknown";
+}
+
+perf_counter_group::perf_counter_group() {
+#if defined(__linux__)
+    source_ = perf_counter_source::software;
+    available_ = software_events;
+
+    group_fd_ = open_counter(hardware_configs[0], -1);
+    if (group_fd_ < 0) {
+        return;
+    }
+    fds_[0] = group_fd_;
+    available_ |= 1u;
+    // A member the CPU cannot count is left out rather than failing the group
+    for (std::size_t i = 1; i < hardware_event_count; ++i) {
+        fds_[i] = open_counter(hardware_configs[i], group_fd_);
+        if (fds_[i] >= 0) {
+            available_ |= static_cast<std::uint8_t>(1u << i);
+        }
+    }
+
+    source_ = perf_counter_source::read;
+    const long page_size = sysconf(_SC_PAGESIZE);
+    bool mapped = page_size > 0;
+    for (std::size_t i = 0; i < hardware_event_count && mapped; ++i) {
+        if (fds_[i] < 0) {
+            continue;
+        }
+        void* page = mmap(nullptr, static_cast<std::size_t>(page_size), PROT_READ, MAP_SHARED, fds_[i], 0);
+        if (page == MAP_FAILED) {
+            mapped = false;
+            break;
+        }
+        pages_[i] = page;
+    }
+    std::uint64_t probe = 0;
+    if (mapped && read_mapped(pages_[0], probe)) {
+        source_ = perf_counter_source::rdpmc;
+    }
+#endif
+}
+
+perf_counter_group::~perf_counter_group() {
+#if defined(__linux__)
+    const long page_size = sysconf(_SC_PAGESIZE);
+    for (std::size_t i = 0; i < hardware_event_count; ++i) {
+        if (pages_[i]) {
+            munmap(pages_[i], static_cast<std::size_t>(page_size));
+        }
+    }
+    // Members first; closing the leader would orphan them into groups of their own
+    for (std::size_t i = hardware_event_count; i-- > 0;) {
+        if (fds_[i] >= 0) {
+            close(fds_[i]);
+        }
+    }
+#endif
+}
+
+perf_counter_group& perf_counter_group::this_thread() {
+    thread_local perf_counter_group group;
+    return group;
+}
+
+perf_reading perf_counter_group::read() noexcept {
+    perf_reading reading;
+#if defined(__linux__)
+    if (group_fd_ >= 0) {
+        read_hardware(reading);
+    }
+    rusage usage{};
+    if (getrusage(RUSAGE_THREAD, &usage) == 0) {
+        reading.values[static_cast<std::size_t>(perf_event::context_switches)] =
+            static_cast<std::uint64_t>(usage.ru_nvcsw + usage.ru_nivcsw);
+        const auto cpu = std::chrono::seconds(usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) +
+                         std::chrono::microseconds(usage.ru_utime.tv_usec + usage.ru_stime.tv_usec);
+        reading.values[static_cast<std::size_t>(perf_event::cpu_time_ns)] =
+            static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(cpu).count());
+    }
+#endif
+    return reading;
+}
+
+bool perf_counter_group::read_hardware(perf_reading& reading) noexcept {
+#if defined(__linux__)
+    if (source_ == perf_counter_source::rdpmc) {
+        bool complete = true;
+        for (std::size_t i = 0; i < hardware_event_count && complete; ++i) {
+            if (fds_[i] >= 0) {
+                complete = read_mapped(pages_[i], reading.values[i]);
+            }
+        }
+        if (complete) {
+            return true;
+        }
+        // The group is not on the counters right now; the kernel has the totals
+    }
+
+    // PERF_FORMAT_GROUP: the member count, then one value per member in open order
+    std::array<std::uint64_t, 1 + hardware_event_count> buffer{};
+    const ssize_t size = ::read(group_fd_, buffer.data(), sizeof(buffer));
+    if (size < static_cast<ssize_t>(sizeof(std::uint64_t))) {
+        return false;
+    }
+    std::size_t member = 1;
+    for (std::size_t i = 0; i < hardware_event_count; ++i) {
+        if (fds_[i] >= 0 && member <= buffer[0]) {
+            reading.values[i] = buffer[member++];
+        }
+    }
+    return true;
+#else
+    (void)reading;
+    return false;
+#endif
+}
+
+// Cells are indexed label * priority_lane_count + lane
+struct perf_profiler::shard {
+    struct cell {
+        std::atomic<std::uint64_t> tasks{0};
+        std::array<std::atomic<std::uint64_t>, perf_event_count> values{};
+    };
+
+    explicit shard(std::size_t cells) : table(std::make_unique<cell[]>(cells)) {}
+
+    std::unique_ptr<cell[]> table;           // Written by the owning thread only
+    perf_counter_group* counters = nullptr;  // The owning thread's group
+    std::uint8_t available = 0;
+    std::size_t countdown = 1;               // Tasks until the next measured one (owner only)
+};
+
+class perf_profiler::impl {
+public:
+    explicit impl(std::size_t max_labels) : max_labels_(max_labels) {
+        names_.push_back("default");
+    }
+
+    task_label label(std::string_view name) {
+        if (name.empty() || name == "default") {
+            return {};
+        }
+        if (name == "other") {
+            return {static_cast<std::uint16_t>(max_labels_ - 1)};
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        const std::string key(name);
+        if (const auto it = ids_.find(key); it != ids_.end()) {
+            return {it->second};
+        }
+        // The last id is kept for "other"
+        if (names_.size() + 1 >= max_labels_) {
+            return {static_cast<std::uint16_t>(max_labels_ - 1)};
+        }
+        const auto id = static_cast<std::uint16_t>(names_.size());
+        names_.push_back(key);
+        ids_.emplace(key, id);
+        return {id};
+    }
+
+    shard* find_or_add() {
+        const auto id = std::this_thread::get_id();
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (const auto it = by_thread_.find(id); it != by_thread_.end()) {
+            // A reused thread id: the shard's previous owner has exited
+            shard* reused = shards_[it->second].get();
+            reused->counters = &perf_counter_group::this_thread();
+            reused->available = reused->counters->available();
+            reused->countdown = 1;
+            return reused;
+        }
+
+        auto created = std::make_unique<shard>(max_labels_ * priority_lane_count);
+        created->counters = &perf_counter_group::this_thread();
+        created->available = created->counters->available();
+        by_thread_.emplace(id, shards_.size());
+        shards_.push_back(std::move(created));
+        return shards_.back().get();
+    }
+
+    std::vector<task_counters> snapshot() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const std::size_t cells = max_labels_ * priority_lane_count;
+
+        std::vector<task_counters> merged(cells);
+        for (auto& entry : merged) {
+            entry.available = 0xFF;
+        }
+        for (const auto& source : shards_) {
+            for (std::size_t i = 0; i < cells; ++i) {
+                const auto& cell = source->table[i];
+                const std::uint64_t tasks = cell.tasks.load(std::memory_order_relaxed);
+                if (tasks == 0) {
+                    continue;
+                }
+                merged[i].tasks += tasks;
+                merged[i].available &= source->available;
+                for (std::size_t event = 0; event < perf_event_count; ++event) {
+                    merged[i].values[event] += cell.values[event].load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+        std::vector<task_counters> result;
+        for (std::size_t i = 0; i < cells; ++i) {
+            if (merged[i].tasks == 0) {
+                continue;
+            }
+            const std::size_t label = i / priority_lane_count;
+            merged[i].label = label + 1 == max_labels_ ? "other" : names_[label];
+            merged[i].lane = priority_lane_name(i % priority_lane_count);
+            result.push_back(std::move(merged[i]));
+        }
+        return result;
+    }
+
+private:
+    const std::size_t max_labels_;
+    mutable std::mutex mutex_;
+    std::vector<std::string> names_;  // Index = task_label::id
+    std::unordered_map<std::string, std::uint16_t> ids_;
+    std::vector<std::unique_ptr<shard>> shards_;
+    std::unordered_map<std::thread::id, std::size_t> by_thread_;
+};
+
+perf_profiler::perf_profiler(std::size_t max_labels, std::size_t sample_interval)
+    : instance_(next_instance.fetch_add(1, std::memory_order_relaxed))
+    , max_labels_(std::clamp<std::size_t>(max_labels, 2, 1u << 16))
+    , sample_interval_(std::max<std::size_t>(sample_interval, 1)) {
+    pimpl_ = std::make_unique<impl>(max_labels_);
+}
+
+perf_profiler::~perf_profiler() = default;
+
+task_label perf_profiler::label(std::string_view name) {
+    return pimpl_->label(name);
+}
+
+perf_profiler::shard* perf_profiler::attach(thread_state& local) noexcept {
+    shard* found = nullptr;
+    try {
+        found = pimpl_->find_or_add();
+    } catch (...) {
+        // Out of memory: this thread measures nothing
+    }
+    local.profiler = instance_;
+    local.current = found;
+    return found;
+}
+
+perf_profiler::measurement perf_profiler::begin() noexcept {
+    measurement started;
+    shard* target = local_shard();
+    if (!target || --target->countdown > 0) {
+        return started;
+    }
+    target->countdown = sample_interval_;
+    started.start = target->counters->read();
+    started.active = true;
+    return started;
+}
+
+void perf_profiler::end(const measurement& started, task_label label, int priority) noexcept {
+    if (!started.active) {
+        return;
+    }
+    shard* target = local_shard();
+    if (!target) {
+        return;
+    }
+    const perf_reading finished = target->counters->read();
+
+    const std::size_t row = std::min<std::size_t>(label.id, max_labels_ - 1);
+    auto& cell = target->table[row * priority_lane_count + priority_lane(priority)];
+    cell.tasks.store(cell.tasks.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    for (std::size_t event = 0; event < perf_event_count; ++event) {
+        const std::uint64_t before = started.start.values[event];
+        const std::uint64_t after = finished.values[event];
+        if (after > before) {
+            auto& total = cell.values[event];
+            total.store(total.load(std::memory_order_relaxed) + (after - before), std::memory_order_relaxed);
+        }
+    }
+}
+
+std::vector<task_counters> perf_profiler::snapshot() const {
+    return pimpl_->snapshot();
+}
+
+void perf_profiler::write_prometheus(prometheus_writer& writer, std::string_view pool) const {
+    const auto cells = snapshot();
+
+    writer.family("task_perf_samples", metric_type::counter, "Tasks measured with performance counters");
+    for (const auto& entry : cells) {
+        writer.counter("task_perf_samples",
+                       {{"pool", pool}, {"label", entry.label}, {"priority", entry.lane}}, entry.tasks);
+    }
+
+    const struct {
+        perf_event event;
+        const char* name;
+        const char* help;
+    } families[] = {
+        {perf_event::cycles, "task_cycles", "CPU cycles in user space while measured tasks ran"},
+        {perf_event::instructions, "task_instructions", "Instructions retired in user space by measured tasks"},
+        {perf_event::llc_misses, "task_llc_misses", "Last-level cache misses of measured tasks"},
+        {perf_event::branch_misses, "task_branch_misses", "Mispredicted branches of measured tasks"},
+        {perf_event::context_switches, "task_context_switches", "Context switches while measured tasks ran"},
+        {perf_event::cpu_time_ns, "task_cpu_seconds", "CPU time of measured tasks"}};
+
+    for (const auto& [event, name, help] : families) {
+        const bool any = std::any_of(cells.begin(), cells.end(),
+                                     [event](const task_counters& entry) { return entry.has(event); });
+        if (!any) {
+            continue;
+        }
+        writer.family(name, metric_type::counter, help);
+        for (const auto& entry : cells) {
+            if (!entry.has(event)) {
+                continue;
+            }
+            const metric_labels labels = {{"pool", pool}, {"label", entry.label}, {"priority", entry.lane}};
+            if (event == perf_event::cpu_time_ns) {
+                writer.counter(name, labels, std::chrono::nanoseconds(entry[event]));
+            } else {
+                writer.counter(name, labels, entry[event]);
+            }
+        }
+    }
+}
+
+void write_task_counters_json(std::ostream& out, std::span<const task_counters> counters, int indent) {
+    const std::string pad(static_cast<std::size_t>(std::max(indent, 0)), ' ');
+
+    out << "[";
+    for (std::size_t i = 0; i < counters.size(); ++i) {
+        const auto& entry = counters[i];
+        out << (i == 0 ? "\n" : ",\n");
+        out << pad << "  {\"label\": ";
+        write_json_string(out, entry.label);
+        out << ", \"priority\": \"" << entry.lane << "\""
+            << ", \"tasks\": " << entry.tasks;
+        for (std::size_t event = 0; event < perf_event_count; ++event) {
+            const auto kind = static_cast<perf_event>(event);
+            if (entry.has(kind)) {
+                out << ", \"" << perf_event_name(kind) << "\": " << entry[kind];
+            }
+        }
+        if (entry.has(perf_event::cycles)) {
+            out << ", \"ipc\": " << entry.ipc()
+                << ", \"llc_mpki\": " << entry.llc_mpki()
+                << ", \"branch_mpki\": " << entry.branch_mpki();
+        }
+        out << "}";
+    }
+    out << (counters.empty() ? "]" : "\n" + pad + "]");
+}
+
+} // namespace kcenon::integrated
@@ -0,0 +1,288 @@
+// BSD 3-Clause License
+// Copyright (c) 2025, kcenon
+// See the LICENSE file in the project root for full license information.
+
+#include <kcenon/integrated/core/prometheus_writer.h>
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+
+namespace kcenon::integrated {
+
+namespace {
+
+constexpr std::size_t max_number_length = 32;
+
+double to_seconds(std::chrono::nanoseconds value) {
+    return static_cast<double>(value.count()) / 1e9;
+}
+
+std::string_view type_name(metric_type type) {
+    switch (type) {
+        case metric_type::counter: return "counter";
+        case metric_type::gauge: return "gauge";
+        case metric_type::histogram: return "histogram";
+    }
+    return "untyped";
+}
+
+// Shortest round-trip representation in %g style (0.0001, 1e-05); Prometheus spells the specials +Inf / -Inf / NaN
+std::string_view format_number(double value, std::array<char, max_number_length>& storage) {
+    if (std::isnan(value)) {
+        return "NaN";
+    }
+    if (std::isinf(value)) {
+        return value > 0 ? "+Inf" : "-Inf";
+    }
+    const auto result = std::to_chars(storage.data(), storage.data() + storage.size(), value,
+                                      std::chars_format::general);
+    return {storage.data(), static_cast<std::size_t>(result.ptr - storage.data())};
+}
+
+// Label values escape backslash, double quote and newline
+void append_escaped(std::string& out, std::string_view value) {
+    for (char c : value) {
+        switch (c) {
+            case '\\': out += "\\\\"; break;
+            case '"': out += "\\\""; break;
+            case '\n': out += "\\n"; break;
+            default: out += c; break;
+        }
+    }
+}
+
+} // namespace
+
+rendered_labels::rendered_labels(std::span<const metric_label> labels) {
+    for (const auto& label : labels) {
+        if (!text_.empty()) {
+            text_ += ',';
+        }
+        text_ += label.name;
+        text_ += "=\"";
+        append_escaped(text_, label.value);
+        text_ += '"';
+    }
+}
+
+prometheus_writer::prometheus_writer(exposition_format format)
+    : format_(format) {
+}
+
+void prometheus_writer::reset() {
+    buffer_.clear();
+    finished_ = false;
+}
+
+void prometheus_writer::reset(exposition_format format) {
+    reset();
+    format_ = format;
+}
+
+std::string_view prometheus_writer::content_type(exposition_format format) noexcept {
+    return format == exposition_format::openmetrics
+        ? "application/openmetrics-text; version=1.0.0; charset=utf-8"
+        : "text/plain; version=0.0.4; charset=utf-8";
+}
+
+void prometheus_writer::family(std::string_view name, metric_type type, std::string_view help) {
+    // OpenMetrics names the counter family without _total; the text format
+    // conventionally declares the sample name
+    const bool total_suffix = type == metric_type::counter &&
+                              format_ == exposition_format::prometheus_text;
+
+    buffer_ += "# HELP ";
+    buffer_ += name;
+    if (total_suffix) {
+        buffer_ += "_total";
+    }
+    buffer_ += ' ';
+    // HELP text escapes backslash and newline
+    for (char c : help) {
+        if (c == '\\') {
+            buffer_ += "\\\\";
+        } else if (c == '\n') {
+            buffer_ += "\\n";
+        } else {
+            buffer_ += c;
+        }
+    }
+    buffer_ += '\n';
+
+    buffer_ += "# TYPE ";
+    buffer_ += name;
+    if (total_suffix) {
+        buffer_ += "_total";
+    }
+    buffer_ += ' ';
+    buffer_ += type_name(type);
+    buffer_ += '\n';
+}
+
+void prometheus_writer::gauge(std::string_view name, metric_labels labels, double value) {
+    append_sample_name(name, {});
+    append_labels(labels);
+    append_value(value);
+}
+
+void prometheus_writer::counter(std::string_view name, metric_labels labels, std::uint64_t value) {
+    append_sample_name(name, "_total");
+    append_labels(labels);
+    append_value(value);
+}
+
+void prometheus_writer::counter(std::string_view name, metric_labels labels, std::chrono::nanoseconds value) {
+    append_sample_name(name, "_total");
+    append_labels(labels);
+    append_value(to_seconds(value));
+}
+
+void prometheus_writer::histogram(std::string_view name, metric_labels labels,
+                                  const latency_snapshot& snapshot,
+                                  std::span<const std::chrono::nanoseconds> bounds) {
+    std::array<std::uint64_t, 64> cumulative{};
+    bounds = bounds.first(std::min(bounds.size(), cumulative.size()));
+    snapshot.cumulative_counts(bounds, std::span<std::uint64_t>(cumulative).first(bounds.size()));
+
+    std::array<char, max_number_length> storage;
+    for (std::size_t i = 0; i < bounds.size(); ++i) {
+        append_sample_name(name, "_bucket");
+        append_labels(labels, "le", format_number(to_seconds(bounds[i]), storage));
+        append_value(cumulative[i]);
+    }
+    append_sample_name(name, "_bucket");
+    append_labels(labels, "le", "+Inf");
+    append_value(snapshot.count());
+
+    append_sample_name(name, "_sum");
+    append_labels(labels);
+    append_value(to_seconds(snapshot.sum()));
+
+    append_sample_name(name, "_count");
+    append_labels(labels);
+    append_value(snapshot.count());
+}
+
+void prometheus_writer::gauge(std::string_view name, const rendered_labels& labels, double value) {
+    append_sample_name(name, {});
+    append_labels(labels.view());
+    append_value(value);
+}
+
+void prometheus_writer::counter(std::string_view name, const rendered_labels& labels, std::uint64_t value) {
+    append_sample_name(name, "_total");
+    append_labels(labels.view());
+    append_value(value);
+}
+
+void prometheus_writer::histogram(std::string_view name, const rendered_labels& labels,
+                                  std::span<const double> bounds, std::span<const std::uint64_t> counts,
+                                  double sum) {
+    std::array<char, max_number_length> storage;
+    std::uint64_t cumulative = 0;
+    for (std::size_t i = 0; i < bounds.size() && i < counts.size(); ++i) {
+        cumulative += counts[i];
+        append_sample_name(name, "_bucket");
+        append_labels(labels.view(), "le", format_number(bounds[i], storage));
+        append_value(cumulative);
+    }
+    if (counts.size() > bounds.size()) {
+        cumulative += counts[bounds.size()];
+    }
+    append_sample_name(name, "_bucket");
+    append_labels(labels.view(), "le", "+Inf");
+    append_value(cumulative);
+
+    append_sample_name(name, "_sum");
+    append_labels(labels.view());
+    append_value(sum);
+
+    append_sample_name(name, "_count");
+    append_labels(labels.view());
+    append_value(cumulative);
+}
+
+std::string_view prometheus_writer::finish() {
+    if (!finished_ && format_ == exposition_format::openmetrics) {
+        buffer_ += "# EOF\n";
+    }
+    finished_ = true;
+    return buffer_;
+}
+
+void prometheus_writer::append_sample_name(std::string_view name, std::string_view suffix) {
+    buffer_ += name;
+    buffer_ += suffix;
+}
+
+void prometheus_writer::append_labels(metric_labels labels, std::string_view extra_name,
+                                      std::string_view extra_value) {
+    if (labels.size() == 0 && extra_name.empty()) {
+        return;
+    }
+
+    buffer_ += '{';
+    bool first = true;
+    for (const auto& label : labels) {
+        if (!first) {
+            buffer_ += ',';
+        }
+        first = false;
+        buffer_ += label.name;
+        buffer_ += "=\"";
+        append_label_value(label.value);
+        buffer_ += '"';
+    }
+    if (!extra_name.empty()) {
+        if (!first) {
+            buffer_ += ',';
+        }
+        buffer_ += extra_name;
+        buffer_ += "=\"";
+        append_label_value(extra_value);
+        buffer_ += '"';
+    }
+    buffer_ += '}';
+}
+
+void prometheus_writer::append_labels(std::string_view rendered, std::string_view extra_name,
+                                      std::string_view extra_value) {
+    if (rendered.empty() && extra_name.empty()) {
+        return;
+    }
+
+    buffer_ += '{';
+    buffer_ += rendered;
+    if (!extra_name.empty()) {
+        if (!rendered.empty()) {
+            buffer_ += ',';
+        }
+        buffer_ += extra_name;
+        buffer_ += "=\"";
+        append_label_value(extra_value);
+        buffer_ += '"';
+    }
+    buffer_ += '}';
+}
+
+void prometheus_writer::append_label_value(std::string_view value) {
+    append_escaped(buffer_, value);
+}
+
+void prometheus_writer::append_value(double value) {
+    std::array<char, max_number_length> storage;
+    buffer_ += ' ';
+    buffer_ += format_number(value, storage);
+    buffer_ += '\n';
+}
+
+void prometheus_writer::append_value(std::uint64_t value) {
+    std::array<char, max_number_length> storage;
+    const auto result = std::to_chars(storage.data(), storage.data() + storage.size(), value);
+    buffer_ += ' ';
+    buffer_.append(storage.data(), result.ptr);
+    buffer_ += '\n';
+}
+
+} // namespace kcenon::integrated
@@ -0,0 +1,142 @@
+// BSD 3-Clause License
+// Copyright (c) 2025, kcenon
+// See the LICENSE file in the project root for full license information.
+
+#include <kcenon/integrated/core/rate_meter.h>
+#include <kcenon/integrated/core/prometheus_writer.h>
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <utility>
+
+namespace kcenon::integrated {
+
+namespace {
+
+constexpr double tick_seconds =
+    std::chrono::duration<double>(rate_meter::tick_interval).count();
+
+constexpr double minutes(double count) {
+    return count * 60.0;
+}
+
+double alpha_for(double period_seconds) {
+    return 1.0 - std::exp(-tick_seconds / period_seconds);
+}
+
+} // namespace
+
+void write_rates_prometheus(prometheus_writer& writer, std::string_view pool,
+                            std::span<const named_rate> rates) {
+    writer.family("task_rate", metric_type::gauge, "Tasks per second");
+    for (const auto& [event, snapshot] : rates) {
+        const std::pair<const char*, double> windows[] = {
+            {"10s", snapshot.window_rate}, {"1m", snapshot.one_minute_rate},
+            {"5m", snapshot.five_minute_rate}, {"15m", snapshot.fifteen_minute_rate},
+            {"lifetime", snapshot.mean_rate}};
+        for (const auto& [window, value] : windows) {
+            writer.gauge("task_rate", {{"pool", pool}, {"event", event}, {"window", window}}, value);
+        }
+    }
+}
+
+void write_rates_json(std::ostream& out, std::span<const named_rate> rates, int indent) {
+    const std::string pad(static_cast<std::size_t>(std::max(indent, 0)), ' ');
+
+    out << "{";
+    for (std::size_t i = 0; i < rates.size(); ++i) {
+        const auto& [event, snapshot] = rates[i];
+        out << (i == 0 ? "\n" : ",\n");
+        out << pad << "  \"" << event << "\": {\"count\": " << snapshot.count
+            << ", \"10s\": " << snapshot.window_rate
+            << ", \"1m\": " << snapshot.one_minute_rate
+            << ", \"5m\": " << snapshot.five_minute_rate
+            << ", \"15m\": " << snapshot.fifteen_minute_rate
+            << ", \"lifetime\": " << snapshot.mean_rate << "}";
+    }
+    out << (rates.empty() ? "}" : "\n" + pad + "}");
+}
+
+rate_meter::rate_meter(clock::time_point start)
+    : start_(start)
+    , last_tick_(start.time_since_epoch().count())
+    , averages_{{{alpha_for(minutes(1))}, {alpha_for(minutes(5))}, {alpha_for(minutes(15))}}} {
+}
+
+void rate_meter::tick(clock::time_point now) noexcept {
+    const auto interval = std::chrono::duration_cast<clock::duration>(tick_interval).count();
+    const auto last = last_tick_.load(std::memory_order_acquire);
+    const auto elapsed = now.time_since_epoch().count() - last;
+    if (elapsed < interval) {
+        return;
+    }
+
+    if (ticking_.exchange(true, std::memory_order_acquire)) {
+        return;  // Another thread is ticking
+    }
+
+    // Re-check: a concurrent tick may have finished in between
+    const auto current = last_tick_.load(std::memory_order_relaxed);
+    const auto due = (now.time_since_epoch().count() - current) / interval;
+    if (due > 0) {
+        const auto total = total_.value();
+        const auto events = total - ticked_total_;
+        ticked_total_ = total;
+
+        // Spread the events over the missed ticks; beyond the longest average
+        // only the decay matters, so cap the catch-up work
+        const auto ticks = static_cast<std::uint64_t>(
+            std::min<clock::rep>(due, static_cast<clock::rep>(minutes(15) / tick_seconds)));
+        for (std::uint64_t i = 0; i < ticks; ++i) {
+            const auto share = events / ticks + (i < events % ticks ? 1 : 0);
+            fold(share);
+        }
+
+        last_tick_.store(current + due * interval, std::memory_order_release);
+    }
+
+    ticking_.store(false, std::memory_order_release);
+}
+
+void rate_meter::fold(std::uint64_t events_per_tick) noexcept {
+    const double instant = static_cast<double>(events_per_tick) / tick_seconds;
+
+    for (auto& average : averages_) {
+        if (!seeded_) {
+            average.rate.store(instant, std::memory_order_relaxed);
+            continue;
+        }
+        const double rate = average.rate.load(std::memory_order_relaxed);
+        average.rate.store(rate + average.alpha * (instant - rate), std::memory_order_relaxed);
+    }
+    seeded_ = true;
+
+    window_running_ += events_per_tick;
+    window_running_ -= window_[window_next_];
+    window_[window_next_] = events_per_tick;
+    window_next_ = (window_next_ + 1) % window_ticks;
+    window_filled_ = std::min(window_filled_ + 1, window_ticks);
+
+    window_rate_.store(static_cast<double>(window_running_) /
+                       (static_cast<double>(window_filled_) * tick_seconds),
+                       std::memory_order_relaxed);
+}
+
+rate_snapshot rate_meter::snapshot(clock::time_point now) const noexcept {
+    rate_snapshot result;
+    result.count = total_.value();
+
+    const double lifetime = std::chrono::duration<double>(now - start_).count();
+    if (lifetime > 0.0) {
+        result.mean_rate = static_cast<double>(result.count) / lifetime;
+    }
+
+    result.window_rate = window_rate_.load(std::memory_order_relaxed);
+    result.one_minute_rate = averages_[0].rate.load(std::memory_order_relaxed);
+    result.five_minute_rate = averages_[1].rate.load(std::memory_order_relaxed);
+    result.fifteen_minute_rate = averages_[2].rate.load(std::memory_order_relaxed);
+    return result;
+}
+
+} // namespace kcenon::integrated
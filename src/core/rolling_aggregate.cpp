@@ -0,0 +1,320 @@
+// BSD 3-Clause License
+// Copyright (c) 2025, kcenon
+// See the LICENSE file in the project root for full license information.
+
+#include <kcenon/integrated/core/rolling_aggregate.h>
+
+#include <algorithm>
+#include <cmath>
+#include <deque>
+#include <map>
+#include <utility>
+
+namespace kcenon::integrated {
+
+namespace {
+
+// Magnitudes below this share the zero bucket
+constexpr double min_indexable = 1e-9;
+
+// Separates positive from negative sketch keys; log-gamma indexes of finite
+// doubles stay far below it for any accuracy the config accepts
+constexpr std::int32_t key_offset = 1 << 24;
+
+std::int64_t to_ms(rolling_aggregate::clock::time_point time) {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(time.time_since_epoch()).count();
+}
+
+/**
+ * Log-bucketed sketch: a value v > 0 lands in bucket ceil(log_gamma(v)) and is
+ * reported as the bucket's midpoint 2 gamma^k / (gamma + 1), which is within
+ * (gamma - 1) / (gamma + 1) = relative accuracy of v. Keys are ordered like
+ * the values, so walking the map in order walks the distribution.
+ */
+class quantile_sketch {
+public:
+    using store = std::map<std::int32_t, std::uint32_t>;
+
+    explicit quantile_sketch(double relative_accuracy) {
+        const double accuracy = std::clamp(relative_accuracy, 1e-4, 0.5);
+        gamma_ = (1.0 + accuracy) / (1.0 - accuracy);
+        inverse_log_gamma_ = 1.0 / std::log(gamma_);
+    }
+
+    std::int32_t key(double value) const {
+        const double magnitude = std::abs(value);
+        if (magnitude < min_indexable) {
+            return 0;
+        }
+        const auto index = static_cast<std::int32_t>(std::ceil(std::log(magnitude) * inverse_log_gamma_));
+        return value > 0 ? key_offset + index : -(key_offset + index);
+    }
+
+    double value(std::int32_t key) const {
+        if (key == 0) {
+            return 0.0;
+        }
+        const std::int32_t index = (key > 0 ? key : -key) - key_offset;
+        const double magnitude = 2.0 * std::pow(gamma_, index) / (gamma_ + 1.0);
+        return key > 0 ? magnitude : -magnitude;
+    }
+
+private:
+    double gamma_;
+    double inverse_log_gamma_;
+};
+
+struct column_state {
+    double sum = 0.0;
+    // Candidates for min/max as (sequence, value), front is the answer
+    std::deque<std::pair<std::uint64_t, double>> min_queue;
+    std::deque<std::pair<std::uint64_t, double>> max_queue;
+    quantile_sketch::store buckets;
+};
+
+struct window_state {
+    std::int64_t width_ms;
+    std::uint64_t tail = 0;  // Sequence of the oldest sample in the window
+    std::uint64_t count = 0;
+    std::vector<column_state> columns;
+};
+
+double sanitize(double value) {
+    return std::isfinite(value) ? value : 0.0;
+}
+
+} // namespace
+
+class rolling_aggregate::impl {
+public:
+    explicit impl(const rolling_config& config)
+        : columns_(std::max<std::size_t>(config.columns, 1)),
+          max_samples_(std::max<std::size_t>(config.max_samples, 1)),
+          sketch_(config.relative_accuracy) {
+        windows_.reserve(config.windows.size());
+        for (const auto& width : config.windows) {
+            window_state window;
+            window.width_ms = std::max<std::int64_t>(width.count(), 1);
+            window.columns.resize(columns_);
+            windows_.push_back(std::move(window));
+        }
+    }
+
+    void add(clock::time_point timestamp, std::span<const double> values) {
+        if (values.size() != columns_) {
+            return;
+        }
+
+        std::int64_t ms = to_ms(timestamp);
+        if (size_ > 0) {
+            ms = std::max(ms, latest_ms_);
+        }
+        latest_ms_ = ms;
+
+        if (size_ == capacity_) {
+            if (capacity_ < max_samples_) {
+                grow();
+            } else {
+                drop_oldest();
+            }
+        }
+
+        const std::size_t slot = (head_ + size_) % capacity_;
+        const std::uint64_t sequence = first_sequence_ + size_;
+        times_[slot] = ms;
+        for (std::size_t c = 0; c < columns_; ++c) {
+            values_[slot * columns_ + c] = sanitize(values[c]);
+        }
+        ++size_;
+
+        for (auto& window : windows_) {
+            insert(window, sequence, &values_[slot * columns_]);
+            while (window.tail < sequence && time_of(window.tail) <= ms - window.width_ms) {
+                expire(window);
+            }
+        }
+    }
+
+    std::optional<std::size_t> find_window(std::chrono::milliseconds width) const {
+        for (std::size_t i = 0; i < windows_.size(); ++i) {
+            if (windows_[i].width_ms == width.count()) {
+                return i;
+            }
+        }
+        return std::nullopt;
+    }
+
+    std::size_t window_count() const { return windows_.size(); }
+
+    std::chrono::milliseconds window(std::size_t index) const {
+        return index < windows_.size() ? std::chrono::milliseconds(windows_[index].width_ms)
+                                       : std::chrono::milliseconds(0);
+    }
+
+    std::size_t columns() const { return columns_; }
+
+    rolling_stats stats(std::size_t window_index, std::size_t column) const {
+        if (window_index >= windows_.size() || column >= columns_) {
+            return {};
+        }
+        const auto& window = windows_[window_index];
+        if (window.count == 0) {
+            return {};
+        }
+        const auto& state = window.columns[column];
+        return {window.count, state.sum, state.min_queue.front().second, state.max_queue.front().second};
+    }
+
+    double quantile(std::size_t window_index, std::size_t column, double q) const {
+        const auto summary = stats(window_index, column);
+        if (summary.count == 0) {
+            return 0.0;
+        }
+
+        const auto& buckets = windows_[window_index].columns[column].buckets;
+        const double rank = std::clamp(q, 0.0, 1.0) * static_cast<double>(summary.count - 1);
+        std::uint64_t cumulative = 0;
+        double result = summary.max;
+        for (const auto& [key, count] : buckets) {
+            cumulative += count;
+            if (static_cast<double>(cumulative) > rank) {
+                result = sketch_.value(key);
+                break;
+            }
+        }
+        return std::clamp(result, summary.min, summary.max);
+    }
+
+private:
+    std::int64_t time_of(std::uint64_t sequence) const {
+        return times_[slot_of(sequence)];
+    }
+
+    std::size_t slot_of(std::uint64_t sequence) const {
+        return (head_ + static_cast<std::size_t>(sequence - first_sequence_)) % capacity_;
+    }
+
+    void insert(window_state& window, std::uint64_t sequence, const double* row) {
+        for (std::size_t c = 0; c < columns_; ++c) {
+            const double value = row[c];
+            auto& state = window.columns[c];
+            state.sum += value;
+            while (!state.min_queue.empty() && state.min_queue.back().second >= value) {
+                state.min_queue.pop_back();
+            }
+            state.min_queue.emplace_back(sequence, value);
+            while (!state.max_queue.empty() && state.max_queue.back().second <= value) {
+                state.max_queue.pop_back();
+            }
+            state.max_queue.emplace_back(sequence, value);
+            ++state.buckets[sketch_.key(value)];
+        }
+        if (window.count == 0) {
+            window.tail = sequence;
+        }
+        ++window.count;
+    }
+
+    // Removes the window's oldest sample
+    void expire(window_state& window) {
+        const std::uint64_t sequence = window.tail;
+        const double* row = &values_[slot_of(sequence) * columns_];
+        --window.count;
+        ++window.tail;
+
+        for (std::size_t c = 0; c < columns_; ++c) {
+            auto& state = window.columns[c];
+            // Reset rather than subtract once empty, so rounding does not accumulate
+            state.sum = window.count == 0 ? 0.0 : state.sum - row[c];
+            if (state.min_queue.front().first == sequence) {
+                state.min_queue.pop_front();
+            }
+            if (state.max_queue.front().first == sequence) {
+                state.max_queue.pop_front();
+            }
+            const auto bucket = state.buckets.find(sketch_.key(row[c]));
+            if (--bucket->second == 0) {
+                state.buckets.erase(bucket);
+            }
+        }
+    }
+
+    void drop_oldest() {
+        for (auto& window : windows_) {
+            if (window.count > 0 && window.tail == first_sequence_) {
+                expire(window);
+            }
+        }
+        head_ = (head_ + 1) % capacity_;
+        ++first_sequence_;
+        --size_;
+    }
+
+    void grow() {
+        const std::size_t capacity = std::min(std::max<std::size_t>(capacity_ * 2, 16), max_samples_);
+        std::vector<std::int64_t> times(capacity);
+        std::vector<double> values(capacity * columns_);
+        for (std::size_t i = 0; i < size_; ++i) {
+            const std::size_t slot = (head_ + i) % capacity_;
+            times[i] = times_[slot];
+            std::copy_n(&values_[slot * columns_], columns_, &values[i * columns_]);
+        }
+        times_ = std::move(times);
+        values_ = std::move(values);
+        capacity_ = capacity;
+        head_ = 0;
+    }
+
+    std::size_t columns_;
+    std::size_t max_samples_;
+    quantile_sketch sketch_;
+    std::vector<window_state> windows_;
+
+    // Ring of retained samples, oldest at head_
+    std::vector<std::int64_t> times_;
+    std::vector<double> values_;
+    std::size_t capacity_ = 0;
+    std::size_t head_ = 0;
+    std::size_t size_ = 0;
+    std::uint64_t first_sequence_ = 0;
+    std::int64_t latest_ms_ = 0;
+};
+
+rolling_aggregate::rolling_aggregate(const rolling_config& config)
+    : pimpl_(std::make_unique<impl>(config)) {
+}
+
+rolling_aggregate::~rolling_aggregate() = default;
+
+rolling_aggregate::rolling_aggregate(rolling_aggregate&&) noexcept = default;
+rolling_aggregate& rolling_aggregate::operator=(rolling_aggregate&&) noexcept = default;
+
+void rolling_aggregate::add(clock::time_point timestamp, std::span<const double> values) {
+    pimpl_->add(timestamp, values);
+}
+
+std::optional<std::size_t> rolling_aggregate::find_window(std::chrono::milliseconds width) const {
+    return pimpl_->find_window(width);
+}
+
+std::size_t rolling_aggregate::window_count() const {
+    return pimpl_->window_count();
+}
+
+std::chrono::milliseconds rolling_aggregate::window(std::size_t index) const {
+    return pimpl_->window(index);
+}
+
+std::size_t rolling_aggregate::columns() const {
+    return pimpl_->columns();
+}
+
+rolling_stats rolling_aggregate::stats(std::size_t window, std::size_t column) const {
+    return pimpl_->stats(window, column);
+}
+
+double rolling_aggregate::quantile(std::size_t window, std::size_t column, double quantile) const {
+    return pimpl_->quantile(window, column, quantile);
+}
+
+} // namespace kcenon::integrated
@@ -0,0 +1,48 @@
+// BSD 3-Clause License
+// Copyright (c) 2025, kcenon
+// See the LICENSE file in the project root for full license information.
+
+#include <kcenon/integrated/core/sharded_counter.h>
+
+#include <algorithm>
+#include <bit>
+#include <thread>
+
+namespace kcenon::integrated {
+
+namespace {
+
+constexpr std::size_t max_shards = 256;
+
+} // namespace
+
+std::size_t detail::assign_counter_slot() noexcept {
+    static std::atomic<std::size_t> next_slot{0};
+    return next_slot.fetch_add(1, std::memory_order_relaxed);
+}
+
+sharded_counter::sharded_counter(std::size_t shards) {
+    if (shards == 0) {
+        shards = std::max(1u, std::thread::hardware_concurrency());
+    }
+    shards = std::bit_ceil(std::clamp<std::size_t>(shards, 1, max_shards));
+
+    mask_ = shards - 1;
+    shards_ = std::make_unique<shard[]>(shards);
+}
+
+std::uint64_t sharded_counter::value() const noexcept {
+    std::uint64_t total = 0;
+    for (std::size_t i = 0; i <= mask_; ++i) {
+        total += shards_[i].value.load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+void sharded_counter::reset() noexcept {
+    for (std::size_t i = 0; i <= mask_; ++i) {
+        shards_[i].value.store(0, std::memory_order_relaxed);
+    }
+}
+
+} // namespace kcenon::integrated
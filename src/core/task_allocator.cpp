@@ -0,0 +1,334 @@
+// BSD 3-Clause License
+// Copyright (c) 2025, kcenon
+// See the LICENSE file in the project root for full license information.
+
+#include <kcenon/integrated/core/task_allocator.h>
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <mutex>
+#include <vector>
+
+namespace kcenon::integrated {
+
+namespace detail {
+
+namespace {
+
+constexpr std::size_t slab_size = 64 * 1024;
+constexpr std::size_t class_count = 5;  // 64, 128, 256, 512, 1024 bytes
+constexpr std::size_t remote_batch_size = 32;
+
+static_assert(pool_max_block_size == (pool_block_alignment << (class_count - 1)));
+
+constexpr std::size_t class_index(std::size_t bytes) {
+    if (bytes <= pool_block_alignment) {
+        return 0;
+    }
+    return static_cast<std::size_t>(std::bit_width(bytes - 1) - std::bit_width(pool_block_alignment - 1));
+}
+
+constexpr std::size_t class_size(std::size_t index) {
+    return pool_block_alignment << index;
+}
+
+struct free_block {
+    free_block* next;
+};
+
+struct thread_cache;
+
+// Sits at the start of every slab; blocks find it by masking their address
+struct alignas(pool_block_alignment) slab_header {
+    thread_cache* owner;
+    std::size_t size_class;
+};
+
+struct alignas(64) thread_cache {
+    struct size_class_state {
+        free_block* free_list = nullptr;
+        char* bump = nullptr;
+        char* bump_end = nullptr;
+    };
+
+    // Blocks freed by this thread that belong to another cache
+    struct remote_chain {
+        thread_cache* owner = nullptr;
+        free_block* head = nullptr;
+        free_block* tail = nullptr;
+        std::size_t count = 0;
+    };
+
+    // Owner-only state
+    std::array<size_class_state, class_count> classes{};
+    std::array<remote_chain, class_count> pending{};
+
+    // Counters are written by a single thread (or under the shared cache mutex)
+    std::atomic<std::uint64_t> allocations{0};
+    std::atomic<std::uint64_t> deallocations{0};
+    std::atomic<std::uint64_t> remote_deallocations{0};
+    std::atomic<std::uint64_t> remote_batches{0};
+    std::atomic<std::uint64_t> oversize_allocations{0};
+    std::atomic<std::uint64_t> slabs{0};
+
+    // Cross-thread frees land here; kept off the owner's cache lines
+    alignas(64) std::array<std::atomic<free_block*>, class_count> remote{};
+};
+
+struct cache_registry {
+    std::mutex mutex;
+    std::vector<thread_cache*> caches;
+    std::vector<thread_cache*> orphans;
+
+    // Serves threads whose thread-local cache has already been destroyed
+    std::mutex shared_mutex;
+    thread_cache* shared = nullptr;
+};
+
+// Intentionally leaked: blocks may be freed during static destruction
+cache_registry& registry() {
+    static cache_registry* instance = [] {
+        auto* reg = new cache_registry();
+        reg->shared = new thread_cache();
+        reg->caches.push_back(reg->shared);
+        return reg;
+    }();
+    return *instance;
+}
+
+void bump(std::atomic<std::uint64_t>& counter, std::uint64_t amount = 1) {
+    counter.store(counter.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+}
+
+void push_remote(thread_cache& owner, std::size_t index, free_block* head, free_block* tail) {
+    auto& list = owner.remote[index];
+    free_block* old_head = list.load(std::memory_order_relaxed);
+    do {
+        tail->next = old_head;
+    } while (!list.compare_exchange_weak(old_head, head,
+                                         std::memory_order_release,
+                                         std::memory_order_relaxed));
+}
+
+void flush_chain(thread_cache& cache, std::size_t index) {
+    auto& chain = cache.pending[index];
+    if (chain.count == 0) {
+        return;
+    }
+
+    push_remote(*chain.owner, index, chain.head, chain.tail);
+    bump(cache.remote_batches);
+    chain = {};
+}
+
+void flush_all(thread_cache& cache) {
+    for (std::size_t i = 0; i < class_count; ++i) {
+        flush_chain(cache, i);
+    }
+}
+
+thread_cache* acquire_cache() {
+    auto& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    if (!reg.orphans.empty()) {
+        thread_cache* cache = reg.orphans.back();
+        reg.orphans.pop_back();
+        return cache;
+    }
+
+    auto* cache = new thread_cache();
+    reg.caches.push_back(cache);
+    return cache;
+}
+
+void release_cache(thread_cache* cache) {
+    if (!cache) {
+        return;
+    }
+
+    flush_all(*cache);
+
+    auto& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    reg.orphans.push_back(cache);
+}
+
+enum class cache_status : unsigned char { unbound, bound, destroyed };
+
+thread_local thread_cache* tls_cache = nullptr;
+thread_local cache_status tls_status = cache_status::unbound;
+
+struct cache_guard {
+    ~cache_guard() {
+        release_cache(tls_cache);
+        tls_cache = nullptr;
+        tls_status = cache_status::destroyed;
+    }
+};
+
+thread_local cache_guard tls_guard;
+
+// Returns nullptr once the calling thread's cache has been torn down
+thread_cache* local_cache() {
+    if (tls_cache) {
+        return tls_cache;
+    }
+    if (tls_status == cache_status::destroyed) {
+        return nullptr;
+    }
+
+    static_cast<void>(&tls_guard);  // Registers the thread-exit hook
+    tls_cache = acquire_cache();
+    tls_status = cache_status::bound;
+    return tls_cache;
+}
+
+void refill(thread_cache& cache, std::size_t index) {
+    void* memory = ::operator new(slab_size, std::align_val_t{slab_size});
+    new (memory) slab_header{&cache, index};
+
+    const std::size_t block = class_size(index);
+    const std::size_t usable = slab_size - sizeof(slab_header);
+
+    auto& state = cache.classes[index];
+    state.bump = static_cast<char*>(memory) + sizeof(slab_header);
+    state.bump_end = state.bump + (usable / block) * block;
+    bump(cache.slabs);
+}
+
+void* allocate_from(thread_cache& cache, std::size_t index) {
+    auto& state = cache.classes[index];
+    if (!state.free_list) {
+        state.free_list = cache.remote[index].exchange(nullptr, std::memory_order_acquire);
+    }
+
+    if (free_block* block = state.free_list) {
+        state.free_list = block->next;
+        return block;
+    }
+
+    if (state.bump == state.bump_end) {
+        refill(cache, index);
+    }
+
+    void* block = state.bump;
+    state.bump += class_size(index);
+    return block;
+}
+
+} // namespace
+
+void* pool_allocate(std::size_t bytes) {
+    thread_cache* cache = local_cache();
+    if (!cache) {
+        auto& reg = registry();
+        std::lock_guard<std::mutex> lock(reg.shared_mutex);
+        bump(reg.shared->allocations);
+        if (bytes > pool_max_block_size) {
+            bump(reg.shared->oversize_allocations);
+            return ::operator new(bytes, std::align_val_t{pool_block_alignment});
+        }
+        return allocate_from(*reg.shared, class_index(bytes));
+    }
+
+    bump(cache->allocations);
+    if (bytes > pool_max_block_size) {
+        bump(cache->oversize_allocations);
+        return ::operator new(bytes, std::align_val_t{pool_block_alignment});
+    }
+    return allocate_from(*cache, class_index(bytes));
+}
+
+void pool_deallocate(void* ptr, std::size_t bytes) noexcept {
+    if (!ptr) {
+        return;
+    }
+
+    thread_cache* cache = local_cache();
+    if (!cache) {
+        auto& reg = registry();
+        std::lock_guard<std::mutex> lock(reg.shared_mutex);
+        cache = reg.shared;
+        bump(cache->deallocations);
+        if (bytes > pool_max_block_size) {
+            ::operator delete(ptr, std::align_val_t{pool_block_alignment});
+            return;
+        }
+
+        auto* header = reinterpret_cast<slab_header*>(
+            reinterpret_cast<std::uintptr_t>(ptr) & ~(slab_size - 1));
+        auto* block = static_cast<free_block*>(ptr);
+        if (header->owner == cache) {
+            block->next = cache->classes[header->size_class].free_list;
+            cache->classes[header->size_class].free_list = block;
+        } else {
+            bump(cache->remote_deallocations);
+            bump(cache->remote_batches);
+            push_remote(*header->owner, header->size_class, block, block);
+        }
+        return;
+    }
+
+    bump(cache->deallocations);
+    if (bytes > pool_max_block_size) {
+        ::operator delete(ptr, std::align_val_t{pool_block_alignment});
+        return;
+    }
+
+    auto* header = reinterpret_cast<slab_header*>(
+        reinterpret_cast<std::uintptr_t>(ptr) & ~(slab_size - 1));
+    const std::size_t index = header->size_class;
+    auto* block = static_cast<free_block*>(ptr);
+
+    if (header->owner == cache) {
+        block->next = cache->classes[index].free_list;
+        cache->classes[index].free_list = block;
+        return;
+    }
+
+    bump(cache->remote_deallocations);
+    auto& chain = cache->pending[index];
+    if (chain.owner != header->owner) {
+        flush_chain(*cache, index);
+        chain.owner = header->owner;
+    }
+
+    block->next = chain.head;
+    chain.head = block;
+    if (!chain.tail) {
+        chain.tail = block;
+    }
+
+    if (++chain.count >= remote_batch_size) {
+        flush_chain(*cache, index);
+    }
+}
+
+void pool_flush_thread() noexcept {
+    if (tls_cache) {
+        flush_all(*tls_cache);
+    }
+}
+
+} // namespace detail
+
+task_allocator_stats get_task_allocator_stats() {
+    auto& reg = detail::registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+
+    task_allocator_stats stats;
+    for (const auto* cache : reg.caches) {
+        stats.allocations += cache->allocations.load(std::memory_order_relaxed);
+        stats.deallocations += cache->deallocations.load(std::memory_order_relaxed);
+        stats.remote_deallocations += cache->remote_deallocations.load(std::memory_order_relaxed);
+        stats.remote_batches += cache->remote_batches.load(std::memory_order_relaxed);
+        stats.oversize_allocations += cache->oversize_allocations.load(std::memory_order_relaxed);
+        stats.slabs += cache->slabs.load(std::memory_order_relaxed);
+    }
+    stats.bytes_reserved = stats.slabs * detail::slab_size;
+    stats.thread_caches = reg.caches.size() - 1;  // Excludes the shared fallback cache
+    return stats;
+}
+
+} // namespace kcenon::integrated
@@ -0,0 +1,175 @@
+// BSD 3-Clause License
+// Copyright (c) 2025, kcenon
+// See the LICENSE file in the project root for full license information.
+
+#include <kcenon/integrated/core/task_latency.h>
+#include <kcenon/integrated/core/prometheus_writer.h>
+
+#include <algorithm>
+
+namespace kcenon::integrated {
+
+namespace {
+
+// Lower bound of each lane; mirrors priority_level
+constexpr std::array<int, priority_lane_count> lane_floors{0, 25, 50, 75, 100, 127};
+constexpr std::array<const char*, priority_lane_count> lane_names{
+    "lowest", "low", "normal", "high", "highest", "critical"};
+
+latency_snapshot merge_lanes(const std::array<latency_snapshot, priority_lane_count>& lanes) {
+    latency_snapshot total;
+    for (const auto& lane : lanes) {
+        total.merge(lane);
+    }
+    return total;
+}
+
+} // namespace
+
+std::size_t priority_lane(int priority) noexcept {
+    std::size_t lane = 0;
+    while (lane + 1 < priority_lane_count && priority >= lane_floors[lane + 1]) {
+        ++lane;
+    }
+    return lane;
+}
+
+const char* priority_lane_name(std::size_t lane) noexcept {
+    return lane < priority_lane_count ? lane_names[lane] : "unknown";
+}
+
+latency_summary latency_summary::from(const latency_snapshot& snapshot) {
+    latency_summary summary;
+    summary.count = snapshot.count();
+    if (summary.count == 0) {
+        return summary;
+    }
+
+    summary.sum = snapshot.sum();
+    summary.mean = snapshot.mean();
+    summary.p50 = snapshot.percentile(0.50);
+    summary.p95 = snapshot.percentile(0.95);
+    summary.p99 = snapshot.percentile(0.99);
+    summary.p999 = snapshot.percentile(0.999);
+    summary.max = snapshot.max();
+    return summary;
+}
+
+void task_latency_snapshot::clear() noexcept {
+    for (std::size_t i = 0; i < priority_lane_count; ++i) {
+        queue_wait[i].clear();
+        execution[i].clear();
+        end_to_end[i].clear();
+    }
+}
+
+latency_snapshot task_latency_snapshot::total_queue_wait() const {
+    return merge_lanes(queue_wait);
+}
+
+latency_snapshot task_latency_snapshot::total_execution() const {
+    return merge_lanes(execution);
+}
+
+latency_snapshot task_latency_snapshot::total_end_to_end() const {
+    return merge_lanes(end_to_end);
+}
+
+std::vector<lane_latency> task_latency_snapshot::lanes() const {
+    std::vector<lane_latency> result;
+    for (std::size_t i = 0; i < priority_lane_count; ++i) {
+        if (end_to_end[i].count() == 0) {
+            continue;
+        }
+        result.push_back({
+            lane_names[i],
+            latency_summary::from(queue_wait[i]),
+            latency_summary::from(execution[i]),
+            latency_summary::from(end_to_end[i])
+        });
+    }
+    return result;
+}
+
+void write_latency_prometheus(prometheus_writer& writer, std::string_view pool,
+                              const task_latency_snapshot& snapshot) {
+    struct stage {
+        const char* name;
+        const char* help;
+        const std::array<latency_snapshot, priority_lane_count>& lanes;
+    };
+    const stage stages[] = {
+        {"task_queue_wait_seconds", "Time tasks waited to be started after becoming runnable",
+         snapshot.queue_wait},
+        {"task_execution_seconds", "Time tasks spent running", snapshot.execution},
+        {"task_end_to_end_seconds", "Queue wait plus execution time", snapshot.end_to_end}};
+
+    for (const auto& [name, help, lanes] : stages) {
+        writer.family(name, metric_type::histogram, help);
+        for (std::size_t i = 0; i < priority_lane_count; ++i) {
+            if (lanes[i].count() == 0) {
+                continue;
+            }
+            writer.histogram(name, {{"pool", pool}, {"priority", lane_names[i]}}, lanes[i]);
+        }
+    }
+}
+
+void write_latency_summary_json(std::ostream& out, const latency_summary& summary) {
+    out << "{\"count\": " << summary.count
+        << ", \"mean_ns\": " << summary.mean.count()
+        << ", \"p50_ns\": " << summary.p50.count()
+        << ", \"p95_ns\": " << summary.p95.count()
+        << ", \"p99_ns\": " << summary.p99.count()
+        << ", \"p999_ns\": " << summary.p999.count()
+        << ", \"max_ns\": " << summary.max.count() << "}";
+}
+
+void write_latency_json(std::ostream& out, const std::vector<lane_latency>& lanes, int indent) {
+    const std::string pad(static_cast<std::size_t>(std::max(indent, 0)), ' ');
+
+    out << "{";
+    for (std::size_t i = 0; i < lanes.size(); ++i) {
+        const auto& lane = lanes[i];
+        out << (i == 0 ? "\n" : ",\n");
+        out << pad << "  \"" << lane.lane << "\": {\n";
+        out << pad << "    \"queue_wait\": ";
+        write_latency_summary_json(out, lane.queue_wait);
+        out << ",\n" << pad << "    \"execution\": ";
+        write_latency_summary_json(out, lane.execution);
+        out << ",\n" << pad << "    \"end_to_end\": ";
+        write_latency_summary_json(out, lane.end_to_end);
+        out << "\n" << pad << "  }";
+    }
+    out << (lanes.empty() ? "}" : "\n" + pad + "}");
+}
+
+task_latency_recorder::task_latency_recorder(unsigned precision_digits) {
+    for (auto& lane_ptr : lanes_) {
+        lane_ptr = std::make_unique<lane>(precision_digits);
+    }
+}
+
+void task_latency_recorder::record(int priority, std::chrono::nanoseconds queue_wait,
+                                   std::chrono::nanoseconds execution) noexcept {
+    lane& target = *lanes_[priority_lane(priority)];
+    target.queue_wait.record(queue_wait);
+    target.execution.record(execution);
+    target.end_to_end.record(queue_wait + execution);
+}
+
+void task_latency_recorder::merge_into(task_latency_snapshot& snapshot) const {
+    for (std::size_t i = 0; i < priority_lane_count; ++i) {
+        lanes_[i]->queue_wait.merge_into(snapshot.queue_wait[i]);
+        lanes_[i]->execution.merge_into(snapshot.execution[i]);
+        lanes_[i]->end_to_end.merge_into(snapshot.end_to_end[i]);
+    }
+}
+
+task_latency_snapshot task_latency_recorder::snapshot() const {
+    task_latency_snapshot result;
+    merge_into(result);
+    return result;
+}
+
+} // namespace kcenon::integrated
@@ -0,0 +1,347 @@
+// BSD 3-Clause License
+// Copyright (c) 2025, kcenon
+// See the LICENSE file in the project root for full license information.
+
+#include <kcenon/integrated/core/task_tracer.h>
+
+#include "core/json_format.h"
+
+#include <algorithm>
+#include <bit>
+#include <fstream>
+#include <iomanip>
+#include <mutex>
+#include <sstream>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace kcenon::integrated {
+
+namespace {
+
+using detail::write_json_string;
+
+constexpr std::size_t min_events_per_thread = 16;
+constexpr std::size_t max_events_per_thread = std::size_t{1} << 24;
+
+std::atomic<std::uint64_t> next_instance{1};
+
+// Chrome traces count microseconds; keep the nanoseconds as decimals
+void write_micros(std::ostream& out, std::uint64_t nanoseconds) {
+    out << nanoseconds / 1000 << '.' << std::setw(3) << std::setfill('0') << nanoseconds % 1000
+        << std::setfill(' ');
+}
+
+struct recorded_event {
+    std::uint64_t timestamp;
+    std::uint64_t trace_id;
+    trace_event event;
+    std::uint32_t arg;
+    std::uint32_t tid;
+};
+
+} // namespace
+
+class task_tracer::impl {
+public:
+    explicit impl(const trace_config& config)
+        : process_name_(config.process_name)
+        , capacity_(std::bit_ceil(std::clamp(config.events_per_thread, min_events_per_thread,
+                                             max_events_per_thread)))
+        , max_threads_(config.max_threads) {}
+
+    ring* find_or_add() {
+        const auto id = std::this_thread::get_id();
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (const auto it = by_thread_.find(id); it != by_thread_.end()) {
+            return rings_[it->second].get();
+        }
+        if (rings_.size() >= max_threads_) {
+            return nullptr;
+        }
+
+        auto created = std::make_unique<ring>();
+        created->index = static_cast<std::uint32_t>(rings_.size());
+        created->mask = capacity_ - 1;
+        created->slots = std::make_unique<slot[]>(capacity_);
+        names_.push_back("thread " + std::to_string(created->index));
+        by_thread_.emplace(id, rings_.size());
+        rings_.push_back(std::move(created));
+        return rings_.back().get();
+    }
+
+    void name(const ring& target, std::string name) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        names_[target.index] = std::move(name);
+    }
+
+    void write(std::ostream& out) const {
+        std::vector<recorded_event> events;
+        std::vector<std::string> names;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            names = names_;
+            for (const auto& source : rings_) {
+                collect(*source, events);
+            }
+        }
+
+        // At equal timestamps, process a task's events in lifecycle order
+        std::sort(events.begin(), events.end(), [](const auto& a, const auto& b) {
+            return a.timestamp != b.timestamp ? a.timestamp < b.timestamp : a.event < b.event;
+        });
+
+        out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n";
+        out << "{\"ph\":\"M\",\"name\":\"process_name\",\"pid\":1,\"tid\":0,\"args\":{\"name\":";
+        write_json_string(out, process_name_);
+        out << "}}";
+        for (std::size_t i = 0; i < names.size(); ++i) {
+            out << ",\n{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":" << i + 1
+                << ",\"args\":{\"name\":";
+            write_json_string(out, names[i]);
+            out << "}}";
+        }
+
+        struct task_state {
+            const recorded_event* submit = nullptr;
+            const recorded_event* enqueue = nullptr;
+        };
+        std::unordered_map<std::uint64_t, task_state> tasks;
+        std::unordered_map<std::uint32_t, std::vector<const recorded_event*>> running;
+
+        for (const auto& event : events) {
+            switch (event.event) {
+                case trace_event::submit:
+                    tasks[event.trace_id].submit = &event;
+                    break;
+
+                case trace_event::enqueue: {
+                    auto& task = tasks[event.trace_id];
+                    task.enqueue = &event;
+                    if (task.submit && task.submit->tid == event.tid) {
+                        write_slice(out, "submit", event.tid, task.submit->timestamp,
+                                    event.timestamp - task.submit->timestamp, event.trace_id);
+                        out << "}}";
+                    }
+                    break;
+                }
+
+                case trace_event::start: {
+                    running[event.tid].push_back(&event);
+                    const auto it = tasks.find(event.trace_id);
+                    if (it == tasks.end()) {
+                        break;
+                    }
+                    const auto& task = it->second;
+                    if (task.submit) {
+                        // Arrow from the submitting slice to the run
+                        write_flow(out, 's', task.submit->tid, task.submit->timestamp, event.trace_id);
+                        write_flow(out, 'f', event.tid, event.timestamp, event.trace_id);
+                    }
+                    if (task.enqueue) {
+                        write_async(out, 'b', task.enqueue->tid, task.enqueue->timestamp, event.trace_id);
+                        write_async(out, 'e', event.tid, event.timestamp, event.trace_id);
+                    }
+                    break;
+                }
+
+                case trace_event::end: {
+                    auto& stack = running[event.tid];
+                    const auto it = std::find_if(stack.rbegin(), stack.rend(), [&](const auto* start) {
+                        return start->trace_id == event.trace_id;
+                    });
+                    if (it == stack.rend()) {
+                        break;  // The start was overwritten
+                    }
+                    const recorded_event& start = **it;
+                    stack.erase(std::next(it).base(), stack.end());
+
+                    write_slice(out, "task", event.tid, start.timestamp, event.timestamp - start.timestamp,
+                                event.trace_id);
+                    out << ",\"priority\":" << start.arg;
+                    if (const auto queued = tasks.find(event.trace_id);
+                        queued != tasks.end() && queued->second.enqueue) {
+                        out << ",\"queue_wait_us\":";
+                        write_micros(out, start.timestamp - queued->second.enqueue->timestamp);
+                    }
+                    out << "}}";
+                    tasks.erase(event.trace_id);
+                    break;
+                }
+
+                case trace_event::steal:
+                    out << ",\n{\"ph\":\"i\",\"s\":\"t\",\"name\":\"steal\",\"cat\":\"task\",\"pid\":1,\"tid\":"
+                        << event.tid << ",\"ts\":";
+                    write_micros(out, event.timestamp);
+                    out << ",\"args\":{\"trace_id\":";
+                    write_id(out, event.trace_id);
+                    out << ",\"victim\":" << event.arg << "}}";
+                    break;
+            }
+        }
+
+        out << "\n]}\n";
+    }
+
+    std::uint64_t overwritten() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::uint64_t total = 0;
+        for (const auto& source : rings_) {
+            const std::uint64_t head = source->head.load(std::memory_order_relaxed);
+            total += head > capacity_ ? head - capacity_ : 0;
+        }
+        return total;
+    }
+
+private:
+    static void collect(const ring& source, std::vector<recorded_event>& events) {
+        const std::uint64_t capacity = source.mask + 1;
+        const std::uint64_t head = source.head.load(std::memory_order_acquire);
+        const std::uint64_t first = head > capacity ? head - capacity : 0;
+
+        for (std::uint64_t position = first; position < head; ++position) {
+            const slot& entry = source.slots[position & source.mask];
+            if (entry.sequence.load(std::memory_order_acquire) != position) {
+                continue;
+            }
+            const std::uint64_t timestamp = entry.timestamp.load(std::memory_order_relaxed);
+            const std::uint64_t trace_id = entry.trace_id.load(std::memory_order_relaxed);
+            const std::uint64_t payload = entry.payload.load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (entry.sequence.load(std::memory_order_relaxed) != position) {
+                continue;  // Overwritten while it was read
+            }
+            events.push_back({timestamp, trace_id, static_cast<trace_event>(payload & 0xFF),
+                              static_cast<std::uint32_t>(payload >> 8), source.index + 1});
+        }
+    }
+
+    // Trace ids exceed what JSON numbers hold exactly, so they are written as hex strings
+    static void write_id(std::ostream& out, std::uint64_t trace_id) {
+        out << "\"0x" << std::hex << trace_id << std::dec << '"';
+    }
+
+    // Leaves the args object open for the caller to extend
+    static void write_slice(std::ostream& out, const char* name, std::uint32_t tid, std::uint64_t start,
+                            std::uint64_t duration, std::uint64_t trace_id) {
+        out << ",\n{\"ph\":\"X\",\"name\":\"" << name << "\",\"cat\":\"task\",\"pid\":1,\"tid\":" << tid
+            << ",\"ts\":";
+        write_micros(out, start);
+        out << ",\"dur\":";
+        write_micros(out, duration);
+        out << ",\"args\":{\"trace_id\":";
+        write_id(out, trace_id);
+    }
+
+    static void write_flow(std::ostream& out, char phase, std::uint32_t tid, std::uint64_t timestamp,
+                           std::uint64_t trace_id) {
+        out << ",\n{\"ph\":\"" << phase << "\",\"name\":\"task\",\"cat\":\"task\",\"pid\":1,\"tid\":" << tid
+            << ",\"ts\":";
+        write_micros(out, timestamp);
+        out << ",\"id\":";
+        write_id(out, trace_id);
+        if (phase == 'f') {
+            out << ",\"bp\":\"e\"";
+        }
+        out << "}";
+    }
+
+    static void write_async(std::ostream& out, char phase, std::uint32_t tid, std::uint64_t timestamp,
+                            std::uint64_t trace_id) {
+        out << ",\n{\"ph\":\"" << phase << "\",\"name\":\"queued\",\"cat\":\"queue\",\"pid\":1,\"tid\":" << tid
+            << ",\"ts\":";
+        write_micros(out, timestamp);
+        out << ",\"id\":";
+        write_id(out, trace_id);
+        out << "}";
+    }
+
+    std::string process_name_;
+    std::size_t capacity_;
+    std::size_t max_threads_;
+
+    mutable std::mutex mutex_;
+    std::vector<std::unique_ptr<ring>> rings_;  // Index = ring::index
+    std::vector<std::string> names_;
+    std::unordered_map<std::thread::id, std::size_t> by_thread_;
+};
+
+task_tracer::task_tracer(const trace_config& config)
+    : pimpl_(std::make_unique<impl>(config))
+    , instance_(next_instance.fetch_add(1, std::memory_order_relaxed))
+    , sample_rate_(std::clamp(config.sample_rate, 0.0, 1.0))
+    , epoch_(clock::now()) {
+    if (sample_rate_ >= 1.0) {
+        threshold_ = always;
+    } else {
+        // Probability sample_rate_ that a uniform 64-bit value falls below it
+        threshold_ = static_cast<std::uint64_t>(sample_rate_ * 18446744073709551616.0);
+        if (threshold_ == 0 && sample_rate_ > 0.0) {
+            threshold_ = 1;
+        }
+    }
+}
+
+task_tracer::~task_tracer() = default;
+
+std::uint64_t task_tracer::seed_random() noexcept {
+    static std::atomic<std::uint64_t> sequence{0};
+    // splitmix64 over a per-thread sequence and the clock
+    std::uint64_t z = sequence.fetch_add(0x9E3779B97F4A7C15ULL, std::memory_order_relaxed) +
+                      static_cast<std::uint64_t>(clock::now().time_since_epoch().count());
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    z ^= z >> 31;
+    return z ? z : 1;
+}
+
+task_tracer::ring* task_tracer::attach(thread_state& local) noexcept {
+    ring* found = nullptr;
+    try {
+        found = pimpl_->find_or_add();
+    } catch (...) {
+        // Out of memory: this thread records nothing
+    }
+    local.tracer = instance_;
+    local.current = found;
+    return found;
+}
+
+void task_tracer::name_thread(std::string name) {
+    if (ring* target = local_ring(local_state())) {
+        pimpl_->name(*target, std::move(name));
+    }
+}
+
+void task_tracer::write_chrome_json(std::ostream& out) const {
+    pimpl_->write(out);
+}
+
+std::string task_tracer::chrome_json() const {
+    std::ostringstream out;
+    pimpl_->write(out);
+    return out.str();
+}
+
+common::VoidResult task_tracer::write_chrome_json(const std::string& path) const {
+    std::ofstream file(path, std::ios::out | std::ios::trunc);
+    if (!file) {
+        return common::VoidResult::err(common::error_codes::INTERNAL_ERROR,
+                                       "Cannot open trace file '" + path + "'");
+    }
+    pimpl_->write(file);
+    file.flush();
+    if (!file) {
+        return common::VoidResult::err(common::error_codes::INTERNAL_ERROR,
+                                       "Failed to write trace file '" + path + "'");
+    }
+    return common::ok();
+}
+
+std::uint64_t task_tracer::overwritten() const {
+    return pimpl_->overwritten();
+}
+
+} // namespace kcenon::integrated
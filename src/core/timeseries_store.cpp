@@ -0,0 +1,717 @@
+// BSD 3-Clause License
+// Copyright (c) 2025, kcenon
+// See the LICENSE file in the project root for full license information.
+
+#include <kcenon/integrated/core/timeseries_store.h>
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <limits>
+#include <optional>
+#include <utility>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define INTEGRATED_HAS_MMAP 1
+#else
+#define INTEGRATED_HAS_MMAP 0
+#endif
+
+namespace kcenon::integrated {
+
+namespace {
+
+constexpr char file_magic[8] = {'I', 'T', 'S', 'T', 'O', 'R', 'E', '1'};
+constexpr std::uint32_t file_version = 1;
+constexpr std::size_t max_resolutions = 8;
+constexpr std::size_t file_header_bytes = 256;
+
+// Leading-zero counts are stored in 5 bits
+constexpr unsigned max_leading_zeros = 31;
+constexpr std::uint8_t no_window = 0xFF;
+
+struct file_header {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t columns;
+    std::uint32_t block_bytes;
+    std::uint32_t resolution_count;
+    struct {
+        std::int64_t step_ms;
+        std::uint64_t block_count;
+    } resolutions[max_resolutions];
+};
+static_assert(sizeof(file_header) <= file_header_bytes);
+
+struct block_header {
+    std::int64_t first_ms;
+    std::int64_t last_ms;
+    std::uint64_t sequence;  // 0 = never written
+    std::uint32_t count;
+    std::uint32_t bits;
+};
+
+std::int64_t to_ms(timeseries_store::clock::time_point time) {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(time.time_since_epoch()).count();
+}
+
+timeseries_store::clock::time_point from_ms(std::int64_t ms) {
+    return timeseries_store::clock::time_point(
+        std::chrono::duration_cast<timeseries_store::clock::duration>(std::chrono::milliseconds(ms)));
+}
+
+// MSB-first bit stream over a block payload
+class bit_writer {
+public:
+    bit_writer(std::uint8_t* data, std::uint32_t& bits) : data_(data), bits_(bits) {}
+
+    void write(std::uint64_t value, unsigned count) {
+        while (count > 0) {
+            const unsigned offset = bits_ % 8;
+            const unsigned room = 8 - offset;
+            const unsigned take = std::min(room, count);
+            const auto chunk = static_cast<std::uint8_t>((value >> (count - take)) & ((1u << take) - 1));
+            if (offset == 0) {
+                data_[bits_ / 8] = 0;  // Blocks are reused; clear stale bytes as they are reached
+            }
+            data_[bits_ / 8] |= static_cast<std::uint8_t>(chunk << (room - take));
+            bits_ += take;
+            count -= take;
+        }
+    }
+
+private:
+    std::uint8_t* data_;
+    std::uint32_t& bits_;
+};
+
+class bit_reader {
+public:
+    explicit bit_reader(const std::uint8_t* data) : data_(data) {}
+
+    std::uint64_t read(unsigned count) {
+        std::uint64_t value = 0;
+        while (count > 0) {
+            const unsigned offset = position_ % 8;
+            const unsigned room = 8 - offset;
+            const unsigned take = std::min(room, count);
+            const unsigned chunk = (data_[position_ / 8] >> (room - take)) & ((1u << take) - 1);
+            value = (value << take) | chunk;
+            position_ += take;
+            count -= take;
+        }
+        return value;
+    }
+
+    bool bit() { return read(1) != 0; }
+
+private:
+    const std::uint8_t* data_;
+    std::size_t position_ = 0;
+};
+
+std::int64_t sign_extend(std::uint64_t value, unsigned bits) {
+    const std::uint64_t sign = std::uint64_t{1} << (bits - 1);
+    return static_cast<std::int64_t>((value ^ sign) - sign);
+}
+
+// Compression state carried from one sample to the next within a block
+struct codec_state {
+    std::int64_t last_ms = 0;
+    std::int64_t last_delta = 0;
+    std::vector<std::uint64_t> last_values;
+    std::vector<std::uint8_t> leading;   // XOR window of the previous value per column
+    std::vector<std::uint8_t> trailing;
+
+    explicit codec_state(std::size_t columns = 0)
+        : last_values(columns), leading(columns, no_window), trailing(columns, 0) {}
+
+    void restart() {
+        last_delta = 0;
+        std::fill(leading.begin(), leading.end(), no_window);
+    }
+};
+
+// Timestamp control codes: '0' same interval, then '10' / '110' / '1110'
+// with 7 / 9 / 12 bit delta-of-deltas, and '1111' with 64 bits
+constexpr std::pair<unsigned, unsigned> dod_classes[] = {{0b10, 7}, {0b110, 9}, {0b1110, 12}};
+
+void encode_timestamp(bit_writer& out, codec_state& state, std::int64_t ms) {
+    const std::int64_t delta = ms - state.last_ms;
+    const std::int64_t dod = delta - state.last_delta;
+    state.last_ms = ms;
+    state.last_delta = delta;
+
+    if (dod == 0) {
+        out.write(0, 1);
+        return;
+    }
+    unsigned control_bits = 2;
+    for (const auto& [control, bits] : dod_classes) {
+        const std::int64_t limit = std::int64_t{1} << (bits - 1);
+        if (dod >= -limit && dod < limit) {
+            out.write(control, control_bits);
+            out.write(static_cast<std::uint64_t>(dod), bits);
+            return;
+        }
+        ++control_bits;
+    }
+    out.write(0b1111, 4);
+    out.write(static_cast<std::uint64_t>(dod), 64);
+}
+
+std::int64_t decode_timestamp(bit_reader& in, codec_state& state) {
+    std::int64_t dod = 0;
+    if (in.bit()) {
+        unsigned width = 64;
+        for (const auto& [control, bits] : dod_classes) {
+            if (!in.bit()) {
+                width = bits;
+                break;
+            }
+        }
+        dod = width == 64 ? static_cast<std::int64_t>(in.read(64)) : sign_extend(in.read(width), width);
+    }
+    state.last_delta += dod;
+    state.last_ms += state.last_delta;
+    return state.last_ms;
+}
+
+void encode_value(bit_writer& out, codec_state& state, std::size_t column, double value) {
+    const auto bits = std::bit_cast<std::uint64_t>(value);
+    const std::uint64_t x = bits ^ state.last_values[column];
+    state.last_values[column] = bits;
+
+    if (x == 0) {
+        out.write(0, 1);
+        return;
+    }
+
+    const auto leading = static_cast<std::uint8_t>(
+        std::min<unsigned>(static_cast<unsigned>(std::countl_zero(x)), max_leading_zeros));
+    const auto trailing = static_cast<std::uint8_t>(std::countr_zero(x));
+
+    auto& previous_leading = state.leading[column];
+    auto& previous_trailing = state.trailing[column];
+    if (previous_leading != no_window && leading >= previous_leading && trailing >= previous_trailing) {
+        // Fits the previous window: only the meaningful bits
+        out.write(0b10, 2);
+        out.write(x >> previous_trailing, 64u - previous_leading - previous_trailing);
+        return;
+    }
+
+    const unsigned meaningful = 64u - leading - trailing;
+    out.write(0b11, 2);
+    out.write(leading, 5);
+    out.write(meaningful - 1, 6);
+    out.write(x >> trailing, meaningful);
+    previous_leading = leading;
+    previous_trailing = trailing;
+}
+
+double decode_value(bit_reader& in, codec_state& state, std::size_t column) {
+    if (in.bit()) {
+        auto& leading = state.leading[column];
+        auto& trailing = state.trailing[column];
+        if (in.bit()) {
+            leading = static_cast<std::uint8_t>(in.read(5));
+            const auto meaningful = static_cast<unsigned>(in.read(6)) + 1;
+            trailing = static_cast<std::uint8_t>(64u - leading - meaningful);
+        }
+        const unsigned meaningful = 64u - leading - trailing;
+        state.last_values[column] ^= in.read(meaningful) << trailing;
+    }
+    return std::bit_cast<double>(state.last_values[column]);
+}
+
+// Bits a sample can take at most: timestamp plus every column uncompressed
+std::size_t worst_case_bits(std::size_t columns) {
+    return 4 + 64 + columns * (2 + 5 + 6 + 64);
+}
+
+} // namespace
+
+class timeseries_store::impl {
+public:
+    explicit impl(const timeseries_config& config)
+        : columns_(std::max<std::size_t>(config.columns, 1)) {
+        // A block must hold at least one sample at worst-case size, and every
+        // block's header must stay aligned however many blocks precede it
+        const std::size_t minimum_block = sizeof(block_header) + (worst_case_bits(columns_) + 7) / 8;
+        constexpr std::size_t header_alignment = alignof(block_header);
+        block_bytes_ = (std::max(config.block_bytes, minimum_block) + header_alignment - 1) /
+                       header_alignment * header_alignment;
+
+        resolutions_.emplace_back(0, block_count(config.capacity_bytes), columns_);
+        for (const auto& rollup : config.rollups) {
+            if (resolutions_.size() == max_resolutions) {
+                break;
+            }
+            const auto step = std::max<std::int64_t>(rollup.step.count(), 1);
+            if (step <= resolutions_.back().step_ms) {
+                continue;  // Steps must ascend
+            }
+            resolutions_.emplace_back(step, block_count(rollup.capacity_bytes), columns_);
+        }
+
+        total_bytes_ = file_header_bytes;
+        for (const auto& resolution : resolutions_) {
+            total_bytes_ += resolution.block_count * block_bytes_;
+        }
+
+        if (config.path.empty() || !map_file(config.path)) {
+            memory_ = std::make_unique<std::uint8_t[]>(total_bytes_);
+            base_ = memory_.get();
+            write_file_header();
+        }
+        assign_blocks();
+        sample_buffer_.resize(columns_);
+    }
+
+    ~impl() {
+#if INTEGRATED_HAS_MMAP
+        if (mapped_) {
+            ::munmap(base_, total_bytes_);
+        }
+#endif
+    }
+
+    void append(clock::time_point timestamp, std::span<const double> values) {
+        if (values.size() != columns_) {
+            return;
+        }
+
+        std::int64_t ms = to_ms(timestamp);
+        if (has_samples_) {
+            ms = std::max(ms, latest_ms_);
+        }
+        latest_ms_ = ms;
+        has_samples_ = true;
+
+        encode(resolutions_[0], ms, values);
+
+        for (std::size_t i = 1; i < resolutions_.size(); ++i) {
+            auto& rollup = resolutions_[i];
+            const std::int64_t bucket = ms - ms % rollup.step_ms;
+            if (rollup.bucket_count > 0 && bucket != rollup.bucket_start) {
+                flush_bucket(rollup);
+            }
+            if (rollup.bucket_count == 0) {
+                rollup.bucket_start = bucket;
+                std::fill(rollup.sums.begin(), rollup.sums.end(), 0.0);
+            }
+            for (std::size_t c = 0; c < columns_; ++c) {
+                rollup.sums[c] += values[c];
+            }
+            ++rollup.bucket_count;
+        }
+    }
+
+    void scan(clock::time_point from, clock::time_point to, const visitor& visit) const {
+        const std::int64_t from_ms_value = to_ms(from);
+        const std::int64_t to_ms_value = to_ms(to);
+
+        // Finest resolution reaching back to from; otherwise the one reaching back furthest
+        std::size_t chosen = resolutions_.size();
+        std::size_t furthest = resolutions_.size();
+        for (std::size_t i = 0; i < resolutions_.size(); ++i) {
+            const auto oldest_ms = oldest_ms_of(resolutions_[i]);
+            if (!oldest_ms) {
+                continue;
+            }
+            if (*oldest_ms <= from_ms_value) {
+                chosen = i;
+                break;
+            }
+            if (furthest == resolutions_.size() || *oldest_ms < *oldest_ms_of(resolutions_[furthest])) {
+                furthest = i;
+            }
+        }
+        if (chosen == resolutions_.size()) {
+            chosen = furthest;
+        }
+        if (chosen == resolutions_.size()) {
+            return;
+        }
+
+        // Coarse data first, then finer data after the last complete bucket
+        std::int64_t lower = from_ms_value;
+        for (std::size_t i = chosen + 1; i-- > 0;) {
+            const auto& resolution = resolutions_[i];
+            scan_resolution(resolution, lower, to_ms_value, visit);
+            if (const auto newest = newest_ms_of(resolution)) {
+                lower = std::max(lower, *newest + std::max<std::int64_t>(resolution.step_ms, 1));
+            }
+        }
+    }
+
+    void scan(std::size_t index, clock::time_point from, clock::time_point to, const visitor& visit) const {
+        if (index < resolutions_.size()) {
+            scan_resolution(resolutions_[index], to_ms(from), to_ms(to), visit);
+        }
+    }
+
+    std::size_t resolutions() const { return resolutions_.size(); }
+
+    std::size_t size(std::size_t index) const {
+        if (index >= resolutions_.size()) {
+            return 0;
+        }
+        std::size_t count = 0;
+        const auto& resolution = resolutions_[index];
+        for (std::size_t b = 0; b < resolution.block_count; ++b) {
+            const auto& header = resolution.header(b);
+            count += header.sequence != 0 ? header.count : 0;
+        }
+        return count;
+    }
+
+    clock::time_point oldest(std::size_t index) const {
+        if (index >= resolutions_.size()) {
+            return {};
+        }
+        const auto oldest_ms = oldest_ms_of(resolutions_[index]);
+        return oldest_ms ? from_ms(*oldest_ms) : clock::time_point{};
+    }
+
+    std::size_t columns() const { return columns_; }
+    std::size_t capacity_bytes() const { return total_bytes_; }
+    bool persistent() const { return mapped_; }
+
+private:
+    struct resolution_state {
+        resolution_state(std::int64_t step, std::size_t blocks, std::size_t columns)
+            : step_ms(step), block_count(blocks), codec(columns), sums(columns) {}
+
+        std::int64_t step_ms;  // 0 = raw samples
+        std::size_t block_count;
+        std::size_t block_bytes = 0;
+        std::uint8_t* blocks = nullptr;
+
+        std::size_t current = 0;  // Block being appended to
+        bool open = false;
+        std::uint64_t next_sequence = 1;
+        codec_state codec;
+
+        // Rollups: running sums of the bucket being filled
+        std::int64_t bucket_start = 0;
+        std::size_t bucket_count = 0;
+        std::vector<double> sums;
+
+        block_header& header(std::size_t index) const {
+            return *reinterpret_cast<block_header*>(blocks + index * block_bytes);
+        }
+        std::uint8_t* payload(std::size_t index) const {
+            return blocks + index * block_bytes + sizeof(block_header);
+        }
+    };
+
+    std::size_t block_count(std::size_t capacity_bytes) const {
+        return std::max<std::size_t>(capacity_bytes / block_bytes_, 2);
+    }
+
+    std::size_t payload_bits() const {
+        return (block_bytes_ - sizeof(block_header)) * 8;
+    }
+
+    void flush_bucket(resolution_state& rollup) {
+        for (std::size_t c = 0; c < columns_; ++c) {
+            sample_buffer_[c] = rollup.sums[c] / static_cast<double>(rollup.bucket_count);
+        }
+        encode(rollup, rollup.bucket_start, sample_buffer_);
+        rollup.bucket_count = 0;
+    }
+
+    void encode(resolution_state& resolution, std::int64_t ms, std::span<const double> values) {
+        if (!resolution.open ||
+            resolution.header(resolution.current).bits + worst_case_bits(columns_) > payload_bits()) {
+            open_block(resolution);
+        }
+
+        auto& header = resolution.header(resolution.current);
+        bit_writer out(resolution.payload(resolution.current), header.bits);
+        auto& codec = resolution.codec;
+
+        if (header.count == 0) {
+            // The first sample of a block is stored verbatim
+            header.first_ms = ms;
+            codec.restart();
+            codec.last_ms = ms;
+            out.write(static_cast<std::uint64_t>(ms), 64);
+            for (std::size_t c = 0; c < columns_; ++c) {
+                codec.last_values[c] = std::bit_cast<std::uint64_t>(values[c]);
+                out.write(codec.last_values[c], 64);
+            }
+        } else {
+            encode_timestamp(out, codec, ms);
+            for (std::size_t c = 0; c < columns_; ++c) {
+                encode_value(out, codec, c, values[c]);
+            }
+        }
+
+        header.last_ms = ms;
+        ++header.count;
+    }
+
+    void open_block(resolution_state& resolution) {
+        if (resolution.open) {
+            resolution.current = (resolution.current + 1) % resolution.block_count;
+        }
+        resolution.open = true;
+
+        auto& header = resolution.header(resolution.current);
+        header = block_header{};
+        header.sequence = resolution.next_sequence++;
+    }
+
+    // Decodes a block, calling on_sample(ms, values) for each sample; returns
+    // the codec state after the last one
+    template<typename F>
+    codec_state decode_block(const resolution_state& resolution, std::size_t index, F&& on_sample) const {
+        const auto& header = resolution.header(index);
+        bit_reader in(resolution.payload(index));
+        codec_state codec(columns_);
+        std::vector<double>& values = decode_buffer_;
+        values.resize(columns_);
+
+        for (std::uint32_t n = 0; n < header.count; ++n) {
+            std::int64_t ms;
+            if (n == 0) {
+                ms = static_cast<std::int64_t>(in.read(64));
+                codec.last_ms = ms;
+                for (std::size_t c = 0; c < columns_; ++c) {
+                    codec.last_values[c] = in.read(64);
+                    values[c] = std::bit_cast<double>(codec.last_values[c]);
+                }
+            } else {
+                ms = decode_timestamp(in, codec);
+                for (std::size_t c = 0; c < columns_; ++c) {
+                    values[c] = decode_value(in, codec, c);
+                }
+            }
+            if (!on_sample(ms, std::span<const double>(values))) {
+                break;
+            }
+        }
+        return codec;
+    }
+
+    void scan_resolution(const resolution_state& resolution, std::int64_t from, std::int64_t to,
+                         const visitor& visit) const {
+        if (!resolution.open || from > to) {
+            return;
+        }
+
+        // Oldest block first: the one after the current block in ring order
+        for (std::size_t n = 1; n <= resolution.block_count; ++n) {
+            const std::size_t index = (resolution.current + n) % resolution.block_count;
+            const auto& header = resolution.header(index);
+            if (header.sequence == 0 || header.count == 0 || header.last_ms < from) {
+                continue;
+            }
+            if (header.first_ms > to) {
+                break;
+            }
+            decode_block(resolution, index, [&](std::int64_t ms, std::span<const double> values) {
+                if (ms > to) {
+                    return false;
+                }
+                if (ms >= from) {
+                    visit(from_ms(ms), values);
+                }
+                return true;
+            });
+        }
+    }
+
+    std::optional<std::int64_t> oldest_ms_of(const resolution_state& resolution) const {
+        if (!resolution.open) {
+            return std::nullopt;
+        }
+        for (std::size_t n = 1; n <= resolution.block_count; ++n) {
+            const auto& header = resolution.header((resolution.current + n) % resolution.block_count);
+            if (header.sequence != 0 && header.count > 0) {
+                return header.first_ms;
+            }
+        }
+        return std::nullopt;
+    }
+
+    std::optional<std::int64_t> newest_ms_of(const resolution_state& resolution) const {
+        if (!resolution.open) {
+            return std::nullopt;
+        }
+        const auto& header = resolution.header(resolution.current);
+        if (header.count == 0) {
+            return std::nullopt;
+        }
+        return header.last_ms;
+    }
+
+    void write_file_header() {
+        file_header header{};
+        std::memcpy(header.magic, file_magic, sizeof(file_magic));
+        header.version = file_version;
+        header.columns = static_cast<std::uint32_t>(columns_);
+        header.block_bytes = static_cast<std::uint32_t>(block_bytes_);
+        header.resolution_count = static_cast<std::uint32_t>(resolutions_.size());
+        for (std::size_t i = 0; i < resolutions_.size(); ++i) {
+            header.resolutions[i].step_ms = resolutions_[i].step_ms;
+            header.resolutions[i].block_count = resolutions_[i].block_count;
+        }
+        std::memcpy(base_, &header, sizeof(header));
+    }
+
+    bool header_matches() const {
+        file_header expected{};
+        std::memcpy(&expected, base_, sizeof(expected));
+        if (std::memcmp(expected.magic, file_magic, sizeof(file_magic)) != 0 ||
+            expected.version != file_version ||
+            expected.columns != columns_ ||
+            expected.block_bytes != block_bytes_ ||
+            expected.resolution_count != resolutions_.size()) {
+            return false;
+        }
+        for (std::size_t i = 0; i < resolutions_.size(); ++i) {
+            if (expected.resolutions[i].step_ms != resolutions_[i].step_ms ||
+                expected.resolutions[i].block_count != resolutions_[i].block_count) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Maps the file, keeping its samples when its layout matches the
+    // configuration and starting over otherwise
+    bool map_file(const std::string& path) {
+#if INTEGRATED_HAS_MMAP
+        const int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+        if (fd < 0) {
+            return false;
+        }
+
+        struct stat info{};
+        const bool same_size = ::fstat(fd, &info) == 0 &&
+                               static_cast<std::size_t>(info.st_size) == total_bytes_;
+        if (!same_size && (::ftruncate(fd, 0) != 0 ||
+                           ::ftruncate(fd, static_cast<off_t>(total_bytes_)) != 0)) {
+            ::close(fd);
+            return false;
+        }
+
+        void* mapping = ::mmap(nullptr, total_bytes_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (mapping == MAP_FAILED) {
+            return false;
+        }
+
+        base_ = static_cast<std::uint8_t*>(mapping);
+        mapped_ = true;
+        if (!same_size || !header_matches()) {
+            std::memset(base_, 0, total_bytes_);
+            write_file_header();
+        }
+        return true;
+#else
+        (void)path;
+        return false;
+#endif
+    }
+
+    // Points each resolution at its blocks and resumes after the newest block
+    void assign_blocks() {
+        std::uint8_t* next = base_ + file_header_bytes;
+        for (auto& resolution : resolutions_) {
+            resolution.blocks = next;
+            resolution.block_bytes = block_bytes_;
+            next += resolution.block_count * block_bytes_;
+
+            std::uint64_t newest = 0;
+            for (std::size_t b = 0; b < resolution.block_count; ++b) {
+                const auto sequence = resolution.header(b).sequence;
+                if (sequence > newest) {
+                    newest = sequence;
+                    resolution.current = b;
+                }
+            }
+            if (newest == 0) {
+                continue;
+            }
+
+            resolution.open = true;
+            resolution.next_sequence = newest + 1;
+            resolution.codec = decode_block(resolution, resolution.current,
+                                            [](std::int64_t, std::span<const double>) { return true; });
+            if (const auto newest_ms = newest_ms_of(resolution)) {
+                latest_ms_ = has_samples_ ? std::max(latest_ms_, *newest_ms) : *newest_ms;
+                has_samples_ = true;
+            }
+        }
+    }
+
+    std::size_t columns_;
+    std::size_t block_bytes_;
+    std::size_t total_bytes_ = 0;
+    std::vector<resolution_state> resolutions_;
+
+    std::unique_ptr<std::uint8_t[]> memory_;
+    std::uint8_t* base_ = nullptr;
+    bool mapped_ = false;
+
+    bool has_samples_ = false;
+    std::int64_t latest_ms_ = 0;
+    std::vector<double> sample_buffer_;
+    mutable std::vector<double> decode_buffer_;
+};
+
+timeseries_store::timeseries_store(const timeseries_config& config)
+    : pimpl_(std::make_unique<impl>(config)) {
+}
+
+timeseries_store::~timeseries_store() = default;
+
+timeseries_store::timeseries_store(timeseries_store&&) noexcept = default;
+timeseries_store& timeseries_store::operator=(timeseries_store&&) noexcept = default;
+
+void timeseries_store::append(clock::time_point timestamp, std::span<const double> values) {
+    pimpl_->append(timestamp, values);
+}
+
+void timeseries_store::scan(clock::time_point from, clock::time_point to, const visitor& visit) const {
+    pimpl_->scan(from, to, visit);
+}
+
+void timeseries_store::scan(std::size_t resolution, clock::time_point from, clock::time_point to,
+                            const visitor& visit) const {
+    pimpl_->scan(resolution, from, to, visit);
+}
+
+std::size_t timeseries_store::resolutions() const {
+    return pimpl_->resolutions();
+}
+
+std::size_t timeseries_store::size(std::size_t resolution) const {
+    return pimpl_->size(resolution);
+}
+
+timeseries_store::clock::time_point timeseries_store::oldest(std::size_t resolution) const {
+    return pimpl_->oldest(resolution);
+}
+
+std::size_t timeseries_store::columns() const {
+    return pimpl_->columns();
+}
+
+std::size_t timeseries_store::capacity_bytes() const {
+    return pimpl_->capacity_bytes();
+}
+
+bool timeseries_store::persistent() const {
+    return pimpl_->persistent();
+}
+
+} // namespace kcenon::integrated
@@ -0,0 +1,101 @@
+// BSD 3-Clause License
+// Copyright (c) 2025, kcenon
+// See the LICENSE file in the project root for full license information.
+
+#include <kcenon/integrated/core/worker_activity.h>
+#include <kcenon/integrated/core/prometheus_writer.h>
+
+#include <algorithm>
+#include <string>
+
+namespace kcenon::integrated {
+
+const char* worker_activity_name(worker_activity activity) {
+    switch (activity) {
+        case worker_activity::busy: return "busy";
+        case worker_activity::spinning: return "spinning";
+        case worker_activity::idle: return "idle";
+        case worker_activity::parked: return "parked";
+    }
+    return "unknown";
+}
+
+worker_utilization worker_clock::read(clock::time_point now) const noexcept {
+    worker_utilization result;
+    std::array<std::uint64_t, worker_activity_count> totals{};
+    std::uint64_t since = 0;
+    std::uint8_t current = 0;
+
+    // Retry while the owner is mid-update, as with any seqlock
+    for (;;) {
+        const std::uint64_t before = sequence_.load(std::memory_order_acquire);
+        if (before & 1) {
+            continue;
+        }
+        for (std::size_t i = 0; i < worker_activity_count; ++i) {
+            totals[i] = totals_[i].load(std::memory_order_relaxed);
+        }
+        since = since_.load(std::memory_order_relaxed);
+        current = current_.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (sequence_.load(std::memory_order_relaxed) == before) {
+            break;
+        }
+    }
+
+    if (since == 0) {
+        return result;
+    }
+
+    const auto now_ns = static_cast<std::uint64_t>(now.time_since_epoch().count());
+    if (now_ns > since) {
+        totals[current] += now_ns - since;
+    }
+    result.state = static_cast<worker_activity>(current);
+    for (std::size_t i = 0; i < worker_activity_count; ++i) {
+        result.time[i] = std::chrono::nanoseconds(totals[i]);
+    }
+    return result;
+}
+
+void write_utilization_prometheus(prometheus_writer& writer, std::string_view pool,
+                                  std::span<const worker_utilization> workers) {
+    writer.family("worker_time_seconds", metric_type::counter,
+                  "Time each worker spent busy, spinning for work, idle or parked");
+    for (const auto& entry : workers) {
+        const std::string worker = std::to_string(entry.worker);
+        for (std::size_t i = 0; i < worker_activity_count; ++i) {
+            const auto activity = static_cast<worker_activity>(i);
+            writer.counter("worker_time_seconds",
+                           {{"pool", pool}, {"worker", worker}, {"state", worker_activity_name(activity)}},
+                           entry[activity]);
+        }
+    }
+
+    writer.family("worker_utilization", metric_type::gauge,
+                  "Busy share of each worker's busy, spinning and idle time since it started");
+    for (const auto& entry : workers) {
+        const std::string worker = std::to_string(entry.worker);
+        writer.gauge("worker_utilization", {{"pool", pool}, {"worker", worker}}, entry.utilization());
+    }
+}
+
+void write_utilization_json(std::ostream& out, std::span<const worker_utilization> workers, int indent) {
+    const std::string pad(static_cast<std::size_t>(std::max(indent, 0)), ' ');
+
+    out << "[";
+    for (std::size_t i = 0; i < workers.size(); ++i) {
+        const auto& entry = workers[i];
+        out << (i == 0 ? "\n" : ",\n");
+        out << pad << "  {\"worker\": " << entry.worker
+            << ", \"state\": \"" << worker_activity_name(entry.state) << "\""
+            << ", \"busy_ns\": " << entry[worker_activity::busy].count()
+            << ", \"spinning_ns\": " << entry[worker_activity::spinning].count()
+            << ", \"idle_ns\": " << entry[worker_activity::idle].count()
+            << ", \"parked_ns\": " << entry[worker_activity::parked].count()
+            << ", \"utilization\": " << entry.utilization() << "}";
+    }
+    out << (workers.empty() ? "]" : "\n" + pad + "]");
+}
+
+} // namespace kcenon::integrated
@@ -6,22 +6,50 @@
 #include <kcenon/integrated/adapters/thread_adapter.h>
 #include <kcenon/integrated/adapters/logger_adapter.h>
 #include <kcenon/integrated/adapters/monitoring_adapter.h>
+#include <kcenon/integrated/core/prometheus_writer.h>
 #include <sstream>
 #include <iomanip>
 #include <ctime>
+#include <iterator>
+#include <utility>
 
 namespace kcenon::integrated::extensions {
 
+namespace {
+
+std::array<named_rate, 4> named_rates(const task_rates& rates) {
+    return {{
+        {"submitted", rates.submitted},
+        {"completed", rates.completed},
+        {"failed", rates.failed},
+        {"rejected", rates.rejected}
+    }};
+}
+
+// Metric names allow [a-zA-Z0-9_:]; collector names such as "system.cpu" are mapped onto that
+void sanitize_metric_name(std::string_view name, std::string& out) {
+    out.clear();
+    for (char c : name) {
+        const bool valid = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+                           (c >= '0' && c <= '9') || c == '_' || c == ':';
+        out += valid ? c : '_';
+    }
+    if (!out.empty() && out.front() >= '0' && out.front() <= '9') {
+        out.insert(out.begin(), '_');
+    }
+}
+
+} // namespace
+
 class metrics_aggregator::impl {
 public:
-    impl()
+    explicit impl(unsigned latency_precision_digits)
         : initialized_(false)
         , thread_adapter_(nullptr)
         , logger_adapter_(nullptr)
         , monitoring_adapter_(nullptr)
-        , tasks_submitted_(0)
-        , tasks_completed_(0)
-        , tasks_failed_(0)
+        , perf_profiler_(nullptr)
+        , task_latency_(latency_precision_digits)
     {}
 
     common::VoidResult initialize() {
@@ -34,6 +62,7 @@ public:
         thread_adapter_ = nullptr;
         logger_adapter_ = nullptr;
         monitoring_adapter_ = nullptr;
+        perf_profiler_ = nullptr;
         return common::ok();
     }
 
@@ -49,6 +78,10 @@ public:
         monitoring_adapter_ = adapter;
     }
 
+    void set_perf_profiler(const perf_profiler* profiler) {
+        perf_profiler_ = profiler;
+    }
+
     common::Result<aggregated_metrics> collect_metrics() {
         if (!initialized_) {
             return common::Result<aggregated_metrics>::err(
@@ -64,9 +97,33 @@ public:
         if (thread_adapter_ && thread_adapter_->is_initialized()) {
             metrics.thread_pool_workers = thread_adapter_->worker_count();
             metrics.thread_pool_queue_size = thread_adapter_->queue_size();
-            metrics.tasks_submitted = tasks_submitted_.load();
-            metrics.tasks_completed = tasks_completed_.load();
-            metrics.tasks_failed = tasks_failed_.load();
+            metrics.tasks_submitted = tasks_submitted_.count();
+            metrics.tasks_completed = tasks_completed_.count();
+            metrics.tasks_failed = tasks_failed_.count();
+            metrics.tasks_rejected = tasks_rejected_.count();
+            metrics.rates = current_rates();
+            metrics.lane_latencies = task_latency_.snapshot().lanes();
+            if (const auto* profiler = thread_adapter_->lock_profiling()) {
+                metrics.locks = profiler->snapshot();
+            }
+
+            thread_adapter_->read_workers(metrics.workers);
+            std::chrono::nanoseconds busy{0};
+            std::chrono::nanoseconds available{0};
+            for (const auto& entry : metrics.workers) {
+                busy += entry[worker_activity::busy];
+                available += entry.available();
+                if (entry.state == worker_activity::busy) {
+                    ++metrics.active_workers;
+                }
+            }
+            if (available.count() > 0) {
+                metrics.pool_utilization = static_cast<double>(busy.count()) / available.count();
+            }
+        }
+
+        if (perf_profiler_) {
+            metrics.task_classes = perf_profiler_->snapshot();
         }
 
         // Collect monitoring system metrics (CPU, memory)
@@ -95,56 +152,82 @@ public:
         return common::Result<aggregated_metrics>::ok(metrics);
     }
 
-    std::string export_prometheus_format() {
-        std::ostringstream oss;
-
-        // Header
-        oss << "# HELP integrated_thread_system Metrics from Integrated Thread System\n";
-        oss << "# TYPE integrated_thread_system gauge\n\n";
-
-        // Thread pool metrics
-        oss << "# HELP thread_pool_workers Number of worker threads\n";
-        oss << "# TYPE thread_pool_workers gauge\n";
-        oss << "thread_pool_workers " << latest_metrics_.thread_pool_workers << "\n\n";
-
-        oss << "# HELP thread_pool_queue_size Current queue size\n";
-        oss << "# TYPE thread_pool_queue_size gauge\n";
-        oss << "thread_pool_queue_size " << latest_metrics_.thread_pool_queue_size << "\n\n";
+    void set_pool_name(std::string name) {
+        pool_name_ = std::move(name);
+    }
 
-        oss << "# HELP tasks_submitted_total Total tasks submitted\n";
-        oss << "# TYPE tasks_submitted_total counter\n";
-        oss << "tasks_submitted_total " << latest_metrics_.tasks_submitted << "\n\n";
+    void export_prometheus(prometheus_writer& writer) {
+        const std::string_view pool = pool_name_;
+        const metric_labels labels = {{"pool", pool}};
+
+        const struct {
+            const char* name;
+            const char* help;
+            double value;
+        } gauges[] = {
+            {"thread_pool_workers", "Number of worker threads",
+             static_cast<double>(latest_metrics_.thread_pool_workers)},
+            {"configured_workers", "Configured worker threads",
+             static_cast<double>(latest_metrics_.thread_pool_workers)},
+            {"active_workers", "Workers running a task",
+             static_cast<double>(latest_metrics_.active_workers)},
+            {"thread_pool_queue_size", "Current queue size",
+             static_cast<double>(latest_metrics_.thread_pool_queue_size)},
+            {"system_cpu_usage_percent", "CPU usage percentage", latest_metrics_.cpu_usage_percent},
+            {"system_memory_usage_percent", "Memory usage percentage", latest_metrics_.memory_usage_percent}
+        };
+        for (const auto& [name, help, value] : gauges) {
+            writer.family(name, metric_type::gauge, help);
+            writer.gauge(name, labels, value);
+        }
 
-        oss << "# HELP tasks_completed_total Total tasks completed\n";
-        oss << "# TYPE tasks_completed_total counter\n";
-        oss << "tasks_completed_total " << latest_metrics_.tasks_completed << "\n\n";
+        const struct {
+            const char* name;
+            const char* help;
+            std::uint64_t value;
+        } counters[] = {
+            {"tasks_submitted", "Total tasks submitted", latest_metrics_.tasks_submitted},
+            {"tasks_completed", "Total tasks completed", latest_metrics_.tasks_completed},
+            {"tasks_failed", "Total task submissions that failed", latest_metrics_.tasks_failed},
+            {"tasks_rejected", "Total task submissions refused", latest_metrics_.tasks_rejected},
+            {"log_messages_written", "Total log messages written", latest_metrics_.log_messages_written},
+            {"log_errors", "Total log errors", latest_metrics_.log_errors}
+        };
+        for (const auto& [name, help, value] : counters) {
+            writer.family(name, metric_type::counter, help);
+            writer.counter(name, labels, value);
+        }
 
-        // System metrics
-        oss << "# HELP system_cpu_usage_percent CPU usage percentage\n";
-        oss << "# TYPE system_cpu_usage_percent gauge\n";
-        oss << "system_cpu_usage_percent " << latest_metrics_.cpu_usage_percent << "\n\n";
+        const auto rates = named_rates(latest_metrics_.rates);
+        write_rates_prometheus(writer, pool, rates);
 
-        oss << "# HELP system_memory_usage_percent Memory usage percentage\n";
-        oss << "# TYPE system_memory_usage_percent gauge\n";
-        oss << "system_memory_usage_percent " << latest_metrics_.memory_usage_percent << "\n\n";
+        // Histograms come from the live recorder, merged into a reused scratch snapshot
+        export_latency_.clear();
+        task_latency_.merge_into(export_latency_);
+        write_latency_prometheus(writer, pool, export_latency_);
 
-        // Logger metrics
-        oss << "# HELP log_messages_written_total Total log messages written\n";
-        oss << "# TYPE log_messages_written_total counter\n";
-        oss << "log_messages_written_total " << latest_metrics_.log_messages_written << "\n\n";
+        write_utilization_prometheus(writer, pool, latest_metrics_.workers);
 
-        oss << "# HELP log_errors_total Total log errors\n";
-        oss << "# TYPE log_errors_total counter\n";
-        oss << "log_errors_total " << latest_metrics_.log_errors << "\n\n";
+        if (thread_adapter_ && thread_adapter_->is_initialized()) {
+            if (const auto* profiler = thread_adapter_->lock_profiling()) {
+                profiler->write_prometheus(writer, pool);
+            }
+        }
+        if (perf_profiler_) {
+            perf_profiler_->write_prometheus(writer, pool);
+        }
 
-        // Custom metrics
         for (const auto& [name, value] : latest_metrics_.custom_metrics) {
-            oss << "# HELP " << name << " Custom metric\n";
-            oss << "# TYPE " << name << " gauge\n";
-            oss << name << " " << value << "\n\n";
+            sanitize_metric_name(name, export_name_);
+            writer.family(export_name_, metric_type::gauge, "Custom metric");
+            writer.gauge(export_name_, labels, value);
         }
+    }
 
-        return oss.str();
+    std::string export_prometheus_format(exposition_format format) {
+        export_writer_.reset(format);
+        export_prometheus(export_writer_);
+        return std::string(export_writer_.finish());
     }
 
     std::string export_json_format() {
@@ -163,9 +246,30 @@ public:
         oss << "    \"workers\": " << latest_metrics_.thread_pool_workers << ",\n";
         oss << "    \"queue_size\": " << latest_metrics_.thread_pool_queue_size << ",\n";
         oss << "    \"tasks_submitted\": " << latest_metrics_.tasks_submitted << ",\n";
-        oss << "    \"tasks_completed\": " << latest_metrics_.tasks_completed << "\n";
+        oss << "    \"tasks_completed\": " << latest_metrics_.tasks_completed << ",\n";
+        oss << "    \"tasks_rejected\": " << latest_metrics_.tasks_rejected << ",\n";
+        oss << "    \"active_workers\": " << latest_metrics_.active_workers << ",\n";
+        oss << "    \"pool_utilization\": " << latest_metrics_.pool_utilization << ",\n";
+        oss << "    \"rates\": ";
+        write_rates_json(oss, named_rates(latest_metrics_.rates), 4);
+        oss << ",\n";
+        oss << "    \"latency_by_lane\": ";
+        write_latency_json(oss, latest_metrics_.lane_latencies, 4);
+        oss << "\n";
         oss << "  },\n";
 
+        // Top-level arrays laid out as in the enhanced build's export;
+        // thread_pool.workers above is only the count
+        oss << "  \"workers\": ";
+        write_utilization_json(oss, latest_metrics_.workers, 2);
+        oss << ",\n";
+        oss << "  \"locks\": ";
+        write_lock_contention_json(oss, latest_metrics_.locks, 2);
+        oss << ",\n";
+        oss << "  \"task_counters\": ";
+        write_task_counters_json(oss, latest_metrics_.task_classes, 2);
+        oss << ",\n";
+
         oss << "  \"system\": {\n";
         oss << "    \"cpu_usage_percent\": " << latest_metrics_.cpu_usage_percent << ",\n";
         oss << "    \"memory_usage_percent\": " << latest_metrics_.memory_usage_percent << "\n";
@@ -192,15 +296,40 @@ public:
     }
 
     void increment_tasks_submitted() {
-        tasks_submitted_.fetch_add(1, std::memory_order_relaxed);
+        tasks_submitted_.mark();
     }
 
     void increment_tasks_completed() {
-        tasks_completed_.fetch_add(1, std::memory_order_relaxed);
+        tasks_completed_.mark();
     }
 
     void increment_tasks_failed() {
-        tasks_failed_.fetch_add(1, std::memory_order_relaxed);
+        tasks_failed_.mark();
+    }
+
+    void increment_tasks_rejected() {
+        tasks_rejected_.mark();
+    }
+
+    task_rates current_rates() {
+        const auto now = rate_meter::clock::now();
+        task_rates rates;
+        rate_meter* meters[] = {&tasks_submitted_, &tasks_completed_, &tasks_failed_, &tasks_rejected_};
+        rate_snapshot* targets[] = {&rates.submitted, &rates.completed, &rates.failed, &rates.rejected};
+        for (std::size_t i = 0; i < std::size(meters); ++i) {
+            meters[i]->tick(now);
+            *targets[i] = meters[i]->snapshot(now);
+        }
+        return rates;
+    }
+
+    void record_task_latency(int priority, std::chrono::nanoseconds queue_wait,
+                             std::chrono::nanoseconds execution) {
+        task_latency_.record(priority, queue_wait, execution);
+    }
+
+    task_latency_snapshot latency_breakdown() const {
+        return task_latency_.snapshot();
     }
 
 private:
@@ -208,18 +337,30 @@ private:
     adapters::thread_adapter* thread_adapter_;
     adapters::logger_adapter* logger_adapter_;
     adapters::monitoring_adapter* monitoring_adapter_;
+    const perf_profiler* perf_profiler_;
+
+    // Counters, sharded per thread: incremented from every worker on every task.
+    // Rates are folded in lazily when read.
+    rate_meter tasks_submitted_;
+    rate_meter tasks_completed_;
+    rate_meter tasks_failed_;
+    rate_meter tasks_rejected_;
 
-    // Counters (thread-safe)
-    std::atomic<std::size_t> tasks_submitted_;
-    std::atomic<std::size_t> tasks_completed_;
-    std::atomic<std::size_t> tasks_failed_;
+    // Lock-free; shared by all workers
+    task_latency_recorder task_latency_;
 
     // Latest collected metrics
     aggregated_metrics latest_metrics_;
+
+    // Exposition state reused across scrapes
+    std::string pool_name_{"default"};
+    prometheus_writer export_writer_;
+    task_latency_snapshot export_latency_;
+    std::string export_name_;
 };
 
-metrics_aggregator::metrics_aggregator()
-    : pimpl_(std::make_unique<impl>()) {}
+metrics_aggregator::metrics_aggregator(unsigned latency_precision_digits)
+    : pimpl_(std::make_unique<impl>(latency_precision_digits)) {}
 
 metrics_aggregator::~metrics_aggregator() = default;
 
@@ -243,12 +384,24 @@ void metrics_aggregator::set_monitoring_adapter(kcenon::integrated::adapters::mo
     pimpl_->set_monitoring_adapter(adapter);
 }
 
+void metrics_aggregator::set_perf_profiler(const perf_profiler* profiler) {
+    pimpl_->set_perf_profiler(profiler);
+}
+
 common::Result<aggregated_metrics> metrics_aggregator::collect_metrics() {
     return pimpl_->collect_metrics();
 }
 
-std::string metrics_aggregator::export_prometheus_format() {
-    return pimpl_->export_prometheus_format();
+std::string metrics_aggregator::export_prometheus_format(exposition_format format) {
+    return pimpl_->export_prometheus_format(format);
+}
+
+void metrics_aggregator::export_prometheus(prometheus_writer& writer) {
+    pimpl_->export_prometheus(writer);
+}
+
+void metrics_aggregator::set_pool_name(std::string name) {
+    pimpl_->set_pool_name(std::move(name));
 }
 
 std::string metrics_aggregator::export_json_format() {
@@ -267,4 +420,21 @@ void metrics_aggregator::increment_tasks_failed() {
     pimpl_->increment_tasks_failed();
 }
 
+void metrics_aggregator::increment_tasks_rejected() {
+    pimpl_->increment_tasks_rejected();
+}
+
+task_rates metrics_aggregator::current_rates() {
+    return pimpl_->current_rates();
+}
+
+void metrics_aggregator::record_task_latency(int priority, std::chrono::nanoseconds queue_wait,
+                                             std::chrono::nanoseconds execution) {
+    pimpl_->record_task_latency(priority, queue_wait, execution);
+}
+
+task_latency_snapshot metrics_aggregator::latency_breakdown() const {
+    return pimpl_->latency_breakdown();
+}
+
 } // namespace kcenon::integrated::extensions
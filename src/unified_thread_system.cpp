@@ -5,17 +5,57 @@
 #include <kcenon/integrated/unified_thread_system.h>
 #include <kcenon/integrated/core/system_coordinator.h>
 #include <kcenon/integrated/core/configuration.h>
+#include <kcenon/integrated/core/circuit_breaker.h>
+#include <kcenon/integrated/core/flight_recorder.h>
+#include <kcenon/integrated/core/health_probes.h>
+#include <kcenon/integrated/core/sharded_counter.h>
+#include <kcenon/integrated/core/task_tracer.h>
 #include <kcenon/integrated/adapters/thread_adapter.h>
 #include <kcenon/integrated/adapters/logger_adapter.h>
 #include <kcenon/integrated/adapters/monitoring_adapter.h>
+#include <kcenon/integrated/adapters/io_adapter.h>
+#include <kcenon/integrated/adapters/metrics_endpoint.h>
 #include <kcenon/integrated/extensions/metrics_aggregator.h>
-// distributed_tracing and plugin_manager removed (planned for v2.1.0)
+// plugin_manager removed (planned for v2.1.0)
+#include "core/json_format.h"
 
+#include <condition_variable>
+#include <ctime>
+#include <filesystem>
+#include <iomanip>
 #include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
 #include <unordered_map>
+#include <vector>
 
 namespace kcenon::integrated {
 
+namespace {
+
+// Minimum spacing of the automatic flight recorder dumps on critical health
+constexpr auto flight_dump_interval = std::chrono::minutes(1);
+
+// How often the background thread polls the health probes
+constexpr auto background_tick = std::chrono::milliseconds(100);
+
+using detail::health_level_name;
+using detail::write_json_string;
+
+// std::localtime shares one buffer between threads
+std::tm local_time(std::time_t time) {
+    std::tm result{};
+#if defined(_WIN32)
+    localtime_s(&result, &time);
+#else
+    localtime_r(&time, &result);
+#endif
+    return result;
+}
+
+} // namespace
+
 /**
  * @brief Implementation of unified_thread_system
  */
@@ -23,7 +63,10 @@ class unified_thread_system::impl {
 public:
     explicit impl(const config& cfg)
         : config_(cfg)
-        , shutting_down_(false) {
+        , shutting_down_(false)
+        , start_time_(std::chrono::steady_clock::now())
+        , metric_registry_(cfg.name, cfg.max_series_per_metric)
+        , health_probes_(cfg.health_check_interval, cfg.health_check_timeout, [this] { publish_health(); }) {
 
         // Convert old config to new unified_config
         unified_config unified_cfg;
@@ -36,6 +79,15 @@ public:
         unified_cfg.thread.enable_dynamic_scaling = cfg.enable_dynamic_scaling;
         unified_cfg.thread.min_threads = cfg.min_threads;
         unified_cfg.thread.max_threads = cfg.max_threads;
+        unified_cfg.thread.enable_batch_processing = cfg.enable_batch_processing;
+        unified_cfg.thread.batch_size = cfg.batch_size;
+        unified_cfg.thread.enable_lock_profiling = cfg.enable_lock_profiling;
+        if (cfg.enable_tracing) {
+            // Runs on each worker before its first task; tracer_ exists by then
+            unified_cfg.thread.on_worker_start = [this](std::size_t index) {
+                tracer_->name_thread("worker " + std::to_string(index));
+            };
+        }
 
         // Logger configuration
         unified_cfg.logger.enable_file_logging = cfg.enable_file_logging;
@@ -45,18 +97,43 @@ public:
 
         // Monitoring configuration
         unified_cfg.monitoring.enable_monitoring = cfg.enable_monitoring;
+        unified_cfg.monitoring.enable_distributed_tracing = cfg.enable_tracing;
 
         // Circuit breaker configuration
         unified_cfg.circuit_breaker.enabled = cfg.enable_circuit_breaker;
         unified_cfg.circuit_breaker.failure_threshold = cfg.circuit_breaker_failure_threshold;
         unified_cfg.circuit_breaker.reset_timeout = cfg.circuit_breaker_reset_timeout;
+        unified_cfg.circuit_breaker.window_seconds = cfg.circuit_breaker_window_seconds;
+        unified_cfg.circuit_breaker.minimum_calls = cfg.circuit_breaker_minimum_calls;
+        unified_cfg.circuit_breaker.failure_rate_threshold = cfg.circuit_breaker_failure_rate;
+        unified_cfg.circuit_breaker.slow_call_rate_threshold = cfg.circuit_breaker_slow_call_rate;
+        unified_cfg.circuit_breaker.slow_call_duration = cfg.circuit_breaker_slow_call_duration;
+        unified_cfg.circuit_breaker.half_open_permits = cfg.circuit_breaker_half_open_permits;
+        if (unified_cfg.circuit_breaker.enabled) {
+            breaker_ = std::make_unique<circuit_breaker>(unified_cfg.circuit_breaker);
+        }
 
         // Create coordinator
         coordinator_ = std::make_unique<system_coordinator>(unified_cfg);
 
         // Initialize extensions
-        metrics_aggregator_ = std::make_unique<extensions::metrics_aggregator>();
-        // distributed_tracing and plugin_manager removed (planned for v2.1.0)
+        metrics_aggregator_ = std::make_unique<extensions::metrics_aggregator>(
+            static_cast<unsigned>(cfg.latency_precision_digits));
+        if (unified_cfg.monitoring.enable_distributed_tracing) {
+            trace_config trace_cfg;
+            trace_cfg.process_name = cfg.name;
+            trace_cfg.sample_rate = cfg.trace_sample_rate;
+            trace_cfg.events_per_thread = cfg.trace_events_per_thread;
+            tracer_ = std::make_unique<task_tracer>(trace_cfg);
+        }
+        if (cfg.enable_flight_recorder) {
+            // Workers live inside the thread adapter, so every event goes to the shared ring
+            flight_recorder_ = std::make_unique<flight_recorder>(0, cfg.flight_recorder_events);
+        }
+        if (cfg.enable_perf_counters) {
+            perf_profiler_ = std::make_unique<perf_profiler>(cfg.max_task_labels, cfg.perf_counter_interval);
+        }
+        // plugin_manager removed (planned for v2.1.0)
 
         // Initialize all systems
         auto init_result = coordinator_->initialize();
@@ -67,13 +144,26 @@ public:
 
         // Initialize extensions
         metrics_aggregator_->initialize();
+        metrics_aggregator_->set_pool_name(cfg.name);
 
         // Connect adapters to metrics aggregator
         metrics_aggregator_->set_thread_adapter(coordinator_->get_thread_adapter());
         metrics_aggregator_->set_logger_adapter(coordinator_->get_logger_adapter());
         metrics_aggregator_->set_monitoring_adapter(coordinator_->get_monitoring_adapter());
+        metrics_aggregator_->set_perf_profiler(perf_profiler_.get());
+
+        // plugin_manager removed (planned for v2.1.0)
+
+        // Readers never see an empty snapshot; no checks are registered yet
+        publish_health();
+        next_health_evaluation_ = std::chrono::steady_clock::now() + config_.health_check_interval;
 
-        // distributed_tracing and plugin_manager removed (planned for v2.1.0)
+        if (cfg.enable_metrics_endpoint) {
+            start_metrics_endpoint(cfg);
+        }
+
+        // Last, so a constructor that throws leaves no thread to join
+        background_thread_ = std::thread([this] { background_loop(); });
     }
 
     ~impl() {
@@ -84,7 +174,7 @@ public:
 
     void submit_internal(std::function<void()> task) {
         if (shutting_down_) {
-            throw std::runtime_error("System is shutting down");
+            reject(flight_reject_reason::shutting_down, "System is shutting down");
         }
 
         auto* thread_adapter = coordinator_->get_thread_adapter();
@@ -92,33 +182,28 @@ public:
             throw std::runtime_error("Thread adapter not available");
         }
 
+        const circuit_permit permit = acquire_permit();
+
         // Increment submitted counter before submission
         metrics_aggregator_->increment_tasks_submitted();
 
-        // Wrap task to track completion
-        auto wrapped_task = [this, task = std::move(task)]() mutable {
-            try {
-                task();
-                // Increment completed counter on success
-                metrics_aggregator_->increment_tasks_completed();
-            } catch (...) {
-                // Still count as completed even if task throws
-                metrics_aggregator_->increment_tasks_completed();
-                throw;
-            }
-        };
+        // Wrap task to track completion and latency
+        const std::uint64_t trace_id = trace_submit();
+        auto wrapped_task = with_tracking(static_cast<int>(priority_level::normal), std::move(task), trace_id);
+        if (breaker_) {
+            wrapped_task = with_breaker(std::move(wrapped_task), permit);
+        }
 
+        trace_enqueue(trace_id);
         auto result = thread_adapter->execute(std::move(wrapped_task));
         if (result.is_err()) {
-            // Track failed submission separately
-            metrics_aggregator_->increment_tasks_failed();
-            throw std::runtime_error("Failed to submit task: " + result.error().message);
+            submit_failed(permit, result.error().message);
         }
     }
 
-    void submit_priority_internal(int priority, std::function<void()> task) {
+    void submit_priority_internal(int priority, std::function<void()> task, task_label label = {}) {
         if (shutting_down_) {
-            throw std::runtime_error("System is shutting down");
+            reject(flight_reject_reason::shutting_down, "System is shutting down");
         }
 
         auto* thread_adapter = coordinator_->get_thread_adapter();
@@ -126,26 +211,25 @@ public:
             throw std::runtime_error("Thread adapter not available");
         }
 
+        const circuit_permit permit = acquire_permit();
+
         // Increment submitted counter before submission
         metrics_aggregator_->increment_tasks_submitted();
 
-        // Wrap task to track completion
-        auto wrapped_task = [this, task = std::move(task)]() mutable {
-            try {
-                task();
-                metrics_aggregator_->increment_tasks_completed();
-            } catch (...) {
-                metrics_aggregator_->increment_tasks_completed();
-                throw;
-            }
-        };
+        // Wrap task to track completion and latency
+        const std::uint64_t trace_id = trace_submit();
+        auto wrapped_task = with_tracking(priority, std::move(task), trace_id, label);
+        if (breaker_) {
+            wrapped_task = with_breaker(std::move(wrapped_task), permit);
+        }
+        trace_enqueue(trace_id);
 
-        // Use thread_adapter's priority submission
-        // Note: Currently thread_adapter::submit_with_priority falls back to regular execute
-        // This will be activated when thread_system adds priority queue support
-        auto future = thread_adapter->submit_with_priority(priority, std::move(wrapped_task));
-        // Let the future go out of scope - we don't need to wait for it
-        (void)future;
+        // Straight to execute_with_priority: submit_with_priority would drop a
+        // rejection, leaving the task's breaker permit taken forever
+        auto result = thread_adapter->execute_with_priority(priority, std::move(wrapped_task));
+        if (result.is_err()) {
+            submit_failed(permit, result.error().message);
+        }
     }
 
     void schedule_internal(std::chrono::milliseconds delay, std::function<void()> task) {
@@ -169,18 +253,102 @@ public:
 
     performance_metrics get_metrics() const {
         performance_metrics metrics;
+        const auto now = std::chrono::steady_clock::now();
         auto* thread_adapter = coordinator_->get_thread_adapter();
         if (thread_adapter) {
-            metrics.active_workers = thread_adapter->worker_count();
+            thread_adapter->read_workers(metrics.workers, now);
+            metrics.blocked_workers = thread_adapter->blocked_worker_count();
+            metrics.compensating_workers = thread_adapter->compensating_worker_count();
             metrics.queue_size = thread_adapter->queue_size();
+            if (const auto* profiler = thread_adapter->lock_profiling()) {
+                metrics.locks = profiler->snapshot();
+            }
+        }
+        if (perf_profiler_) {
+            metrics.task_classes = perf_profiler_->snapshot();
+        }
+
+        const auto rates = metrics_aggregator_->current_rates();
+        metrics.tasks_submitted = rates.submitted.count;
+        metrics.tasks_completed = rates.completed.count;
+        metrics.tasks_failed = rates.failed.count;
+        metrics.tasks_rejected = rates.rejected.count;
+        metrics.submission_rate = rates.submitted;
+        metrics.completion_rate = rates.completed;
+        metrics.failure_rate = rates.failed;
+        metrics.rejection_rate = rates.rejected;
+        metrics.tasks_per_second = rates.completed.window_rate;
+
+        const auto breakdown = metrics_aggregator_->latency_breakdown();
+        const auto execution = breakdown.total_execution();
+        metrics.queue_wait_latency = latency_summary::from(breakdown.total_queue_wait());
+        metrics.execution_latency = latency_summary::from(execution);
+        metrics.end_to_end_latency = latency_summary::from(breakdown.total_end_to_end());
+        metrics.lane_latencies = breakdown.lanes();
+        if (execution.count() > 0) {
+            metrics.min_latency = execution.min();
+            metrics.max_latency = execution.max();
+            metrics.average_latency = execution.mean();
+            metrics.p50_latency = execution.percentile(0.50);
+            metrics.p95_latency = execution.percentile(0.95);
+            metrics.p99_latency = execution.percentile(0.99);
+            metrics.p999_latency = execution.percentile(0.999);
+        }
+        metrics.measurement_start = start_time_;
+
+        // Busy time comes from the workers' clocks, so a task run by a waiting
+        // worker is counted once, inside the wait
+        std::chrono::nanoseconds busy{0};
+        std::chrono::nanoseconds available{0};
+        for (const auto& entry : metrics.workers) {
+            busy += entry[worker_activity::busy];
+            available += entry.available();
+            if (entry.state == worker_activity::busy) {
+                ++metrics.active_workers;
+            }
         }
+        if (available.count() > 0) {
+            metrics.pool_utilization = static_cast<double>(busy.count()) / available.count();
+        }
+
+        const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(now - start_time_).count();
+        if (elapsed > 0) {
+            metrics.average_busy_workers = static_cast<double>(busy.count()) / elapsed;
+            metrics.average_queue_length = static_cast<double>(queued_ns_.value()) / elapsed;
+            metrics.average_tasks_in_system = metrics.average_busy_workers + metrics.average_queue_length;
+        }
+
         // Future: Include enhanced metrics from monitoring_system v2.0.0+ collectors
         // See ADAPTER_INTEGRATION_GUIDE.md Phase 5 for collector integration details
         return metrics;
     }
 
-    health_status get_health() const {
+    // Health as of the last evaluation, replaced whole so that get_health(),
+    // is_healthy() and /health are a single load
+    struct health_snapshot {
         health_status status;
+        std::string json;
+    };
+
+    health_status get_health() const {
+        return load_health()->status;
+    }
+
+    std::shared_ptr<const health_snapshot> load_health() const {
+#if defined(__cpp_lib_atomic_shared_ptr)
+        return health_.load(std::memory_order_acquire);
+#else
+        return std::atomic_load_explicit(&health_, std::memory_order_acquire);
+#endif
+    }
+
+    // Republishes with the last check results, for state that changes
+    // between evaluations, such as the breaker opening
+    void publish_health() {
+        std::lock_guard<std::mutex> lock(health_publish_mutex_);
+
+        auto snapshot = std::make_shared<health_snapshot>();
+        health_status& status = snapshot->status;
         auto* monitoring_adapter = coordinator_->get_monitoring_adapter();
         if (monitoring_adapter) {
             // Get health check from monitoring_adapter
@@ -192,7 +360,25 @@ public:
                     health_level::healthy : health_level::degraded;
             }
         }
-        return status;
+
+        status.issues = health_probes_.issues();
+        status.circuit_breaker_open = breaker_ && breaker_->is_open();
+        if (status.circuit_breaker_open || !status.issues.empty()) {
+            status.overall_health = health_level::critical;
+        }
+        snapshot->json = health_json(status);
+
+#if defined(__cpp_lib_atomic_shared_ptr)
+        health_.store(std::move(snapshot), std::memory_order_release);
+#else
+        std::atomic_store_explicit(&health_, std::shared_ptr<const health_snapshot>(std::move(snapshot)),
+                                   std::memory_order_release);
+#endif
+
+        const bool critical = status.overall_health == health_level::critical;
+        if (health_critical_.exchange(critical) != critical && critical) {
+            request_flight_dump();
+        }
     }
 
     void wait_for_completion() {
@@ -221,15 +407,61 @@ public:
     }
 
     bool is_healthy() const {
-        return get_health().overall_health == health_level::healthy;
+        return load_health()->status.overall_health == health_level::healthy;
+    }
+
+    void add_health_check(const std::string& name, std::function<std::pair<bool, std::string>()> check,
+                          std::chrono::milliseconds timeout) {
+        health_probes_.add_check(name, std::move(check), timeout);
+    }
+
+    void register_metric_collector(const std::string& name, std::function<double()> collector,
+                                   gauge_handle gauge) {
+        health_probes_.add_collector(name, std::move(collector), gauge);
+    }
+
+    // Starts the due probes; true when a check newly timed out
+    bool poll_probes(std::chrono::steady_clock::time_point now) {
+        return health_probes_.poll(now, [this](std::function<void()> probe) {
+            auto* thread_adapter = coordinator_->get_thread_adapter();
+            return thread_adapter && !shutting_down_ && thread_adapter->execute_untracked(std::move(probe)).is_ok();
+        });
     }
 
     void shutdown_impl() {
         if (shutting_down_) return;
         shutting_down_ = true;
-        // plugin_manager and distributed_tracing removed (planned for v2.1.0)
+        if (metrics_endpoint_) {
+            metrics_endpoint_->shutdown();
+        }
+        // plugin_manager removed (planned for v2.1.0)
         metrics_aggregator_->shutdown();
+        {
+            std::lock_guard<std::mutex> lock(io_mutex_);
+            if (io_adapter_) {
+                io_adapter_->shutdown();
+            }
+        }
+        // Before the coordinator drops the adapters the background thread uses
+        if (background_thread_.joinable()) {
+            {
+                std::lock_guard<std::mutex> lock(flight_dump_mutex_);
+                background_stop_ = true;
+            }
+            background_cv_.notify_one();
+            background_thread_.join();
+        }
         coordinator_->shutdown();
+
+        // The breaker may have opened while the workers drained
+        std::vector<std::uint64_t> heads;
+        {
+            std::lock_guard<std::mutex> lock(flight_dump_mutex_);
+            heads.swap(pending_flight_dump_);
+        }
+        if (!heads.empty()) {
+            write_flight_dump(heads);
+        }
     }
 
     void shutdown_immediate() { shutdown_impl(); }
@@ -244,20 +476,94 @@ public:
         return metrics_aggregator_->export_json_format();
     }
 
-    std::string export_metrics_prometheus() const {
+    std::string export_metrics_prometheus(exposition_format format) const {
         // Collect latest metrics before exporting
         auto result = metrics_aggregator_->collect_metrics();
         if (result.is_err()) {
             return "# Error: Failed to collect metrics: " + result.error().message + "\n";
         }
-        return metrics_aggregator_->export_prometheus_format();
+        thread_local prometheus_writer writer;
+        writer.reset(format);
+        metrics_aggregator_->export_prometheus(writer);
+        write_system_metrics(writer);
+        return std::string(writer.finish());
+    }
+
+    void export_metrics(prometheus_writer& writer) const {
+        if (metrics_aggregator_->collect_metrics().is_ok()) {
+            metrics_aggregator_->export_prometheus(writer);
+        }
+        write_system_metrics(writer);
+    }
+
+    // Families the system owns, written after the aggregator's
+    void write_system_metrics(prometheus_writer& writer) const {
+        const metric_labels labels = {{"pool", config_.name}};
+        writer.family("task_queued_seconds", metric_type::counter,
+                      "Queue wait summed over started tasks; its rate is the average queue length");
+        writer.counter("task_queued_seconds", labels, std::chrono::nanoseconds(queued_ns_.value()));
+        metric_registry_.write(writer);
+    }
+
+    task_label register_task_label(const std::string& name) {
+        if (name.empty()) {
+            throw std::invalid_argument("Task label name must not be empty");
+        }
+        return perf_profiler_ ? perf_profiler_->label(name) : task_label{};
+    }
+
+    metric_registry& metrics() { return metric_registry_; }
+
+    const task_tracer& tracer() const {
+        if (!tracer_) {
+            throw std::runtime_error("Tracing is not enabled");
+        }
+        return *tracer_;
+    }
+
+    const flight_recorder& flight() const {
+        if (!flight_recorder_) {
+            throw std::runtime_error("Flight recorder is not enabled");
+        }
+        return *flight_recorder_;
+    }
+
+    std::string export_health_json() const {
+        return load_health()->json;
+    }
+
+    static std::string health_json(const health_status& status) {
+        std::ostringstream oss;
+        oss << "{\n";
+        oss << "  \"status\": \"" << health_level_name(status.overall_health) << "\",\n";
+        oss << "  \"queue_utilization_percent\": " << status.queue_utilization_percent << ",\n";
+        oss << "  \"circuit_breaker_open\": " << (status.circuit_breaker_open ? "true" : "false") << ",\n";
+        oss << "  \"consecutive_failures\": " << status.consecutive_failures << ",\n";
+        oss << "  \"issues\": [";
+        for (size_t i = 0; i < status.issues.size(); ++i) {
+            oss << (i == 0 ? "" : ", ");
+            write_json_string(oss, status.issues[i]);
+        }
+        oss << "]\n";
+        oss << "}";
+        return oss.str();
+    }
+
+    std::uint16_t metrics_endpoint_port() const {
+        return metrics_endpoint_ ? metrics_endpoint_->port() : 0;
     }
 
     void cancel_recurring(size_t task_id) {}
     size_t subscribe_to_events(const std::string& event_type, event_callback callback) { return 0; }
     void unsubscribe_from_events(size_t subscription_id) {}
-    void reset_circuit_breaker() {}
-    bool is_circuit_open() const { return false; }
+    void reset_circuit_breaker() {
+        if (breaker_) {
+            breaker_->reset();
+        }
+        publish_health();
+    }
+
+    bool is_circuit_open() const { return breaker_ && breaker_->is_open(); }
 
     void load_plugin(const std::string& /* plugin_path */) {
         // plugin_manager removed (planned for v2.1.0)
@@ -316,7 +622,7 @@ public:
 
     void submit_cancellable_internal(std::shared_ptr<void> token, std::function<void()> task) {
         if (shutting_down_) {
-            throw std::runtime_error("System is shutting down");
+            reject(flight_reject_reason::shutting_down, "System is shutting down");
         }
 
         auto* thread_adapter = coordinator_->get_thread_adapter();
@@ -324,36 +630,342 @@ public:
             throw std::runtime_error("Thread adapter not available");
         }
 
+        const circuit_permit permit = acquire_permit();
+
         // Increment submitted counter
         metrics_aggregator_->increment_tasks_submitted();
 
-        // Note: We can't wrap the task for metrics tracking here because
-        // submit_cancellable uses std::bind internally which causes const issues
-        // with mutable lambdas. For now, cancellable tasks won't track completion.
-        // TODO: Refactor thread_adapter::submit_cancellable to avoid std::bind
+        // Count completion inside the task itself.
+        // A task cancelled before it starts is not counted as completed.
+        const std::uint64_t trace_id = trace_submit();
+        auto wrapped_task = with_tracking(static_cast<int>(priority_level::normal), std::move(task), trace_id);
+        if (breaker_) {
+            wrapped_task = with_breaker(std::move(wrapped_task), permit);
+        }
+        trace_enqueue(trace_id);
+
+        // Checked here rather than through thread_adapter::submit_cancellable,
+        // which drops a rejection; a task cancelled before it starts hands its
+        // permit back like a rejected one
+        auto result = thread_adapter->execute(
+            [this, thread_adapter, token, permit, task = std::move(wrapped_task)]() {
+                if (thread_adapter->is_token_cancelled(token)) {
+                    if (breaker_) {
+                        breaker_->release(permit);
+                    }
+                    return;
+                }
+                task();
+            });
+        if (result.is_err()) {
+            submit_failed(permit, result.error().message);
+        }
+    }
 
-        // Submit via thread_adapter's cancel-aware submission
-        auto future = thread_adapter->submit_cancellable(token, std::move(task));
-        // Manually track completion here (not ideal but works)
-        auto tracking_future = thread_adapter->submit([this, f = std::move(future)]() mutable {
-            try {
-                f.get();  // Wait for cancellable task
+    bool begin_blocking() {
+        auto* thread_adapter = coordinator_->get_thread_adapter();
+        return thread_adapter && thread_adapter->begin_blocking();
+    }
+
+    void end_blocking() {
+        auto* thread_adapter = coordinator_->get_thread_adapter();
+        if (thread_adapter) {
+            thread_adapter->end_blocking();
+        }
+    }
+
+    bool is_worker_thread() const {
+        auto* thread_adapter = coordinator_->get_thread_adapter();
+        return thread_adapter && thread_adapter->is_worker_thread();
+    }
+
+    bool run_pending_task() {
+        auto* thread_adapter = coordinator_->get_thread_adapter();
+        return thread_adapter && thread_adapter->run_pending_task();
+    }
+
+    adapters::io_adapter& io() {
+        if (shutting_down_) {
+            throw std::runtime_error("System is shutting down");
+        }
+
+        // Created on first use so systems without file I/O pay nothing
+        std::lock_guard<std::mutex> lock(io_mutex_);
+        if (!io_adapter_) {
+            io_config io_cfg;
+            io_cfg.enable_io_uring = config_.enable_io_uring;
+            io_cfg.queue_depth = config_.io_queue_depth;
+            io_cfg.fallback_threads = config_.io_fallback_threads;
+
+            auto adapter = std::make_unique<adapters::io_adapter>(io_cfg);
+            auto result = adapter->initialize();
+            if (result.is_err()) {
+                throw std::runtime_error("Failed to initialize async I/O: " + result.error().message);
+            }
+            io_adapter_ = std::move(adapter);
+        }
+        return *io_adapter_;
+    }
+
+private:
+    void start_metrics_endpoint(const config& cfg) {
+        metrics_endpoint_config endpoint_cfg;
+        endpoint_cfg.enabled = true;
+        endpoint_cfg.bind_address = cfg.metrics_bind_address;
+        endpoint_cfg.port = cfg.metrics_port;
+
+        adapters::metrics_endpoint_handlers handlers;
+        handlers.write_metrics = [this](prometheus_writer& writer) { export_metrics(writer); };
+        handlers.metrics_json = [this] { return export_metrics_json(); };
+        handlers.health = [this] {
+            const auto health = load_health();
+            return adapters::health_response{health->status.overall_health == health_level::healthy, health->json};
+        };
+
+        metrics_endpoint_ = std::make_unique<adapters::metrics_endpoint>(endpoint_cfg, std::move(handlers));
+        auto result = metrics_endpoint_->initialize();
+        if (result.is_err()) {
+            throw std::runtime_error("Failed to start metrics endpoint: " + result.error().message);
+        }
+    }
+
+    // A permit for the task about to be queued; a half-open breaker only
+    // hands out a few, so a submit that fails later must give it back
+    circuit_permit acquire_permit() {
+        if (!breaker_) {
+            return {};
+        }
+        auto permit = breaker_->acquire();
+        if (!permit) {
+            reject(flight_reject_reason::circuit_open, "Circuit breaker is open");
+        }
+        return *permit;
+    }
+
+    [[noreturn]] void submit_failed(const circuit_permit& permit, const std::string& message) {
+        if (breaker_) {
+            breaker_->release(permit);
+        }
+        // Track failed submission separately
+        metrics_aggregator_->increment_tasks_failed();
+        throw std::runtime_error("Failed to submit task: " + message);
+    }
+
+    [[noreturn]] void reject(flight_reject_reason reason, const char* message) {
+        metrics_aggregator_->increment_tasks_rejected();
+        record_flight(flight_event_kind::reject, std::chrono::steady_clock::now(),
+                      static_cast<std::uint32_t>(reason));
+        throw std::runtime_error(message);
+    }
+
+    void record_flight(flight_event_kind kind, std::chrono::steady_clock::time_point at,
+                       std::uint32_t arg = 0) const noexcept {
+        if (flight_recorder_) {
+            flight_recorder_->record_shared(kind, at, arg);
+        }
+    }
+
+    // Keeps the events leading up to the transition, written later by the
+    // dump thread; rate limited so a flapping breaker cannot fill the disk
+    void request_flight_dump() {
+        if (!flight_recorder_) {
+            return;
+        }
+
+        const auto now = std::chrono::steady_clock::now();
+        {
+            std::lock_guard<std::mutex> lock(flight_dump_mutex_);
+            if (last_flight_dump_ != std::chrono::steady_clock::time_point{} &&
+                now - last_flight_dump_ < flight_dump_interval) {
+                return;
+            }
+            last_flight_dump_ = now;
+            pending_flight_dump_ = flight_recorder_->heads();
+        }
+        background_cv_.notify_one();
+    }
+
+    // Polls the health probes, republishes health at least every
+    // health_check_interval, and writes requested flight dumps off the
+    // workers; drains the last dump on shutdown
+    void background_loop() {
+        std::unique_lock<std::mutex> lock(flight_dump_mutex_);
+        while (true) {
+            background_cv_.wait_for(lock, background_tick,
+                                    [this] { return background_stop_ || !pending_flight_dump_.empty(); });
+            if (background_stop_ && pending_flight_dump_.empty()) {
+                return;
+            }
+            std::vector<std::uint64_t> heads;
+            heads.swap(pending_flight_dump_);
+            lock.unlock();
+            if (!heads.empty()) {
+                write_flight_dump(heads);
+            }
+
+            // Checks report back as they finish; the tick catches timeouts
+            // and refreshes the built-in state
+            const auto now = std::chrono::steady_clock::now();
+            if (poll_probes(now) || now >= next_health_evaluation_) {
+                publish_health();
+                next_health_evaluation_ = now + config_.health_check_interval;
+            }
+            lock.lock();
+        }
+    }
+
+    void write_flight_dump(const std::vector<std::uint64_t>& heads) const {
+        const std::tm local = local_time(std::chrono::system_clock::to_time_t(std::chrono::system_clock::now()));
+        std::ostringstream name;
+        name << config_.name << "-flight-" << std::put_time(&local, "%Y%m%d-%H%M%S") << ".bin";
+
+        const std::filesystem::path directory = config_.flight_recorder_dump_directory.empty()
+            ? config_.log_directory
+            : config_.flight_recorder_dump_directory;
+        std::error_code ec;
+        std::filesystem::create_directories(directory, ec);
+
+        const std::string path = (directory / name.str()).string();
+        auto result = flight_recorder_->dump(path, heads);
+        auto* logger = coordinator_->get_logger_adapter();
+        if (!logger) {
+            return;
+        }
+        if (result.is_err()) {
+            logger->log(log_level::warning, "Flight recorder dump failed: " + result.error().message);
+        } else {
+            logger->log(log_level::warning, "Health is critical; flight recorder dumped to " + path);
+        }
+    }
+
+    // Head sampling: the decision made here covers every event of the task.
+    // Steals happen inside the thread adapter and are not traced.
+    std::uint64_t trace_submit() {
+        if (!tracer_) {
+            return 0;
+        }
+        const std::uint64_t trace_id = tracer_->sample();
+        if (trace_id) {
+            tracer_->record(trace_event::submit, trace_id, std::chrono::steady_clock::now());
+        }
+        return trace_id;
+    }
+
+    void trace_enqueue(std::uint64_t trace_id) {
+        if (!trace_id && !flight_recorder_) {
+            return;
+        }
+        const auto now = std::chrono::steady_clock::now();
+        record_flight(flight_event_kind::enqueue, now);
+        if (trace_id) {
+            tracer_->record(trace_event::enqueue, trace_id, now);
+        }
+    }
+
+    // Counts the task as completed, even if it throws, and records how long
+    // it waited to start and how long it ran
+    std::function<void()> with_tracking(int priority, std::function<void()> task, std::uint64_t trace_id = 0,
+                                        task_label label = {}) {
+        return [this, priority, trace_id, label, ready = std::chrono::steady_clock::now(), task = std::move(task)]() {
+            const auto start = std::chrono::steady_clock::now();
+            if (start > ready) {
+                queued_ns_.add(static_cast<std::uint64_t>(
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(start - ready).count()));
+            }
+            record_flight(flight_event_kind::start, start, static_cast<std::uint32_t>(priority));
+            if (trace_id) {
+                tracer_->record(trace_event::start, trace_id, start, static_cast<std::uint32_t>(priority));
+            }
+            perf_profiler::measurement counters;
+            if (perf_profiler_) {
+                counters = perf_profiler_->begin();
+            }
+            auto finish = [&](bool failed) {
+                if (counters.active) {
+                    perf_profiler_->end(counters, label, priority);
+                }
+                const auto end = std::chrono::steady_clock::now();
+                record_flight(flight_event_kind::finish, end, failed ? 1 : 0);
+                if (trace_id) {
+                    tracer_->record(trace_event::end, trace_id, end);
+                }
                 metrics_aggregator_->increment_tasks_completed();
+                metrics_aggregator_->record_task_latency(priority, start - ready, end - start);
+            };
+            try {
+                task();
             } catch (...) {
-                metrics_aggregator_->increment_tasks_completed();
+                finish(true);
                 throw;
             }
-        });
-        (void)tracking_future;
+            finish(false);
+        };
+    }
+
+    // Times the task and feeds its outcome to the breaker. Wraps the tracked
+    // task, so a flight dump taken as the breaker opens includes its finish.
+    std::function<void()> with_breaker(std::function<void()> task, circuit_permit permit) {
+        return [this, permit, task = std::move(task)]() {
+            const auto start = std::chrono::steady_clock::now();
+            detail::task_outcome_scope outcome;
+            try {
+                task();
+            } catch (...) {
+                record_outcome(permit, false, std::chrono::steady_clock::now() - start);
+                throw;
+            }
+            record_outcome(permit, !outcome.failed(), std::chrono::steady_clock::now() - start);
+        };
+    }
+
+    void record_outcome(const circuit_permit& permit, bool success, std::chrono::nanoseconds duration) {
+        // An open breaker makes the health critical
+        if (breaker_->record(permit, success, duration)) {
+            publish_health();
+        }
     }
 
-private:
     config config_;
     std::atomic<bool> shutting_down_;
+    std::chrono::steady_clock::time_point start_time_;
+
+    sharded_counter queued_ns_;  // Queue wait summed over started tasks
+    metric_registry metric_registry_;  // Series registered through handles
+    std::unique_ptr<circuit_breaker> breaker_;
+
+    std::mutex io_mutex_;
+    std::unique_ptr<adapters::io_adapter> io_adapter_;
+
+    // Health checks and custom metric collectors, run on the pool
+    health_probes health_probes_;
+
+    // Health as of the last evaluation (see health_snapshot)
+#if defined(__cpp_lib_atomic_shared_ptr)
+    std::atomic<std::shared_ptr<const health_snapshot>> health_;
+#else
+    std::shared_ptr<const health_snapshot> health_;
+#endif
+    std::mutex health_publish_mutex_;
+    std::chrono::steady_clock::time_point next_health_evaluation_{};  // background thread only
 
     std::unique_ptr<system_coordinator> coordinator_;
     std::unique_ptr<extensions::metrics_aggregator> metrics_aggregator_;
-    // distributed_tracing and plugin_manager removed (planned for v2.1.0)
+    std::unique_ptr<adapters::metrics_endpoint> metrics_endpoint_;
+    std::unique_ptr<task_tracer> tracer_;  // Null when tracing is disabled
+    std::unique_ptr<perf_profiler> perf_profiler_;  // Null when perf counters are disabled
+
+    // Shared ring only; null when the flight recorder is disabled
+    std::unique_ptr<flight_recorder> flight_recorder_;
+    std::atomic<bool> health_critical_{false};
+    std::mutex flight_dump_mutex_;
+    std::chrono::steady_clock::time_point last_flight_dump_{};  // guarded by flight_dump_mutex_
+    std::vector<std::uint64_t> pending_flight_dump_;  // Ring heads to write; guarded by flight_dump_mutex_
+
+    // Health evaluation and flight dumps; stopped before the coordinator shuts down
+    std::condition_variable background_cv_;
+    bool background_stop_ = false;  // guarded by flight_dump_mutex_
+    std::thread background_thread_;
+    // plugin_manager removed (planned for v2.1.0)
 };
 
 // unified_thread_system implementation
@@ -371,10 +983,46 @@ void unified_thread_system::submit_priority_internal(int priority, std::function
     pimpl_->submit_priority_internal(priority, std::move(task));
 }
 
+void unified_thread_system::submit_labeled_internal(task_label label, int priority, std::function<void()> task) {
+    pimpl_->submit_priority_internal(priority, std::move(task), label);
+}
+
+task_label unified_thread_system::register_task_label(const std::string& name) {
+    return pimpl_->register_task_label(name);
+}
+
 void unified_thread_system::submit_cancellable_internal(std::shared_ptr<void> token, std::function<void()> task) {
     pimpl_->submit_cancellable_internal(token, std::move(task));
 }
 
+bool unified_thread_system::begin_blocking() {
+    return pimpl_->begin_blocking();
+}
+
+void unified_thread_system::end_blocking() {
+    pimpl_->end_blocking();
+}
+
+bool unified_thread_system::is_worker_thread() const {
+    return pimpl_->is_worker_thread();
+}
+
+bool unified_thread_system::run_pending_task() {
+    return pimpl_->run_pending_task();
+}
+
+std::future<size_t> unified_thread_system::async_read(int fd, std::span<std::byte> buffer, std::uint64_t offset) {
+    return pimpl_->io().read(fd, buffer, offset);
+}
+
+std::future<size_t> unified_thread_system::async_write(int fd, std::span<const std::byte> buffer, std::uint64_t offset) {
+    return pimpl_->io().write(fd, buffer, offset);
+}
+
+std::future<void> unified_thread_system::async_fsync(int fd) {
+    return pimpl_->io().fsync(fd);
+}
+
 void unified_thread_system::schedule_internal(std::chrono::milliseconds delay, std::function<void()> task) {
     pimpl_->schedule_internal(delay, std::move(task));
 }
@@ -419,6 +1067,21 @@ bool unified_thread_system::is_healthy() const {
     return pimpl_->is_healthy();
 }
 
+void unified_thread_system::add_health_check(const std::string& name,
+                                             std::function<std::pair<bool, std::string>()> check,
+                                             std::chrono::milliseconds timeout) {
+    pimpl_->add_health_check(name, std::move(check), timeout);
+}
+
+void unified_thread_system::register_metric_collector(const std::string& name,
+                                                      std::function<double()> collector) {
+    auto result = pimpl_->metrics().register_gauge(name, {});
+    if (result.is_err()) {
+        throw std::invalid_argument(result.error().message);
+    }
+    pimpl_->register_metric_collector(name, std::move(collector), result.value());
+}
+
 void unified_thread_system::shutdown() {
     pimpl_->shutdown_impl();
 }
@@ -436,7 +1099,66 @@ std::string unified_thread_system::export_metrics_json() const {
 }
 
 std::string unified_thread_system::export_metrics_prometheus() const {
-    return pimpl_->export_metrics_prometheus();
+    return pimpl_->export_metrics_prometheus(exposition_format::prometheus_text);
+}
+
+std::string unified_thread_system::export_metrics_openmetrics() const {
+    return pimpl_->export_metrics_prometheus(exposition_format::openmetrics);
+}
+
+void unified_thread_system::export_metrics(prometheus_writer& writer) const {
+    pimpl_->export_metrics(writer);
+}
+
+std::string unified_thread_system::export_health_json() const {
+    return pimpl_->export_health_json();
+}
+
+std::uint16_t unified_thread_system::metrics_endpoint_port() const {
+    return pimpl_->metrics_endpoint_port();
+}
+
+std::string unified_thread_system::export_trace_json() const {
+    return pimpl_->tracer().chrome_json();
+}
+
+void unified_thread_system::export_trace(const std::string& path) const {
+    auto result = pimpl_->tracer().write_chrome_json(path);
+    if (result.is_err()) {
+        throw std::runtime_error(result.error().message);
+    }
+}
+
+void unified_thread_system::dump_flight_recorder(const std::string& path) const {
+    auto result = pimpl_->flight().dump(path);
+    if (result.is_err()) {
+        throw std::runtime_error(result.error().message);
+    }
+}
+
+counter_handle unified_thread_system::register_counter(const std::string& name, metric_labels labels) {
+    auto result = pimpl_->metrics().register_counter(name, labels);
+    if (result.is_err()) {
+        throw std::invalid_argument(result.error().message);
+    }
+    return result.value();
+}
+
+gauge_handle unified_thread_system::register_gauge(const std::string& name, metric_labels labels) {
+    auto result = pimpl_->metrics().register_gauge(name, labels);
+    if (result.is_err()) {
+        throw std::invalid_argument(result.error().message);
+    }
+    return result.value();
+}
+
+histogram_handle unified_thread_system::register_histogram(const std::string& name, metric_labels labels,
+                                                           std::span<const double> bounds) {
+    auto result = pimpl_->metrics().register_histogram(name, labels, bounds);
+    if (result.is_err()) {
+        throw std::invalid_argument(result.error().message);
+    }
+    return result.value();
 }
 
 void unified_thread_system::cancel_recurring(size_t task_id) {
@@ -455,6 +1177,11 @@ size_t unified_thread_system::subscribe_to_events(const std::string& event_type,
     return pimpl_->subscribe_to_events(event_type, callback);
 }
 
+size_t unified_thread_system::subscribe_to_events(const std::string& event_type, event_callback callback,
+                                                  event_delivery /*delivery*/) {
+    return pimpl_->subscribe_to_events(event_type, callback);
+}
+
 void unified_thread_system::unsubscribe_from_events(size_t subscription_id) {
     pimpl_->unsubscribe_from_events(subscription_id);
 }
@@ -4,6 +4,20 @@
  */
 
 #include <kcenon/integrated/unified_thread_system.h>
+#include <kcenon/integrated/adapters/io_adapter.h>
+#include <kcenon/integrated/adapters/metrics_endpoint.h>
+#include <kcenon/integrated/core/circuit_breaker.h>
+#include <kcenon/integrated/core/event_bus.h>
+#include <kcenon/integrated/core/flight_recorder.h>
+#include <kcenon/integrated/core/health_probes.h>
+#include <kcenon/integrated/core/lock_profiler.h>
+#include <kcenon/integrated/core/task_latency.h>
+#include <kcenon/integrated/core/prometheus_writer.h>
+#include <kcenon/integrated/core/rate_meter.h>
+#include <kcenon/integrated/core/sharded_counter.h>
+#include <kcenon/integrated/core/task_tracer.h>
+#include <kcenon/integrated/core/worker_activity.h>
+#include "core/json_format.h"
 
 #include <iostream>
 #include <memory>
@@ -12,15 +26,18 @@
 #include <queue>
 #include <mutex>
 #include <condition_variable>
+#include <deque>
 #include <functional>
 #include <map>
 #include <chrono>
 #include <random>
 #include <algorithm>
-#include <numeric>
 #include <sstream>
+#include <stdexcept>
 #include <iomanip>
 #include <ctime>
+#include <filesystem>
+#include <utility>
 
 #ifdef __cpp_lib_format
 #include <format>
@@ -33,6 +50,10 @@ struct priority_task {
     int priority;
     std::chrono::steady_clock::time_point scheduled_time;
     std::function<void()> task;
+    std::uint64_t trace_id = 0;
+    std::uint16_t label = 0;
+    bool internal = false;
+    circuit_permit breaker_permit{};
 
     bool operator<(const priority_task& other) const {
         // Higher priority first, then earlier scheduled time
@@ -43,6 +64,72 @@ struct priority_task {
     }
 };
 
+// A runnable task with what is needed to attribute its latency
+struct queued_task {
+    std::function<void()> fn;
+    std::chrono::steady_clock::time_point ready_time;  // enqueued, or due when scheduled
+    int priority = static_cast<int>(priority_level::normal);
+    std::uint64_t trace_id = 0;  // Nonzero when sampled for tracing
+    std::uint16_t label = 0;     // task_label::id, for performance counters
+    bool internal = false;       // Health probe: kept out of task metrics and completion tracking
+    circuit_permit breaker_permit{};  // Handed back to the breaker with the outcome
+
+    explicit operator bool() const noexcept { return static_cast<bool>(fn); }
+};
+
+// Per-worker scheduling state. Tasks submitted from inside a worker land here
+// instead of the global queue; the owner pops LIFO, thieves take the oldest.
+struct worker_state {
+    worker_state(size_t worker_id, unsigned latency_precision)
+        : id(worker_id), latency(latency_precision) {}
+
+    size_t id;
+    std::mutex local_mutex;
+    std::deque<queued_task> local_tasks;
+    queued_task next_task;            // LIFO slot for cache-warm continuation
+    size_t local_streak = 0;          // local pops since the last global check (owner only)
+    size_t help_depth = 0;            // nested run_pending_task() calls (owner only)
+    task_latency_recorder latency;    // tasks run by this worker
+    worker_clock activity;            // busy/spinning/idle/parked time (owner writes)
+    lock_profile* local_lock_profile = nullptr;  // local_mutex contention; null unless profiling
+};
+
+namespace {
+
+// Identifies the pool worker running on the current thread, if any
+struct worker_binding {
+    const void* owner = nullptr;
+    worker_state* state = nullptr;
+};
+
+thread_local worker_binding current_worker;
+
+// Local pops allowed before a worker must look at the global queue again,
+// so a worker that keeps spawning nested tasks cannot starve external work
+constexpr size_t local_fairness_interval = 32;
+
+// Nested run_pending_task() calls allowed per worker before waits must block
+constexpr size_t max_help_depth = 64;
+
+// Minimum spacing of the automatic flight recorder dumps on critical health
+constexpr auto flight_dump_interval = std::chrono::minutes(1);
+
+using detail::health_level_name;
+using detail::write_json_string;
+
+// std::localtime shares one buffer between threads
+std::tm local_time(std::time_t time) {
+    std::tm result{};
+#if defined(_WIN32)
+    localtime_s(&result, &time);
+#else
+    localtime_r(&time, &result);
+#endif
+    return result;
+}
+
+} // namespace
+
 // Recurring task info
 struct recurring_task_info {
     std::chrono::milliseconds interval;
@@ -51,12 +138,6 @@ struct recurring_task_info {
     bool cancelled = false;
 };
 
-// Performance sample
-struct performance_sample {
-    std::chrono::nanoseconds duration;
-    std::chrono::steady_clock::time_point timestamp;
-    bool success;
-};
 
 class unified_thread_system::impl {
 private:
@@ -64,10 +145,30 @@ private:
 
     // Thread pool components
     std::vector<std::thread> workers_;
+    std::vector<std::unique_ptr<worker_state>> worker_states_;
     std::priority_queue<priority_task> tasks_;
     mutable std::mutex queue_mutex_;
+    lock_profile* queue_lock_profile_ = nullptr;  // null unless lock profiling is enabled
     std::condition_variable condition_;
+    std::atomic<size_t> idle_workers_{0};
+    std::atomic<size_t> local_pending_{0};
+    std::atomic<size_t> global_pending_{0};     // tasks_.size(), readable without queue_mutex_
+    size_t thread_count_{0};                    // configured parallelism
+    std::atomic<size_t> started_workers_{0};    // worker_states_ slots in use
+
+    // Managed blocking: compensating workers keep thread_count_ runnable
+    std::mutex compensation_mutex_;
+    std::condition_variable spare_cv_;
+    std::atomic<size_t> blocked_workers_{0};
+    std::atomic<size_t> running_compensators_{0};
+    size_t parked_compensators_{0};             // guarded by compensation_mutex_
+    size_t spare_wakeups_{0};                   // guarded by compensation_mutex_
     std::atomic<bool> stop_{false};
+
+    // Completion tracking (queued + running tasks)
+    std::atomic<size_t> outstanding_tasks_{0};
+    std::mutex completion_mutex_;
+    std::condition_variable completion_cv_;
     std::atomic<bool> shutting_down_{false};
 
     // Scheduled tasks
@@ -77,39 +178,101 @@ private:
     std::atomic<size_t> next_task_id_{1};
 
     // Metrics
-    mutable std::mutex metrics_mutex_;
-    std::atomic<size_t> tasks_submitted_{0};
-    std::atomic<size_t> tasks_completed_{0};
-    std::atomic<size_t> tasks_failed_{0};
+    // Bumped by every worker on every task; counts are sharded per thread
+    // and rates are folded in by the scheduler thread
+    rate_meter tasks_submitted_;
+    rate_meter tasks_completed_;
+    rate_meter tasks_failed_;
+    rate_meter tasks_rejected_;
     std::atomic<size_t> tasks_cancelled_{0};
-    std::vector<performance_sample> performance_samples_;
+    task_latency_recorder external_latency_;  // tasks run outside the workers
+    sharded_counter queued_ns_;               // Queue wait summed over started tasks
+    metric_registry metric_registry_;         // Series registered through handles
     std::chrono::steady_clock::time_point start_time_;
 
-    // Circuit breaker
-    std::atomic<bool> circuit_open_{false};
+    // Circuit breaker (null when disabled)
+    std::unique_ptr<circuit_breaker> breaker_;
     std::atomic<size_t> consecutive_failures_{0};
-    std::chrono::steady_clock::time_point circuit_open_time_;
 
-    // Event system
-    mutable std::mutex event_mutex_;
-    std::map<std::string, std::vector<std::pair<size_t, event_callback>>> event_subscribers_;
-    std::atomic<size_t> next_subscription_id_{1};
+    // Sampled task spans (null when tracing is disabled)
+    std::unique_ptr<task_tracer> tracer_;
+
+    // Recent scheduler events, one ring per worker slot (null when disabled)
+    std::unique_ptr<flight_recorder> flight_recorder_;
+    mutable std::atomic<bool> health_critical_{false};
+    mutable std::mutex flight_dump_mutex_;
+    mutable std::chrono::steady_clock::time_point last_flight_dump_{};  // guarded by flight_dump_mutex_
+    std::vector<std::uint64_t> pending_flight_dump_;  // Ring heads to write; guarded by flight_dump_mutex_
+
+    // Queue lock contention (null when disabled); every profile is registered
+    // before the first worker starts
+    std::unique_ptr<lock_profiler> lock_profiler_;
 
-    // Custom metrics
-    mutable std::mutex custom_metrics_mutex_;
-    std::map<std::string, std::function<double()>> metric_collectors_;
+    // Hardware counters per task label and lane (null when disabled)
+    std::unique_ptr<perf_profiler> perf_profiler_;
 
-    // Health checks
-    mutable std::mutex health_checks_mutex_;
-    std::map<std::string, std::function<std::pair<bool, std::string>()>> health_checks_;
+    // Event system; mutable so const paths such as get_health() can log
+    mutable event_bus events_;
+    const event_type_id log_event_ = events_.intern("log");
+
+    // Scratch histograms reused by every Prometheus scrape
+    mutable std::mutex export_mutex_;
+    mutable task_latency_snapshot export_latency_;
+    mutable std::vector<worker_utilization> export_workers_;
+
+    // Health checks and custom metric collectors, run on the pool
+    health_probes health_probes_;
+
+    // Health as of the last evaluation, replaced whole so that get_health(),
+    // is_healthy() and /health are a single load
+    struct health_snapshot {
+        health_status status;
+        std::string json;
+    };
+#if defined(__cpp_lib_atomic_shared_ptr)
+    std::atomic<std::shared_ptr<const health_snapshot>> health_;
+#else
+    std::shared_ptr<const health_snapshot> health_;
+#endif
+    std::mutex health_publish_mutex_;
+    std::chrono::steady_clock::time_point next_health_evaluation_{};  // scheduler thread only
 
     // Work stealing flag
     std::atomic<bool> work_stealing_enabled_{false};
 
+    // Async file I/O, created on first use
+    std::mutex io_mutex_;
+    std::unique_ptr<adapters::io_adapter> io_adapter_;
+
+    // HTTP endpoint for /metrics and /health (null when disabled)
+    std::unique_ptr<adapters::metrics_endpoint> metrics_endpoint_;
+
 public:
-    explicit impl(const config& cfg) : config_(cfg) {
+    explicit impl(const config& cfg)
+        : config_(cfg)
+        , external_latency_(static_cast<unsigned>(cfg.latency_precision_digits))
+        , metric_registry_(cfg.name, cfg.max_series_per_metric)
+        , health_probes_(cfg.health_check_interval, cfg.health_check_timeout, [this] { publish_health(); }) {
         start_time_ = std::chrono::steady_clock::now();
+        work_stealing_enabled_ = config_.enable_work_stealing;
+        if (config_.enable_circuit_breaker) {
+            breaker_ = std::make_unique<circuit_breaker>(make_breaker_config(config_));
+        }
+        if (config_.enable_tracing) {
+            trace_config trace_cfg;
+            trace_cfg.process_name = config_.name;
+            trace_cfg.sample_rate = config_.trace_sample_rate;
+            trace_cfg.events_per_thread = config_.trace_events_per_thread;
+            tracer_ = std::make_unique<task_tracer>(trace_cfg);
+        }
         initialize_systems();
+
+        try {
+            start_metrics_endpoint();
+        } catch (...) {
+            shutdown_systems();
+            throw;
+        }
     }
 
     ~impl() {
@@ -117,16 +280,61 @@ public:
     }
 
 private:
+    static circuit_breaker_config make_breaker_config(const config& cfg) {
+        circuit_breaker_config breaker_cfg;
+        breaker_cfg.enabled = cfg.enable_circuit_breaker;
+        breaker_cfg.failure_threshold = cfg.circuit_breaker_failure_threshold;
+        breaker_cfg.reset_timeout = cfg.circuit_breaker_reset_timeout;
+        breaker_cfg.window_seconds = cfg.circuit_breaker_window_seconds;
+        breaker_cfg.minimum_calls = cfg.circuit_breaker_minimum_calls;
+        breaker_cfg.failure_rate_threshold = cfg.circuit_breaker_failure_rate;
+        breaker_cfg.slow_call_rate_threshold = cfg.circuit_breaker_slow_call_rate;
+        breaker_cfg.slow_call_duration = cfg.circuit_breaker_slow_call_duration;
+        breaker_cfg.half_open_permits = cfg.circuit_breaker_half_open_permits;
+        return breaker_cfg;
+    }
+
     void initialize_systems() {
         // Initialize worker threads
         const size_t thread_count = config_.thread_count == 0
             ? std::thread::hardware_concurrency()
             : config_.thread_count;
+        thread_count_ = thread_count;
+
+        // Slots for compensating workers are created up front so that stealers
+        // can scan worker_states_ without synchronizing with its growth
+        const size_t capacity = thread_count + compensator_capacity(thread_count);
+        worker_states_.reserve(capacity);
+        workers_.reserve(capacity);
+        for (size_t i = 0; i < capacity; ++i) {
+            worker_states_.push_back(std::make_unique<worker_state>(
+                i, static_cast<unsigned>(config_.latency_precision_digits)));
+        }
+        if (config_.enable_flight_recorder) {
+            flight_recorder_ = std::make_unique<flight_recorder>(capacity, config_.flight_recorder_events);
+        }
+        if (config_.enable_lock_profiling) {
+            lock_profiler_ = std::make_unique<lock_profiler>(
+                lock_profiler::default_hold_sample_interval,
+                static_cast<unsigned>(config_.latency_precision_digits));
+            queue_lock_profile_ = lock_profiler_->add("queue");
+            for (auto& state : worker_states_) {
+                state->local_lock_profile = lock_profiler_->add("local_queue");
+            }
+        }
+        if (config_.enable_perf_counters) {
+            perf_profiler_ = std::make_unique<perf_profiler>(config_.max_task_labels, config_.perf_counter_interval);
+        }
 
+        started_workers_ = thread_count;
         for (size_t i = 0; i < thread_count; ++i) {
             workers_.emplace_back([this, i] { worker_thread(i); });
         }
 
+        // Readers never see an empty snapshot; no checks are registered yet
+        publish_health();
+        next_health_evaluation_ = std::chrono::steady_clock::now() + config_.health_check_interval;
+
         // Initialize scheduler thread
         scheduler_thread_ = std::thread([this] { scheduler_thread_func(); });
 
@@ -135,8 +343,43 @@ private:
                    std::to_string(thread_count) + " worker threads");
     }
 
+    void start_metrics_endpoint() {
+        if (!config_.enable_metrics_endpoint) {
+            return;
+        }
+
+        metrics_endpoint_config endpoint_cfg;
+        endpoint_cfg.enabled = true;
+        endpoint_cfg.bind_address = config_.metrics_bind_address;
+        endpoint_cfg.port = config_.metrics_port;
+
+        adapters::metrics_endpoint_handlers handlers;
+        handlers.write_metrics = [this](prometheus_writer& writer) { export_metrics(writer); };
+        handlers.metrics_json = [this] { return export_metrics_json(); };
+        handlers.health = [this] {
+            const auto health = load_health();
+            return adapters::health_response{health->status.overall_health == health_level::healthy, health->json};
+        };
+
+        auto endpoint = std::make_unique<adapters::metrics_endpoint>(endpoint_cfg, std::move(handlers));
+        auto result = endpoint->initialize();
+        if (result.is_err()) {
+            throw std::runtime_error(result.error().message);
+        }
+        metrics_endpoint_ = std::move(endpoint);
+
+        log_message(log_level::info, "Serving metrics on " + config_.metrics_bind_address + ":" +
+                    std::to_string(metrics_endpoint_->port()));
+    }
+
     void shutdown_systems() {
         shutting_down_ = true;
+
+        // Stop serving before the state behind the handlers goes away
+        if (metrics_endpoint_) {
+            metrics_endpoint_->shutdown();
+        }
+
         stop_ = true;
 
         // Cancel all recurring tasks
@@ -147,8 +390,12 @@ private:
             }
         }
 
-        // Notify all workers
+        // Notify all workers; taking compensation_mutex_ also stops further spawns
         condition_.notify_all();
+        {
+            std::lock_guard<std::mutex> lock(compensation_mutex_);
+            spare_cv_.notify_all();
+        }
 
         // Join all threads
         for (std::thread& worker : workers_) {
@@ -160,81 +407,421 @@ private:
         if (scheduler_thread_.joinable()) {
             scheduler_thread_.join();
         }
+        write_pending_flight_dump();
+
+        {
+            std::lock_guard<std::mutex> lock(io_mutex_);
+            if (io_adapter_) {
+                io_adapter_->shutdown();
+            }
+        }
 
         log_message(log_level::info, "Unified thread system shut down");
+
+        // Stops async subscribers after they received the final events
+        events_.shutdown();
     }
 
     void worker_thread(size_t worker_id) {
+        worker_state& self = *worker_states_[worker_id];
+        current_worker = {this, &self};
+        self.activity.start(worker_activity::spinning, std::chrono::steady_clock::now());
+        if (tracer_) {
+            tracer_->name_thread("worker " + std::to_string(worker_id));
+        }
+
+        const bool compensator = worker_id >= thread_count_;
         while (!stop_) {
-            std::function<void()> task;
-            {
-                std::unique_lock<std::mutex> lock(queue_mutex_);
-                condition_.wait(lock, [this] {
-                    return stop_ || !tasks_.empty();
-                });
+            queued_task task = acquire_task(self);
+            if (task) {
+                execute_task(task);
+            }
+
+            if (compensator && !park_if_surplus(self)) {
+                break;
+            }
+        }
+
+        current_worker = {};
+    }
+
+    // Extra workers allowed beyond thread_count: up to max_threads when it is
+    // set, otherwise as many again as the base pool
+    size_t compensator_capacity(size_t thread_count) const {
+        if (config_.max_threads == 0) {
+            return thread_count;
+        }
+        return config_.max_threads > thread_count ? config_.max_threads - thread_count : 0;
+    }
+
+public:
+    bool begin_blocking() {
+        if (current_worker.owner != this) {
+            return false;
+        }
+
+        size_t started_slot = 0;
+        {
+            std::lock_guard<std::mutex> lock(compensation_mutex_);
+            const size_t blocked = blocked_workers_.fetch_add(1) + 1;
+            if (stop_ || running_compensators_.load() >= blocked) {
+                return true;
+            }
+
+            if (parked_compensators_ > 0) {
+                --parked_compensators_;
+                ++spare_wakeups_;
+                running_compensators_.fetch_add(1);
+                spare_cv_.notify_one();
+                return true;
+            }
+
+            started_slot = started_workers_.load();
+            if (started_slot == worker_states_.size()) {
+                return true;  // At capacity; this block goes uncompensated
+            }
+
+            running_compensators_.fetch_add(1);
+            workers_.emplace_back([this, started_slot] { worker_thread(started_slot); });
+            started_workers_.store(started_slot + 1);
+        }
+
+        log_message(log_level::debug, "Started compensating worker " + std::to_string(started_slot));
+        return true;
+    }
+
+    void end_blocking() {
+        blocked_workers_.fetch_sub(1);
+    }
+
+private:
+    // Parks a compensating worker once the blocked workers it stood in for have
+    // resumed. Returns false when the pool is stopping.
+    bool park_if_surplus(worker_state& self) {
+        if (running_compensators_.load() <= blocked_workers_.load()) {
+            return true;
+        }
+
+        std::unique_lock<std::mutex> lock(compensation_mutex_);
+        if (running_compensators_.load() <= blocked_workers_.load()) {
+            return true;
+        }
+
+        // Unfinished local work stays with this worker until it is done
+        {
+            profiled_lock local_lock(self.local_mutex, self.local_lock_profile);
+            if (self.next_task || !self.local_tasks.empty()) {
+                return true;
+            }
+        }
+
+        running_compensators_.fetch_sub(1);
+        ++parked_compensators_;
+        detail::pool_flush_thread();
+        const auto parked_at = std::chrono::steady_clock::now();
+        self.activity.enter(worker_activity::parked, parked_at);
+        record_flight(flight_event_kind::park, parked_at, 1);
+        spare_cv_.wait(lock, [this] { return stop_ || spare_wakeups_ > 0; });
+        const auto woken_at = std::chrono::steady_clock::now();
+        self.activity.enter(worker_activity::spinning, woken_at);
+        record_flight(flight_event_kind::unpark, woken_at);
+        if (stop_) {
+            return false;
+        }
+        --spare_wakeups_;
+        return true;
+    }
+
+    queued_task acquire_task(worker_state& self) {
+        if (self.local_streak < local_fairness_interval) {
+            if (auto task = pop_local(self)) {
+                ++self.local_streak;
+                return task;
+            }
+        }
+        self.local_streak = 0;
+
+        while (!stop_) {
+            if (auto task = pop_global_batch(self)) {
+                return task;
+            }
 
-                if (stop_ && tasks_.empty()) {
-                    return;
+            if (auto task = pop_local(self)) {
+                return task;
+            }
+
+            if (work_stealing_enabled_) {
+                if (auto task = steal_task(self)) {
+                    return task;
                 }
+            }
 
-                if (!tasks_.empty()) {
-                    auto priority_task = tasks_.top();
+            // Return cross-thread frees before sleeping so their owners can reuse them
+            detail::pool_flush_thread();
+
+            profiled_lock lock(queue_mutex_, queue_lock_profile_);
+            idle_workers_.fetch_add(1);
+            const auto parked_at = std::chrono::steady_clock::now();
+            self.activity.enter(worker_activity::idle, parked_at);
+            record_flight(flight_event_kind::park, parked_at);
+            if (!tasks_.empty() && !stop_) {
+                // Only future-scheduled work is queued; sleep until it is due
+                condition_.wait_until(lock.for_wait(), tasks_.top().scheduled_time);
+            } else {
+                condition_.wait(lock.for_wait(), [this] {
+                    return stop_ || !tasks_.empty() || has_stealable_work();
+                });
+            }
+            idle_workers_.fetch_sub(1);
+            const auto woken_at = std::chrono::steady_clock::now();
+            self.activity.enter(worker_activity::spinning, woken_at);
+            record_flight(flight_event_kind::unpark, woken_at);
+        }
 
-                    // Check if task is scheduled for future
-                    auto now = std::chrono::steady_clock::now();
-                    if (priority_task.scheduled_time > now) {
-                        // Wait until scheduled time
-                        condition_.wait_until(lock, priority_task.scheduled_time);
-                        continue;
-                    }
+        return {};
+    }
 
-                    task = std::move(priority_task.task);
-                    tasks_.pop();
+    // Requires queue_mutex_; returns an empty task when nothing is due at now
+    queued_task pop_global(std::chrono::steady_clock::time_point now) {
+        if (tasks_.empty() || tasks_.top().scheduled_time > now) {
+            return {};
+        }
+
+        // pop() only reorders by priority and time, so the task can be moved out first
+        auto& top = const_cast<priority_task&>(tasks_.top());
+        queued_task task{std::move(top.task), top.scheduled_time, top.priority, top.trace_id, top.label, top.internal,
+                        top.breaker_permit};
+        tasks_.pop();
+        global_pending_.fetch_sub(1, std::memory_order_relaxed);
+        return task;
+    }
+
+    // Takes the highest-priority due task plus, when the worker has no local
+    // backlog, up to batch_size - 1 more under the same lock acquisition. The
+    // extras land in the worker's local deque, where idle peers can steal them.
+    queued_task pop_global_batch(worker_state& self) {
+        std::vector<queued_task> extras;
+        queued_task task;
+        std::chrono::steady_clock::time_point now;
+        {
+            profiled_lock lock(queue_mutex_, queue_lock_profile_);
+            now = std::chrono::steady_clock::now();
+            task = pop_global(now);
+            if (!task) {
+                return {};
+            }
+
+            const size_t count = batch_share(self);
+            for (size_t i = 1; i < count; ++i) {
+                auto next = pop_global(now);
+                if (!next) {
+                    break;
                 }
+                extras.push_back(std::move(next));
             }
+        }
+        record_flight(flight_event_kind::dequeue, now, static_cast<std::uint32_t>(extras.size() + 1));
 
-            if (task) {
-                auto start = std::chrono::steady_clock::now();
-                bool success = true;
+        if (!extras.empty()) {
+            profiled_lock lock(self.local_mutex, self.local_lock_profile);
+            // pop_local() takes from the back, so keep priority order by pushing in reverse
+            for (auto it = extras.rbegin(); it != extras.rend(); ++it) {
+                self.local_tasks.push_back(std::move(*it));
+            }
+            local_pending_.fetch_add(extras.size());
+        }
+        if (!extras.empty() && work_stealing_enabled_) {
+            wake_idle_worker();
+        }
+        return task;
+    }
 
-                try {
-                    task();
-                    tasks_completed_++;
-                    consecutive_failures_ = 0;
-                } catch (const std::exception& e) {
-                    tasks_failed_++;
-                    consecutive_failures_++;
-                    success = false;
-                    log_message(log_level::error, "Task failed: " + std::string(e.what()));
-
-                    // Check circuit breaker
-                    if (config_.enable_circuit_breaker &&
-                        consecutive_failures_ >= config_.circuit_breaker_failure_threshold) {
-                        circuit_open_ = true;
-                        circuit_open_time_ = std::chrono::steady_clock::now();
-                        log_message(log_level::warning, "Circuit breaker opened");
-                    }
+    // Requires queue_mutex_. Caps a batch at an even share of the global
+    // backlog so one worker cannot hoard tasks while its peers sit idle.
+    // Without stealing nobody could reach the extras, so no batching either.
+    size_t batch_share(worker_state& self) const {
+        if (!config_.enable_batch_processing || config_.batch_size <= 1 || !work_stealing_enabled_) {
+            return 1;
+        }
+
+        {
+            profiled_lock lock(self.local_mutex, self.local_lock_profile);
+            if (self.next_task || !self.local_tasks.empty()) {
+                return 1;
+            }
+        }
+
+        // +1 accounts for the task already popped by the caller
+        const size_t fair_share = (tasks_.size() + 1) / std::max<size_t>(thread_count_, 1);
+        return std::clamp<size_t>(fair_share, 1, config_.batch_size);
+    }
+
+    queued_task pop_local(worker_state& self) {
+        if (local_pending_.load(std::memory_order_relaxed) == 0) {
+            return {};
+        }
+
+        profiled_lock lock(self.local_mutex, self.local_lock_profile);
+        queued_task task;
+        if (self.next_task) {
+            task = std::exchange(self.next_task, {});
+        } else if (!self.local_tasks.empty()) {
+            task = std::move(self.local_tasks.back());
+            self.local_tasks.pop_back();
+        }
+
+        if (task) {
+            local_pending_.fetch_sub(1, std::memory_order_relaxed);
+        }
+        return task;
+    }
+
+    queued_task steal_task(worker_state& self) {
+        const size_t count = started_workers_.load();
+        for (size_t i = 1; i < count && has_stealable_work(); ++i) {
+            auto& victim = *worker_states_[(self.id + i) % count];
+
+            profiled_lock lock(victim.local_mutex, victim.local_lock_profile);
+            queued_task task;
+            if (!victim.local_tasks.empty()) {
+                task = std::move(victim.local_tasks.front());
+                victim.local_tasks.pop_front();
+            } else if (victim.next_task) {
+                task = std::exchange(victim.next_task, {});
+            }
+
+            if (task) {
+                local_pending_.fetch_sub(1, std::memory_order_relaxed);
+                const auto now = std::chrono::steady_clock::now();
+                record_flight(flight_event_kind::steal, now, static_cast<std::uint32_t>(victim.id));
+                if (tracer_ && task.trace_id) {
+                    tracer_->record(trace_event::steal, task.trace_id, now,
+                                    static_cast<std::uint32_t>(victim.id));
                 }
+                return task;
+            }
+        }
+        return {};
+    }
 
-                auto end = std::chrono::steady_clock::now();
-                auto duration = end - start;
-
-                // Record performance sample
-                {
-                    std::lock_guard<std::mutex> lock(metrics_mutex_);
-                    performance_samples_.push_back({
-                        std::chrono::duration_cast<std::chrono::nanoseconds>(duration),
-                        end,
-                        success
-                    });
-
-                    // Keep only last 1000 samples
-                    if (performance_samples_.size() > 1000) {
-                        performance_samples_.erase(performance_samples_.begin());
-                    }
+    bool has_stealable_work() const {
+        return work_stealing_enabled_ && local_pending_.load() > 0;
+    }
+
+    void wake_idle_worker() {
+        if (idle_workers_.load() == 0) {
+            return;
+        }
+
+        // Taking the lock orders this notify after a waiter's predicate check
+        { profiled_lock lock(queue_mutex_, queue_lock_profile_); }
+        condition_.notify_one();
+    }
+
+    void finish_tasks(size_t count) {
+        if (outstanding_tasks_.fetch_sub(count) == count) {
+            std::lock_guard<std::mutex> lock(completion_mutex_);
+            completion_cv_.notify_all();
+        }
+    }
+
+    void execute_task(queued_task& task) {
+        if (task.internal) {
+            run_probe(task);
+            return;
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        bool success = true;
+        // Tasks run by run_pending_task() nest inside a busy period already,
+        // and their counters count toward the task that ran them
+        const bool nested = current_worker.owner == this && current_worker.state->help_depth > 0;
+        worker_clock* activity = current_worker.owner == this && !nested
+            ? &current_worker.state->activity
+            : nullptr;
+        if (activity) {
+            activity->enter(worker_activity::busy, start);
+        }
+        perf_profiler::measurement counters;
+        if (perf_profiler_ && !nested) {
+            counters = perf_profiler_->begin();
+        }
+        record_flight(flight_event_kind::start, start, static_cast<std::uint32_t>(task.priority));
+        if (tracer_) {
+            tracer_->record(trace_event::start, task.trace_id, start, static_cast<std::uint32_t>(task.priority));
+        }
+
+        try {
+            detail::task_outcome_scope outcome;
+            task.fn();
+            if (outcome.failed()) {
+                // The exception went to the task's future
+                tasks_failed_.mark();
+                consecutive_failures_++;
+                success = false;
+            } else {
+                tasks_completed_.mark();
+                if (consecutive_failures_.load(std::memory_order_relaxed) != 0) {
+                    consecutive_failures_ = 0;
                 }
             }
+        } catch (const std::exception& e) {
+            tasks_failed_.mark();
+            consecutive_failures_++;
+            success = false;
+            log_message(log_level::error, "Task failed: " + std::string(e.what()));
         }
+
+        if (counters.active) {
+            perf_profiler_->end(counters, {task.label}, task.priority);
+        }
+        auto end = std::chrono::steady_clock::now();
+        auto duration = end - start;
+        if (activity) {
+            activity->enter(worker_activity::spinning, end);
+        }
+        record_flight(flight_event_kind::finish, end, success ? 0 : 1);
+        if (tracer_) {
+            tracer_->record(trace_event::end, task.trace_id, end);
+        }
+
+        if (breaker_ && breaker_->record(task.breaker_permit, success, duration)) {
+            log_message(log_level::warning, "Circuit breaker opened");
+            publish_health();
+        }
+
+        // Record latency in this worker's histograms
+        auto& latency = current_worker.owner == this
+            ? current_worker.state->latency
+            : external_latency_;
+        latency.record(task.priority, start - task.ready_time, duration);
+        if (start > task.ready_time) {
+            queued_ns_.add(static_cast<std::uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(start - task.ready_time).count()));
+        }
+
+        // Release captured state before signalling completion
+        task.fn = nullptr;
+        finish_tasks(1);
+    }
+
+    // Health probes keep the worker busy but stay out of task metrics
+    void run_probe(queued_task& task) {
+        worker_clock* activity = current_worker.owner == this && current_worker.state->help_depth == 0
+            ? &current_worker.state->activity
+            : nullptr;
+        if (activity) {
+            activity->enter(worker_activity::busy, std::chrono::steady_clock::now());
+        }
+        try {
+            task.fn();
+        } catch (const std::exception& e) {
+            log_message(log_level::error, "Health probe failed: " + std::string(e.what()));
+        }
+        if (activity) {
+            activity->enter(worker_activity::spinning, std::chrono::steady_clock::now());
+        }
+        task.fn = nullptr;
     }
 
     void scheduler_thread_func() {
@@ -243,20 +830,32 @@ private:
 
             auto now = std::chrono::steady_clock::now();
 
-            // Check circuit breaker timeout
-            if (circuit_open_ && config_.enable_circuit_breaker) {
-                if (now - circuit_open_time_ >= config_.circuit_breaker_reset_timeout) {
-                    circuit_open_ = false;
-                    consecutive_failures_ = 0;
-                    log_message(log_level::info, "Circuit breaker reset");
-                }
+            tasks_submitted_.tick(now);
+            tasks_completed_.tick(now);
+            tasks_failed_.tick(now);
+            tasks_rejected_.tick(now);
+
+            // Checks report back as they finish; the tick catches timeouts
+            // and refreshes the built-in state
+            const bool timed_out = health_probes_.poll(now, [this](std::function<void()> probe) {
+                return submit_probe(std::move(probe));
+            });
+            if (timed_out || now >= next_health_evaluation_) {
+                publish_health();
+                next_health_evaluation_ = now + config_.health_check_interval;
             }
+            write_pending_flight_dump();
 
             // Process recurring tasks
             std::lock_guard<std::mutex> lock(recurring_mutex_);
             for (auto& [id, task_info] : recurring_tasks_) {
                 if (!task_info.cancelled && now >= task_info.next_execution) {
-                    submit_internal(task_info.task);
+                    try {
+                        submit_internal(task_info.task);
+                    } catch (const std::exception& e) {
+                        // Rejected (open breaker, full queue); retried next interval
+                        log_message(log_level::warning, "Recurring task skipped: " + std::string(e.what()));
+                    }
                     task_info.next_execution = now + task_info.interval;
                 }
             }
@@ -268,7 +867,7 @@ private:
         }
     }
 
-    void log_message(log_level level, const std::string& message) {
+    void log_message(log_level level, const std::string& message) const {
         if (!config_.enable_console_logging && !config_.enable_file_logging) {
             return;
         }
@@ -281,7 +880,8 @@ private:
         auto time_t = std::chrono::system_clock::to_time_t(now);
 
         std::stringstream ss;
-        ss << "[" << std::put_time(std::localtime(&time_t), "%Y-%m-%d %H:%M:%S") << "] ";
+        const std::tm local = local_time(time_t);
+        ss << "[" << std::put_time(&local, "%Y-%m-%d %H:%M:%S") << "] ";
         ss << "[" << to_string(level) << "] ";
         ss << "[" << config_.name << "] ";
         ss << message;
@@ -296,10 +896,12 @@ private:
         }
 
         // Emit log event
-        emit_event("log", ss.str());
+        if (events_.has_subscribers(log_event_)) {
+            events_.emit(log_event_, ss.str());
+        }
     }
 
-    std::string to_string(log_level level) {
+    std::string to_string(log_level level) const {
         switch (level) {
             case log_level::trace: return "TRACE";
             case log_level::debug: return "DEBUG";
@@ -312,70 +914,251 @@ private:
         }
     }
 
-    void emit_event(const std::string& event_type, const std::any& data) {
-        std::lock_guard<std::mutex> lock(event_mutex_);
+public:
+    bool is_worker_thread() const {
+        return current_worker.owner == this;
+    }
 
-        auto it = event_subscribers_.find(event_type);
-        if (it != event_subscribers_.end()) {
-            for (const auto& [id, callback] : it->second) {
-                try {
-                    callback(event_type, data);
-                } catch (...) {
-                    // Ignore callback errors
-                }
+    adapters::io_adapter& io() {
+        if (shutting_down_) {
+            throw std::runtime_error("System is shutting down");
+        }
+
+        std::lock_guard<std::mutex> lock(io_mutex_);
+        if (!io_adapter_) {
+            io_config io_cfg;
+            io_cfg.enable_io_uring = config_.enable_io_uring;
+            io_cfg.queue_depth = config_.io_queue_depth;
+            io_cfg.fallback_threads = config_.io_fallback_threads;
+
+            auto adapter = std::make_unique<adapters::io_adapter>(io_cfg);
+            auto result = adapter->initialize();
+            if (result.is_err()) {
+                throw std::runtime_error("Failed to initialize async I/O: " + result.error().message);
             }
+            io_adapter_ = std::move(adapter);
         }
+        return *io_adapter_;
     }
 
-public:
-    void submit_internal(std::function<void()> task) {
-        submit_priority_internal(static_cast<int>(priority_level::normal), std::move(task));
+    // Runs one runnable task on the calling worker without sleeping
+    bool run_pending_task() {
+        if (current_worker.owner != this) {
+            return false;
+        }
+
+        worker_state& self = *current_worker.state;
+        if (self.help_depth >= max_help_depth) {
+            return false;
+        }
+
+        queued_task task = pop_local(self);
+        if (!task) {
+            profiled_lock lock(queue_mutex_, queue_lock_profile_);
+            task = pop_global(std::chrono::steady_clock::now());
+        }
+        if (!task && work_stealing_enabled_) {
+            task = steal_task(self);
+        }
+        if (!task) {
+            return false;
+        }
+
+        ++self.help_depth;
+        execute_task(task);
+        --self.help_depth;
+        return true;
     }
 
-    void submit_priority_internal(int priority, std::function<void()> task) {
-        if (circuit_open_) {
-            throw std::runtime_error("Circuit breaker is open");
+    void submit_internal(std::function<void()> task) {
+        if (current_worker.owner == this && work_stealing_enabled_) {
+            submit_local(*current_worker.state, std::move(task));
+            return;
         }
 
+        submit_priority_internal(static_cast<int>(priority_level::normal), std::move(task));
+    }
+
+    void submit_priority_internal(int priority, std::function<void()> task, task_label label = {}) {
         if (stop_) {
-            throw std::runtime_error("Thread system is shutting down");
+            reject(flight_reject_reason::shutting_down, "Thread system is shutting down");
         }
 
+        const circuit_permit permit = acquire_permit();
+
+        const std::uint64_t trace_id = trace_submit();
+        std::chrono::steady_clock::time_point enqueued;
+        size_t depth = 0;
         {
-            std::unique_lock<std::mutex> lock(queue_mutex_);
+            profiled_lock lock(queue_mutex_, queue_lock_profile_);
 
             // Check queue size limit
-            if (config_.max_queue_size > 0 && tasks_.size() >= config_.max_queue_size) {
-                throw std::runtime_error("Queue is full");
+            if (queue_full()) {
+                release_permit(permit);
+                reject(flight_reject_reason::queue_full, "Queue is full");
             }
 
+            outstanding_tasks_++;
+            enqueued = std::chrono::steady_clock::now();
             tasks_.push({
                 priority,
-                std::chrono::steady_clock::now(),
-                std::move(task)
+                enqueued,
+                std::move(task),
+                trace_id,
+                label.id,
+                false,
+                permit
             });
+            global_pending_.fetch_add(1, std::memory_order_relaxed);
+            depth = tasks_.size();
+
+            tasks_submitted_.mark();
+        }
 
-            tasks_submitted_++;
+        condition_.notify_one();
+        record_flight(flight_event_kind::enqueue, enqueued, static_cast<std::uint32_t>(depth));
+        if (trace_id) {
+            tracer_->record(trace_event::enqueue, trace_id, enqueued);
         }
+    }
 
+    // Queued at the lowest priority, past the breaker and the queue limit,
+    // and not counted as outstanding: a hung check must not hold up
+    // wait_for_completion()
+    bool submit_probe(std::function<void()> probe) {
+        if (stop_) {
+            return false;
+        }
+        {
+            profiled_lock lock(queue_mutex_, queue_lock_profile_);
+            tasks_.push({
+                static_cast<int>(priority_level::lowest),
+                std::chrono::steady_clock::now(),
+                std::move(probe),
+                0,
+                0,
+                true
+            });
+            global_pending_.fetch_add(1, std::memory_order_relaxed);
+        }
         condition_.notify_one();
+        return true;
+    }
+
+    // Head sampling: the decision made here covers every event of the task
+    std::uint64_t trace_submit() {
+        if (!tracer_) {
+            return 0;
+        }
+        const std::uint64_t trace_id = tracer_->sample();
+        if (trace_id) {
+            tracer_->record(trace_event::submit, trace_id, std::chrono::steady_clock::now());
+        }
+        return trace_id;
+    }
+
+    // A permit for the task about to be queued; every later rejection must
+    // hand it back, or a half-open breaker waits for a probe that never runs
+    circuit_permit acquire_permit() {
+        if (!breaker_) {
+            return {};
+        }
+        auto permit = breaker_->acquire();
+        if (!permit) {
+            reject(flight_reject_reason::circuit_open, "Circuit breaker is open");
+        }
+        return *permit;
+    }
+
+    void release_permit(const circuit_permit& permit) noexcept {
+        if (breaker_) {
+            breaker_->release(permit);
+        }
+    }
+
+    [[noreturn]] void reject(flight_reject_reason reason, const char* message) {
+        tasks_rejected_.mark();
+        record_flight(flight_event_kind::reject, std::chrono::steady_clock::now(),
+                      static_cast<std::uint32_t>(reason));
+        throw std::runtime_error(message);
+    }
+
+    // Workers record on their own ring; every other thread shares the last one
+    void record_flight(flight_event_kind kind, std::chrono::steady_clock::time_point at,
+                       std::uint32_t arg = 0) const noexcept {
+        if (!flight_recorder_) {
+            return;
+        }
+        if (current_worker.owner == this) {
+            flight_recorder_->record(current_worker.state->id, kind, at, arg);
+        } else {
+            flight_recorder_->record_shared(kind, at, arg);
+        }
+    }
+
+    // Fast path for tasks submitted from one of our own workers: no global lock,
+    // and the new task becomes the worker's next task unless someone steals it.
+    void submit_local(worker_state& self, std::function<void()> task) {
+        if (stop_) {
+            reject(flight_reject_reason::shutting_down, "Thread system is shutting down");
+        }
+
+        const circuit_permit permit = acquire_permit();
+        if (queue_full()) {
+            release_permit(permit);
+            reject(flight_reject_reason::queue_full, "Queue is full");
+        }
+
+        const std::uint64_t trace_id = trace_submit();
+        outstanding_tasks_++;
+        queued_task entry{std::move(task), std::chrono::steady_clock::now(),
+                          static_cast<int>(priority_level::normal), trace_id, 0, false, permit};
+        const auto enqueued = entry.ready_time;
+        size_t depth = 0;
+        {
+            profiled_lock lock(self.local_mutex, self.local_lock_profile);
+            if (self.next_task) {
+                self.local_tasks.push_back(std::move(self.next_task));
+            }
+            self.next_task = std::move(entry);
+            depth = self.local_tasks.size() + 1;
+            local_pending_.fetch_add(1);
+        }
+
+        tasks_submitted_.mark();
+        record_flight(flight_event_kind::enqueue, enqueued, static_cast<std::uint32_t>(depth));
+        if (trace_id) {
+            tracer_->record(trace_event::enqueue, trace_id, enqueued);
+        }
+        wake_idle_worker();
     }
 
     void schedule_internal(std::chrono::milliseconds delay, std::function<void()> task) {
-        auto scheduled_time = std::chrono::steady_clock::now() + delay;
+        const std::uint64_t trace_id = trace_submit();
+        const auto now = std::chrono::steady_clock::now();
+        size_t depth = 0;
 
         {
-            std::unique_lock<std::mutex> lock(queue_mutex_);
+            profiled_lock lock(queue_mutex_, queue_lock_profile_);
+            outstanding_tasks_++;
             tasks_.push({
                 static_cast<int>(priority_level::normal),
-                scheduled_time,
-                std::move(task)
+                now + delay,
+                std::move(task),
+                trace_id
             });
+            global_pending_.fetch_add(1, std::memory_order_relaxed);
+            depth = tasks_.size();
 
-            tasks_submitted_++;
+            tasks_submitted_.mark();
         }
 
         condition_.notify_one();
+        record_flight(flight_event_kind::enqueue, now, static_cast<std::uint32_t>(depth));
+        if (trace_id) {
+            // The queued span includes the delay
+            tracer_->record(trace_event::enqueue, trace_id, now);
+        }
     }
 
     size_t schedule_recurring_internal(std::chrono::milliseconds interval, std::function<void()> task) {
@@ -400,130 +1183,247 @@ public:
         }
     }
 
-    performance_metrics get_metrics() const {
-        std::lock_guard<std::mutex> lock(metrics_mutex_);
+    // Merges the per-worker latency histograms
+    void merge_latency_into(task_latency_snapshot& breakdown) const {
+        external_latency_.merge_into(breakdown);
+        for (const auto& state : worker_states_) {
+            state->latency.merge_into(breakdown);
+        }
+    }
 
+    performance_metrics get_metrics() const {
         performance_metrics metrics;
-        metrics.tasks_submitted = tasks_submitted_;
-        metrics.tasks_completed = tasks_completed_;
-        metrics.tasks_failed = tasks_failed_;
+        metrics.tasks_submitted = tasks_submitted_.count();
+        metrics.tasks_completed = tasks_completed_.count();
+        metrics.tasks_failed = tasks_failed_.count();
+        metrics.tasks_rejected = tasks_rejected_.count();
         metrics.tasks_cancelled = tasks_cancelled_;
 
-        // Calculate timing metrics
-        if (!performance_samples_.empty()) {
-            std::vector<std::chrono::nanoseconds> durations;
-            for (const auto& sample : performance_samples_) {
-                durations.push_back(sample.duration);
-            }
-
-            std::sort(durations.begin(), durations.end());
-
-            metrics.min_latency = durations.front();
-            metrics.max_latency = durations.back();
-            metrics.average_latency = std::accumulate(
-                durations.begin(), durations.end(),
-                std::chrono::nanoseconds(0)
-            ) / durations.size();
-
-            // Calculate percentiles
-            size_t p95_index = static_cast<size_t>(durations.size() * 0.95);
-            size_t p99_index = static_cast<size_t>(durations.size() * 0.99);
-            metrics.p95_latency = durations[p95_index];
-            metrics.p99_latency = durations[p99_index];
+        task_latency_snapshot breakdown;
+        merge_latency_into(breakdown);
+
+        const latency_snapshot latency = breakdown.total_execution();
+        metrics.queue_wait_latency = latency_summary::from(breakdown.total_queue_wait());
+        metrics.execution_latency = latency_summary::from(latency);
+        metrics.end_to_end_latency = latency_summary::from(breakdown.total_end_to_end());
+        metrics.lane_latencies = breakdown.lanes();
+
+        if (latency.count() > 0) {
+            metrics.min_latency = latency.min();
+            metrics.max_latency = latency.max();
+            metrics.average_latency = latency.mean();
+            metrics.p50_latency = latency.percentile(0.50);
+            metrics.p95_latency = latency.percentile(0.95);
+            metrics.p99_latency = latency.percentile(0.99);
+            metrics.p999_latency = latency.percentile(0.999);
         }
 
         // Resource metrics
-        metrics.active_workers = workers_.size();
-        metrics.queue_size = tasks_.size();
+        const auto now = std::chrono::steady_clock::now();
+        read_workers(metrics.workers, now);
+        add_time_averages(metrics, now);
+        metrics.blocked_workers = blocked_workers_.load();
+        metrics.compensating_workers = running_compensators_.load();
+        metrics.queue_size = queue_size();
         metrics.max_queue_size = config_.max_queue_size;
+        if (lock_profiler_) {
+            metrics.locks = lock_profiler_->snapshot();
+        }
+        if (perf_profiler_) {
+            metrics.task_classes = perf_profiler_->snapshot();
+        }
 
         if (config_.max_queue_size > 0) {
             metrics.queue_utilization_percent =
-                (static_cast<double>(tasks_.size()) / config_.max_queue_size) * 100.0;
+                (static_cast<double>(metrics.queue_size) / config_.max_queue_size) * 100.0;
         }
 
-        // Calculate throughput
-        auto elapsed = std::chrono::steady_clock::now() - start_time_;
-        auto elapsed_seconds = std::chrono::duration_cast<std::chrono::seconds>(elapsed).count();
-        if (elapsed_seconds > 0) {
-            metrics.tasks_per_second =
-                static_cast<double>(metrics.tasks_completed) / elapsed_seconds;
-        }
+        // Throughput, as of the scheduler's last meter tick
+        metrics.submission_rate = tasks_submitted_.snapshot(now);
+        metrics.completion_rate = tasks_completed_.snapshot(now);
+        metrics.failure_rate = tasks_failed_.snapshot(now);
+        metrics.rejection_rate = tasks_rejected_.snapshot(now);
+        metrics.tasks_per_second = metrics.completion_rate.window_rate;
 
         metrics.measurement_start = start_time_;
 
         return metrics;
     }
 
-    health_status get_health() const {
-        health_status status;
-
-        // Basic health calculation
-        auto metrics = get_metrics();
-
-        // Queue utilization
-        status.queue_utilization_percent = metrics.queue_utilization_percent;
-
-        // Circuit breaker status
-        status.circuit_breaker_open = circuit_open_;
-        status.consecutive_failures = consecutive_failures_;
+    // Started workers only; compensator slots that never ran are left out
+    void read_workers(std::vector<worker_utilization>& out, std::chrono::steady_clock::time_point now) const {
+        const size_t started = started_workers_.load();
+        out.clear();
+        out.reserve(started);
+        for (size_t i = 0; i < started; ++i) {
+            auto entry = worker_states_[i]->activity.read(now);
+            entry.worker = i;
+            out.push_back(entry);
+        }
+    }
 
-        // Run custom health checks
-        {
-            std::lock_guard<std::mutex> lock(health_checks_mutex_);
-            for (const auto& [name, check] : health_checks_) {
-                try {
-                    auto [healthy, message] = check();
-                    if (!healthy) {
-                        status.issues.push_back(name + ": " + message);
-                    }
-                } catch (const std::exception& e) {
-                    status.issues.push_back(name + " check failed: " + std::string(e.what()));
-                }
+    void add_time_averages(performance_metrics& metrics, std::chrono::steady_clock::time_point now) const {
+        std::chrono::nanoseconds busy{0};
+        std::chrono::nanoseconds available{0};
+        for (const auto& entry : metrics.workers) {
+            busy += entry[worker_activity::busy];
+            available += entry.available();
+            if (entry.state == worker_activity::busy) {
+                ++metrics.active_workers;
             }
         }
+        if (available.count() > 0) {
+            metrics.pool_utilization = static_cast<double>(busy.count()) / available.count();
+        }
 
-        // Collect custom metrics
-        {
-            std::lock_guard<std::mutex> lock(custom_metrics_mutex_);
-            for (const auto& [name, collector] : metric_collectors_) {
-                try {
-                    // Custom metrics are collected but not currently added to health_status
-                    // This is intentional to keep health_status lightweight
-                    // For full metrics, use get_metrics() instead
-                    auto metric_value = collector();
-                    (void)metric_value; // Suppress unused variable warning
-                } catch (...) {
-                    // Ignore collector errors
-                }
-            }
+        const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(now - start_time_).count();
+        if (elapsed > 0) {
+            metrics.average_busy_workers = static_cast<double>(busy.count()) / elapsed;
+            metrics.average_queue_length = static_cast<double>(queued_ns_.value()) / elapsed;
+            metrics.average_tasks_in_system = metrics.average_busy_workers + metrics.average_queue_length;
         }
+    }
+
+    health_status get_health() const {
+        return load_health()->status;
+    }
+
+    std::shared_ptr<const health_snapshot> load_health() const {
+#if defined(__cpp_lib_atomic_shared_ptr)
+        return health_.load(std::memory_order_acquire);
+#else
+        return std::atomic_load_explicit(&health_, std::memory_order_acquire);
+#endif
+    }
+
+    // Republishes with the last check results, for state that changes
+    // between evaluations, such as the breaker opening
+    void publish_health() {
+        std::lock_guard<std::mutex> lock(health_publish_mutex_);
+        publish_health_locked();
+    }
+
+    void publish_health_locked() {
+        auto snapshot = std::make_shared<health_snapshot>();
+        health_status& status = snapshot->status;
+
+        status.queue_utilization_percent = config_.max_queue_size > 0
+            ? (static_cast<double>(queue_size()) / config_.max_queue_size) * 100.0
+            : 0.0;
+        status.circuit_breaker_open = breaker_ && breaker_->is_open();
+        status.consecutive_failures = consecutive_failures_;
+        status.issues = health_probes_.issues();
 
         // Determine overall health
         constexpr double QUEUE_UTILIZATION_DEGRADED_THRESHOLD = 80.0;
-        if (circuit_open_ || !status.issues.empty()) {
+        if (status.circuit_breaker_open || !status.issues.empty()) {
             status.overall_health = health_level::critical;
         } else if (status.queue_utilization_percent > QUEUE_UTILIZATION_DEGRADED_THRESHOLD) {
             status.overall_health = health_level::degraded;
         } else {
             status.overall_health = health_level::healthy;
         }
+        snapshot->json = health_json(status);
+
+#if defined(__cpp_lib_atomic_shared_ptr)
+        health_.store(std::move(snapshot), std::memory_order_release);
+#else
+        std::atomic_store_explicit(&health_, std::shared_ptr<const health_snapshot>(std::move(snapshot)),
+                                   std::memory_order_release);
+#endif
+
+        const bool critical = status.overall_health == health_level::critical;
+        if (health_critical_.exchange(critical) != critical && critical) {
+            request_flight_dump();
+        }
+    }
+
+    // Keeps the events leading up to the transition, written later by the
+    // scheduler thread; rate limited so a flapping health check cannot fill
+    // the disk
+    void request_flight_dump() {
+        if (!flight_recorder_) {
+            return;
+        }
+
+        const auto now = std::chrono::steady_clock::now();
+        std::lock_guard<std::mutex> lock(flight_dump_mutex_);
+        if (last_flight_dump_ != std::chrono::steady_clock::time_point{} &&
+            now - last_flight_dump_ < flight_dump_interval) {
+            return;
+        }
+        last_flight_dump_ = now;
+        pending_flight_dump_ = flight_recorder_->heads();
+    }
+
+    void write_pending_flight_dump() {
+        std::vector<std::uint64_t> heads;
+        {
+            std::lock_guard<std::mutex> lock(flight_dump_mutex_);
+            heads.swap(pending_flight_dump_);
+        }
+        if (heads.empty()) {
+            return;
+        }
+
+        const std::tm local = local_time(std::chrono::system_clock::to_time_t(std::chrono::system_clock::now()));
+        std::stringstream name;
+        name << config_.name << "-flight-" << std::put_time(&local, "%Y%m%d-%H%M%S") << ".bin";
+
+        const std::filesystem::path directory = config_.flight_recorder_dump_directory.empty()
+            ? config_.log_directory
+            : config_.flight_recorder_dump_directory;
+        std::error_code ec;
+        std::filesystem::create_directories(directory, ec);
+
+        const std::string path = (directory / name.str()).string();
+        auto result = flight_recorder_->dump(path, heads);
+        if (result.is_err()) {
+            log_message(log_level::warning, "Flight recorder dump failed: " + result.error().message);
+        } else {
+            log_message(log_level::warning, "Health is critical; flight recorder dumped to " + path);
+        }
+    }
 
-        return status;
+    static std::string health_json(const health_status& status) {
+        std::stringstream ss;
+        ss << "{\n";
+        ss << "  \"status\": \"" << health_level_name(status.overall_health) << "\",\n";
+        ss << "  \"queue_utilization_percent\": " << status.queue_utilization_percent << ",\n";
+        ss << "  \"circuit_breaker_open\": " << (status.circuit_breaker_open ? "true" : "false") << ",\n";
+        ss << "  \"consecutive_failures\": " << status.consecutive_failures << ",\n";
+        ss << "  \"issues\": [";
+        for (size_t i = 0; i < status.issues.size(); ++i) {
+            ss << (i == 0 ? "" : ", ");
+            write_json_string(ss, status.issues[i]);
+        }
+        ss << "]\n";
+        ss << "}";
+        return ss.str();
+    }
+
+    std::string export_health_json() const {
+        return load_health()->json;
+    }
+
+    std::uint16_t metrics_endpoint_port() const {
+        return metrics_endpoint_ ? metrics_endpoint_->port() : 0;
     }
 
     void wait_for_completion() {
-        std::unique_lock<std::mutex> lock(queue_mutex_);
-        condition_.wait(lock, [this] { return tasks_.empty(); });
+        std::unique_lock<std::mutex> lock(completion_mutex_);
+        completion_cv_.wait(lock, [this] { return outstanding_tasks_.load() == 0; });
     }
 
     bool wait_for_completion_timeout(std::chrono::milliseconds timeout) {
-        std::unique_lock<std::mutex> lock(queue_mutex_);
-        return condition_.wait_for(lock, timeout, [this] { return tasks_.empty(); });
+        std::unique_lock<std::mutex> lock(completion_mutex_);
+        return completion_cv_.wait_for(lock, timeout, [this] {
+            return outstanding_tasks_.load() == 0;
+        });
     }
 
     size_t worker_count() const {
-        return workers_.size();
+        return thread_count_;
     }
 
     void set_worker_count(size_t count) {
@@ -537,13 +1437,19 @@ public:
         log_message(log_level::info, "Work stealing " + std::string(enabled ? "enabled" : "disabled"));
     }
 
+    // Everything queued and not yet started, global and local alike
     size_t queue_size() const {
-        std::lock_guard<std::mutex> lock(queue_mutex_);
-        return tasks_.size();
+        return global_pending_.load() + local_pending_.load();
+    }
+
+    // One limit for both submit paths; batching only moves tasks between
+    // the queues, so it never counts against a nested submit
+    bool queue_full() const {
+        return config_.max_queue_size > 0 && queue_size() >= config_.max_queue_size;
     }
 
     bool is_healthy() const {
-        return get_health().overall_health == health_level::healthy;
+        return load_health()->status.overall_health == health_level::healthy;
     }
 
     void shutdown() {
@@ -554,14 +1460,33 @@ public:
 
     void shutdown_immediate() {
         stop_ = true;
-        tasks_cancelled_ = tasks_.size();
 
-        // Clear the queue
+        // Clear the queues
+        size_t dropped = 0;
         {
-            std::lock_guard<std::mutex> lock(queue_mutex_);
+            profiled_lock lock(queue_mutex_, queue_lock_profile_);
             while (!tasks_.empty()) {
+                dropped += tasks_.top().internal ? 0 : 1;
                 tasks_.pop();
             }
+            global_pending_ = 0;
+        }
+
+        for (auto& state : worker_states_) {
+            profiled_lock lock(state->local_mutex, state->local_lock_profile);
+            size_t local = state->local_tasks.size() + (state->next_task ? 1 : 0);
+            dropped += static_cast<size_t>(std::count_if(
+                state->local_tasks.begin(), state->local_tasks.end(),
+                [](const queued_task& task) { return !task.internal; }));
+            dropped += state->next_task && !state->next_task.internal ? 1 : 0;
+            state->local_tasks.clear();
+            state->next_task = {};
+            local_pending_.fetch_sub(local);
+        }
+
+        tasks_cancelled_ = dropped;
+        if (dropped > 0) {
+            finish_tasks(dropped);
         }
 
         shutdown_systems();
@@ -572,44 +1497,44 @@ public:
     }
 
     void reset_circuit_breaker() {
-        circuit_open_ = false;
+        if (breaker_) {
+            breaker_->reset();
+        }
         consecutive_failures_ = 0;
+        publish_health();
         log_message(log_level::info, "Circuit breaker manually reset");
     }
 
     bool is_circuit_open() const {
-        return circuit_open_;
+        return breaker_ && breaker_->is_open();
     }
 
-    void register_metric_collector(const std::string& name, std::function<double()> collector) {
-        std::lock_guard<std::mutex> lock(custom_metrics_mutex_);
-        metric_collectors_[name] = std::move(collector);
+    void register_metric_collector(const std::string& name, std::function<double()> collector,
+                                   gauge_handle gauge) {
+        health_probes_.add_collector(name, std::move(collector), gauge);
     }
 
-    void add_health_check(const std::string& name,
-                         std::function<std::pair<bool, std::string>()> check) {
-        std::lock_guard<std::mutex> lock(health_checks_mutex_);
-        health_checks_[name] = std::move(check);
+    void add_health_check(const std::string& name, std::function<std::pair<bool, std::string>()> check,
+                          std::chrono::milliseconds timeout) {
+        health_probes_.add_check(name, std::move(check), timeout);
     }
 
-    size_t subscribe_to_events(const std::string& event_type, event_callback callback) {
-        std::lock_guard<std::mutex> lock(event_mutex_);
-        size_t id = next_subscription_id_++;
-        event_subscribers_[event_type].push_back({id, std::move(callback)});
-        return id;
+    size_t subscribe_to_events(const std::string& event_type, event_callback callback,
+                               event_delivery delivery) {
+        return events_.subscribe(events_.intern(event_type), std::move(callback), delivery);
     }
 
     void unsubscribe_from_events(size_t subscription_id) {
-        std::lock_guard<std::mutex> lock(event_mutex_);
-        for (auto& [type, subscribers] : event_subscribers_) {
-            subscribers.erase(
-                std::remove_if(subscribers.begin(), subscribers.end(),
-                              [subscription_id](const auto& p) {
-                                  return p.first == subscription_id;
-                              }),
-                subscribers.end()
-            );
-        }
+        events_.unsubscribe(subscription_id);
+    }
+
+    static std::array<named_rate, 4> task_rates(const performance_metrics& metrics) {
+        return {{
+            {"submitted", metrics.submission_rate},
+            {"completed", metrics.completion_rate},
+            {"failed", metrics.failure_rate},
+            {"rejected", metrics.rejection_rate}
+        }};
     }
 
     std::string export_metrics_json() const {
@@ -620,44 +1545,142 @@ public:
         ss << "  \"tasks_submitted\": " << metrics.tasks_submitted << ",\n";
         ss << "  \"tasks_completed\": " << metrics.tasks_completed << ",\n";
         ss << "  \"tasks_failed\": " << metrics.tasks_failed << ",\n";
+        ss << "  \"tasks_rejected\": " << metrics.tasks_rejected << ",\n";
         ss << "  \"tasks_cancelled\": " << metrics.tasks_cancelled << ",\n";
         ss << "  \"average_latency_ns\": " << metrics.average_latency.count() << ",\n";
+        ss << "  \"p50_latency_ns\": " << metrics.p50_latency.count() << ",\n";
         ss << "  \"p95_latency_ns\": " << metrics.p95_latency.count() << ",\n";
         ss << "  \"p99_latency_ns\": " << metrics.p99_latency.count() << ",\n";
+        ss << "  \"p999_latency_ns\": " << metrics.p999_latency.count() << ",\n";
+        ss << "  \"latency_by_lane\": ";
+        write_latency_json(ss, metrics.lane_latencies, 2);
+        ss << ",\n";
         ss << "  \"queue_size\": " << metrics.queue_size << ",\n";
         ss << "  \"queue_utilization_percent\": " << metrics.queue_utilization_percent << ",\n";
-        ss << "  \"tasks_per_second\": " << metrics.tasks_per_second << "\n";
+        ss << "  \"active_workers\": " << metrics.active_workers << ",\n";
+        ss << "  \"pool_utilization\": " << metrics.pool_utilization << ",\n";
+        ss << "  \"average_busy_workers\": " << metrics.average_busy_workers << ",\n";
+        ss << "  \"average_queue_length\": " << metrics.average_queue_length << ",\n";
+        ss << "  \"average_tasks_in_system\": " << metrics.average_tasks_in_system << ",\n";
+        ss << "  \"workers\": ";
+        write_utilization_json(ss, metrics.workers, 2);
+        ss << ",\n";
+        ss << "  \"locks\": ";
+        write_lock_contention_json(ss, metrics.locks, 2);
+        ss << ",\n";
+        ss << "  \"task_counters\": ";
+        write_task_counters_json(ss, metrics.task_classes, 2);
+        ss << ",\n";
+        ss << "  \"tasks_per_second\": " << metrics.tasks_per_second << ",\n";
+        ss << "  \"rates\": ";
+        write_rates_json(ss, task_rates(metrics), 2);
+        ss << "\n";
         ss << "}";
 
         return ss.str();
     }
 
-    std::string export_metrics_prometheus() const {
-        auto metrics = get_metrics();
-
-        std::stringstream ss;
-        ss << "# HELP tasks_submitted Total number of tasks submitted\n";
-        ss << "# TYPE tasks_submitted counter\n";
-        ss << "tasks_submitted " << metrics.tasks_submitted << "\n";
+    // Serializes straight from the counters and histograms, so with a reused
+    // writer a scrape does not allocate
+    void export_metrics(prometheus_writer& writer) const {
+        const std::string_view pool = config_.name;
+        const metric_labels labels = {{"pool", pool}};
+
+        const struct {
+            const char* name;
+            const char* help;
+            const rate_meter& meter;
+        } counters[] = {
+            {"tasks_submitted", "Tasks accepted for execution", tasks_submitted_},
+            {"tasks_completed", "Tasks that finished successfully", tasks_completed_},
+            {"tasks_failed", "Tasks that threw", tasks_failed_},
+            {"tasks_rejected", "Submissions refused (open breaker, full queue, shutdown)", tasks_rejected_}
+        };
+        for (const auto& [name, help, meter] : counters) {
+            writer.family(name, metric_type::counter, help);
+            writer.counter(name, labels, meter.count());
+        }
+        writer.family("tasks_cancelled", metric_type::counter, "Queued tasks dropped by shutdown");
+        writer.counter("tasks_cancelled", labels, tasks_cancelled_.load());
+        writer.family("task_queued_seconds", metric_type::counter,
+                      "Queue wait summed over started tasks; its rate is the average queue length");
+        writer.counter("task_queued_seconds", labels, std::chrono::nanoseconds(queued_ns_.value()));
+
+        // Worker clocks are read into a scratch vector kept across scrapes
+        std::lock_guard<std::mutex> lock(export_mutex_);
+        const auto now = std::chrono::steady_clock::now();
+        read_workers(export_workers_, now);
+        const auto busy_now = std::count_if(export_workers_.begin(), export_workers_.end(), [](const auto& entry) {
+            return entry.state == worker_activity::busy;
+        });
+
+        const struct {
+            const char* name;
+            const char* help;
+            size_t value;
+        } gauges[] = {
+            {"queue_size", "Tasks waiting to run", queue_size()},
+            {"configured_workers", "Configured worker threads", thread_count_},
+            {"active_workers", "Workers running a task", static_cast<size_t>(busy_now)},
+            {"blocked_workers", "Workers inside blocking sections", blocked_workers_.load()},
+            {"compensating_workers", "Extra workers standing in for blocked ones", running_compensators_.load()}
+        };
+        for (const auto& [name, help, value] : gauges) {
+            writer.family(name, metric_type::gauge, help);
+            writer.gauge(name, labels, static_cast<double>(value));
+        }
+        write_utilization_prometheus(writer, pool, export_workers_);
+
+        const std::array<named_rate, 4> rates{{
+            {"submitted", tasks_submitted_.snapshot(now)},
+            {"completed", tasks_completed_.snapshot(now)},
+            {"failed", tasks_failed_.snapshot(now)},
+            {"rejected", tasks_rejected_.snapshot(now)}
+        }};
+        write_rates_prometheus(writer, pool, rates);
+        metric_registry_.write(writer);
+
+        // Histograms are merged into a scratch snapshot kept across scrapes
+        export_latency_.clear();
+        merge_latency_into(export_latency_);
+        write_latency_prometheus(writer, pool, export_latency_);
+
+        if (lock_profiler_) {
+            lock_profiler_->write_prometheus(writer, pool);
+        }
+        if (perf_profiler_) {
+            perf_profiler_->write_prometheus(writer, pool);
+        }
+    }
 
-        ss << "# HELP tasks_completed Total number of tasks completed\n";
-        ss << "# TYPE tasks_completed counter\n";
-        ss << "tasks_completed " << metrics.tasks_completed << "\n";
+    task_label register_task_label(const std::string& name) {
+        if (name.empty()) {
+            throw std::invalid_argument("Task label name must not be empty");
+        }
+        return perf_profiler_ ? perf_profiler_->label(name) : task_label{};
+    }
 
-        ss << "# HELP tasks_failed Total number of tasks failed\n";
-        ss << "# TYPE tasks_failed counter\n";
-        ss << "tasks_failed " << metrics.tasks_failed << "\n";
+    metric_registry& metrics() { return metric_registry_; }
 
-        ss << "# HELP average_latency_seconds Average task latency\n";
-        ss << "# TYPE average_latency_seconds gauge\n";
-        ss << "average_latency_seconds " <<
-              (metrics.average_latency.count() / 1e9) << "\n";
+    const task_tracer& tracer() const {
+        if (!tracer_) {
+            throw std::runtime_error("Tracing is not enabled");
+        }
+        return *tracer_;
+    }
 
-        ss << "# HELP queue_size Current queue size\n";
-        ss << "# TYPE queue_size gauge\n";
-        ss << "queue_size " << metrics.queue_size << "\n";
+    const flight_recorder& flight() const {
+        if (!flight_recorder_) {
+            throw std::runtime_error("Flight recorder is not enabled");
+        }
+        return *flight_recorder_;
+    }
 
-        return ss.str();
+    std::string export_metrics_text(exposition_format format) const {
+        thread_local prometheus_writer writer;
+        writer.reset(format);
+        export_metrics(writer);
+        return std::string(writer.finish());
     }
 
     void load_plugin(const std::string& plugin_path) {
@@ -693,6 +1716,42 @@ void unified_thread_system::submit_priority_internal(int priority, std::function
     pimpl_->submit_priority_internal(priority, std::move(task));
 }
 
+void unified_thread_system::submit_labeled_internal(task_label label, int priority, std::function<void()> task) {
+    pimpl_->submit_priority_internal(priority, std::move(task), label);
+}
+
+task_label unified_thread_system::register_task_label(const std::string& name) {
+    return pimpl_->register_task_label(name);
+}
+
+bool unified_thread_system::begin_blocking() {
+    return pimpl_->begin_blocking();
+}
+
+void unified_thread_system::end_blocking() {
+    pimpl_->end_blocking();
+}
+
+bool unified_thread_system::is_worker_thread() const {
+    return pimpl_->is_worker_thread();
+}
+
+bool unified_thread_system::run_pending_task() {
+    return pimpl_->run_pending_task();
+}
+
+std::future<size_t> unified_thread_system::async_read(int fd, std::span<std::byte> buffer, std::uint64_t offset) {
+    return pimpl_->io().read(fd, buffer, offset);
+}
+
+std::future<size_t> unified_thread_system::async_write(int fd, std::span<const std::byte> buffer, std::uint64_t offset) {
+    return pimpl_->io().write(fd, buffer, offset);
+}
+
+std::future<void> unified_thread_system::async_fsync(int fd) {
+    return pimpl_->io().fsync(fd);
+}
+
 void unified_thread_system::schedule_internal(std::chrono::milliseconds delay, std::function<void()> task) {
     pimpl_->schedule_internal(delay, std::move(task));
 }
@@ -758,7 +1817,66 @@ std::string unified_thread_system::export_metrics_json() const {
 }
 
 std::string unified_thread_system::export_metrics_prometheus() const {
-    return pimpl_->export_metrics_prometheus();
+    return pimpl_->export_metrics_text(exposition_format::prometheus_text);
+}
+
+std::string unified_thread_system::export_metrics_openmetrics() const {
+    return pimpl_->export_metrics_text(exposition_format::openmetrics);
+}
+
+void unified_thread_system::export_metrics(prometheus_writer& writer) const {
+    pimpl_->export_metrics(writer);
+}
+
+std::string unified_thread_system::export_health_json() const {
+    return pimpl_->export_health_json();
+}
+
+std::uint16_t unified_thread_system::metrics_endpoint_port() const {
+    return pimpl_->metrics_endpoint_port();
+}
+
+std::string unified_thread_system::export_trace_json() const {
+    return pimpl_->tracer().chrome_json();
+}
+
+void unified_thread_system::export_trace(const std::string& path) const {
+    auto result = pimpl_->tracer().write_chrome_json(path);
+    if (result.is_err()) {
+        throw std::runtime_error(result.error().message);
+    }
+}
+
+void unified_thread_system::dump_flight_recorder(const std::string& path) const {
+    auto result = pimpl_->flight().dump(path);
+    if (result.is_err()) {
+        throw std::runtime_error(result.error().message);
+    }
+}
+
+counter_handle unified_thread_system::register_counter(const std::string& name, metric_labels labels) {
+    auto result = pimpl_->metrics().register_counter(name, labels);
+    if (result.is_err()) {
+        throw std::invalid_argument(result.error().message);
+    }
+    return result.value();
+}
+
+gauge_handle unified_thread_system::register_gauge(const std::string& name, metric_labels labels) {
+    auto result = pimpl_->metrics().register_gauge(name, labels);
+    if (result.is_err()) {
+        throw std::invalid_argument(result.error().message);
+    }
+    return result.value();
+}
+
+histogram_handle unified_thread_system::register_histogram(const std::string& name, metric_labels labels,
+                                                           std::span<const double> bounds) {
+    auto result = pimpl_->metrics().register_histogram(name, labels, bounds);
+    if (result.is_err()) {
+        throw std::invalid_argument(result.error().message);
+    }
+    return result.value();
 }
 
 void unified_thread_system::reset_circuit_breaker() {
@@ -775,19 +1893,28 @@ bool unified_thread_system::is_circuit_open() const {
 //     // Would format fields into JSON or other structured format
 // }
 
-// Advanced monitoring features - not declared in header yet
-// void unified_thread_system::register_metric_collector(const std::string& name,
-//                                                      std::function<double()> collector) {
-//     pimpl_->register_metric_collector(name, std::move(collector));
-// }
-//
-// void unified_thread_system::add_health_check(const std::string& name,
-//                                             std::function<std::pair<bool, std::string>()> check) {
-//     pimpl_->add_health_check(name, std::move(check));
-// }
+void unified_thread_system::register_metric_collector(const std::string& name,
+                                                      std::function<double()> collector) {
+    auto result = pimpl_->metrics().register_gauge(name, {});
+    if (result.is_err()) {
+        throw std::invalid_argument(result.error().message);
+    }
+    pimpl_->register_metric_collector(name, std::move(collector), result.value());
+}
+
+void unified_thread_system::add_health_check(const std::string& name,
+                                             std::function<std::pair<bool, std::string>()> check,
+                                             std::chrono::milliseconds timeout) {
+    pimpl_->add_health_check(name, std::move(check), timeout);
+}
 
 size_t unified_thread_system::subscribe_to_events(const std::string& event_type, event_callback callback) {
-    return pimpl_->subscribe_to_events(event_type, std::move(callback));
+    return pimpl_->subscribe_to_events(event_type, std::move(callback), event_delivery::sync);
+}
+
+size_t unified_thread_system::subscribe_to_events(const std::string& event_type, event_callback callback,
+                                                  event_delivery delivery) {
+    return pimpl_->subscribe_to_events(event_type, std::move(callback), delivery);
 }
 
 void unified_thread_system::unsubscribe_from_events(size_t subscription_id) {
@@ -0,0 +1,230 @@
+/**
+ * @file test_alert_rule_engine.cpp
+ * @brief Unit tests for compiled alert rules and their state transitions
+ */
+
+#include <gtest/gtest.h>
+#include <kcenon/integrated/core/alert_rule_engine.h>
+#include <string>
+#include <vector>
+
+using namespace kcenon::integrated;
+using namespace std::chrono_literals;
+
+namespace {
+
+using time_point = alert_rule_engine::clock::time_point;
+
+alert_rule_engine make_engine() {
+    alert_rule_engine engine({"cpu_usage", "queue_utilization", "error_rate"});
+    engine.add_alias("cpu", 0);
+    return engine;
+}
+
+struct recorder {
+    std::vector<alert_transition> transitions;
+
+    alert_rule_engine::transition_handler handler() {
+        return [this](const alert_transition& transition) { transitions.push_back(transition); };
+    }
+};
+
+} // namespace
+
+TEST(AlertRuleEngineTest, FiresAfterDurationAndResolves) {
+    auto engine = make_engine();
+    ASSERT_TRUE(engine.add_rule({"saturation", "queue_utilization > 95", 60s, "warning"}).is_ok());
+
+    recorder events;
+    const time_point start{};
+    engine.evaluate(start, std::vector<double>{0, 99, 0}, events.handler());
+    ASSERT_EQ(events.transitions.size(), 1u);
+    EXPECT_EQ(events.transitions[0].to, alert_state::pending);
+    EXPECT_EQ(events.transitions[0].value, 99.0);
+    EXPECT_EQ(events.transitions[0].threshold, 95.0);
+
+    // Holding for less than the duration reports nothing new
+    engine.evaluate(start + 30s, std::vector<double>{0, 98, 0}, events.handler());
+    EXPECT_EQ(events.transitions.size(), 1u);
+
+    engine.evaluate(start + 60s, std::vector<double>{0, 97, 0}, events.handler());
+    ASSERT_EQ(events.transitions.size(), 2u);
+    EXPECT_EQ(events.transitions[1].from, alert_state::pending);
+    EXPECT_EQ(events.transitions[1].to, alert_state::firing);
+    EXPECT_EQ(events.transitions[1].since, start);
+
+    // Staying firing is reported once
+    engine.evaluate(start + 90s, std::vector<double>{0, 99, 0}, events.handler());
+    EXPECT_EQ(events.transitions.size(), 2u);
+
+    engine.evaluate(start + 120s, std::vector<double>{0, 10, 0}, events.handler());
+    ASSERT_EQ(events.transitions.size(), 3u);
+    EXPECT_EQ(events.transitions[2].to, alert_state::resolved);
+    EXPECT_EQ(engine.state(0), alert_state::resolved);
+}
+
+TEST(AlertRuleEngineTest, PendingResetsWhenConditionBreaks) {
+    auto engine = make_engine();
+    ASSERT_TRUE(engine.add_rule({"cpu", "cpu_usage > 85", 5min, "warning"}).is_ok());
+
+    recorder events;
+    const time_point start{};
+    engine.evaluate(start, std::vector<double>{90, 0, 0}, events.handler());
+    engine.evaluate(start + 4min, std::vector<double>{50, 0, 0}, events.handler());
+    engine.evaluate(start + 5min, std::vector<double>{90, 0, 0}, events.handler());
+    engine.evaluate(start + 9min, std::vector<double>{90, 0, 0}, events.handler());
+
+    // pending -> inactive -> pending again; the sustain window restarts
+    ASSERT_EQ(events.transitions.size(), 3u);
+    EXPECT_EQ(events.transitions[1].to, alert_state::inactive);
+    EXPECT_EQ(events.transitions[2].to, alert_state::pending);
+    EXPECT_EQ(engine.state(0), alert_state::pending);
+
+    engine.evaluate(start + 10min, std::vector<double>{90, 0, 0}, events.handler());
+    EXPECT_EQ(engine.state(0), alert_state::firing);
+}
+
+TEST(AlertRuleEngineTest, ZeroDurationFiresImmediately) {
+    auto engine = make_engine();
+    ASSERT_TRUE(engine.add_rule({"errors", "error_rate > 10", 0ms, "critical"}).is_ok());
+
+    recorder events;
+    engine.evaluate(time_point{}, std::vector<double>{0, 0, 11}, events.handler());
+    ASSERT_EQ(events.transitions.size(), 1u);
+    EXPECT_EQ(events.transitions[0].from, alert_state::inactive);
+    EXPECT_EQ(events.transitions[0].to, alert_state::firing);
+}
+
+TEST(AlertRuleEngineTest, EvaluatesCompoundConditions) {
+    auto engine = make_engine();
+    ASSERT_TRUE(engine.add_rule({"a", "cpu > 80 && (error_rate >= 1 || !(queue_utilization < 50))"}).is_ok());
+    ASSERT_TRUE(engine.add_rule({"b", "cpu_usage > 80 and not error_rate == 0"}).is_ok());
+    ASSERT_TRUE(engine.add_rule({"c", "90 <= cpu_usage or queue_utilization != queue_utilization"}).is_ok());
+
+    recorder events;
+    engine.evaluate(time_point{}, std::vector<double>{85, 60, 0}, events.handler());
+    EXPECT_EQ(engine.state(0), alert_state::firing);
+    EXPECT_EQ(engine.state(1), alert_state::inactive);
+    EXPECT_EQ(engine.state(2), alert_state::inactive);
+
+    engine.evaluate(time_point{} + 1s, std::vector<double>{95, 10, 2}, events.handler());
+    EXPECT_EQ(engine.state(0), alert_state::firing);
+    EXPECT_EQ(engine.state(1), alert_state::firing);
+    EXPECT_EQ(engine.state(2), alert_state::firing);
+}
+
+TEST(AlertRuleEngineTest, RejectsInvalidRules) {
+    auto engine = make_engine();
+    EXPECT_TRUE(engine.add_rule({"x", "unknown_metric > 1"}).is_err());
+    EXPECT_TRUE(engine.add_rule({"x", "cpu_usage >"}).is_err());
+    EXPECT_TRUE(engine.add_rule({"x", "cpu_usage 5"}).is_err());
+    EXPECT_TRUE(engine.add_rule({"x", "(cpu_usage > 5"}).is_err());
+    EXPECT_TRUE(engine.add_rule({"x", "1 > 2"}).is_err());
+    EXPECT_TRUE(engine.add_rule({"x", "cpu_usage > 5 extra"}).is_err());
+    EXPECT_TRUE(engine.add_rule({"", "cpu_usage > 5"}).is_err());
+    EXPECT_EQ(engine.rule_count(), 0u);
+
+    ASSERT_TRUE(engine.add_rule({"x", "cpu_usage > -5.5"}).is_ok());
+    EXPECT_TRUE(engine.add_rule({"x", "cpu_usage > 5"}).is_err());
+    EXPECT_EQ(engine.find_rule("x").value(), 0u);
+    EXPECT_TRUE(engine.find_rule("y").is_err());
+}
+
+TEST(AlertRuleEngineTest, ParsesDurations) {
+    EXPECT_EQ(alert_rule_engine::parse_duration("30s").value(), 30s);
+    EXPECT_EQ(alert_rule_engine::parse_duration("1m").value(), 1min);
+    EXPECT_EQ(alert_rule_engine::parse_duration("250ms").value(), 250ms);
+    EXPECT_EQ(alert_rule_engine::parse_duration("1h30m").value(), 90min);
+    EXPECT_EQ(alert_rule_engine::parse_duration("2d").value(), 48h);
+    EXPECT_EQ(alert_rule_engine::parse_duration(" 5 ").value(), 5s);
+    EXPECT_EQ(alert_rule_engine::parse_duration("1.5s").value(), 1500ms);
+    EXPECT_TRUE(alert_rule_engine::parse_duration("").is_err());
+    EXPECT_TRUE(alert_rule_engine::parse_duration("5 minutes").is_err());
+    EXPECT_TRUE(alert_rule_engine::parse_duration("-1s").is_err());
+}
+
+TEST(AlertRuleEngineTest, ParsesAlertingSections) {
+    auto parsed = alert_rule_engine::parse_alerting_section(R"({
+        "monitoring": {"alerting": {"enabled": true, "rules": {
+            "errors": {"condition": "error_rate > 10", "duration": "90s", "severity": "critical"},
+            "cpu": {"condition": "cpu_usage > 85"}
+        }}}
+    })");
+    ASSERT_TRUE(parsed.is_ok());
+    const auto& rules = parsed.value();
+    ASSERT_EQ(rules.size(), 2u);
+    EXPECT_EQ(rules[0].name, "errors");
+    EXPECT_EQ(rules[0].condition, "error_rate > 10");
+    EXPECT_EQ(rules[0].duration, 90s);
+    EXPECT_EQ(rules[0].severity, "critical");
+    EXPECT_EQ(rules[1].name, "cpu");
+    EXPECT_EQ(rules[1].duration, 0ms);
+
+    auto disabled = alert_rule_engine::parse_alerting_section(
+        R"({"alerting": {"enabled": false, "rules": {"cpu": {"condition": "cpu_usage > 85"}}}})");
+    ASSERT_TRUE(disabled.is_ok());
+    EXPECT_TRUE(disabled.value().empty());
+
+    EXPECT_TRUE(alert_rule_engine::parse_alerting_section("{").is_err());
+    EXPECT_TRUE(alert_rule_engine::parse_alerting_section(R"({"logging": {}})").is_err());
+    EXPECT_TRUE(alert_rule_engine::parse_alerting_section(
+        R"({"alerting": {"rules": {"cpu": {"duration": "1m"}}}})").is_err());
+    EXPECT_TRUE(alert_rule_engine::parse_alerting_section(
+        R"({"alerting": {"rules": {"cpu": {"condition": "cpu_usage > 85", "duration": "soon"}}}})").is_err());
+    EXPECT_TRUE(alert_rule_engine::load_alerting_section("no_such_config.json").is_err());
+}
+
+TEST(AlertRuleEngineTest, ProductionRulesFireOnMatchingData) {
+    auto loaded = alert_rule_engine::load_alerting_section(INTEGRATED_CONFIG_DIR "/production.json");
+    ASSERT_TRUE(loaded.is_ok()) << loaded.error().message;
+    const auto& rules = loaded.value();
+    ASSERT_EQ(rules.size(), 4u);
+
+    // The metric names production.json uses, all percentages
+    alert_rule_engine engine({"cpu_usage", "memory_usage", "queue_utilization", "error_rate"});
+    for (const auto& rule : rules) {
+        ASSERT_TRUE(engine.add_rule(rule).is_ok()) << rule.name;
+    }
+
+    struct expectation {
+        const char* name;
+        std::chrono::milliseconds duration;
+        const char* severity;
+        std::vector<double> matching;
+    };
+    const std::vector<expectation> expected{
+        {"high_cpu_usage", 5min, "warning", {90, 0, 0, 0}},
+        {"memory_exhaustion", 2min, "critical", {0, 95, 0, 0}},
+        {"thread_pool_saturation", 1min, "warning", {0, 0, 99, 0}},
+        {"error_rate_spike", 1min, "critical", {0, 0, 0, 15}},
+    };
+
+    recorder events;
+    time_point now{};
+    const std::vector<double> healthy{50, 50, 50, 1};
+    for (const auto& rule : expected) {
+        SCOPED_TRACE(rule.name);
+        auto index = engine.find_rule(rule.name);
+        ASSERT_TRUE(index.is_ok());
+        EXPECT_EQ(engine.rule(index.value()).duration, rule.duration);
+        EXPECT_EQ(engine.rule(index.value()).severity, rule.severity);
+
+        engine.evaluate(now, healthy, events.handler());
+        now += 1s;
+        engine.evaluate(now, rule.matching, events.handler());
+        EXPECT_EQ(engine.state(index.value()), alert_state::pending);
+        now += rule.duration;
+        engine.evaluate(now, rule.matching, events.handler());
+        EXPECT_EQ(engine.state(index.value()), alert_state::firing);
+
+        // Only the rule whose metric matched
+        for (std::size_t other = 0; other < engine.rule_count(); ++other) {
+            if (other != index.value()) {
+                EXPECT_NE(engine.state(other), alert_state::firing) << engine.rule(other).name;
+            }
+        }
+        now += 1s;
+        engine.evaluate(now, healthy, events.handler());
+        EXPECT_EQ(engine.state(index.value()), alert_state::resolved);
+    }
+}
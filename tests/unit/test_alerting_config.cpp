@@ -0,0 +1,75 @@
+/**
+ * @file test_alerting_config.cpp
+ * @brief Unit tests for the production.json alerting rules in metrics_aggregator
+ *
+ * Needs the external systems, which metrics_aggregator.h includes.
+ */
+
+#include <gtest/gtest.h>
+#include <kcenon/integrated/metrics_aggregator.h>
+#include <chrono>
+#include <functional>
+#include <vector>
+
+using namespace kcenon::integrated;
+using namespace std::chrono_literals;
+
+namespace {
+
+struct expectation {
+    const char* rule;
+    std::chrono::milliseconds duration;
+    std::function<void(aggregated_metrics&)> match;
+};
+
+} // namespace
+
+TEST(AlertingConfigTest, ProductionRulesFireOnMatchingSamples) {
+    const std::vector<expectation> expected{
+        {"high_cpu_usage", 5min, [](aggregated_metrics& m) { m.system_metrics.cpu_usage_percent = 90; }},
+        {"memory_exhaustion", 2min, [](aggregated_metrics& m) { m.system_metrics.memory_usage_percent = 95; }},
+        {"thread_pool_saturation", 1min, [](aggregated_metrics& m) { m.thread_metrics.queue_utilization = 99; }},
+        {"error_rate_spike", 1min, [](aggregated_metrics& m) { m.performance_metrics.error_rate = 15; }},
+    };
+
+    for (const auto& rule : expected) {
+        SCOPED_TRACE(rule.rule);
+        metrics_aggregator aggregator;
+        auto loaded = aggregator.load_alert_rules(INTEGRATED_CONFIG_DIR "/production.json");
+        ASSERT_TRUE(loaded.is_ok()) << loaded.error().message;
+
+        aggregated_metrics sample;
+        sample.timestamp = std::chrono::system_clock::now();
+        aggregator.add_sample(sample);
+        EXPECT_EQ(aggregator.get_alert_state(rule.rule), alert_state::inactive);
+
+        rule.match(sample);
+        sample.timestamp += 1s;
+        aggregator.add_sample(sample);
+        EXPECT_EQ(aggregator.get_alert_state(rule.rule), alert_state::pending);
+
+        sample.timestamp += rule.duration;
+        aggregator.add_sample(sample);
+        EXPECT_EQ(aggregator.get_alert_state(rule.rule), alert_state::firing);
+
+        for (const auto& other : expected) {
+            if (&other != &rule) {
+                EXPECT_EQ(aggregator.get_alert_state(other.rule), alert_state::inactive) << other.rule;
+            }
+        }
+    }
+}
+
+TEST(AlertingConfigTest, MemoryRuleReadsThePercentageNotMegabytes) {
+    metrics_aggregator aggregator;
+    ASSERT_TRUE(aggregator.load_alert_rules(INTEGRATED_CONFIG_DIR "/production.json").is_ok());
+
+    aggregated_metrics sample;
+    sample.timestamp = std::chrono::system_clock::now();
+    sample.system_metrics.memory_usage_mb = 4096.0;
+    sample.system_metrics.memory_usage_percent = 50.0;
+    aggregator.add_sample(sample);
+    sample.timestamp += 5min;
+    aggregator.add_sample(sample);
+    EXPECT_EQ(aggregator.get_alert_state("memory_exhaustion"), alert_state::inactive);
+}
@@ -0,0 +1,168 @@
+/**
+ * @file test_async_io.cpp
+ * @brief Unit tests for asynchronous file I/O
+ */
+
+#include <gtest/gtest.h>
+#include <kcenon/integrated/unified_thread_system.h>
+#include <kcenon/integrated/adapters/io_adapter.h>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#if defined(_WIN32)
+#include <io.h>
+#define fileno _fileno
+#endif
+
+using namespace kcenon::integrated;
+
+namespace {
+
+class temp_file {
+public:
+    temp_file() : file_(std::tmpfile()) {}
+    ~temp_file() {
+        if (file_) {
+            std::fclose(file_);
+        }
+    }
+
+    bool valid() const { return file_ != nullptr; }
+    int fd() const { return fileno(file_); }
+
+private:
+    std::FILE* file_;
+};
+
+std::vector<std::byte> to_bytes(const std::string& text) {
+    std::vector<std::byte> bytes(text.size());
+    std::memcpy(bytes.data(), text.data(), text.size());
+    return bytes;
+}
+
+std::string to_string(const std::vector<std::byte>& bytes, std::size_t size) {
+    return std::string(reinterpret_cast<const char*>(bytes.data()), size);
+}
+
+} // namespace
+
+class AsyncIoTest : public ::testing::TestWithParam<bool> {
+protected:
+    unified_thread_system::config make_config() const {
+        unified_thread_system::config cfg;
+        cfg.thread_count = 2;
+        cfg.enable_io_uring = GetParam();
+        return cfg;
+    }
+};
+
+TEST_P(AsyncIoTest, WriteThenReadBack) {
+    temp_file file;
+    ASSERT_TRUE(file.valid());
+
+    unified_thread_system system(make_config());
+
+    auto payload = to_bytes("integrated thread system");
+    EXPECT_EQ(system.async_write(file.fd(), payload, 0).get(), payload.size());
+    EXPECT_NO_THROW(system.async_fsync(file.fd()).get());
+
+    std::vector<std::byte> buffer(64);
+    auto read = system.async_read(file.fd(), std::span(buffer).first(6), 11).get();
+    EXPECT_EQ(read, 6u);
+    EXPECT_EQ(to_string(buffer, read), "thread");
+}
+
+TEST_P(AsyncIoTest, ReadPastEndReturnsZero) {
+    temp_file file;
+    ASSERT_TRUE(file.valid());
+
+    unified_thread_system system(make_config());
+
+    std::vector<std::byte> buffer(16);
+    EXPECT_EQ(system.async_read(file.fd(), buffer, 4096).get(), 0u);
+}
+
+TEST_P(AsyncIoTest, InvalidDescriptorFailsFuture) {
+    unified_thread_system system(make_config());
+
+    std::vector<std::byte> buffer(16);
+    auto future = system.async_read(-1, buffer, 0);
+    EXPECT_THROW(future.get(), std::system_error);
+}
+
+TEST_P(AsyncIoTest, ManyRequestsFromTasks) {
+    temp_file file;
+    ASSERT_TRUE(file.valid());
+
+    auto cfg = make_config();
+    cfg.io_queue_depth = 8;  // Forces submitters through backpressure
+    unified_thread_system system(cfg);
+
+    constexpr std::size_t blocks = 64;
+    constexpr std::size_t block_size = 128;
+
+    std::vector<std::future<size_t>> writes;
+    std::vector<std::vector<std::byte>> payloads;
+    payloads.reserve(blocks);
+    for (std::size_t i = 0; i < blocks; ++i) {
+        payloads.emplace_back(block_size, static_cast<std::byte>(i));
+    }
+    for (std::size_t i = 0; i < blocks; ++i) {
+        writes.push_back(system.async_write(file.fd(), payloads[i], i * block_size));
+    }
+    for (auto& write : writes) {
+        EXPECT_EQ(write.get(), block_size);
+    }
+
+    // Tasks wait on their reads through the pool instead of blocking a worker
+    std::vector<std::future<bool>> checks;
+    for (std::size_t i = 0; i < blocks; ++i) {
+        checks.push_back(system.submit([&system, &file, i] {
+            std::vector<std::byte> buffer(block_size);
+            auto read = system.wait(system.async_read(file.fd(), buffer, i * block_size));
+            if (read != block_size) {
+                return false;
+            }
+            for (auto b : buffer) {
+                if (b != static_cast<std::byte>(i)) {
+                    return false;
+                }
+            }
+            return true;
+        }));
+    }
+    for (auto& check : checks) {
+        EXPECT_TRUE(check.get());
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(Backends, AsyncIoTest, ::testing::Values(true, false),
+                         [](const ::testing::TestParamInfo<bool>& info) {
+                             return info.param ? "IoUring" : "Threads";
+                         });
+
+TEST(IoAdapterTest, ReportsBackend) {
+    io_config cfg;
+    cfg.enable_io_uring = false;
+    adapters::io_adapter adapter(cfg);
+
+    ASSERT_TRUE(adapter.initialize().is_ok());
+    EXPECT_TRUE(adapter.is_initialized());
+    EXPECT_EQ(adapter.backend(), adapters::io_backend::threads);
+    EXPECT_EQ(adapter.in_flight(), 0u);
+    EXPECT_TRUE(adapter.shutdown().is_ok());
+    EXPECT_FALSE(adapter.is_initialized());
+}
+
+TEST(IoAdapterTest, RequestsAfterShutdownAreCancelled) {
+    io_config cfg;
+    adapters::io_adapter adapter(cfg);
+    ASSERT_TRUE(adapter.initialize().is_ok());
+    ASSERT_TRUE(adapter.shutdown().is_ok());
+
+    auto future = adapter.fsync(0);
+    EXPECT_THROW(future.get(), std::system_error);
+}
@@ -10,6 +10,7 @@
 #include <atomic>
 #include <numeric>
 #include <thread>
+#include <stdexcept>
 
 using namespace kcenon::integrated;
 using namespace std::chrono_literals;
@@ -0,0 +1,377 @@
+/**
+ * @file test_circuit_breaker.cpp
+ * @brief Unit tests for the sliding-window circuit breaker
+ */
+
+#include <gtest/gtest.h>
+#include <kcenon/integrated/unified_thread_system.h>
+#include <kcenon/integrated/core/circuit_breaker.h>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace kcenon::integrated;
+using namespace std::chrono_literals;
+
+namespace {
+
+circuit_breaker_config make_config() {
+    circuit_breaker_config cfg;
+    cfg.enabled = true;
+    cfg.failure_threshold = 0;  // Rates only unless a test opts in
+    cfg.reset_timeout = 50ms;
+    cfg.window_seconds = 10;
+    cfg.minimum_calls = 10;
+    cfg.failure_rate_threshold = 0.5;
+    cfg.half_open_permits = 2;
+    return cfg;
+}
+
+// Outcome of a call admitted while the breaker was closed
+bool record_closed(circuit_breaker& breaker, bool success, std::chrono::nanoseconds duration = 1ms) {
+    return breaker.record(circuit_permit{}, success, duration);
+}
+
+void open_breaker(circuit_breaker& breaker) {
+    for (int i = 0; i < 10; ++i) {
+        record_closed(breaker, false);
+    }
+}
+
+} // namespace
+
+TEST(CircuitBreakerTest, StaysClosedBelowMinimumCalls) {
+    circuit_breaker breaker(make_config());
+
+    for (int i = 0; i < 9; ++i) {
+        EXPECT_FALSE(record_closed(breaker, false));
+    }
+    EXPECT_EQ(breaker.state(), circuit_state::closed);
+    EXPECT_TRUE(breaker.acquire().has_value());
+}
+
+TEST(CircuitBreakerTest, OpensOnFailureRate) {
+    circuit_breaker breaker(make_config());
+
+    for (int i = 0; i < 6; ++i) {
+        record_closed(breaker, true);
+    }
+    bool opened = false;
+    for (int i = 0; i < 6 && !opened; ++i) {
+        opened = record_closed(breaker, false);
+    }
+
+    EXPECT_TRUE(opened);
+    EXPECT_TRUE(breaker.is_open());
+    EXPECT_FALSE(breaker.acquire().has_value());
+
+    auto stats = breaker.window_stats();
+    EXPECT_GE(stats.calls, 10u);
+    EXPECT_GE(stats.failures * 2, stats.calls);
+}
+
+TEST(CircuitBreakerTest, OpensOnSlowCallRate) {
+    auto cfg = make_config();
+    cfg.slow_call_duration = 10ms;
+    cfg.slow_call_rate_threshold = 0.8;
+    circuit_breaker breaker(cfg);
+
+    for (int i = 0; i < 9; ++i) {
+        record_closed(breaker, true, 20ms);
+    }
+    EXPECT_FALSE(breaker.is_open());
+    EXPECT_TRUE(record_closed(breaker, true, 20ms));
+    EXPECT_EQ(breaker.window_stats().slow_calls, 10u);
+}
+
+TEST(CircuitBreakerTest, OpensOnConsecutiveFailures) {
+    auto cfg = make_config();
+    cfg.failure_threshold = 3;
+    cfg.minimum_calls = 1000;
+    circuit_breaker breaker(cfg);
+
+    record_closed(breaker, false);
+    record_closed(breaker, false);
+    record_closed(breaker, true);  // Resets the streak
+    record_closed(breaker, false);
+    record_closed(breaker, false);
+    EXPECT_FALSE(breaker.is_open());
+    EXPECT_TRUE(record_closed(breaker, false));
+}
+
+TEST(CircuitBreakerTest, HalfOpenProbesClose) {
+    circuit_breaker breaker(make_config());
+    open_breaker(breaker);
+    ASSERT_TRUE(breaker.is_open());
+
+    std::this_thread::sleep_for(60ms);
+
+    // Exactly half_open_permits probes are admitted
+    auto first = breaker.acquire();
+    ASSERT_TRUE(first.has_value());
+    EXPECT_TRUE(first->is_probe());
+    EXPECT_EQ(breaker.state(), circuit_state::half_open);
+    auto second = breaker.acquire();
+    ASSERT_TRUE(second.has_value());
+    EXPECT_FALSE(breaker.acquire().has_value());
+
+    breaker.record(*first, true, 1ms);
+    EXPECT_EQ(breaker.state(), circuit_state::half_open);
+    breaker.record(*second, true, 1ms);
+    EXPECT_EQ(breaker.state(), circuit_state::closed);
+    EXPECT_EQ(breaker.window_stats().calls, 0u);
+}
+
+TEST(CircuitBreakerTest, FailedProbeReopens) {
+    circuit_breaker breaker(make_config());
+    open_breaker(breaker);
+    std::this_thread::sleep_for(60ms);
+
+    auto probe = breaker.acquire();
+    ASSERT_TRUE(probe.has_value());
+    EXPECT_TRUE(breaker.record(*probe, false, 1ms));
+    EXPECT_TRUE(breaker.is_open());
+    EXPECT_FALSE(breaker.acquire().has_value());
+}
+
+TEST(CircuitBreakerTest, ReleasedProbePermitIsHandedOutAgain) {
+    circuit_breaker breaker(make_config());
+    open_breaker(breaker);
+    std::this_thread::sleep_for(60ms);
+
+    auto kept = breaker.acquire();
+    auto rejected = breaker.acquire();
+    ASSERT_TRUE(kept.has_value());
+    ASSERT_TRUE(rejected.has_value());
+    ASSERT_FALSE(breaker.acquire().has_value());
+
+    // Rejected further down the submit path; the round can still complete
+    breaker.release(*rejected);
+    auto retry = breaker.acquire();
+    ASSERT_TRUE(retry.has_value());
+    EXPECT_FALSE(breaker.acquire().has_value());
+
+    breaker.record(*kept, true, 1ms);
+    breaker.record(*retry, true, 1ms);
+    EXPECT_EQ(breaker.state(), circuit_state::closed);
+}
+
+TEST(CircuitBreakerTest, OnlyProbesDecideHalfOpen) {
+    circuit_breaker breaker(make_config());
+
+    // Admitted while closed, still running when the breaker opens
+    auto straggler = breaker.acquire();
+    ASSERT_TRUE(straggler.has_value());
+    EXPECT_FALSE(straggler->is_probe());
+    open_breaker(breaker);
+    std::this_thread::sleep_for(60ms);
+
+    auto probe = breaker.acquire();
+    ASSERT_TRUE(probe.has_value());
+    EXPECT_FALSE(breaker.record(*straggler, false, 1ms));
+    EXPECT_EQ(breaker.state(), circuit_state::half_open);
+    breaker.record(*straggler, true, 1ms);
+    breaker.record(*probe, true, 1ms);
+    EXPECT_EQ(breaker.state(), circuit_state::half_open);
+}
+
+TEST(CircuitBreakerTest, ProbesOfAnEarlierRoundAreIgnored) {
+    circuit_breaker breaker(make_config());
+    open_breaker(breaker);
+    std::this_thread::sleep_for(60ms);
+
+    auto stale = breaker.acquire();
+    auto failing = breaker.acquire();
+    ASSERT_TRUE(stale.has_value());
+    ASSERT_TRUE(failing.has_value());
+    EXPECT_TRUE(breaker.record(*failing, false, 1ms));
+    std::this_thread::sleep_for(60ms);
+
+    // Neither counts towards nor frees a permit of the next round
+    auto fresh = breaker.acquire();
+    ASSERT_TRUE(fresh.has_value());
+    breaker.release(*stale);
+    breaker.record(*stale, true, 1ms);
+    auto other = breaker.acquire();
+    ASSERT_TRUE(other.has_value());
+    EXPECT_FALSE(breaker.acquire().has_value());
+    breaker.record(*fresh, true, 1ms);
+    EXPECT_EQ(breaker.state(), circuit_state::half_open);
+    breaker.record(*other, true, 1ms);
+    EXPECT_EQ(breaker.state(), circuit_state::closed);
+}
+
+TEST(CircuitBreakerTest, ResetCloses) {
+    circuit_breaker breaker(make_config());
+    open_breaker(breaker);
+    ASSERT_TRUE(breaker.is_open());
+
+    breaker.reset();
+    EXPECT_EQ(breaker.state(), circuit_state::closed);
+    EXPECT_TRUE(breaker.acquire().has_value());
+}
+
+TEST(CircuitBreakerTest, ConcurrentRecordsAreCounted) {
+    auto cfg = make_config();
+    cfg.minimum_calls = 1'000'000;
+    circuit_breaker breaker(cfg);
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&breaker] {
+            for (int i = 0; i < 10000; ++i) {
+                breaker.acquire().has_value();
+                record_closed(breaker, i % 4 != 0, 1us);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    EXPECT_FALSE(breaker.is_open());
+    // Bucket rollover mid-run may drop a few counts
+    EXPECT_GT(breaker.window_stats().calls, 30000u);
+}
+
+TEST(CircuitBreakerTest, SystemRejectsSubmissionsWhileOpen) {
+    unified_thread_system::config cfg;
+    cfg.thread_count = 2;
+    cfg.enable_circuit_breaker = true;
+    cfg.circuit_breaker_failure_threshold = 3;
+    cfg.circuit_breaker_reset_timeout = 100ms;
+    unified_thread_system system(cfg);
+
+    for (int i = 0; i < 3; ++i) {
+        auto future = system.submit([]() -> int { throw std::runtime_error("failure"); });
+        EXPECT_THROW(future.get(), std::runtime_error);
+    }
+    system.wait_for_completion();
+
+    EXPECT_TRUE(system.is_circuit_open());
+    EXPECT_TRUE(system.get_health().circuit_breaker_open);
+    EXPECT_THROW(system.submit([] { return 1; }), std::runtime_error);
+
+    // Half-open after the timeout: a successful probe is admitted
+    std::this_thread::sleep_for(150ms);
+    EXPECT_EQ(system.submit([] { return 7; }).get(), 7);
+    EXPECT_FALSE(system.is_circuit_open());
+
+    system.reset_circuit_breaker();
+    EXPECT_EQ(system.submit([] { return 8; }).get(), 8);
+}
+
+TEST(CircuitBreakerTest, SystemReturnsPermitsOfRejectedProbes) {
+    unified_thread_system::config cfg;
+    cfg.thread_count = 1;
+    cfg.max_queue_size = 1;
+    cfg.enable_circuit_breaker = true;
+    cfg.circuit_breaker_failure_threshold = 1;
+    cfg.circuit_breaker_reset_timeout = 50ms;
+    cfg.circuit_breaker_half_open_permits = 2;
+    unified_thread_system system(cfg);
+
+    std::promise<void> fail_gate;
+    std::shared_future<void> fail_now = fail_gate.get_future().share();
+    std::promise<void> block_gate;
+    std::shared_future<void> unblocked = block_gate.get_future().share();
+    std::atomic<bool> failing_started{false};
+    std::atomic<bool> blocker_started{false};
+
+    // Opens the breaker, then leaves the only worker on a task admitted while closed
+    auto failing = system.submit([fail_now, &failing_started]() -> int {
+        failing_started = true;
+        fail_now.wait();
+        throw std::runtime_error("failure");
+    });
+    while (!failing_started) {
+        std::this_thread::sleep_for(1ms);
+    }
+    auto blocker = system.submit([unblocked, &blocker_started] {
+        blocker_started = true;
+        unblocked.wait();
+    });
+    fail_gate.set_value();
+    EXPECT_THROW(failing.get(), std::runtime_error);
+    while (!blocker_started) {
+        std::this_thread::sleep_for(1ms);
+    }
+    ASSERT_TRUE(system.is_circuit_open());
+
+    std::this_thread::sleep_for(80ms);
+
+    // First probe fills the queue; the next ones take the other permit and are
+    // rejected for the full queue, each time handing the permit back
+    auto probe = system.submit([] { return 1; });
+    for (int i = 0; i < 3; ++i) {
+        EXPECT_THROW(system.submit([] { return 2; }), std::runtime_error);
+    }
+
+    // The blocker finishes during half-open, but was no probe
+    block_gate.set_value();
+    blocker.get();
+    EXPECT_EQ(probe.get(), 1);
+    EXPECT_FALSE(system.is_circuit_open());
+
+    // The permit returned by the rejected probes completes the round
+    EXPECT_EQ(system.submit([] { return 3; }).get(), 3);
+    system.wait_for_completion();
+    EXPECT_EQ(system.submit([] { return 4; }).get(), 4);
+}
+
+TEST(CircuitBreakerTest, SystemCountsCancellableTasks) {
+    unified_thread_system::config cfg;
+    cfg.thread_count = 1;
+    cfg.enable_circuit_breaker = true;
+    cfg.circuit_breaker_failure_threshold = 1;
+    cfg.circuit_breaker_reset_timeout = 50ms;
+    cfg.circuit_breaker_half_open_permits = 1;
+    unified_thread_system system(cfg);
+    auto token = system.create_cancellation_token();
+
+    std::promise<void> fail_gate;
+    std::shared_future<void> fail_now = fail_gate.get_future().share();
+    std::promise<void> block_gate;
+    std::shared_future<void> unblocked = block_gate.get_future().share();
+    std::atomic<bool> failing_started{false};
+    std::atomic<bool> blocker_started{false};
+
+    // A failing cancellable task opens the breaker, then the only worker is
+    // left on a task admitted while closed
+    auto failing = system.submit_cancellable(token, [fail_now, &failing_started]() -> int {
+        failing_started = true;
+        fail_now.wait();
+        throw std::runtime_error("failure");
+    });
+    while (!failing_started) {
+        std::this_thread::sleep_for(1ms);
+    }
+    auto blocker = system.submit([unblocked, &blocker_started] {
+        blocker_started = true;
+        unblocked.wait();
+    });
+    fail_gate.set_value();
+    EXPECT_THROW(failing.get(), std::runtime_error);
+    while (!blocker_started) {
+        std::this_thread::sleep_for(1ms);
+    }
+    ASSERT_TRUE(system.is_circuit_open());
+    EXPECT_THROW(system.submit_cancellable(token, [] { return 1; }), std::runtime_error);
+
+    // The only probe permit goes to a task cancelled before it starts
+    std::this_thread::sleep_for(80ms);
+    auto cancelled = system.create_cancellation_token();
+    auto probe = system.submit_cancellable(cancelled, [] { return 2; });
+    EXPECT_THROW(system.submit([] { return 3; }), std::runtime_error);
+    system.cancel_token(cancelled);
+    block_gate.set_value();
+    blocker.get();
+    system.wait_for_completion();
+
+    // Which hands it back, so the next probe can close the breaker
+    EXPECT_EQ(system.submit([] { return 4; }).get(), 4);
+    EXPECT_FALSE(system.is_circuit_open());
+}
@@ -0,0 +1,179 @@
+/**
+ * @file test_event_bus.cpp
+ * @brief Unit tests for the event bus
+ */
+
+#include <gtest/gtest.h>
+#include <kcenon/integrated/core/event_bus.h>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace kcenon::integrated;
+using namespace std::chrono_literals;
+
+TEST(EventBusTest, InternReturnsStableIds) {
+    event_bus bus;
+
+    auto log = bus.intern("log");
+    auto metric = bus.intern("metric");
+    EXPECT_NE(log, metric);
+    EXPECT_EQ(bus.intern("log"), log);
+    EXPECT_EQ(bus.name(metric), "metric");
+    EXPECT_THROW(bus.name(99), std::out_of_range);
+}
+
+TEST(EventBusTest, SyncSubscribersRunOnEmitter) {
+    event_bus bus;
+    auto type = bus.intern("log");
+
+    std::thread::id caller;
+    std::string received;
+    bus.subscribe(type, [&](const std::string& name, const std::any& payload) {
+        caller = std::this_thread::get_id();
+        received = name + ":" + std::any_cast<std::string>(payload);
+    });
+
+    EXPECT_TRUE(bus.has_subscribers(type));
+    bus.emit(type, std::string("hello"));
+    EXPECT_EQ(caller, std::this_thread::get_id());
+    EXPECT_EQ(received, "log:hello");
+}
+
+TEST(EventBusTest, OnlyMatchingTypeIsDelivered) {
+    event_bus bus;
+    auto a = bus.intern("a");
+    auto b = bus.intern("b");
+
+    int count = 0;
+    bus.subscribe(a, [&](const std::string&, const std::any&) { ++count; });
+
+    bus.emit(b, 1);
+    EXPECT_FALSE(bus.has_subscribers(b));
+    EXPECT_EQ(count, 0);
+    bus.emit(a, 1);
+    EXPECT_EQ(count, 1);
+}
+
+TEST(EventBusTest, UnsubscribeStopsDelivery) {
+    event_bus bus;
+    auto type = bus.intern("log");
+
+    int count = 0;
+    auto id = bus.subscribe(type, [&](const std::string&, const std::any&) { ++count; });
+    bus.emit(type, 1);
+
+    EXPECT_TRUE(bus.unsubscribe(id));
+    EXPECT_FALSE(bus.unsubscribe(id));
+    EXPECT_FALSE(bus.has_subscribers(type));
+    bus.emit(type, 1);
+    EXPECT_EQ(count, 1);
+}
+
+TEST(EventBusTest, CallbackErrorsAreContained) {
+    event_bus bus;
+    auto type = bus.intern("log");
+
+    int count = 0;
+    bus.subscribe(type, [](const std::string&, const std::any&) { throw std::runtime_error("bad"); });
+    bus.subscribe(type, [&](const std::string&, const std::any&) { ++count; });
+
+    EXPECT_NO_THROW(bus.emit(type, 1));
+    EXPECT_EQ(count, 1);
+    EXPECT_EQ(bus.stats().callback_errors, 1u);
+}
+
+TEST(EventBusTest, AsyncSubscribersRunOffEmitter) {
+    event_bus bus;
+    auto type = bus.intern("log");
+
+    std::promise<std::thread::id> caller;
+    bus.subscribe(type, [&](const std::string&, const std::any&) {
+        caller.set_value(std::this_thread::get_id());
+    }, event_delivery::async);
+
+    bus.emit(type, 1);
+    auto future = caller.get_future();
+    ASSERT_EQ(future.wait_for(5s), std::future_status::ready);
+    EXPECT_NE(future.get(), std::this_thread::get_id());
+}
+
+TEST(EventBusTest, SlowAsyncSubscriberDoesNotStallEmitter) {
+    event_bus bus;
+    auto type = bus.intern("log");
+
+    std::promise<void> release;
+    auto released = release.get_future().share();
+    std::atomic<int> delivered{0};
+    bus.subscribe(type, [&, released](const std::string&, const std::any&) {
+        released.wait();
+        ++delivered;
+    }, event_delivery::async, 8);
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < 100; ++i) {
+        bus.emit(type, i);
+    }
+    EXPECT_LT(std::chrono::steady_clock::now() - start, 1s);
+
+    // One event is blocked in the callback; the ring holds 8 more
+    EXPECT_GE(bus.stats().dropped, 100u - 9u);
+
+    release.set_value();
+    bus.shutdown();
+    EXPECT_LE(delivered.load(), 9);
+    EXPECT_GE(delivered.load(), 1);
+}
+
+TEST(EventBusTest, UnsubscribeFromOwnAsyncCallback) {
+    event_bus bus;
+    auto type = bus.intern("log");
+
+    std::promise<void> done;
+    std::size_t id = 0;
+    id = bus.subscribe(type, [&](const std::string&, const std::any&) {
+        bus.unsubscribe(id);
+        done.set_value();
+    }, event_delivery::async);
+
+    bus.emit(type, 1);
+    EXPECT_EQ(done.get_future().wait_for(5s), std::future_status::ready);
+    EXPECT_FALSE(bus.has_subscribers(type));
+}
+
+TEST(EventBusTest, ConcurrentEmitAndSubscribe) {
+    event_bus bus;
+    auto type = bus.intern("log");
+
+    std::atomic<int> delivered{0};
+    std::atomic<bool> stop{false};
+
+    std::vector<std::thread> emitters;
+    for (int t = 0; t < 4; ++t) {
+        emitters.emplace_back([&] {
+            while (!stop) {
+                bus.emit(type, 1);
+                std::this_thread::yield();
+            }
+        });
+    }
+
+    for (int i = 0; i < 20; ++i) {
+        auto id = bus.subscribe(type, [&](const std::string&, const std::any&) { ++delivered; },
+                                i % 2 == 0 ? event_delivery::sync : event_delivery::async);
+        std::this_thread::sleep_for(100us);
+        bus.unsubscribe(id);
+    }
+
+    stop = true;
+    for (auto& emitter : emitters) {
+        emitter.join();
+    }
+
+    EXPECT_GT(delivered.load(), 0);
+    EXPECT_EQ(bus.stats().subscribers, 0u);
+}
@@ -0,0 +1,277 @@
+/**
+ * @file test_flight_recorder.cpp
+ * @brief Unit tests for the always-on scheduler event rings and their dumps
+ */
+
+#include <gtest/gtest.h>
+#include <kcenon/integrated/unified_thread_system.h>
+#include <kcenon/integrated/core/flight_recorder.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace kcenon::integrated;
+using namespace std::chrono_literals;
+
+namespace {
+
+size_t count_kind(const std::vector<flight_event>& events, flight_event_kind kind) {
+    return static_cast<size_t>(std::count_if(events.begin(), events.end(),
+                                             [kind](const flight_event& e) { return e.kind == kind; }));
+}
+
+// Automatic dumps are written by a background thread; waits until there
+// are some and all of them are complete
+std::vector<std::filesystem::path> wait_for_dumps(const std::filesystem::path& directory) {
+    const auto until = std::chrono::steady_clock::now() + 5s;
+    while (true) {
+        std::vector<std::filesystem::path> dumps;
+        bool complete = true;
+        std::error_code ec;
+        for (const auto& entry : std::filesystem::directory_iterator(directory, ec)) {
+            dumps.push_back(entry.path());
+            complete = complete && flight_recorder::load(entry.path().string()).is_ok();
+        }
+        if ((!dumps.empty() && complete) || std::chrono::steady_clock::now() >= until) {
+            return dumps;
+        }
+        std::this_thread::sleep_for(10ms);
+    }
+}
+
+} // namespace
+
+TEST(FlightRecorderTest, EventsAreSixteenBytes) {
+    EXPECT_EQ(sizeof(flight_event), 16u);
+    EXPECT_STREQ(flight_event_name(flight_event_kind::steal), "steal");
+}
+
+TEST(FlightRecorderTest, CapacityIsRoundedUpToAPowerOfTwo) {
+    flight_recorder recorder(2, 100);
+    EXPECT_EQ(recorder.capacity(), 128u);
+    EXPECT_EQ(recorder.workers(), 2u);
+    EXPECT_TRUE(recorder.events(0).empty());
+    EXPECT_TRUE(recorder.events(2).empty());
+}
+
+TEST(FlightRecorderTest, FullRingKeepsNewestEvents) {
+    flight_recorder recorder(1, 16);
+    const auto base = flight_recorder::clock::now();
+    for (std::uint32_t i = 0; i < 40; ++i) {
+        recorder.record(0, flight_event_kind::start, base + std::chrono::microseconds(i), i);
+    }
+
+    const auto events = recorder.events(0);
+    ASSERT_EQ(events.size(), 16u);
+    for (size_t i = 0; i < events.size(); ++i) {
+        EXPECT_EQ(events[i].arg, 24u + i);
+        EXPECT_EQ(events[i].kind, flight_event_kind::start);
+    }
+    EXPECT_LT(events.front().timestamp_ns, events.back().timestamp_ns);
+    EXPECT_EQ(events.back().timestamp_ns - events.front().timestamp_ns, 15000u);
+}
+
+TEST(FlightRecorderTest, SharedRingTakesEventsFromManyThreads) {
+    flight_recorder recorder(0, 4096);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&recorder] {
+            for (int i = 0; i < 500; ++i) {
+                recorder.record_shared(flight_event_kind::enqueue, flight_recorder::clock::now(), 7);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    const auto events = recorder.events(0);
+    EXPECT_EQ(events.size(), 2000u);
+    EXPECT_EQ(count_kind(events, flight_event_kind::enqueue), 2000u);
+}
+
+TEST(FlightRecorderTest, ReadingWhileRecordingSkipsTornEvents) {
+    flight_recorder recorder(1, 64);
+    std::atomic<bool> stop{false};
+    std::thread writer([&] {
+        std::uint32_t i = 0;
+        while (!stop.load(std::memory_order_relaxed)) {
+            // The arg encodes the kind, so a torn event would show up as a mismatch
+            const auto kind = static_cast<flight_event_kind>(i % 8);
+            recorder.record(0, kind, flight_recorder::clock::now(), (i % 8) * 1000 + 1);
+            ++i;
+        }
+    });
+
+    const auto deadline = std::chrono::steady_clock::now() + 200ms;
+    while (std::chrono::steady_clock::now() < deadline) {
+        for (const auto& event : recorder.events(0)) {
+            ASSERT_EQ(event.arg, static_cast<std::uint32_t>(event.kind) * 1000 + 1);
+        }
+    }
+    stop = true;
+    writer.join();
+}
+
+TEST(FlightRecorderTest, DumpRoundTrips) {
+    flight_recorder recorder(2, 16);
+    const auto base = flight_recorder::clock::now();
+    recorder.record(0, flight_event_kind::start, base, 2);
+    recorder.record(0, flight_event_kind::finish, base + 5us, 1);
+    recorder.record(1, flight_event_kind::steal, base + 7us, 0);
+    recorder.record_shared(flight_event_kind::reject, base + 9us,
+                           static_cast<std::uint32_t>(flight_reject_reason::queue_full));
+
+    const std::string path = ::testing::TempDir() + "flight_recorder_test.bin";
+    ASSERT_TRUE(recorder.dump(path).is_ok());
+
+    auto loaded = flight_recorder::load(path);
+    ASSERT_TRUE(loaded.is_ok());
+    const auto& dump = loaded.value();
+    ASSERT_EQ(dump.rings.size(), 3u);
+    EXPECT_EQ(dump.rings[0].id, 0u);
+    EXPECT_EQ(dump.rings[1].id, 1u);
+    EXPECT_EQ(dump.rings[2].id, flight_recorder::shared_ring_id);
+
+    ASSERT_EQ(dump.rings[0].events.size(), 2u);
+    EXPECT_EQ(dump.rings[0].events[1].kind, flight_event_kind::finish);
+    EXPECT_EQ(dump.rings[0].events[1].arg, 1u);
+    EXPECT_EQ(dump.rings[0].events[1].timestamp_ns - dump.rings[0].events[0].timestamp_ns, 5000u);
+    ASSERT_EQ(dump.rings[2].events.size(), 1u);
+    EXPECT_EQ(dump.rings[2].events[0].arg, static_cast<std::uint32_t>(flight_reject_reason::queue_full));
+
+    const auto age = std::chrono::system_clock::now() - dump.epoch;
+    EXPECT_GE(age, 0s);
+    EXPECT_LT(age, 60s);
+    std::remove(path.c_str());
+}
+
+TEST(FlightRecorderTest, DumpAsOfHeadsLeavesOutLaterEvents) {
+    flight_recorder recorder(1, 16);
+    const auto base = flight_recorder::clock::now();
+    recorder.record(0, flight_event_kind::start, base);
+    recorder.record_shared(flight_event_kind::enqueue, base);
+    const auto heads = recorder.heads();
+    ASSERT_EQ(heads.size(), 2u);
+
+    recorder.record(0, flight_event_kind::finish, base + 1us);
+    recorder.record_shared(flight_event_kind::reject, base + 1us);
+    // Overwrites the worker ring's first event, which is then lost
+    for (int i = 0; i < 16; ++i) {
+        recorder.record(0, flight_event_kind::park, base + 2us);
+    }
+
+    const std::string path = ::testing::TempDir() + "flight_recorder_heads.bin";
+    ASSERT_TRUE(recorder.dump(path, heads).is_ok());
+    auto loaded = flight_recorder::load(path);
+    ASSERT_TRUE(loaded.is_ok());
+    EXPECT_TRUE(loaded.value().rings[0].events.empty());
+    ASSERT_EQ(loaded.value().rings[1].events.size(), 1u);
+    EXPECT_EQ(loaded.value().rings[1].events[0].kind, flight_event_kind::enqueue);
+
+    EXPECT_TRUE(recorder.dump(path, {}).is_err());
+    std::remove(path.c_str());
+}
+
+TEST(FlightRecorderTest, LoadRejectsOtherFiles) {
+    const std::string path = ::testing::TempDir() + "flight_recorder_garbage.bin";
+    {
+        std::ofstream file(path, std::ios::binary);
+        file << "not a flight recorder dump";
+    }
+    EXPECT_TRUE(flight_recorder::load(path).is_err());
+    std::remove(path.c_str());
+
+    EXPECT_TRUE(flight_recorder::load(path).is_err());
+}
+
+TEST(FlightRecorderTest, SystemRecordsSchedulerEvents) {
+    unified_thread_system::config cfg;
+    cfg.name = "recorded";
+    cfg.thread_count = 2;
+    cfg.enable_console_logging = false;
+    unified_thread_system system(cfg);
+
+    std::vector<std::future<int>> futures;
+    for (int i = 0; i < 50; ++i) {
+        futures.push_back(system.submit([i] { return i; }));
+    }
+    for (auto& future : futures) {
+        future.get();
+    }
+    system.wait_for_completion();
+
+    const std::string path = ::testing::TempDir() + "flight_recorder_system.bin";
+    system.dump_flight_recorder(path);
+    auto loaded = flight_recorder::load(path);
+    ASSERT_TRUE(loaded.is_ok());
+
+    std::vector<flight_event> all;
+    for (const auto& ring : loaded.value().rings) {
+        all.insert(all.end(), ring.events.begin(), ring.events.end());
+    }
+    EXPECT_EQ(count_kind(all, flight_event_kind::enqueue), 50u);
+    EXPECT_EQ(count_kind(all, flight_event_kind::start), 50u);
+    EXPECT_EQ(count_kind(all, flight_event_kind::finish), 50u);
+    std::remove(path.c_str());
+}
+
+TEST(FlightRecorderTest, SystemWithoutRecorderThrows) {
+    unified_thread_system::config cfg;
+    cfg.thread_count = 1;
+    cfg.enable_console_logging = false;
+    cfg.enable_flight_recorder = false;
+    unified_thread_system system(cfg);
+
+    EXPECT_THROW(system.dump_flight_recorder("unused.bin"), std::runtime_error);
+}
+
+TEST(FlightRecorderTest, DumpsAutomaticallyWhenHealthTurnsCritical) {
+    namespace fs = std::filesystem;
+    const fs::path directory = fs::path(::testing::TempDir()) / "flight_recorder_auto";
+    fs::remove_all(directory);
+
+    unified_thread_system::config cfg;
+    cfg.name = "breaker";
+    cfg.thread_count = 1;
+    cfg.enable_console_logging = false;
+    cfg.enable_circuit_breaker = true;
+    cfg.circuit_breaker_failure_threshold = 1;
+    cfg.circuit_breaker_reset_timeout = 60s;
+    cfg.flight_recorder_dump_directory = directory.string();
+    unified_thread_system system(cfg);
+
+    EXPECT_NE(system.get_health().overall_health, health_level::critical);
+    EXPECT_FALSE(fs::exists(directory));
+
+    auto failing = system.submit([]() -> int { throw std::runtime_error("boom"); });
+    EXPECT_THROW(failing.get(), std::runtime_error);
+    system.wait_for_completion();
+    ASSERT_TRUE(system.is_circuit_open());
+    EXPECT_THROW(system.submit([] { return 0; }), std::runtime_error);
+
+    EXPECT_EQ(system.get_health().overall_health, health_level::critical);
+    EXPECT_EQ(system.get_health().overall_health, health_level::critical);
+
+    const auto dumps = wait_for_dumps(directory);
+    ASSERT_EQ(dumps.size(), 1u);  // One dump per transition, not per call
+    EXPECT_EQ(dumps[0].filename().string().rfind("breaker-flight-", 0), 0u);
+
+    auto loaded = flight_recorder::load(dumps[0].string());
+    ASSERT_TRUE(loaded.is_ok());
+    std::vector<flight_event> all;
+    for (const auto& ring : loaded.value().rings) {
+        all.insert(all.end(), ring.events.begin(), ring.events.end());
+    }
+    // Cut as the breaker opened, so it ends with the failing task
+    EXPECT_EQ(count_kind(all, flight_event_kind::finish), 1u);
+    EXPECT_EQ(count_kind(all, flight_event_kind::reject), 0u);
+    fs::remove_all(directory);
+}
@@ -0,0 +1,212 @@
+/**
+ * @file test_health_probes.cpp
+ * @brief Unit tests for parallel, timeout-bounded health checks and collectors
+ */
+
+#include <gtest/gtest.h>
+#include <kcenon/integrated/unified_thread_system.h>
+#include <kcenon/integrated/core/health_probes.h>
+#include "../utils/test_wait_helper.h"
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <future>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+using namespace kcenon::integrated;
+using namespace kcenon::testing;
+using namespace std::chrono_literals;
+
+namespace {
+
+using clock_type = health_probes::clock;
+
+// Runs every probe on the calling thread
+bool run_inline(std::function<void()> probe) {
+    probe();
+    return true;
+}
+
+health_probes::check_fn passing() {
+    return [] { return std::make_pair(true, std::string()); };
+}
+
+} // namespace
+
+TEST(HealthProbesTest, FailingAndThrowingChecksAreIssues) {
+    int changes = 0;
+    health_probes probes(1s, 1s, [&changes] { ++changes; });
+    probes.add_check("cache", passing());
+    probes.add_check("database", [] { return std::make_pair(false, std::string("unreachable")); });
+    probes.add_check("queue", []() -> std::pair<bool, std::string> { throw std::runtime_error("boom"); });
+
+    EXPECT_FALSE(probes.poll(clock_type::now(), run_inline));
+
+    const auto issues = probes.issues();
+    ASSERT_EQ(issues.size(), 2u);
+    EXPECT_EQ(issues[0], "database: unreachable");
+    EXPECT_EQ(issues[1], "queue check failed: boom");
+    EXPECT_EQ(changes, 2);  // Passing on the first run is no change
+}
+
+TEST(HealthProbesTest, ResultsAreCachedForTheTtl) {
+    health_probes probes(100ms, 1s);
+    int runs = 0;
+    probes.add_check("counted", [&runs] {
+        ++runs;
+        return std::make_pair(true, std::string());
+    });
+
+    const auto start = clock_type::now();
+    probes.poll(start, run_inline);
+    probes.poll(start + 50ms, run_inline);
+    EXPECT_EQ(runs, 1);
+    probes.poll(start + 100ms, run_inline);
+    EXPECT_EQ(runs, 2);
+}
+
+TEST(HealthProbesTest, ChecksRunInParallel) {
+    health_probes probes(1s, 1s);
+    std::atomic<int> arrived{0};
+    // Each check passes only if the other is running at the same time
+    auto rendezvous = [&arrived] {
+        arrived.fetch_add(1);
+        const auto until = std::chrono::steady_clock::now() + 2s;
+        while (arrived.load() < 2 && std::chrono::steady_clock::now() < until) {
+            std::this_thread::sleep_for(1ms);
+        }
+        return std::make_pair(arrived.load() >= 2, std::string("ran alone"));
+    };
+    probes.add_check("first", rendezvous);
+    probes.add_check("second", rendezvous);
+
+    std::vector<std::thread> pool;
+    probes.poll(clock_type::now(), [&pool](std::function<void()> probe) {
+        pool.emplace_back(std::move(probe));
+        return true;
+    });
+    for (auto& thread : pool) {
+        thread.join();
+    }
+    EXPECT_TRUE(probes.issues().empty());
+}
+
+TEST(HealthProbesTest, OverdueCheckIsReportedAndNotRestarted) {
+    int changes = 0;
+    health_probes probes(10ms, 1s, [&changes] { ++changes; });
+    probes.add_check("slow", passing(), 50ms);
+
+    std::vector<std::function<void()>> queued;
+    auto hold = [&queued](std::function<void()> probe) {
+        queued.push_back(std::move(probe));
+        return true;
+    };
+
+    const auto start = clock_type::now();
+    EXPECT_FALSE(probes.poll(start, hold));
+    ASSERT_EQ(queued.size(), 1u);
+    EXPECT_TRUE(probes.issues().empty());
+
+    EXPECT_TRUE(probes.poll(start + 50ms, hold));
+    EXPECT_FALSE(probes.poll(start + 500ms, hold));  // Reported once, and still running
+    EXPECT_EQ(queued.size(), 1u);
+    ASSERT_EQ(probes.issues().size(), 1u);
+    EXPECT_EQ(probes.issues()[0], "slow: timed out after 50 ms");
+
+    queued[0]();
+    EXPECT_TRUE(probes.issues().empty());
+    EXPECT_EQ(changes, 1);
+}
+
+TEST(HealthProbesTest, RejectedProbeIsRetriedOnTheNextPoll) {
+    health_probes probes(1s, 1s);
+    int runs = 0;
+    probes.add_check("counted", [&runs] {
+        ++runs;
+        return std::make_pair(true, std::string());
+    });
+
+    const auto start = clock_type::now();
+    probes.poll(start, [](std::function<void()>) { return false; });
+    probes.poll(start + 1ms, run_inline);
+    EXPECT_EQ(runs, 1);
+}
+
+TEST(HealthProbesTest, CollectorKeepsItsLastValueOnError) {
+    metric_registry registry("probes");
+    auto gauge = registry.register_gauge("queue_depth");
+    ASSERT_TRUE(gauge.is_ok());
+
+    health_probes probes(10ms, 1s);
+    bool failing = false;
+    probes.add_collector("queue_depth", [&failing]() -> double {
+        if (failing) {
+            throw std::runtime_error("unavailable");
+        }
+        return 42.0;
+    }, gauge.value());
+
+    const auto start = clock_type::now();
+    probes.poll(start, run_inline);
+    EXPECT_DOUBLE_EQ(gauge.value().value(), 42.0);
+
+    failing = true;
+    probes.poll(start + 10ms, run_inline);
+    EXPECT_DOUBLE_EQ(gauge.value().value(), 42.0);
+    EXPECT_TRUE(probes.issues().empty());  // Collectors do not affect health
+}
+
+TEST(HealthProbesTest, SystemExportsCollectorsAsGauges) {
+    unified_thread_system::config cfg;
+    cfg.name = "collected";
+    cfg.thread_count = 2;
+    cfg.enable_console_logging = false;
+    cfg.enable_file_logging = false;
+    cfg.health_check_interval = 100ms;
+    unified_thread_system system(cfg);
+
+    system.register_metric_collector("connection_pool_size", [] { return 12.0; });
+    EXPECT_THROW(system.register_metric_collector("bad name", [] { return 0.0; }), std::invalid_argument);
+
+    EXPECT_TRUE(TestWaitHelper::wait_for([&] {
+        return system.export_metrics_prometheus().find("connection_pool_size{pool=\"collected\"} 12\n") !=
+               std::string::npos;
+    }, 3s).success);
+    // Probes are not tasks
+    EXPECT_EQ(system.get_metrics().tasks_completed, 0u);
+}
+
+TEST(HealthProbesTest, HungCheckTimesOutWithoutBlockingTheSystem) {
+    unified_thread_system::config cfg;
+    cfg.name = "hung";
+    cfg.thread_count = 2;
+    cfg.enable_console_logging = false;
+    cfg.enable_file_logging = false;
+    cfg.health_check_interval = 100ms;
+    unified_thread_system system(cfg);
+
+    std::promise<void> release;
+    std::shared_future<void> released = release.get_future().share();
+    system.add_health_check("database", [released] {
+        released.wait();
+        return std::make_pair(true, std::string());
+    }, 200ms);
+    system.add_health_check("cache", [] { return std::make_pair(false, std::string("cold")); });
+
+    ASSERT_TRUE(TestWaitHelper::wait_for([&] { return system.get_health().issues.size() == 2; }, 3s).success);
+    const auto health = system.get_health();
+    EXPECT_EQ(health.overall_health, health_level::critical);
+    EXPECT_EQ(health.issues[0], "cache: cold");
+    EXPECT_EQ(health.issues[1], "database: timed out after 200 ms");
+
+    // The hung check holds one worker; tasks and completion waits carry on
+    EXPECT_EQ(system.submit([] { return 5; }).get(), 5);
+    EXPECT_TRUE(system.wait_for_completion_timeout(1s));
+
+    release.set_value();
+    EXPECT_TRUE(TestWaitHelper::wait_for([&] { return system.get_health().issues.size() == 1; }, 3s).success);
+}
@@ -0,0 +1,106 @@
+/**
+ * @file test_health_snapshot.cpp
+ * @brief Unit tests for background health evaluation
+ */
+
+#include <gtest/gtest.h>
+#include <kcenon/integrated/unified_thread_system.h>
+#include "../utils/test_wait_helper.h"
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <utility>
+
+using namespace kcenon::integrated;
+using namespace kcenon::testing;
+using namespace std::chrono_literals;
+
+namespace {
+
+unified_thread_system::config health_config() {
+    unified_thread_system::config cfg;
+    cfg.name = "health";
+    cfg.thread_count = 1;
+    cfg.enable_console_logging = false;
+    cfg.enable_file_logging = false;
+    cfg.enable_flight_recorder = false;
+    cfg.health_check_interval = 100ms;
+    return cfg;
+}
+
+} // namespace
+
+TEST(HealthSnapshotTest, HealthyBeforeTheFirstEvaluation) {
+    unified_thread_system system(health_config());
+
+    EXPECT_TRUE(system.is_healthy());
+    EXPECT_EQ(system.get_health().overall_health, health_level::healthy);
+    EXPECT_NE(system.export_health_json().find("\"status\": \"healthy\""), std::string::npos);
+}
+
+TEST(HealthSnapshotTest, FailingCheckIsPublishedByTheEvaluator) {
+    unified_thread_system system(health_config());
+    system.add_health_check("database", [] { return std::make_pair(false, std::string("unreachable")); });
+
+    ASSERT_TRUE(TestWaitHelper::wait_for([&] { return !system.is_healthy(); }, 3s).success);
+    const auto health = system.get_health();
+    EXPECT_EQ(health.overall_health, health_level::critical);
+    ASSERT_EQ(health.issues.size(), 1u);
+    EXPECT_EQ(health.issues[0], "database: unreachable");
+    EXPECT_NE(system.export_health_json().find("database: unreachable"), std::string::npos);
+}
+
+TEST(HealthSnapshotTest, ReadsDoNotRunChecks) {
+    unified_thread_system system(health_config());
+    std::atomic<int> runs{0};
+    system.add_health_check("counted", [&runs] {
+        runs.fetch_add(1);
+        return std::make_pair(true, std::string());
+    });
+    ASSERT_TRUE(TestWaitHelper::wait_for([&] { return runs.load() > 0; }, 3s).success);
+
+    const int before = runs.load();
+    for (int i = 0; i < 10000; ++i) {
+        (void)system.get_health();
+        (void)system.is_healthy();
+    }
+    // At most a couple of background evaluations fit in the loop
+    EXPECT_LE(runs.load() - before, 2);
+}
+
+TEST(HealthSnapshotTest, SlowCheckDoesNotBlockReaders) {
+    unified_thread_system system(health_config());
+    std::atomic<bool> running{false};
+    system.add_health_check("slow", [&running] {
+        running = true;
+        std::this_thread::sleep_for(500ms);
+        running = false;
+        return std::make_pair(true, std::string());
+    });
+    ASSERT_TRUE(TestWaitHelper::wait_for([&] { return running.load(); }, 3s).success);
+
+    const auto started = std::chrono::steady_clock::now();
+    EXPECT_TRUE(system.is_healthy());
+    (void)system.export_health_json();
+    EXPECT_LT(std::chrono::steady_clock::now() - started, 100ms);
+}
+
+TEST(HealthSnapshotTest, BreakerStateIsPublishedImmediately) {
+    auto cfg = health_config();
+    cfg.health_check_interval = 1h;  // Only event-driven publishing
+    cfg.enable_circuit_breaker = true;
+    cfg.circuit_breaker_failure_threshold = 1;
+    cfg.circuit_breaker_reset_timeout = 60s;
+    unified_thread_system system(cfg);
+
+    auto failing = system.submit([]() -> int { throw std::runtime_error("boom"); });
+    EXPECT_THROW(failing.get(), std::runtime_error);
+    system.wait_for_completion();
+
+    EXPECT_TRUE(system.get_health().circuit_breaker_open);
+    EXPECT_EQ(system.get_health().overall_health, health_level::critical);
+
+    system.reset_circuit_breaker();
+    EXPECT_TRUE(system.is_healthy());
+}
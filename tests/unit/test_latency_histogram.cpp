@@ -0,0 +1,138 @@
+/**
+ * @file test_latency_histogram.cpp
+ * @brief Unit tests for the log-linear latency histogram
+ */
+
+#include <gtest/gtest.h>
+#include <kcenon/integrated/unified_thread_system.h>
+#include <kcenon/integrated/core/latency_histogram.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <thread>
+#include <vector>
+
+using namespace kcenon::integrated;
+using namespace std::chrono_literals;
+
+TEST(LatencyHistogramTest, EmptySnapshot) {
+    latency_histogram histogram;
+    auto snapshot = histogram.snapshot();
+
+    EXPECT_EQ(snapshot.count(), 0u);
+    EXPECT_EQ(snapshot.percentile(0.99), 0ns);
+    EXPECT_EQ(snapshot.mean(), 0ns);
+}
+
+TEST(LatencyHistogramTest, SmallValuesAreExact) {
+    latency_histogram histogram;
+    for (int i = 1; i <= 100; ++i) {
+        histogram.record(std::chrono::nanoseconds(i));
+    }
+
+    auto snapshot = histogram.snapshot();
+    EXPECT_EQ(snapshot.count(), 100u);
+    EXPECT_EQ(snapshot.min(), 1ns);
+    EXPECT_EQ(snapshot.max(), 100ns);
+    EXPECT_EQ(snapshot.percentile(0.5), 50ns);
+    EXPECT_EQ(snapshot.percentile(0.99), 99ns);
+    EXPECT_EQ(snapshot.mean(), 50ns);  // 5050 / 100, truncated
+}
+
+TEST(LatencyHistogramTest, PercentilesWithinPrecision) {
+    for (unsigned digits : {1u, 2u, 3u}) {
+        latency_histogram histogram(digits);
+        const double tolerance = std::pow(10.0, -static_cast<double>(digits));
+
+        std::mt19937_64 rng(42);
+        std::lognormal_distribution<double> dist(12.0, 2.0);  // ~160 us median, long tail
+        std::vector<std::int64_t> values;
+        for (int i = 0; i < 20000; ++i) {
+            values.push_back(static_cast<std::int64_t>(dist(rng)) + 1);
+            histogram.record(std::chrono::nanoseconds(values.back()));
+        }
+        std::sort(values.begin(), values.end());
+
+        auto snapshot = histogram.snapshot();
+        for (double q : {0.5, 0.9, 0.99, 0.999}) {
+            const auto rank = static_cast<std::size_t>(std::ceil(q * values.size())) - 1;
+            const double expected = static_cast<double>(values[rank]);
+            const double actual = static_cast<double>(snapshot.percentile(q).count());
+            EXPECT_LE(std::abs(actual - expected), expected * tolerance)
+                << "digits=" << digits << " q=" << q;
+        }
+    }
+}
+
+TEST(LatencyHistogramTest, ValuesBeyondMaxAreClamped) {
+    latency_histogram histogram(2, 1ms);
+    histogram.record(10s);
+    histogram.record(1us);
+
+    auto snapshot = histogram.snapshot();
+    EXPECT_EQ(snapshot.count(), 2u);
+    EXPECT_EQ(snapshot.max(), 10s);
+    EXPECT_EQ(snapshot.percentile(1.0), 10s);
+}
+
+TEST(LatencyHistogramTest, MergeCombinesShards) {
+    latency_histogram first;
+    latency_histogram second;
+    for (int i = 0; i < 50; ++i) {
+        first.record(10us);
+        second.record(1ms);
+    }
+
+    auto merged = first.snapshot();
+    second.merge_into(merged);
+
+    EXPECT_EQ(merged.count(), 100u);
+    EXPECT_EQ(merged.min(), 10us);
+    EXPECT_EQ(merged.max(), 1ms);
+    EXPECT_NEAR(static_cast<double>(merged.percentile(0.25).count()), 10000.0, 100.0);
+    EXPECT_NEAR(static_cast<double>(merged.percentile(0.75).count()), 1000000.0, 10000.0);
+}
+
+TEST(LatencyHistogramTest, ConcurrentRecordsAreAllCounted) {
+    latency_histogram histogram;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&histogram, t] {
+            for (int i = 0; i < 10000; ++i) {
+                histogram.record(std::chrono::nanoseconds(100 * (t + 1)));
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    auto snapshot = histogram.snapshot();
+    EXPECT_EQ(snapshot.count(), 40000u);
+    EXPECT_EQ(snapshot.min(), 100ns);
+    EXPECT_EQ(snapshot.max(), 400ns);
+}
+
+TEST(LatencyHistogramTest, SystemMetricsCoverAllTasks) {
+    unified_thread_system::config cfg;
+    cfg.thread_count = 2;
+    unified_thread_system system(cfg);
+
+    constexpr int task_count = 3000;
+    std::vector<std::future<void>> futures;
+    for (int i = 0; i < task_count; ++i) {
+        futures.push_back(system.submit([] {}));
+    }
+    for (auto& future : futures) {
+        future.get();
+    }
+    system.wait_for_completion();
+
+    auto metrics = system.get_metrics();
+    EXPECT_GE(metrics.max_latency, metrics.p99_latency);
+    EXPECT_GE(metrics.p999_latency, metrics.p99_latency);
+    EXPECT_GE(metrics.p99_latency, metrics.p95_latency);
+    EXPECT_GE(metrics.p95_latency, metrics.p50_latency);
+    EXPECT_GE(metrics.p50_latency, metrics.min_latency);
+}
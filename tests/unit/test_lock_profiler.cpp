@@ -0,0 +1,190 @@
+/**
+ * @file test_lock_profiler.cpp
+ * @brief Unit tests for queue lock contention profiling
+ */
+
+#include <gtest/gtest.h>
+#include <kcenon/integrated/unified_thread_system.h>
+#include <kcenon/integrated/core/lock_profiler.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <future>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace kcenon::integrated;
+using namespace std::chrono_literals;
+
+TEST(LockProfilerTest, UncontendedAcquisitionsAreCountedNotTimed) {
+    lock_profiler profiler(1);
+    std::mutex mutex;
+    lock_profile* profile = profiler.add("queue");
+
+    for (int i = 0; i < 10; ++i) {
+        profiled_lock lock(mutex, profile);
+    }
+
+    const auto locks = profiler.snapshot();
+    ASSERT_EQ(locks.size(), 1u);
+    EXPECT_EQ(locks[0].name, "queue");
+    EXPECT_EQ(locks[0].acquisitions, 10u);
+    EXPECT_EQ(locks[0].contended, 0u);
+    EXPECT_EQ(locks[0].wait.count, 0u);
+    EXPECT_EQ(locks[0].hold.count, 10u);  // Every acquisition sampled at interval 1
+    EXPECT_DOUBLE_EQ(locks[0].contention_ratio(), 0.0);
+}
+
+TEST(LockProfilerTest, ContendedAcquisitionRecordsItsWait) {
+    lock_profiler profiler;
+    std::mutex mutex;
+    lock_profile* profile = profiler.add("queue");
+
+    std::promise<void> holding;
+    std::thread holder;
+    {
+        std::unique_lock<std::mutex> held(mutex);
+        holder = std::thread([&] {
+            holding.set_value();
+            profiled_lock lock(mutex, profile);
+        });
+        holding.get_future().wait();
+        std::this_thread::sleep_for(20ms);
+    }
+    holder.join();
+
+    const auto locks = profiler.snapshot();
+    ASSERT_EQ(locks.size(), 1u);
+    EXPECT_EQ(locks[0].acquisitions, 1u);
+    EXPECT_EQ(locks[0].contended, 1u);
+    ASSERT_EQ(locks[0].wait.count, 1u);
+    EXPECT_GE(locks[0].wait.max, 15ms);
+    EXPECT_DOUBLE_EQ(locks[0].contention_ratio(), 1.0);
+}
+
+TEST(LockProfilerTest, HoldTimesAreSampled) {
+    lock_profiler profiler(4);
+    std::mutex mutex;
+    lock_profile* profile = profiler.add("queue");
+
+    for (int i = 0; i < 16; ++i) {
+        profiled_lock lock(mutex, profile);
+        std::this_thread::sleep_for(100us);
+    }
+
+    const auto locks = profiler.snapshot();
+    ASSERT_EQ(locks.size(), 1u);
+    EXPECT_EQ(locks[0].acquisitions, 16u);
+    ASSERT_EQ(locks[0].hold.count, 4u);
+    EXPECT_GE(locks[0].hold.p50, 90us);
+}
+
+TEST(LockProfilerTest, WaitingOnAConditionEndsTheHoldSample) {
+    lock_profiler profiler(1);
+    std::mutex mutex;
+    std::condition_variable cv;
+    lock_profile* profile = profiler.add("queue");
+
+    {
+        profiled_lock lock(mutex, profile);
+        cv.wait_for(lock.for_wait(), 30ms, [] { return false; });
+    }
+
+    const auto locks = profiler.snapshot();
+    ASSERT_EQ(locks.size(), 1u);
+    ASSERT_EQ(locks[0].hold.count, 1u);
+    EXPECT_LT(locks[0].hold.max, 20ms);
+}
+
+TEST(LockProfilerTest, ProfilesSharingANameAreSummed) {
+    lock_profiler profiler;
+    std::mutex first;
+    std::mutex second;
+    std::mutex global;
+    lock_profile* first_profile = profiler.add("local_queue");
+    lock_profile* second_profile = profiler.add("local_queue");
+    lock_profile* global_profile = profiler.add("queue");
+
+    { profiled_lock lock(first, first_profile); }
+    { profiled_lock lock(second, second_profile); }
+    { profiled_lock lock(second, second_profile); }
+    { profiled_lock lock(global, global_profile); }
+
+    const auto locks = profiler.snapshot();
+    ASSERT_EQ(locks.size(), 2u);
+    EXPECT_EQ(locks[0].name, "local_queue");
+    EXPECT_EQ(locks[0].acquisitions, 3u);
+    EXPECT_EQ(locks[1].name, "queue");
+    EXPECT_EQ(locks[1].acquisitions, 1u);
+}
+
+TEST(LockProfilerTest, NullProfileStillLocks) {
+    std::mutex mutex;
+    std::atomic<int> inside{0};
+    std::atomic<bool> overlapped{false};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&] {
+            for (int i = 0; i < 1000; ++i) {
+                profiled_lock lock(mutex, nullptr);
+                if (inside.fetch_add(1) != 0) {
+                    overlapped = true;
+                }
+                inside.fetch_sub(1);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    EXPECT_FALSE(overlapped.load());
+}
+
+TEST(LockProfilerTest, SystemProfilesItsQueueLocks) {
+    unified_thread_system::config cfg;
+    cfg.name = "profiled";
+    cfg.thread_count = 2;
+    cfg.enable_console_logging = false;
+    cfg.enable_lock_profiling = true;
+    unified_thread_system system(cfg);
+
+    std::vector<std::future<int>> futures;
+    for (int i = 0; i < 100; ++i) {
+        futures.push_back(system.submit([i] { return i; }));
+    }
+    for (auto& future : futures) {
+        future.get();
+    }
+    system.wait_for_completion();
+
+    const auto metrics = system.get_metrics();
+    ASSERT_FALSE(metrics.locks.empty());
+    EXPECT_EQ(metrics.locks[0].name, "queue");
+    // Every submission takes the queue lock once
+    EXPECT_GE(metrics.locks[0].acquisitions, 100u);
+    EXPECT_LE(metrics.locks[0].contended, metrics.locks[0].acquisitions);
+
+    const auto text = system.export_metrics_prometheus();
+    EXPECT_NE(text.find("lock_acquisitions_total{pool=\"profiled\",lock=\"queue\"}"), std::string::npos);
+    EXPECT_NE(text.find("lock_contended_acquisitions_total{pool=\"profiled\",lock=\"queue\"}"),
+              std::string::npos);
+    EXPECT_NE(text.find("lock_wait_seconds_bucket{pool=\"profiled\",lock=\"queue\",le=\"2.5e-07\"}"),
+              std::string::npos);
+    EXPECT_NE(text.find("lock_hold_seconds_count{pool=\"profiled\",lock=\"queue\"}"), std::string::npos);
+
+    const auto json = system.export_metrics_json();
+    EXPECT_NE(json.find("\"locks\": [\n    {\"lock\": \"queue\", \"acquisitions\": "), std::string::npos);
+}
+
+TEST(LockProfilerTest, DisabledByDefault) {
+    unified_thread_system::config cfg;
+    cfg.thread_count = 1;
+    cfg.enable_console_logging = false;
+    unified_thread_system system(cfg);
+    system.submit([] { return 0; }).get();
+
+    EXPECT_TRUE(system.get_metrics().locks.empty());
+    EXPECT_EQ(system.export_metrics_prometheus().find("lock_acquisitions"), std::string::npos);
+}
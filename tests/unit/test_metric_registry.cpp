@@ -0,0 +1,163 @@
+/**
+ * @file test_metric_registry.cpp
+ * @brief Unit tests for pre-registered metric handles
+ */
+
+#include <gtest/gtest.h>
+#include <kcenon/integrated/unified_thread_system.h>
+#include <kcenon/integrated/core/metric_registry.h>
+#include <kcenon/integrated/core/prometheus_writer.h>
+#include <array>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace kcenon::integrated;
+
+namespace {
+
+std::string render(const metric_registry& registry) {
+    prometheus_writer writer;
+    registry.write(writer);
+    return std::string(writer.finish());
+}
+
+} // namespace
+
+TEST(MetricRegistryTest, HandlesUpdateExportedSeries) {
+    metric_registry registry("app");
+    auto requests = registry.register_counter("requests", {{"route", "/a"}}, "Handled requests");
+    auto in_flight = registry.register_gauge("in_flight");
+    ASSERT_TRUE(requests.is_ok());
+    ASSERT_TRUE(in_flight.is_ok());
+
+    requests.value().increment();
+    requests.value().increment(4);
+    in_flight.value().set(3.0);
+    in_flight.value().add(-1.0);
+
+    EXPECT_EQ(requests.value().value(), 5u);
+    EXPECT_DOUBLE_EQ(in_flight.value().value(), 2.0);
+
+    const auto text = render(registry);
+    EXPECT_NE(text.find("# HELP requests_total Handled requests\n"), std::string::npos);
+    EXPECT_NE(text.find("requests_total{pool=\"app\",route=\"/a\"} 5\n"), std::string::npos);
+    EXPECT_NE(text.find("in_flight{pool=\"app\"} 2\n"), std::string::npos);
+    // Families are written sorted by name
+    EXPECT_LT(text.find("in_flight"), text.find("requests_total"));
+}
+
+TEST(MetricRegistryTest, RegisteringAgainReturnsTheSameSeries) {
+    metric_registry registry("app");
+    auto first = registry.register_counter("hits", {{"kind", "a"}});
+    auto second = registry.register_counter("hits", {{"kind", "a"}});
+    auto other = registry.register_counter("hits", {{"kind", "b"}});
+    ASSERT_TRUE(first.is_ok() && second.is_ok() && other.is_ok());
+
+    first.value().increment();
+    second.value().increment();
+    EXPECT_EQ(first.value().value(), 2u);
+    EXPECT_EQ(other.value().value(), 0u);
+    EXPECT_EQ(registry.series_count(), 2u);
+}
+
+TEST(MetricRegistryTest, RejectsConflictsAndInvalidNames) {
+    metric_registry registry("app");
+    ASSERT_TRUE(registry.register_counter("jobs").is_ok());
+
+    EXPECT_TRUE(registry.register_gauge("jobs").is_err());
+    EXPECT_TRUE(registry.register_counter("").is_err());
+    EXPECT_TRUE(registry.register_counter("9lives").is_err());
+    EXPECT_TRUE(registry.register_counter("has-dash").is_err());
+    EXPECT_TRUE(registry.register_counter("ok", {{"pool", "x"}}).is_err());
+    EXPECT_TRUE(registry.register_counter("ok", {{"__internal", "x"}}).is_err());
+    EXPECT_TRUE(registry.register_histogram("latency", {{"le", "1"}}).is_err());
+
+    constexpr std::array<double, 2> descending{2.0, 1.0};
+    EXPECT_TRUE(registry.register_histogram("latency", {}, descending).is_err());
+
+    constexpr std::array<double, 2> bounds{1.0, 2.0};
+    ASSERT_TRUE(registry.register_histogram("latency", {}, bounds).is_ok());
+    EXPECT_TRUE(registry.register_histogram("latency", {{"route", "/b"}}).is_err());
+}
+
+TEST(MetricRegistryTest, CardinalityLimitFoldsIntoOverflowSeries) {
+    metric_registry registry("app", 2);
+    auto a = registry.register_counter("calls", {{"user", "a"}});
+    auto b = registry.register_counter("calls", {{"user", "b"}});
+    auto c = registry.register_counter("calls", {{"user", "c"}});
+    auto d = registry.register_counter("calls", {{"user", "d"}});
+    ASSERT_TRUE(a.is_ok() && b.is_ok() && c.is_ok() && d.is_ok());
+
+    c.value().increment();
+    d.value().increment();
+    EXPECT_EQ(c.value().value(), 2u);
+    EXPECT_EQ(registry.rejected_series(), 2u);
+    EXPECT_EQ(registry.series_count(), 3u);
+
+    const auto text = render(registry);
+    EXPECT_NE(text.find("calls_total{pool=\"app\",overflow=\"true\"} 2\n"), std::string::npos);
+    EXPECT_EQ(text.find("user=\"c\""), std::string::npos);
+}
+
+TEST(MetricRegistryTest, HistogramBucketsAreCumulative) {
+    metric_registry registry("app");
+    constexpr std::array<double, 3> bounds{0.1, 1.0, 10.0};
+    auto latency = registry.register_histogram("latency_seconds", {{"op", "read"}}, bounds);
+    ASSERT_TRUE(latency.is_ok());
+
+    latency.value().observe(0.05);
+    latency.value().observe(0.1);
+    latency.value().observe(0.5);
+    latency.value().observe(50.0);
+
+    const auto text = render(registry);
+    EXPECT_NE(text.find("# TYPE latency_seconds histogram\n"), std::string::npos);
+    EXPECT_NE(text.find("latency_seconds_bucket{pool=\"app\",op=\"read\",le=\"0.1\"} 2\n"), std::string::npos);
+    EXPECT_NE(text.find("latency_seconds_bucket{pool=\"app\",op=\"read\",le=\"1\"} 3\n"), std::string::npos);
+    EXPECT_NE(text.find("latency_seconds_bucket{pool=\"app\",op=\"read\",le=\"10\"} 3\n"), std::string::npos);
+    EXPECT_NE(text.find("latency_seconds_bucket{pool=\"app\",op=\"read\",le=\"+Inf\"} 4\n"), std::string::npos);
+    EXPECT_NE(text.find("latency_seconds_sum{pool=\"app\",op=\"read\"} 50.65\n"), std::string::npos);
+    EXPECT_NE(text.find("latency_seconds_count{pool=\"app\",op=\"read\"} 4\n"), std::string::npos);
+}
+
+TEST(MetricRegistryTest, ConcurrentIncrementsAreNotLost) {
+    metric_registry registry("app");
+    auto counter = registry.register_counter("events").value();
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([counter] {
+            for (int i = 0; i < 10000; ++i) {
+                counter.increment();
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(counter.value(), 40000u);
+}
+
+TEST(MetricRegistryTest, SystemExportsRegisteredMetrics) {
+    unified_thread_system::config cfg;
+    cfg.name = "handles";
+    cfg.thread_count = 1;
+    unified_thread_system system(cfg);
+
+    auto orders = system.register_counter("orders", {{"region", "eu"}});
+    auto depth = system.register_gauge("backlog_depth");
+    auto size = system.register_histogram("order_size");
+    orders.increment(3);
+    depth.set(7);
+    size.observe(0.2);
+
+    const auto text = system.export_metrics_prometheus();
+    EXPECT_NE(text.find("orders_total{pool=\"handles\",region=\"eu\"} 3\n"), std::string::npos);
+    EXPECT_NE(text.find("backlog_depth{pool=\"handles\"} 7\n"), std::string::npos);
+    EXPECT_NE(text.find("order_size_bucket{pool=\"handles\",le=\"0.25\"} 1\n"), std::string::npos);
+
+    EXPECT_THROW(system.register_gauge("orders"), std::invalid_argument);
+    EXPECT_THROW(system.register_counter("bad name"), std::invalid_argument);
+}
@@ -0,0 +1,221 @@
+/**
+ * @file test_metrics_endpoint.cpp
+ * @brief Unit tests for the built-in HTTP metrics endpoint
+ */
+
+#include <gtest/gtest.h>
+#include <kcenon/integrated/unified_thread_system.h>
+#include <kcenon/integrated/adapters/metrics_endpoint.h>
+#include <string>
+
+#if defined(__linux__) && defined(ENABLE_WEB_DASHBOARD)
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#define HAS_METRICS_ENDPOINT 1
+#else
+#define HAS_METRICS_ENDPOINT 0
+#endif
+
+using namespace kcenon::integrated;
+
+#if HAS_METRICS_ENDPOINT
+
+namespace {
+
+struct http_reply {
+    int status = 0;
+    std::string headers;
+    std::string body;
+};
+
+class http_client {
+public:
+    explicit http_client(std::uint16_t port) : fd_(::socket(AF_INET, SOCK_STREAM, 0)) {
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_port = htons(port);
+        ::inet_pton(AF_INET, "127.0.0.1", &address.sin_addr);
+        connected_ = ::connect(fd_, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0;
+    }
+
+    ~http_client() { ::close(fd_); }
+
+    bool connected() const { return connected_; }
+
+    void send(const std::string& request) {
+        ASSERT_EQ(::send(fd_, request.data(), request.size(), 0), static_cast<ssize_t>(request.size()));
+    }
+
+    // Reads one response, using Content-Length to find its end
+    http_reply receive(bool head = false) {
+        http_reply reply;
+        size_t header_end;
+        while ((header_end = buffer_.find("\r\n\r\n")) == std::string::npos) {
+            if (!fill()) {
+                return reply;
+            }
+        }
+
+        reply.headers = buffer_.substr(0, header_end + 4);
+        reply.status = std::stoi(reply.headers.substr(9, 3));
+        const auto length_at = reply.headers.find("Content-Length: ");
+        const size_t length = head ? 0 : std::stoul(reply.headers.substr(length_at + 16));
+
+        while (buffer_.size() < header_end + 4 + length) {
+            if (!fill()) {
+                return reply;
+            }
+        }
+        reply.body = buffer_.substr(header_end + 4, length);
+        buffer_.erase(0, header_end + 4 + length);
+        return reply;
+    }
+
+    http_reply get(const std::string& path, const std::string& extra_headers = "") {
+        send("GET " + path + " HTTP/1.1\r\nHost: localhost\r\n" + extra_headers + "\r\n");
+        return receive();
+    }
+
+    // True once the server has closed the connection
+    bool closed() {
+        return !fill();
+    }
+
+private:
+    bool fill() {
+        char chunk[4096];
+        const ssize_t received = ::recv(fd_, chunk, sizeof(chunk), 0);
+        if (received <= 0) {
+            return false;
+        }
+        buffer_.append(chunk, static_cast<size_t>(received));
+        return true;
+    }
+
+    int fd_;
+    bool connected_ = false;
+    std::string buffer_;
+};
+
+unified_thread_system::config endpoint_config() {
+    unified_thread_system::config cfg;
+    cfg.name = "endpoint_test";
+    cfg.thread_count = 2;
+    cfg.enable_console_logging = false;
+    cfg.enable_file_logging = false;
+    cfg.enable_metrics_endpoint = true;
+    cfg.metrics_port = 0;
+    return cfg;
+}
+
+} // namespace
+
+TEST(MetricsEndpointTest, ServesPrometheusOverKeepAlive) {
+    unified_thread_system system(endpoint_config());
+    system.submit([] { return 1; }).get();
+    system.wait_for_completion();
+
+    ASSERT_NE(system.metrics_endpoint_port(), 0);
+    http_client client(system.metrics_endpoint_port());
+    ASSERT_TRUE(client.connected());
+
+    for (int i = 0; i < 3; ++i) {
+        const auto reply = client.get("/metrics");
+        EXPECT_EQ(reply.status, 200);
+        EXPECT_NE(reply.headers.find("Connection: keep-alive"), std::string::npos);
+        EXPECT_NE(reply.headers.find("text/plain; version=0.0.4"), std::string::npos);
+        EXPECT_NE(reply.body.find("tasks_submitted_total{pool=\"endpoint_test\"} 1"), std::string::npos);
+    }
+}
+
+TEST(MetricsEndpointTest, NegotiatesOpenMetrics) {
+    unified_thread_system system(endpoint_config());
+    http_client client(system.metrics_endpoint_port());
+    ASSERT_TRUE(client.connected());
+
+    const auto reply = client.get("/metrics", "Accept: application/openmetrics-text; version=1.0.0\r\n");
+    EXPECT_EQ(reply.status, 200);
+    EXPECT_NE(reply.headers.find("application/openmetrics-text"), std::string::npos);
+    EXPECT_EQ(reply.body.substr(reply.body.size() - 6), "# EOF\n");
+}
+
+TEST(MetricsEndpointTest, ServesJsonAndHealth) {
+    unified_thread_system system(endpoint_config());
+    http_client client(system.metrics_endpoint_port());
+    ASSERT_TRUE(client.connected());
+
+    const auto json = client.get("/metrics.json?pretty=1");
+    EXPECT_EQ(json.status, 200);
+    EXPECT_NE(json.headers.find("application/json"), std::string::npos);
+    EXPECT_NE(json.body.find("\"tasks_submitted\""), std::string::npos);
+
+    const auto health = client.get("/health");
+    EXPECT_EQ(health.status, 200);
+    EXPECT_NE(health.body.find("\"status\": \"healthy\""), std::string::npos);
+    EXPECT_EQ(health.body, system.export_health_json());
+}
+
+TEST(MetricsEndpointTest, AnswersPipelinedRequestsInOrder) {
+    unified_thread_system system(endpoint_config());
+    http_client client(system.metrics_endpoint_port());
+    ASSERT_TRUE(client.connected());
+
+    client.send("GET /health HTTP/1.1\r\n\r\n"
+                "HEAD /metrics HTTP/1.1\r\n\r\n"
+                "GET /missing HTTP/1.1\r\n\r\n"
+                "POST /metrics HTTP/1.1\r\n\r\n");
+
+    EXPECT_EQ(client.receive().status, 200);
+    const auto head = client.receive(true);
+    EXPECT_EQ(head.status, 200);
+    EXPECT_TRUE(head.body.empty());
+    EXPECT_EQ(client.receive().status, 404);
+    const auto post = client.receive();
+    EXPECT_EQ(post.status, 405);
+    EXPECT_NE(post.headers.find("Allow: GET, HEAD"), std::string::npos);
+
+    EXPECT_EQ(client.get("/health").status, 200);
+}
+
+TEST(MetricsEndpointTest, ClosesOnConnectionCloseAndBadRequests) {
+    unified_thread_system system(endpoint_config());
+
+    {
+        http_client client(system.metrics_endpoint_port());
+        const auto reply = client.get("/health", "Connection: close\r\n");
+        EXPECT_EQ(reply.status, 200);
+        EXPECT_NE(reply.headers.find("Connection: close"), std::string::npos);
+        EXPECT_TRUE(client.closed());
+    }
+    {
+        http_client client(system.metrics_endpoint_port());
+        client.send("garbage\r\n\r\n");
+        EXPECT_EQ(client.receive().status, 400);
+        EXPECT_TRUE(client.closed());
+    }
+    {
+        http_client client(system.metrics_endpoint_port());
+        client.send("GET /" + std::string(10000, 'a'));
+        EXPECT_EQ(client.receive().status, 431);
+    }
+}
+
+TEST(MetricsEndpointTest, AdapterReportsBindErrors) {
+    metrics_endpoint_config cfg;
+    cfg.bind_address = "not-an-address";
+    adapters::metrics_endpoint endpoint(cfg, {});
+    EXPECT_TRUE(endpoint.initialize().is_err());
+    EXPECT_FALSE(endpoint.is_initialized());
+    EXPECT_EQ(endpoint.port(), 0);
+}
+
+#endif
+
+TEST(MetricsEndpointTest, DisabledByDefault) {
+    unified_thread_system::config cfg;
+    cfg.thread_count = 1;
+    unified_thread_system system(cfg);
+    EXPECT_EQ(system.metrics_endpoint_port(), 0);
+}
@@ -0,0 +1,222 @@
+/**
+ * @file test_perf_counters.cpp
+ * @brief Unit tests for per-task performance counters
+ */
+
+#include <gtest/gtest.h>
+#include <kcenon/integrated/unified_thread_system.h>
+#include <kcenon/integrated/core/perf_counters.h>
+#include <chrono>
+#include <future>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace kcenon::integrated;
+using namespace std::chrono_literals;
+
+namespace {
+
+// Keeps the CPU busy for at least the given wall time
+void spin_for(std::chrono::milliseconds duration) {
+    const auto until = std::chrono::steady_clock::now() + duration;
+    volatile std::uint64_t sink = 0;
+    while (std::chrono::steady_clock::now() < until) {
+        for (int i = 0; i < 1000; ++i) {
+            sink = sink + static_cast<std::uint64_t>(i);
+        }
+    }
+}
+
+const task_counters* find(const std::vector<task_counters>& cells, const std::string& label,
+                          const std::string& lane) {
+    for (const auto& cell : cells) {
+        if (cell.label == label && cell.lane == lane) {
+            return &cell;
+        }
+    }
+    return nullptr;
+}
+
+} // namespace
+
+TEST(PerfCountersTest, SoftwareCountersAreAlwaysAvailableOnLinux) {
+#if defined(__linux__)
+    auto& group = perf_counter_group::this_thread();
+    EXPECT_NE(group.source(), perf_counter_source::none);
+    EXPECT_TRUE(group.available() & (1u << static_cast<unsigned>(perf_event::cpu_time_ns)));
+    EXPECT_TRUE(group.available() & (1u << static_cast<unsigned>(perf_event::context_switches)));
+
+    const auto before = group.read();
+    spin_for(20ms);
+    const auto after = group.read();
+    const auto cpu = static_cast<std::size_t>(perf_event::cpu_time_ns);
+    EXPECT_GT(after.values[cpu], before.values[cpu]);
+#else
+    GTEST_SKIP() << "perf counters are Linux-only";
+#endif
+}
+
+TEST(PerfCountersTest, LabelsAreInternedWithDefaultAndOverflow) {
+    perf_profiler profiler(4);
+
+    EXPECT_EQ(profiler.label(""), task_label{});
+    EXPECT_EQ(profiler.label("default"), task_label{});
+
+    const task_label parse = profiler.label("parse");
+    EXPECT_NE(parse, task_label{});
+    EXPECT_EQ(profiler.label("parse"), parse);
+
+    const task_label render = profiler.label("render");
+    EXPECT_NE(render, parse);
+
+    // Ids 0 and 3 are reserved, so a third name shares "other"
+    const task_label other = profiler.label("other");
+    EXPECT_EQ(profiler.label("encode"), other);
+    EXPECT_EQ(profiler.label("compress"), other);
+}
+
+TEST(PerfCountersTest, MeasurementsAccumulatePerLabelAndLane) {
+    perf_profiler profiler;
+    const task_label busy = profiler.label("busy");
+
+    for (int i = 0; i < 3; ++i) {
+        const auto started = profiler.begin();
+        spin_for(5ms);
+        profiler.end(started, busy, static_cast<int>(priority_level::high));
+    }
+    profiler.end(profiler.begin(), {}, static_cast<int>(priority_level::normal));
+
+    const auto cells = profiler.snapshot();
+    ASSERT_EQ(cells.size(), 2u);
+    const auto* high = find(cells, "busy", "high");
+    ASSERT_NE(high, nullptr);
+    EXPECT_EQ(high->tasks, 3u);
+#if defined(__linux__)
+    EXPECT_TRUE(high->has(perf_event::cpu_time_ns));
+    EXPECT_GE((*high)[perf_event::cpu_time_ns], static_cast<std::uint64_t>(std::chrono::nanoseconds(5ms).count()));
+#endif
+    const auto* normal = find(cells, "default", "normal");
+    ASSERT_NE(normal, nullptr);
+    EXPECT_EQ(normal->tasks, 1u);
+}
+
+TEST(PerfCountersTest, SampleIntervalMeasuresOneTaskInN) {
+    perf_profiler profiler(perf_profiler::default_max_labels, 4);
+
+    int measured = 0;
+    for (int i = 0; i < 16; ++i) {
+        const auto started = profiler.begin();
+        measured += started.active ? 1 : 0;
+        profiler.end(started, {}, 0);
+    }
+    EXPECT_EQ(measured, 4);
+
+    const auto cells = profiler.snapshot();
+    ASSERT_EQ(cells.size(), 1u);
+    EXPECT_EQ(cells[0].tasks, 4u);
+}
+
+TEST(PerfCountersTest, ThreadsAreMergedAndAvailabilityIsShared) {
+    perf_profiler profiler;
+    const task_label work = profiler.label("work");
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&] {
+            for (int i = 0; i < 10; ++i) {
+                profiler.end(profiler.begin(), work, 0);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    const auto cells = profiler.snapshot();
+    ASSERT_EQ(cells.size(), 1u);
+    EXPECT_EQ(cells[0].tasks, 40u);
+    EXPECT_EQ(cells[0].available & perf_counter_group::this_thread().available(), cells[0].available);
+}
+
+TEST(PerfCountersTest, RatiosNeedTheirCounters) {
+    task_counters cell;
+    cell.values[static_cast<std::size_t>(perf_event::cycles)] = 2000;
+    cell.values[static_cast<std::size_t>(perf_event::instructions)] = 4000;
+    cell.values[static_cast<std::size_t>(perf_event::llc_misses)] = 8;
+    cell.values[static_cast<std::size_t>(perf_event::branch_misses)] = 20;
+
+    // Software counters only: no ratio is meaningful
+    cell.available = (1u << static_cast<unsigned>(perf_event::cpu_time_ns));
+    EXPECT_DOUBLE_EQ(cell.ipc(), 0.0);
+    EXPECT_DOUBLE_EQ(cell.llc_mpki(), 0.0);
+
+    cell.available = 0x0F;
+    EXPECT_DOUBLE_EQ(cell.ipc(), 2.0);
+    EXPECT_DOUBLE_EQ(cell.llc_mpki(), 2.0);
+    EXPECT_DOUBLE_EQ(cell.branch_mpki(), 5.0);
+
+    std::ostringstream out;
+    const std::vector<task_counters> cells{cell};
+    write_task_counters_json(out, cells);
+    EXPECT_NE(out.str().find("\"ipc\": 2, \"llc_mpki\": 2, \"branch_mpki\": 5"), std::string::npos);
+}
+
+TEST(PerfCountersTest, SystemReportsLabeledTasks) {
+    unified_thread_system::config cfg;
+    cfg.name = "counted";
+    cfg.thread_count = 2;
+    cfg.enable_console_logging = false;
+    cfg.enable_perf_counters = true;
+    unified_thread_system system(cfg);
+
+    EXPECT_THROW(system.register_task_label(""), std::invalid_argument);
+    const task_label hash = system.register_task_label("hash");
+    EXPECT_EQ(system.register_task_label("hash"), hash);
+
+    std::vector<std::future<int>> futures;
+    for (int i = 0; i < 20; ++i) {
+        futures.push_back(system.submit_labeled(hash, priority_level::high, [i] {
+            spin_for(1ms);
+            return i;
+        }));
+    }
+    futures.push_back(system.submit([] { return 0; }));
+    for (auto& future : futures) {
+        future.get();
+    }
+    system.wait_for_completion();
+
+    const auto metrics = system.get_metrics();
+    const auto* hashed = find(metrics.task_classes, "hash", "high");
+    ASSERT_NE(hashed, nullptr);
+    EXPECT_EQ(hashed->tasks, 20u);
+    ASSERT_NE(find(metrics.task_classes, "default", "normal"), nullptr);
+
+    const auto text = system.export_metrics_prometheus();
+    EXPECT_NE(text.find("task_perf_samples_total{pool=\"counted\",label=\"hash\",priority=\"high\"} 20"),
+              std::string::npos);
+#if defined(__linux__)
+    EXPECT_NE(text.find("task_cpu_seconds_total{pool=\"counted\",label=\"hash\",priority=\"high\"}"),
+              std::string::npos);
+#endif
+
+    const auto json = system.export_metrics_json();
+    EXPECT_NE(json.find("\"task_counters\": [\n    {\"label\": \"default\""), std::string::npos);
+}
+
+TEST(PerfCountersTest, DisabledByDefault) {
+    unified_thread_system::config cfg;
+    cfg.thread_count = 1;
+    cfg.enable_console_logging = false;
+    unified_thread_system system(cfg);
+
+    const task_label label = system.register_task_label("ignored");
+    EXPECT_EQ(label, task_label{});
+    system.submit_labeled(label, [] { return 0; }).get();
+
+    EXPECT_TRUE(system.get_metrics().task_classes.empty());
+    EXPECT_EQ(system.export_metrics_prometheus().find("task_perf_samples"), std::string::npos);
+}
@@ -0,0 +1,109 @@
+/**
+ * @file test_prometheus_writer.cpp
+ * @brief Unit tests for the Prometheus / OpenMetrics exposition writer
+ */
+
+#include <gtest/gtest.h>
+#include <kcenon/integrated/unified_thread_system.h>
+#include <kcenon/integrated/core/latency_histogram.h>
+#include <kcenon/integrated/core/prometheus_writer.h>
+#include <array>
+#include <chrono>
+#include <string>
+
+using namespace kcenon::integrated;
+using namespace std::chrono_literals;
+
+TEST(PrometheusWriterTest, TextFormatCountersAndGauges) {
+    prometheus_writer writer;
+    writer.family("tasks_completed", metric_type::counter, "Finished tasks");
+    writer.counter("tasks_completed", {{"pool", "io"}}, 42);
+    writer.family("queue_size", metric_type::gauge, "Waiting tasks");
+    writer.gauge("queue_size", {}, 2.5);
+
+    EXPECT_EQ(writer.finish(),
+              "# HELP tasks_completed_total Finished tasks\n"
+              "# TYPE tasks_completed_total counter\n"
+              "tasks_completed_total{pool=\"io\"} 42\n"
+              "# HELP queue_size Waiting tasks\n"
+              "# TYPE queue_size gauge\n"
+              "queue_size 2.5\n");
+}
+
+TEST(PrometheusWriterTest, OpenMetricsNamesFamiliesAndTerminates) {
+    prometheus_writer writer(exposition_format::openmetrics);
+    writer.family("tasks_completed", metric_type::counter, "Finished tasks");
+    writer.counter("tasks_completed", {}, 1);
+
+    const std::string text(writer.finish());
+    EXPECT_NE(text.find("# TYPE tasks_completed counter\n"), std::string::npos);
+    EXPECT_NE(text.find("tasks_completed_total 1\n"), std::string::npos);
+    EXPECT_EQ(text.substr(text.size() - 6), "# EOF\n");
+
+    // finish() is idempotent
+    EXPECT_EQ(writer.finish().size(), text.size());
+    EXPECT_NE(prometheus_writer::content_type(exposition_format::openmetrics).find("openmetrics"),
+              std::string_view::npos);
+}
+
+TEST(PrometheusWriterTest, EscapesLabelValues) {
+    prometheus_writer writer;
+    writer.gauge("g", {{"path", "a\\b\"c\nd"}}, 1.0);
+    EXPECT_EQ(writer.view(), "g{path=\"a\\\\b\\\"c\\nd\"} 1\n");
+}
+
+TEST(PrometheusWriterTest, HistogramBucketsAreCumulative) {
+    latency_histogram histogram;
+    histogram.record(5us);
+    histogram.record(20us);
+    histogram.record(20us);
+    histogram.record(2s);
+
+    const std::array<std::chrono::nanoseconds, 3> bounds{10us, 100us, 1s};
+    prometheus_writer writer;
+    writer.histogram("latency_seconds", {{"pool", "p"}}, histogram.snapshot(), bounds);
+    const std::string text(writer.view());
+
+    EXPECT_NE(text.find("latency_seconds_bucket{pool=\"p\",le=\"1e-05\"} 1\n"), std::string::npos);
+    EXPECT_NE(text.find("latency_seconds_bucket{pool=\"p\",le=\"0.0001\"} 3\n"), std::string::npos);
+    EXPECT_NE(text.find("latency_seconds_bucket{pool=\"p\",le=\"1\"} 3\n"), std::string::npos);
+    EXPECT_NE(text.find("latency_seconds_bucket{pool=\"p\",le=\"+Inf\"} 4\n"), std::string::npos);
+    EXPECT_NE(text.find("latency_seconds_count{pool=\"p\"} 4\n"), std::string::npos);
+    EXPECT_NE(text.find("latency_seconds_sum{pool=\"p\"} 2.0000"), std::string::npos);
+}
+
+TEST(PrometheusWriterTest, ResetKeepsCapacity) {
+    prometheus_writer writer;
+    for (int i = 0; i < 100; ++i) {
+        writer.gauge("some_gauge", {{"pool", "default"}}, i);
+    }
+    const auto* data = writer.view().data();
+
+    writer.reset(exposition_format::openmetrics);
+    EXPECT_TRUE(writer.view().empty());
+    EXPECT_EQ(writer.format(), exposition_format::openmetrics);
+    writer.gauge("some_gauge", {{"pool", "default"}}, 1.0);
+    EXPECT_EQ(writer.view().data(), data);
+}
+
+TEST(PrometheusWriterTest, SystemExportsLabelledHistograms) {
+    unified_thread_system::config cfg;
+    cfg.name = "exporter";
+    cfg.thread_count = 1;
+    unified_thread_system system(cfg);
+
+    system.submit([] { return 1; }).get();
+    system.wait_for_completion();
+
+    const auto text = system.export_metrics_prometheus();
+    EXPECT_NE(text.find("tasks_completed_total{pool=\"exporter\"}"), std::string::npos);
+    EXPECT_NE(text.find("# TYPE task_execution_seconds histogram"), std::string::npos);
+    EXPECT_NE(text.find("task_execution_seconds_bucket{pool=\"exporter\""), std::string::npos);
+
+    const auto open_metrics = system.export_metrics_openmetrics();
+    EXPECT_EQ(open_metrics.substr(open_metrics.size() - 6), "# EOF\n");
+
+    prometheus_writer writer;
+    system.export_metrics(writer);
+    EXPECT_NE(writer.view().find("task_rate{pool=\"exporter\""), std::string::npos);
+}
@@ -0,0 +1,133 @@
+/**
+ * @file test_rate_meter.cpp
+ * @brief Unit tests for the windowed / EWMA rate meter
+ */
+
+#include <gtest/gtest.h>
+#include <kcenon/integrated/unified_thread_system.h>
+#include <kcenon/integrated/core/prometheus_writer.h>
+#include <kcenon/integrated/core/rate_meter.h>
+#include <chrono>
+#include <cmath>
+#include <sstream>
+#include <stdexcept>
+
+using namespace kcenon::integrated;
+using namespace std::chrono_literals;
+
+namespace {
+
+constexpr auto tick = rate_meter::tick_interval;
+constexpr auto half_tick = std::chrono::duration_cast<std::chrono::milliseconds>(tick) / 2;
+
+} // namespace
+
+TEST(RateMeterTest, NoRatesBeforeFirstTick) {
+    const auto t0 = rate_meter::clock::now();
+    rate_meter meter(t0);
+    meter.mark(10);
+
+    meter.tick(t0 + half_tick);
+    auto snapshot = meter.snapshot(t0 + half_tick);
+    EXPECT_EQ(snapshot.count, 10u);
+    EXPECT_EQ(snapshot.window_rate, 0.0);
+    EXPECT_EQ(snapshot.one_minute_rate, 0.0);
+    EXPECT_GT(snapshot.mean_rate, 0.0);
+}
+
+TEST(RateMeterTest, SteadyLoadConverges) {
+    const auto t0 = rate_meter::clock::now();
+    rate_meter meter(t0);
+
+    auto now = t0;
+    for (int i = 0; i < 20; ++i) {
+        meter.mark(100);
+        now += tick;
+        meter.tick(now);
+    }
+
+    auto snapshot = meter.snapshot(now);
+    EXPECT_EQ(snapshot.count, 2000u);
+    EXPECT_DOUBLE_EQ(snapshot.window_rate, 100.0);
+    EXPECT_DOUBLE_EQ(snapshot.one_minute_rate, 100.0);  // Seeded by the first tick
+    EXPECT_DOUBLE_EQ(snapshot.fifteen_minute_rate, 100.0);
+    EXPECT_NEAR(snapshot.mean_rate, 100.0, 1e-6);
+}
+
+TEST(RateMeterTest, ReactsToIdlePeriodsWithinSeconds) {
+    const auto t0 = rate_meter::clock::now();
+    rate_meter meter(t0);
+
+    auto now = t0;
+    for (int i = 0; i < 10; ++i) {
+        meter.mark(100);
+        now += tick;
+        meter.tick(now);
+    }
+
+    // Ten idle ticks: the fixed window empties, the averages decay
+    for (int i = 0; i < 10; ++i) {
+        now += tick;
+        meter.tick(now);
+    }
+
+    auto snapshot = meter.snapshot(now);
+    EXPECT_DOUBLE_EQ(snapshot.window_rate, 0.0);
+    EXPECT_NEAR(snapshot.one_minute_rate, 100.0 * std::exp(-10.0 / 60.0), 1e-6);
+    EXPECT_GT(snapshot.five_minute_rate, snapshot.one_minute_rate);
+    EXPECT_GT(snapshot.fifteen_minute_rate, snapshot.five_minute_rate);
+}
+
+TEST(RateMeterTest, MissedTicksAreCaughtUp) {
+    const auto t0 = rate_meter::clock::now();
+    rate_meter meter(t0);
+
+    meter.mark(50);
+    meter.tick(t0 + 5 * tick);  // Five ticks at once: 10 events each
+
+    auto snapshot = meter.snapshot(t0 + 5 * tick);
+    EXPECT_DOUBLE_EQ(snapshot.window_rate, 10.0);
+    EXPECT_DOUBLE_EQ(snapshot.one_minute_rate, 10.0);
+
+    // Not due again yet
+    meter.mark(1000);
+    meter.tick(t0 + 5 * tick + half_tick);
+    EXPECT_DOUBLE_EQ(meter.snapshot().window_rate, 10.0);
+}
+
+TEST(RateMeterTest, ExportFormats) {
+    rate_snapshot rates;
+    rates.count = 3;
+    rates.window_rate = 1.5;
+    std::vector<named_rate> named{{"completed", rates}};
+
+    prometheus_writer prometheus;
+    write_rates_prometheus(prometheus, "pool", named);
+    EXPECT_NE(prometheus.view().find("task_rate{pool=\"pool\",event=\"completed\",window=\"10s\"} 1.5"),
+              std::string::npos);
+
+    std::ostringstream json;
+    write_rates_json(json, named);
+    EXPECT_NE(json.str().find("\"completed\": {\"count\": 3, \"10s\": 1.5"), std::string::npos);
+}
+
+TEST(RateMeterTest, SystemCountsRejections) {
+    unified_thread_system::config cfg;
+    cfg.thread_count = 1;
+    cfg.enable_circuit_breaker = true;
+    cfg.circuit_breaker_failure_threshold = 1;
+    cfg.circuit_breaker_reset_timeout = 10s;
+    unified_thread_system system(cfg);
+
+    auto failing = system.submit([] { throw std::runtime_error("boom"); });
+    EXPECT_THROW(failing.get(), std::runtime_error);
+    system.wait_for_completion();
+
+    ASSERT_TRUE(system.is_circuit_open());
+    EXPECT_THROW(system.submit([] {}), std::runtime_error);
+
+    auto metrics = system.get_metrics();
+    EXPECT_EQ(metrics.tasks_rejected, 1u);
+    EXPECT_EQ(metrics.rejection_rate.count, 1u);
+    EXPECT_GE(metrics.submission_rate.count, 1u);
+}
@@ -0,0 +1,146 @@
+/**
+ * @file test_rolling_aggregate.cpp
+ * @brief Unit tests for sliding-window aggregates
+ */
+
+#include <gtest/gtest.h>
+#include <kcenon/integrated/core/rolling_aggregate.h>
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+using namespace kcenon::integrated;
+using namespace std::chrono_literals;
+
+namespace {
+
+using time_point = rolling_aggregate::clock::time_point;
+
+const time_point epoch = time_point(std::chrono::duration_cast<rolling_aggregate::clock::duration>(
+    std::chrono::milliseconds(1'700'000'000'000)));
+
+void add(rolling_aggregate& aggregate, std::chrono::milliseconds at, std::vector<double> values) {
+    aggregate.add(epoch + at, values);
+}
+
+} // namespace
+
+TEST(RollingAggregateTest, TracksSumMinMaxPerWindow) {
+    rolling_config cfg;
+    cfg.windows = {10s, 60s};
+    rolling_aggregate aggregate(cfg);
+    ASSERT_EQ(aggregate.find_window(10s), 0u);
+    ASSERT_EQ(aggregate.find_window(60s), 1u);
+    EXPECT_FALSE(aggregate.find_window(30s).has_value());
+
+    for (int i = 0; i < 100; ++i) {
+        add(aggregate, std::chrono::seconds(i), {static_cast<double>(i)});
+    }
+
+    // Windows hold (newest - width, newest]: 90..99 and 40..99
+    const auto ten = aggregate.stats(0, 0);
+    EXPECT_EQ(ten.count, 10u);
+    EXPECT_DOUBLE_EQ(ten.mean(), 94.5);
+    EXPECT_EQ(ten.min, 90.0);
+    EXPECT_EQ(ten.max, 99.0);
+
+    const auto minute = aggregate.stats(1, 0);
+    EXPECT_EQ(minute.count, 60u);
+    EXPECT_DOUBLE_EQ(minute.sum, (40 + 99) * 60 / 2.0);
+    EXPECT_EQ(minute.min, 40.0);
+}
+
+TEST(RollingAggregateTest, MinAndMaxFollowExpiry) {
+    rolling_config cfg;
+    cfg.windows = {3s};
+    rolling_aggregate aggregate(cfg);
+
+    const std::vector<double> series{5, 1, 4, 2, 8, 3, 3, 0};
+    std::vector<double> seen;
+    for (std::size_t i = 0; i < series.size(); ++i) {
+        add(aggregate, std::chrono::seconds(i), {series[i]});
+        seen.push_back(series[i]);
+        const auto first = seen.size() > 3 ? seen.end() - 3 : seen.begin();
+        const auto stats = aggregate.stats(0, 0);
+        EXPECT_EQ(stats.min, *std::min_element(first, seen.end())) << i;
+        EXPECT_EQ(stats.max, *std::max_element(first, seen.end())) << i;
+    }
+}
+
+TEST(RollingAggregateTest, QuantilesWithinRelativeAccuracy) {
+    rolling_config cfg;
+    cfg.windows = {1000s};
+    cfg.relative_accuracy = 0.01;
+    rolling_aggregate aggregate(cfg);
+
+    std::mt19937 rng(42);
+    std::lognormal_distribution<double> distribution(3.0, 1.0);
+    std::vector<double> values;
+    for (int i = 0; i < 2000; ++i) {
+        const double value = distribution(rng);
+        values.push_back(value);
+        add(aggregate, std::chrono::seconds(i), {value});
+    }
+
+    // Only the last 1000 samples are in the window
+    std::vector<double> window(values.end() - 1000, values.end());
+    std::sort(window.begin(), window.end());
+    for (double q : {0.0, 0.5, 0.9, 0.99, 1.0}) {
+        const double expected = window[static_cast<std::size_t>(q * 999)];
+        EXPECT_NEAR(aggregate.quantile(0, 0, q), expected, expected * 0.01) << q;
+    }
+}
+
+TEST(RollingAggregateTest, HandlesNegativeAndZeroValues) {
+    rolling_config cfg;
+    cfg.windows = {100s};
+    rolling_aggregate aggregate(cfg);
+    for (int i = 0; i < 9; ++i) {
+        add(aggregate, std::chrono::seconds(i), {static_cast<double>(i - 4)});
+    }
+    EXPECT_EQ(aggregate.quantile(0, 0, 0.0), -4.0);
+    EXPECT_EQ(aggregate.quantile(0, 0, 0.5), 0.0);
+    EXPECT_NEAR(aggregate.quantile(0, 0, 0.25), -2.0, 0.02);
+    EXPECT_EQ(aggregate.quantile(0, 0, 1.0), 4.0);
+}
+
+TEST(RollingAggregateTest, BoundedSampleRingShortensWindows) {
+    rolling_config cfg;
+    cfg.columns = 2;
+    cfg.windows = {1h};
+    cfg.max_samples = 50;
+    rolling_aggregate aggregate(cfg);
+
+    for (int i = 0; i < 200; ++i) {
+        add(aggregate, std::chrono::seconds(i), {static_cast<double>(i), 1.0});
+    }
+    const auto stats = aggregate.stats(0, 0);
+    EXPECT_EQ(stats.count, 50u);
+    EXPECT_EQ(stats.min, 150.0);
+    EXPECT_EQ(aggregate.stats(0, 1).sum, 50.0);
+}
+
+TEST(RollingAggregateTest, EmptiesAfterGap) {
+    rolling_config cfg;
+    cfg.windows = {10s};
+    rolling_aggregate aggregate(cfg);
+    add(aggregate, 0s, {100.0});
+    add(aggregate, 1s, {200.0});
+    add(aggregate, 60s, {1.0});
+
+    const auto stats = aggregate.stats(0, 0);
+    EXPECT_EQ(stats.count, 1u);
+    EXPECT_EQ(stats.sum, 1.0);
+    EXPECT_EQ(stats.max, 1.0);
+}
+
+TEST(RollingAggregateTest, EmptyWindowReportsZero) {
+    rolling_aggregate aggregate(rolling_config{});
+    EXPECT_EQ(aggregate.stats(0, 0).count, 0u);
+    EXPECT_EQ(aggregate.quantile(0, 0, 0.5), 0.0);
+    EXPECT_EQ(aggregate.stats(99, 0).count, 0u);
+
+    add(aggregate, 0s, {1.0, 2.0});  // Wrong width is ignored
+    EXPECT_EQ(aggregate.stats(0, 0).count, 0u);
+}
@@ -0,0 +1,152 @@
+/**
+ * @file test_scheduling.cpp
+ * @brief Unit tests for how the pool takes, waits on and compensates for tasks
+ */
+
+#include <gtest/gtest.h>
+#include <kcenon/integrated/unified_thread_system.h>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace kcenon::integrated;
+using namespace std::chrono_literals;
+
+namespace {
+
+std::uint64_t queue_lock_acquisitions(const unified_thread_system& system) {
+    for (const auto& lock : system.get_metrics().locks) {
+        if (lock.name == "queue") {
+            return lock.acquisitions;
+        }
+    }
+    return 0;
+}
+
+// Queue lock acquisitions spent running `tasks` tiny tasks that were all
+// queued before any worker could take one
+std::uint64_t acquisitions_for_backlog(bool batching, int tasks, std::atomic<int>& executed) {
+    unified_thread_system::config cfg;
+    cfg.thread_count = 2;
+    cfg.enable_batch_processing = batching;
+    cfg.batch_size = 16;
+    cfg.enable_lock_profiling = true;
+    cfg.enable_console_logging = false;
+    cfg.enable_file_logging = false;
+    unified_thread_system system(cfg);
+
+    // Occupy both workers, one at a time so neither batches the other's blocker
+    std::promise<void> release;
+    std::shared_future<void> released = release.get_future().share();
+    std::atomic<int> started{0};
+    for (int i = 0; i < 2; ++i) {
+        system.submit([released, &started] {
+            started.fetch_add(1);
+            released.wait();
+        });
+        while (started.load() <= i) {
+            std::this_thread::sleep_for(1ms);
+        }
+    }
+
+    const std::uint64_t before = queue_lock_acquisitions(system);
+    for (int i = 0; i < tasks; ++i) {
+        system.submit([&executed] { executed.fetch_add(1); });
+    }
+    release.set_value();
+    system.wait_for_completion();
+    EXPECT_EQ(system.get_metrics().queue_size, 0u);
+    return queue_lock_acquisitions(system) - before;
+}
+
+} // namespace
+
+TEST(BatchProcessingTest, WorkersDrainSeveralTasksPerLockAcquisition) {
+    constexpr int tasks = 500;
+
+    std::atomic<int> batched_executed{0};
+    const std::uint64_t batched = acquisitions_for_backlog(true, tasks, batched_executed);
+    std::atomic<int> single_executed{0};
+    const std::uint64_t single = acquisitions_for_backlog(false, tasks, single_executed);
+
+    EXPECT_EQ(batched_executed.load(), tasks);
+    EXPECT_EQ(single_executed.load(), tasks);
+
+    // Both pay one acquisition per submit. Taking tasks one at a time adds
+    // about one more per task; batches of up to 16 add a few dozen.
+    ASSERT_GE(single, 2u * tasks);
+    EXPECT_LT(batched, single - tasks / 2) << "batched=" << batched << " single=" << single;
+}
+
+TEST(WaitHelpingTest, NestedWaitHelpsInsteadOfBlocking) {
+    unified_thread_system::config cfg;
+    cfg.thread_count = 2;
+
+    unified_thread_system system(cfg);
+
+    // Every level blocks on its children; with only two workers this
+    // deadlocks unless waiting workers run queued tasks themselves
+    std::function<int(int)> sum_tree = [&](int depth) -> int {
+        if (depth == 0) {
+            return 1;
+        }
+
+        std::vector<std::future<int>> children;
+        for (int i = 0; i < 4; ++i) {
+            children.push_back(system.submit(sum_tree, depth - 1));
+        }
+
+        int total = 0;
+        for (auto& child : children) {
+            total += system.wait(child);
+        }
+        return total;
+    };
+
+    auto root = system.submit(sum_tree, 4);
+    ASSERT_EQ(root.wait_for(30s), std::future_status::ready);
+    EXPECT_EQ(system.wait(root), 256);
+
+    auto failing = system.submit([]() -> int { throw std::runtime_error("child failed"); });
+    auto parent = system.submit([&]() { return system.wait(failing); });
+    EXPECT_THROW(parent.get(), std::runtime_error);
+}
+
+TEST(BlockingSectionTest, BlockingSectionsAreCompensated) {
+    unified_thread_system::config cfg;
+    cfg.thread_count = 2;
+
+    unified_thread_system system(cfg);
+
+    std::promise<void> release;
+    std::shared_future<void> released = release.get_future().share();
+
+    // Both base workers block; the releasing task only runs on a compensator
+    std::vector<std::future<int>> blocked;
+    for (int i = 0; i < 2; ++i) {
+        blocked.push_back(system.submit_blocking([released, i]() {
+            released.wait();
+            return i;
+        }));
+    }
+    while (system.get_metrics().blocked_workers < 2) {
+        std::this_thread::sleep_for(1ms);
+    }
+
+    auto releaser = system.submit([&release]() { release.set_value(); });
+    ASSERT_EQ(releaser.wait_for(10s), std::future_status::ready);
+
+    for (int i = 0; i < 2; ++i) {
+        EXPECT_EQ(blocked[i].get(), i);
+    }
+    EXPECT_EQ(system.get_metrics().blocked_workers, 0u);
+    EXPECT_EQ(system.worker_count(), 2u);
+
+    // Outside the pool the section just runs inline
+    EXPECT_EQ(system.blocking_section([]() { return 7; }), 7);
+}
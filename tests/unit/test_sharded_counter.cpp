@@ -0,0 +1,51 @@
+/**
+ * @file test_sharded_counter.cpp
+ * @brief Unit tests for the cache-line-sharded counter
+ */
+
+#include <gtest/gtest.h>
+#include <kcenon/integrated/core/sharded_counter.h>
+#include <thread>
+#include <vector>
+
+using namespace kcenon::integrated;
+
+TEST(ShardedCounterTest, ShardCountRoundsUpToPowerOfTwo) {
+    EXPECT_EQ(sharded_counter(1).shard_count(), 1u);
+    EXPECT_EQ(sharded_counter(3).shard_count(), 4u);
+    EXPECT_EQ(sharded_counter(64).shard_count(), 64u);
+    EXPECT_GE(sharded_counter().shard_count(), 1u);
+}
+
+TEST(ShardedCounterTest, AddAndReset) {
+    sharded_counter counter(4);
+    EXPECT_EQ(counter.value(), 0u);
+
+    ++counter;
+    counter.add(41);
+    EXPECT_EQ(counter.value(), 42u);
+
+    counter.reset();
+    EXPECT_EQ(counter.value(), 0u);
+}
+
+TEST(ShardedCounterTest, ConcurrentIncrementsAreAllCounted) {
+    constexpr int thread_count = 8;
+    constexpr int per_thread = 50000;
+
+    // Fewer shards than threads, so some threads share a slot
+    sharded_counter counter(4);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < thread_count; ++t) {
+        threads.emplace_back([&counter] {
+            for (int i = 0; i < per_thread; ++i) {
+                ++counter;
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    EXPECT_EQ(counter.value(), static_cast<std::uint64_t>(thread_count) * per_thread);
+}
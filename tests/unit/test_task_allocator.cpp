@@ -0,0 +1,160 @@
+/**
+ * @file test_task_allocator.cpp
+ * @brief Unit tests for the pooled task allocator
+ */
+
+#include <gtest/gtest.h>
+#include <kcenon/integrated/unified_thread_system.h>
+#include <kcenon/integrated/core/task_allocator.h>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace kcenon::integrated;
+
+TEST(TaskAllocatorTest, ReusesFreedBlocksOnSameThread) {
+    void* first = detail::pool_allocate(48);
+    ASSERT_NE(first, nullptr);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(first) % detail::pool_block_alignment, 0u);
+    detail::pool_deallocate(first, 48);
+
+    void* second = detail::pool_allocate(60);
+    EXPECT_EQ(first, second);
+    detail::pool_deallocate(second, 60);
+}
+
+TEST(TaskAllocatorTest, SizeClassesDoNotOverlap) {
+    std::vector<std::pair<void*, std::size_t>> blocks;
+    for (std::size_t size : {1u, 64u, 65u, 200u, 512u, 1000u, 1024u}) {
+        void* block = detail::pool_allocate(size);
+        std::memset(block, 0xAB, size);
+        blocks.emplace_back(block, size);
+    }
+
+    for (std::size_t i = 0; i < blocks.size(); ++i) {
+        for (std::size_t j = i + 1; j < blocks.size(); ++j) {
+            EXPECT_NE(blocks[i].first, blocks[j].first);
+        }
+    }
+
+    for (auto& [block, size] : blocks) {
+        detail::pool_deallocate(block, size);
+    }
+}
+
+TEST(TaskAllocatorTest, OversizeRequestsFallBack) {
+    auto before = get_task_allocator_stats();
+
+    void* block = detail::pool_allocate(detail::pool_max_block_size + 1);
+    ASSERT_NE(block, nullptr);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(block) % detail::pool_block_alignment, 0u);
+    detail::pool_deallocate(block, detail::pool_max_block_size + 1);
+
+    auto after = get_task_allocator_stats();
+    EXPECT_EQ(after.oversize_allocations, before.oversize_allocations + 1);
+}
+
+TEST(TaskAllocatorTest, OverAlignedTypesStayAlignedPastTheLargestClass) {
+    struct alignas(64) cache_line_state {
+        std::byte bytes[2 * detail::pool_max_block_size];
+    };
+    static_assert(alignof(cache_line_state) > __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+
+    detail::pool_allocator<cache_line_state> allocator;
+    for (std::size_t n : {1u, 3u}) {
+        cache_line_state* states = allocator.allocate(n);
+        EXPECT_EQ(reinterpret_cast<std::uintptr_t>(states) % alignof(cache_line_state), 0u) << "n=" << n;
+        allocator.deallocate(states, n);
+    }
+}
+
+TEST(TaskAllocatorTest, CrossThreadFreesReturnToOwner) {
+    constexpr std::size_t count = 256;
+    std::vector<void*> blocks;
+    for (std::size_t i = 0; i < count; ++i) {
+        blocks.push_back(detail::pool_allocate(128));
+    }
+
+    auto before = get_task_allocator_stats();
+
+    std::thread consumer([&blocks] {
+        for (void* block : blocks) {
+            detail::pool_deallocate(block, 128);
+        }
+        detail::pool_flush_thread();
+    });
+    consumer.join();
+
+    auto after = get_task_allocator_stats();
+    EXPECT_EQ(after.remote_deallocations - before.remote_deallocations, count);
+    EXPECT_LT(after.remote_batches - before.remote_batches, count);
+
+    // The owner drains the returned blocks instead of carving a new slab
+    std::vector<void*> reused;
+    for (std::size_t i = 0; i < count; ++i) {
+        reused.push_back(detail::pool_allocate(128));
+    }
+    EXPECT_EQ(get_task_allocator_stats().slabs, after.slabs);
+
+    for (void* block : reused) {
+        detail::pool_deallocate(block, 128);
+    }
+}
+
+TEST(TaskAllocatorTest, ExitedThreadCachesAreAdopted) {
+    auto spawn = [] {
+        std::thread([] {
+            detail::pool_deallocate(detail::pool_allocate(64), 64);
+        }).join();
+    };
+
+    spawn();
+    const auto caches = get_task_allocator_stats().thread_caches;
+    for (int i = 0; i < 8; ++i) {
+        spawn();
+    }
+    EXPECT_EQ(get_task_allocator_stats().thread_caches, caches);
+}
+
+TEST(TaskAllocatorTest, SubmitPathUsesPool) {
+    unified_thread_system::config cfg;
+    cfg.thread_count = 2;
+    unified_thread_system system(cfg);
+
+    auto before = get_task_allocator_stats();
+
+    std::vector<std::future<int>> futures;
+    for (int i = 0; i < 100; ++i) {
+        futures.push_back(system.submit([i]() { return i * 2; }));
+    }
+    for (int i = 0; i < 100; ++i) {
+        EXPECT_EQ(futures[i].get(), i * 2);
+    }
+
+    auto after = get_task_allocator_stats();
+    EXPECT_GE(after.allocations - before.allocations, 200u);  // Task + shared state each
+}
+
+TEST(TaskAllocatorTest, PooledTaskPropagatesExceptions) {
+    unified_thread_system system;
+
+    auto future = system.submit([]() -> std::string {
+        throw std::runtime_error("pooled failure");
+    });
+
+    EXPECT_THROW(future.get(), std::runtime_error);
+}
+
+TEST(TaskAllocatorTest, DroppedTaskBreaksPromise) {
+    std::future<int> future;
+    {
+        auto task = detail::make_pooled_task<int>([]() { return 1; });
+        future = std::move(task.future);
+    }
+
+    EXPECT_THROW(future.get(), std::future_error);
+}
@@ -0,0 +1,124 @@
+/**
+ * @file test_task_latency.cpp
+ * @brief Unit tests for the queue-wait / execution latency breakdown
+ */
+
+#include <gtest/gtest.h>
+#include <kcenon/integrated/unified_thread_system.h>
+#include <kcenon/integrated/core/prometheus_writer.h>
+#include <kcenon/integrated/core/task_latency.h>
+#include <algorithm>
+#include <chrono>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+using namespace kcenon::integrated;
+using namespace std::chrono_literals;
+
+namespace {
+
+const lane_latency* find_lane(const std::vector<lane_latency>& lanes, const std::string& name) {
+    auto it = std::find_if(lanes.begin(), lanes.end(),
+                           [&](const lane_latency& lane) { return lane.lane == name; });
+    return it == lanes.end() ? nullptr : &*it;
+}
+
+} // namespace
+
+TEST(TaskLatencyTest, PriorityLanesFollowNamedLevels) {
+    EXPECT_EQ(priority_lane(static_cast<int>(priority_level::lowest)), 0u);
+    EXPECT_EQ(priority_lane(static_cast<int>(priority_level::normal)), 2u);
+    EXPECT_EQ(priority_lane(static_cast<int>(priority_level::critical)), 5u);
+
+    // Between two levels belongs to the lower one
+    EXPECT_EQ(priority_lane(60), priority_lane(static_cast<int>(priority_level::normal)));
+    EXPECT_EQ(priority_lane(-5), 0u);
+    EXPECT_EQ(priority_lane(1000), priority_lane_count - 1);
+
+    EXPECT_STREQ(priority_lane_name(priority_lane(75)), "high");
+}
+
+TEST(TaskLatencyTest, RecordsEachStagePerLane) {
+    task_latency_recorder recorder;
+    recorder.record(static_cast<int>(priority_level::high), 3000ns, 1000ns);
+    recorder.record(static_cast<int>(priority_level::high), 5000ns, 1000ns);
+    recorder.record(static_cast<int>(priority_level::low), 0ns, 7000ns);
+
+    auto snapshot = recorder.snapshot();
+    auto lanes = snapshot.lanes();
+    ASSERT_EQ(lanes.size(), 2u);
+    EXPECT_EQ(lanes[0].lane, "low");  // Lowest first
+    EXPECT_EQ(lanes[1].lane, "high");
+
+    const auto& high = lanes[1];
+    EXPECT_EQ(high.queue_wait.count, 2u);
+    EXPECT_EQ(high.queue_wait.max, 5000ns);
+    EXPECT_EQ(high.execution.mean, 1000ns);
+    EXPECT_EQ(high.end_to_end.sum, 10000ns);
+
+    EXPECT_EQ(snapshot.total_execution().count(), 3u);
+    EXPECT_EQ(snapshot.total_execution().max(), 7000ns);
+    EXPECT_EQ(snapshot.total_queue_wait().sum(), 8000ns);
+}
+
+TEST(TaskLatencyTest, ExportFormats) {
+    task_latency_recorder recorder;
+    recorder.record(static_cast<int>(priority_level::normal), 2000ns, 1000ns);
+    const auto snapshot = recorder.snapshot();
+    auto lanes = snapshot.lanes();
+
+    prometheus_writer prometheus;
+    write_latency_prometheus(prometheus, "pool", snapshot);
+    const std::string text(prometheus.finish());
+    EXPECT_NE(text.find("# TYPE task_queue_wait_seconds histogram"), std::string::npos);
+    EXPECT_NE(text.find("task_execution_seconds_bucket{pool=\"pool\",priority=\"normal\",le=\"1e-05\"} 1"),
+              std::string::npos);
+    EXPECT_NE(text.find("task_end_to_end_seconds_count{pool=\"pool\",priority=\"normal\"} 1"),
+              std::string::npos);
+    EXPECT_EQ(text.find("priority=\"high\""), std::string::npos);  // Empty lanes are skipped
+
+    std::ostringstream json;
+    write_latency_json(json, lanes);
+    EXPECT_NE(json.str().find("\"normal\""), std::string::npos);
+    EXPECT_NE(json.str().find("\"queue_wait\": {\"count\": 1"), std::string::npos);
+
+    std::ostringstream empty;
+    write_latency_json(empty, {});
+    EXPECT_EQ(empty.str(), "{}");
+}
+
+TEST(TaskLatencyTest, SystemSeparatesQueueWaitFromExecution) {
+    unified_thread_system::config cfg;
+    cfg.thread_count = 1;
+    unified_thread_system system(cfg);
+
+    // One worker and tasks that each run ~2ms: later tasks queue behind earlier ones
+    std::vector<std::future<void>> futures;
+    for (int i = 0; i < 5; ++i) {
+        futures.push_back(system.submit_with_priority(priority_level::high, [] {
+            std::this_thread::sleep_for(2ms);
+        }));
+    }
+    futures.push_back(system.submit([] {}));
+    for (auto& future : futures) {
+        future.get();
+    }
+    system.wait_for_completion();
+
+    auto metrics = system.get_metrics();
+    EXPECT_EQ(metrics.execution_latency.count, 6u);
+    EXPECT_EQ(metrics.queue_wait_latency.count, 6u);
+    EXPECT_GE(metrics.queue_wait_latency.max, 2ms);
+    EXPECT_GE(metrics.end_to_end_latency.max, metrics.execution_latency.max);
+    EXPECT_EQ(metrics.execution_latency.p99, metrics.p99_latency);
+
+    const auto* high = find_lane(metrics.lane_latencies, "high");
+    ASSERT_NE(high, nullptr);
+    EXPECT_EQ(high->execution.count, 5u);
+    EXPECT_GE(high->execution.p50, 1ms);
+    ASSERT_NE(find_lane(metrics.lane_latencies, "normal"), nullptr);
+
+    EXPECT_NE(system.export_metrics_prometheus().find("task_queue_wait_seconds"), std::string::npos);
+    EXPECT_NE(system.export_metrics_json().find("latency_by_lane"), std::string::npos);
+}
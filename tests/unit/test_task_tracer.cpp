@@ -0,0 +1,204 @@
+/**
+ * @file test_task_tracer.cpp
+ * @brief Unit tests for sampled task tracing and its Chrome trace export
+ */
+
+#include <gtest/gtest.h>
+#include <kcenon/integrated/unified_thread_system.h>
+#include <kcenon/integrated/core/task_tracer.h>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace kcenon::integrated;
+using namespace std::chrono_literals;
+
+namespace {
+
+trace_config always_sample() {
+    trace_config cfg;
+    cfg.sample_rate = 1.0;
+    return cfg;
+}
+
+size_t count(const std::string& text, const std::string& needle) {
+    size_t found = 0;
+    for (auto pos = text.find(needle); pos != std::string::npos; pos = text.find(needle, pos + 1)) {
+        ++found;
+    }
+    return found;
+}
+
+} // namespace
+
+TEST(TaskTracerTest, ZeroSampleRateTracesNothing) {
+    trace_config cfg;
+    cfg.sample_rate = 0.0;
+    task_tracer tracer(cfg);
+
+    EXPECT_EQ(tracer.sample(), 0u);
+    tracer.record(trace_event::start, 0, task_tracer::clock::now());
+
+    const auto json = tracer.chrome_json();
+    EXPECT_EQ(json.find("\"ph\":\"X\""), std::string::npos);
+    EXPECT_NE(json.find("\"traceEvents\":["), std::string::npos);
+}
+
+TEST(TaskTracerTest, SampleRateIsRespected) {
+    trace_config cfg;
+    cfg.sample_rate = 0.25;
+    task_tracer tracer(cfg);
+
+    size_t sampled = 0;
+    for (int i = 0; i < 100000; ++i) {
+        if (tracer.sample() != 0) {
+            ++sampled;
+        }
+    }
+    EXPECT_GT(sampled, 23000u);
+    EXPECT_LT(sampled, 27000u);
+}
+
+TEST(TaskTracerTest, ExportsTaskLifecycle) {
+    trace_config cfg = always_sample();
+    cfg.process_name = "pool \"a\"";
+    task_tracer tracer(cfg);
+    tracer.name_thread("submitter");
+
+    const auto base = task_tracer::clock::now();
+    const auto id = tracer.sample();
+    ASSERT_NE(id, 0u);
+    tracer.record(trace_event::submit, id, base);
+    tracer.record(trace_event::enqueue, id, base + 2us);
+
+    std::thread worker([&] {
+        tracer.name_thread("worker 0");
+        tracer.record(trace_event::steal, id, base + 9us, 3);
+        tracer.record(trace_event::start, id, base + 10us, 2);
+        tracer.record(trace_event::end, id, base + 25us);
+    });
+    worker.join();
+
+    const auto json = tracer.chrome_json();
+    EXPECT_NE(json.find("\"name\":\"pool \\\"a\\\"\""), std::string::npos);
+    EXPECT_NE(json.find("\"args\":{\"name\":\"submitter\"}"), std::string::npos);
+    EXPECT_NE(json.find("\"args\":{\"name\":\"worker 0\"}"), std::string::npos);
+
+    EXPECT_NE(json.find("\"ph\":\"X\",\"name\":\"submit\",\"cat\":\"task\",\"pid\":1,\"tid\":1"), std::string::npos);
+    EXPECT_NE(json.find("\"ph\":\"X\",\"name\":\"task\",\"cat\":\"task\",\"pid\":1,\"tid\":2"), std::string::npos);
+    EXPECT_NE(json.find("\"dur\":15.000"), std::string::npos);
+    EXPECT_NE(json.find("\"priority\":2,\"queue_wait_us\":8.000"), std::string::npos);
+    EXPECT_NE(json.find("\"name\":\"steal\""), std::string::npos);
+    EXPECT_NE(json.find("\"victim\":3"), std::string::npos);
+
+    // Flow arrow and queued span, each opened and closed
+    EXPECT_EQ(count(json, "\"ph\":\"s\""), 1u);
+    EXPECT_EQ(count(json, "\"ph\":\"f\""), 1u);
+    EXPECT_EQ(count(json, "\"ph\":\"b\""), 1u);
+    EXPECT_EQ(count(json, "\"ph\":\"e\""), 1u);
+    EXPECT_EQ(json.substr(json.size() - 4), "\n]}\n");
+    EXPECT_EQ(count(json, "{"), count(json, "}"));
+}
+
+TEST(TaskTracerTest, UnfinishedRunsAreNotExported) {
+    task_tracer tracer(always_sample());
+    const auto id = tracer.sample();
+    tracer.record(trace_event::start, id, task_tracer::clock::now());
+
+    EXPECT_EQ(tracer.chrome_json().find("\"name\":\"task\""), std::string::npos);
+}
+
+TEST(TaskTracerTest, FullRingOverwritesOldestEvents) {
+    trace_config cfg = always_sample();
+    cfg.events_per_thread = 16;
+    task_tracer tracer(cfg);
+
+    const auto base = task_tracer::clock::now();
+    for (int i = 0; i < 50; ++i) {
+        const auto id = tracer.sample();
+        tracer.record(trace_event::start, id, base + std::chrono::microseconds(i * 10));
+        tracer.record(trace_event::end, id, base + std::chrono::microseconds(i * 10 + 5));
+    }
+
+    EXPECT_EQ(tracer.overwritten(), 84u);
+    EXPECT_EQ(count(tracer.chrome_json(), "\"name\":\"task\""), 8u);
+}
+
+TEST(TaskTracerTest, ExportWhileRecording) {
+    trace_config cfg = always_sample();
+    cfg.events_per_thread = 256;
+    task_tracer tracer(cfg);
+
+    std::atomic<bool> stop{false};
+    std::vector<std::thread> writers;
+    for (int t = 0; t < 4; ++t) {
+        writers.emplace_back([&] {
+            while (!stop.load(std::memory_order_relaxed)) {
+                const auto id = tracer.sample();
+                tracer.record(trace_event::start, id, task_tracer::clock::now());
+                tracer.record(trace_event::end, id, task_tracer::clock::now());
+            }
+        });
+    }
+
+    // Keep exporting until the rings have wrapped many times under the reader
+    const auto deadline = std::chrono::steady_clock::now() + 5s;
+    while (tracer.overwritten() < 100000 && std::chrono::steady_clock::now() < deadline) {
+        const auto json = tracer.chrome_json();
+        EXPECT_EQ(json.substr(json.size() - 4), "\n]}\n");
+    }
+    stop = true;
+    for (auto& writer : writers) {
+        writer.join();
+    }
+    EXPECT_GE(tracer.overwritten(), 100000u);
+}
+
+TEST(TaskTracerTest, SystemTracesSubmittedTasks) {
+    unified_thread_system::config cfg;
+    cfg.name = "traced";
+    cfg.thread_count = 2;
+    cfg.enable_console_logging = false;
+    cfg.enable_tracing = true;
+    cfg.trace_sample_rate = 1.0;
+    unified_thread_system system(cfg);
+
+    std::vector<std::future<int>> futures;
+    for (int i = 0; i < 20; ++i) {
+        futures.push_back(system.submit([i] { return i; }));
+    }
+    for (auto& future : futures) {
+        future.get();
+    }
+    system.wait_for_completion();
+
+    const auto json = system.export_trace_json();
+    EXPECT_NE(json.find("\"args\":{\"name\":\"traced\"}"), std::string::npos);
+    EXPECT_NE(json.find("\"args\":{\"name\":\"worker 0\"}"), std::string::npos);
+    EXPECT_EQ(count(json, "\"name\":\"task\",\"cat\":\"task\",\"pid\":1"), 20u + 2 * 20u);
+    EXPECT_EQ(count(json, "\"name\":\"submit\""), 20u);
+
+    const std::string path = ::testing::TempDir() + "task_tracer_test.json";
+    system.export_trace(path);
+    std::ifstream file(path);
+    std::stringstream written;
+    written << file.rdbuf();
+    EXPECT_NE(written.str().find("\"traceEvents\""), std::string::npos);
+    std::remove(path.c_str());
+}
+
+TEST(TaskTracerTest, SystemWithoutTracingThrows) {
+    unified_thread_system::config cfg;
+    cfg.thread_count = 1;
+    cfg.enable_console_logging = false;
+    unified_thread_system system(cfg);
+
+    EXPECT_THROW(system.export_trace_json(), std::runtime_error);
+    EXPECT_THROW(system.export_trace("unused.json"), std::runtime_error);
+}
@@ -0,0 +1,268 @@
+/**
+ * @file test_timeseries_store.cpp
+ * @brief Unit tests for the compressed time-series store
+ */
+
+#include <gtest/gtest.h>
+#include <kcenon/integrated/core/timeseries_store.h>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <vector>
+
+using namespace kcenon::integrated;
+using namespace std::chrono_literals;
+
+namespace {
+
+using time_point = timeseries_store::clock::time_point;
+
+// Aligned to a minute so rollup buckets start at epoch
+const time_point epoch = time_point(std::chrono::duration_cast<timeseries_store::clock::duration>(
+    std::chrono::milliseconds(1'699'999'980'000)));
+
+struct sample {
+    time_point timestamp;
+    std::vector<double> values;
+};
+
+std::vector<sample> scan_all(const timeseries_store& store, time_point from, time_point to) {
+    std::vector<sample> samples;
+    store.scan(from, to, [&](time_point timestamp, std::span<const double> values) {
+        samples.push_back({timestamp, {values.begin(), values.end()}});
+    });
+    return samples;
+}
+
+std::vector<sample> scan_resolution(const timeseries_store& store, std::size_t resolution) {
+    std::vector<sample> samples;
+    store.scan(resolution, time_point::min(), time_point::max(),
+               [&](time_point timestamp, std::span<const double> values) {
+                   samples.push_back({timestamp, {values.begin(), values.end()}});
+               });
+    return samples;
+}
+
+} // namespace
+
+TEST(TimeseriesStoreTest, RoundTripsSamplesExactly) {
+    timeseries_config cfg;
+    cfg.columns = 3;
+    cfg.rollups.clear();
+    timeseries_store store(cfg);
+
+    std::vector<sample> written;
+    for (int i = 0; i < 1000; ++i) {
+        // Steady interval with occasional jitter; constant, integer and noisy columns
+        const auto timestamp = epoch + std::chrono::milliseconds(i * 1000 + (i % 7 == 0 ? 3 : 0));
+        std::vector<double> values{42.0, static_cast<double>(i / 10), std::sin(i * 0.1) * 1e6};
+        store.append(timestamp, values);
+        written.push_back({timestamp, values});
+    }
+
+    const auto read = scan_all(store, time_point::min(), time_point::max());
+    ASSERT_EQ(read.size(), written.size());
+    for (std::size_t i = 0; i < read.size(); ++i) {
+        EXPECT_EQ(read[i].timestamp, written[i].timestamp) << i;
+        EXPECT_EQ(read[i].values, written[i].values) << i;
+    }
+    EXPECT_EQ(store.size(), 1000u);
+    EXPECT_EQ(store.oldest(), written.front().timestamp);
+}
+
+TEST(TimeseriesStoreTest, CompressesSteadySeries) {
+    timeseries_config cfg;
+    cfg.columns = 20;
+    cfg.capacity_bytes = 64 * 1024;
+    cfg.rollups.clear();
+    timeseries_store store(cfg);
+
+    // Mostly unchanged values at a fixed interval cost about one bit per field
+    std::vector<double> values(20, 1.0);
+    for (int i = 0; i < 10000; ++i) {
+        values[0] = static_cast<double>(i % 4);
+        store.append(epoch + std::chrono::seconds(i), values);
+    }
+    EXPECT_EQ(store.size(), 10000u);
+    EXPECT_LT(store.capacity_bytes(), 10000u * 20 * sizeof(double) / 10);
+}
+
+TEST(TimeseriesStoreTest, OverwritesOldestBlocksWhenFull) {
+    timeseries_config cfg;
+    cfg.columns = 2;
+    cfg.capacity_bytes = 4 * 512;
+    cfg.block_bytes = 512;
+    cfg.rollups.clear();
+    timeseries_store store(cfg);
+
+    const int total = 5000;
+    for (int i = 0; i < total; ++i) {
+        store.append(epoch + std::chrono::milliseconds(i * 10),
+                     std::vector<double>{static_cast<double>(i), i * 0.5});
+    }
+
+    const auto read = scan_all(store, time_point::min(), time_point::max());
+    ASSERT_FALSE(read.empty());
+    EXPECT_LT(read.size(), static_cast<std::size_t>(total));
+    EXPECT_EQ(read.size(), store.size());
+    EXPECT_EQ(read.back().values[0], total - 1.0);
+    EXPECT_EQ(read.front().timestamp, store.oldest());
+    for (std::size_t i = 1; i < read.size(); ++i) {
+        EXPECT_EQ(read[i].values[0], read[i - 1].values[0] + 1.0);
+    }
+}
+
+TEST(TimeseriesStoreTest, OddBlockSizesRoundTrip) {
+    // Rounded up so that every block header stays aligned
+    timeseries_config cfg;
+    cfg.columns = 3;
+    cfg.capacity_bytes = 64 * 1024;
+    cfg.block_bytes = 301;
+    cfg.rollups.clear();
+    timeseries_store store(cfg);
+
+    const int total = 2000;
+    for (int i = 0; i < total; ++i) {
+        store.append(epoch + std::chrono::seconds(i),
+                     std::vector<double>{static_cast<double>(i), std::sqrt(i), -i * 0.25});
+    }
+
+    const auto read = scan_all(store, time_point::min(), time_point::max());
+    ASSERT_EQ(read.size(), static_cast<std::size_t>(total));
+    for (int i = 0; i < total; ++i) {
+        EXPECT_EQ(read[i].values[0], static_cast<double>(i));
+        EXPECT_EQ(read[i].values[1], std::sqrt(i));
+        EXPECT_EQ(read[i].values[2], -i * 0.25);
+    }
+}
+
+TEST(TimeseriesStoreTest, ScansOnlyTheRequestedWindow) {
+    timeseries_config cfg;
+    cfg.rollups.clear();
+    cfg.block_bytes = 256;
+    timeseries_store store(cfg);
+
+    for (int i = 0; i < 2000; ++i) {
+        store.append(epoch + std::chrono::seconds(i), std::vector<double>{static_cast<double>(i)});
+    }
+
+    const auto read = scan_all(store, epoch + 100s, epoch + 199s);
+    ASSERT_EQ(read.size(), 100u);
+    EXPECT_EQ(read.front().values[0], 100.0);
+    EXPECT_EQ(read.back().values[0], 199.0);
+}
+
+TEST(TimeseriesStoreTest, ClampsOutOfOrderTimestamps) {
+    timeseries_store store(timeseries_config{});
+    store.append(epoch + 10s, std::vector<double>{1.0});
+    store.append(epoch + 5s, std::vector<double>{2.0});
+
+    const auto read = scan_all(store, time_point::min(), time_point::max());
+    ASSERT_EQ(read.size(), 2u);
+    EXPECT_EQ(read[1].timestamp, epoch + 10s);
+    EXPECT_EQ(read[1].values[0], 2.0);
+}
+
+TEST(TimeseriesStoreTest, DownsamplesIntoRollups) {
+    timeseries_config cfg;
+    cfg.rollups = {{10s, 4096}, {60s, 4096}};
+    timeseries_store store(cfg);
+    ASSERT_EQ(store.resolutions(), 3u);
+
+    for (int i = 0; i < 125; ++i) {
+        store.append(epoch + std::chrono::seconds(i), std::vector<double>{static_cast<double>(i)});
+    }
+
+    // Complete buckets only; the one being filled is not emitted yet
+    const auto tens = scan_resolution(store, 1);
+    ASSERT_EQ(tens.size(), 12u);
+    EXPECT_EQ(tens[0].timestamp, epoch);
+    EXPECT_DOUBLE_EQ(tens[0].values[0], 4.5);
+    EXPECT_DOUBLE_EQ(tens[11].values[0], 114.5);
+
+    const auto minutes = scan_resolution(store, 2);
+    ASSERT_EQ(minutes.size(), 2u);
+    EXPECT_DOUBLE_EQ(minutes[0].values[0], 29.5);
+    EXPECT_DOUBLE_EQ(minutes[1].values[0], 89.5);
+}
+
+TEST(TimeseriesStoreTest, FallsBackToRollupsForOldRanges) {
+    timeseries_config cfg;
+    cfg.capacity_bytes = 2 * 256;
+    cfg.block_bytes = 256;
+    cfg.rollups = {{60s, 64 * 1024}};
+    timeseries_store store(cfg);
+
+    const int total = 3600;
+    for (int i = 0; i < total; ++i) {
+        store.append(epoch + std::chrono::seconds(i), std::vector<double>{static_cast<double>(i % 60)});
+    }
+    ASSERT_GT(store.oldest(0), epoch);
+
+    // Minute averages up to the newest complete bucket, raw samples after it
+    const auto read = scan_all(store, epoch, epoch + std::chrono::seconds(total));
+    ASSERT_FALSE(read.empty());
+    EXPECT_EQ(read.front().timestamp, epoch);
+    EXPECT_DOUBLE_EQ(read.front().values[0], 29.5);
+    EXPECT_EQ(read.back().timestamp, epoch + std::chrono::seconds(total - 1));
+    for (std::size_t i = 1; i < read.size(); ++i) {
+        EXPECT_LT(read[i - 1].timestamp, read[i].timestamp);
+    }
+    EXPECT_LT(read.size(), static_cast<std::size_t>(total));
+}
+
+TEST(TimeseriesStoreTest, PersistsThroughMappedFile) {
+    const auto path = (std::filesystem::temp_directory_path() / "integrated_timeseries_test.bin").string();
+    std::filesystem::remove(path);
+
+    timeseries_config cfg;
+    cfg.columns = 2;
+    cfg.capacity_bytes = 16 * 1024;
+    cfg.rollups = {{10s, 4096}};
+    cfg.path = path;
+
+    {
+        timeseries_store store(cfg);
+#if defined(_WIN32)
+        EXPECT_FALSE(store.persistent());
+        return;
+#endif
+        ASSERT_TRUE(store.persistent());
+        EXPECT_EQ(std::filesystem::file_size(path), store.capacity_bytes());
+        for (int i = 0; i < 500; ++i) {
+            store.append(epoch + std::chrono::seconds(i), std::vector<double>{i * 1.5, 7.0});
+        }
+    }
+
+    {
+        // Reopening resumes after the last sample
+        timeseries_store store(cfg);
+        EXPECT_EQ(store.size(), 500u);
+        for (int i = 500; i < 600; ++i) {
+            store.append(epoch + std::chrono::seconds(i), std::vector<double>{i * 1.5, 7.0});
+        }
+        const auto read = scan_resolution(store, 0);
+        ASSERT_EQ(read.size(), 600u);
+        for (int i = 0; i < 600; ++i) {
+            EXPECT_EQ(read[i].values[0], i * 1.5) << i;
+        }
+    }
+
+    {
+        // A different layout starts over
+        cfg.columns = 3;
+        timeseries_store store(cfg);
+        EXPECT_TRUE(store.persistent());
+        EXPECT_EQ(store.size(), 0u);
+    }
+    std::filesystem::remove(path);
+}
+
+TEST(TimeseriesStoreTest, IgnoresSamplesOfTheWrongWidth) {
+    timeseries_config cfg;
+    cfg.columns = 2;
+    timeseries_store store(cfg);
+    store.append(epoch, std::vector<double>{1.0});
+    EXPECT_EQ(store.size(), 0u);
+    EXPECT_TRUE(scan_all(store, time_point::min(), time_point::max()).empty());
+}
@@ -0,0 +1,267 @@
+/**
+ * @file test_work_stealing.cpp
+ * @brief Unit tests for worker-local queues and work stealing
+ *
+ * Links the enhanced implementation, whose own pool keeps a local queue per
+ * worker. Tasks submitted from a worker go to that queue; the owner runs them
+ * newest first, idle peers steal them oldest first.
+ */
+
+#include <gtest/gtest.h>
+#include <kcenon/integrated/unified_thread_system.h>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace kcenon::integrated;
+using namespace std::chrono_literals;
+
+namespace {
+
+// Matches local_fairness_interval in the enhanced implementation
+constexpr size_t local_fairness_interval = 32;
+
+unified_thread_system::config pool_config(size_t threads) {
+    unified_thread_system::config cfg;
+    cfg.name = "stealing";
+    cfg.thread_count = threads;
+    cfg.enable_console_logging = false;
+    cfg.enable_file_logging = false;
+    return cfg;
+}
+
+// Records which tasks ran, in order, and on which thread
+class run_log {
+public:
+    void add(const std::string& name) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        names_.push_back(name);
+        threads_.push_back(std::this_thread::get_id());
+    }
+
+    std::vector<std::string> names() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return names_;
+    }
+
+    std::vector<std::thread::id> threads() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return threads_;
+    }
+
+    size_t size() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return names_.size();
+    }
+
+private:
+    mutable std::mutex mutex_;
+    std::vector<std::string> names_;
+    std::vector<std::thread::id> threads_;
+};
+
+void wait_until(const std::atomic<bool>& flag) {
+    const auto until = std::chrono::steady_clock::now() + 5s;
+    while (!flag.load() && std::chrono::steady_clock::now() < until) {
+        std::this_thread::sleep_for(1ms);
+    }
+}
+
+} // namespace
+
+TEST(WorkStealingTest, NestedSubmitBecomesTheNextTask) {
+    unified_thread_system system(pool_config(1));
+    run_log log;
+    std::atomic<bool> started{false};
+    std::atomic<bool> go{false};
+
+    system.submit([&] {
+        started = true;
+        wait_until(go);
+        system.submit([&] { log.add("first"); });
+        system.submit([&] { log.add("second"); });
+    });
+
+    // Queued globally while the only worker is busy, before the nested tasks exist
+    wait_until(started);
+    system.submit([&] { log.add("external"); });
+    go = true;
+
+    ASSERT_TRUE(system.wait_for_completion_timeout(5s));
+    // The newest nested task sits in the next-task slot, ahead of the local
+    // queue, and both run before the global queue is looked at again
+    EXPECT_EQ(log.names(), (std::vector<std::string>{"second", "first", "external"}));
+}
+
+TEST(WorkStealingTest, IdleWorkerStealsTheOldestLocalTask) {
+    unified_thread_system system(pool_config(2));
+    run_log log;
+    std::atomic<bool> release{false};
+    std::thread::id owner;
+
+    system.submit([&] {
+        owner = std::this_thread::get_id();
+        for (const char* name : {"a", "b", "c"}) {
+            system.submit([&log, name] { log.add(name); });
+        }
+        // Stays busy, without helping, until the peer has stolen everything
+        const auto until = std::chrono::steady_clock::now() + 5s;
+        while (log.size() < 3 && std::chrono::steady_clock::now() < until) {
+            std::this_thread::sleep_for(1ms);
+        }
+        release = true;
+    });
+
+    wait_until(release);
+    ASSERT_TRUE(system.wait_for_completion_timeout(5s));
+    EXPECT_EQ(log.names(), (std::vector<std::string>{"a", "b", "c"}));
+    for (const auto& thread : log.threads()) {
+        EXPECT_NE(thread, owner);
+    }
+}
+
+TEST(WorkStealingTest, GlobalQueueIsCheckedAfterTheFairnessInterval) {
+    unified_thread_system system(pool_config(1));
+    run_log log;
+    std::atomic<bool> started{false};
+    std::atomic<bool> go{false};
+
+    system.submit([&] {
+        started = true;
+        wait_until(go);
+        for (size_t i = 0; i < local_fairness_interval + 8; ++i) {
+            system.submit([&] { log.add("local"); });
+        }
+    });
+
+    wait_until(started);
+    system.submit([&] { log.add("external"); });
+    go = true;
+
+    ASSERT_TRUE(system.wait_for_completion_timeout(5s));
+    const auto names = log.names();
+    ASSERT_EQ(names.size(), local_fairness_interval + 9);
+    for (size_t i = 0; i < names.size(); ++i) {
+        EXPECT_EQ(names[i], i == local_fairness_interval ? "external" : "local") << "position " << i;
+    }
+}
+
+TEST(WorkStealingTest, WaitForCompletionCoversLocalAndRunningTasks) {
+    unified_thread_system system(pool_config(2));
+    std::atomic<int> finished{0};
+
+    // A tree of nested submissions, all of which go to local queues
+    std::function<void(int)> spawn = [&](int depth) {
+        if (depth > 0) {
+            system.submit(spawn, depth - 1);
+            system.submit(spawn, depth - 1);
+        }
+        std::this_thread::sleep_for(1ms);
+        finished.fetch_add(1);
+    };
+    system.submit(spawn, 5);
+
+    ASSERT_TRUE(system.wait_for_completion_timeout(10s));
+    EXPECT_EQ(finished.load(), 63);
+
+    // Returns only once a task that is already running has finished
+    std::atomic<bool> started{false};
+    std::atomic<bool> done{false};
+    system.submit([&] {
+        started = true;
+        std::this_thread::sleep_for(50ms);
+        done = true;
+    });
+    wait_until(started);
+    system.wait_for_completion();
+    EXPECT_TRUE(done.load());
+
+    // And does not block once everything has drained
+    EXPECT_TRUE(system.wait_for_completion_timeout(100ms));
+}
+
+TEST(WorkStealingTest, NoBatchingWithoutStealing) {
+    auto cfg = pool_config(2);
+    cfg.enable_work_stealing = false;
+    cfg.batch_size = 16;
+    unified_thread_system system(cfg);
+    constexpr int shorts = 8;
+    std::atomic<int> short_done{0};
+    std::atomic<bool> shorts_ran_alongside{false};
+
+    // Occupy both workers, one at a time so neither batches the other's blocker
+    std::atomic<bool> release{false};
+    std::atomic<int> started{0};
+    for (int i = 0; i < 2; ++i) {
+        system.submit([&] {
+            started.fetch_add(1);
+            wait_until(release);
+        });
+        while (started.load() <= i) {
+            std::this_thread::sleep_for(1ms);
+        }
+    }
+
+    // Whoever takes the long task must leave every short one to its peer
+    system.submit([&] {
+        const auto until = std::chrono::steady_clock::now() + 5s;
+        while (short_done.load() < shorts && std::chrono::steady_clock::now() < until) {
+            std::this_thread::sleep_for(1ms);
+        }
+        shorts_ran_alongside = short_done.load() == shorts;
+    });
+    for (int i = 0; i < shorts; ++i) {
+        system.submit([&] { short_done.fetch_add(1); });
+    }
+    release = true;
+
+    ASSERT_TRUE(system.wait_for_completion_timeout(10s));
+    EXPECT_TRUE(shorts_ran_alongside.load());
+}
+
+TEST(WorkStealingTest, NestedSubmitsShareTheQueueLimit) {
+    auto cfg = pool_config(1);
+    cfg.max_queue_size = 4;
+    unified_thread_system system(cfg);
+    std::atomic<bool> started{false};
+    std::atomic<bool> go{false};
+    std::atomic<bool> filled{false};
+    std::atomic<bool> resume{false};
+    std::atomic<int> accepted{0};
+
+    system.submit([&] {
+        started = true;
+        wait_until(go);
+        for (int i = 0; i < 8; ++i) {
+            try {
+                system.submit([] {});
+                accepted.fetch_add(1);
+            } catch (const std::runtime_error&) {
+                break;
+            }
+        }
+        filled = true;
+        wait_until(resume);
+    });
+
+    // Two tasks wait globally, so only two nested ones fit under the limit
+    wait_until(started);
+    system.submit([] {});
+    system.submit([] {});
+    go = true;
+    wait_until(filled);
+    EXPECT_EQ(accepted.load(), 2);
+    EXPECT_EQ(system.queue_size(), 4u);
+
+    // And the tasks in the local queue count against external submits too
+    EXPECT_THROW(system.submit([] {}), std::runtime_error);
+
+    resume = true;
+    ASSERT_TRUE(system.wait_for_completion_timeout(5s));
+    EXPECT_EQ(system.queue_size(), 0u);
+}
@@ -0,0 +1,176 @@
+/**
+ * @file test_worker_utilization.cpp
+ * @brief Unit tests for per-worker time accounting and queue-length averages
+ */
+
+#include <gtest/gtest.h>
+#include <kcenon/integrated/unified_thread_system.h>
+#include <kcenon/integrated/core/worker_activity.h>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace kcenon::integrated;
+using namespace std::chrono_literals;
+
+namespace {
+
+unified_thread_system::config quiet_config(size_t threads) {
+    unified_thread_system::config cfg;
+    cfg.name = "utilization";
+    cfg.thread_count = threads;
+    cfg.enable_console_logging = false;
+    return cfg;
+}
+
+} // namespace
+
+TEST(WorkerUtilizationTest, ClockAccumulatesTimePerActivity) {
+    worker_clock activity;
+    const worker_clock::clock::time_point base{1s};
+
+    EXPECT_EQ(activity.read(base + 1s).available().count(), 0);
+
+    activity.start(worker_activity::spinning, base);
+    activity.enter(worker_activity::busy, base + 10ms);
+    activity.enter(worker_activity::idle, base + 40ms);
+    activity.enter(worker_activity::parked, base + 50ms);
+
+    const auto times = activity.read(base + 100ms);
+    EXPECT_EQ(times.state, worker_activity::parked);
+    EXPECT_EQ(times[worker_activity::spinning], 10ms);
+    EXPECT_EQ(times[worker_activity::busy], 30ms);
+    EXPECT_EQ(times[worker_activity::idle], 10ms);
+    EXPECT_EQ(times[worker_activity::parked], 50ms);
+
+    // Parked time is not available capacity
+    EXPECT_EQ(times.available(), 50ms);
+    EXPECT_DOUBLE_EQ(times.utilization(), 0.6);
+}
+
+TEST(WorkerUtilizationTest, EarlierTimestampsCountAsNoTime) {
+    worker_clock activity;
+    const worker_clock::clock::time_point base{1s};
+    activity.start(worker_activity::busy, base);
+    activity.enter(worker_activity::spinning, base + 20ms);
+    activity.enter(worker_activity::busy, base + 15ms);
+
+    const auto times = activity.read(base + 30ms);
+    EXPECT_EQ(times[worker_activity::busy], 30ms);
+    EXPECT_EQ(times[worker_activity::spinning], 0ms);
+}
+
+TEST(WorkerUtilizationTest, ConcurrentReadsAreConsistent) {
+    worker_clock activity;
+    const worker_clock::clock::time_point base{1s};
+    activity.start(worker_activity::spinning, base);
+
+    std::atomic<bool> stop{false};
+    std::thread owner([&] {
+        auto at = base;
+        for (std::uint64_t i = 0; !stop.load(std::memory_order_relaxed); ++i) {
+            at += 1us;
+            activity.enter(static_cast<worker_activity>(i % worker_activity_count), at);
+        }
+    });
+
+    // Every consistent read accounts for exactly the time since start()
+    const auto far_future = base + 24h;
+    for (int i = 0; i < 20000; ++i) {
+        const auto times = activity.read(far_future);
+        std::chrono::nanoseconds total{0};
+        for (const auto value : times.time) {
+            total += value;
+        }
+        ASSERT_EQ(total, far_future - base);
+    }
+    stop = true;
+    owner.join();
+}
+
+TEST(WorkerUtilizationTest, ActiveWorkersCountsRunningTasks) {
+    unified_thread_system system(quiet_config(3));
+
+    std::promise<void> release;
+    std::shared_future<void> gate = release.get_future().share();
+    std::atomic<int> running{0};
+    std::vector<std::future<void>> futures;
+    for (int i = 0; i < 2; ++i) {
+        futures.push_back(system.submit([gate, &running] {
+            ++running;
+            gate.wait();
+        }));
+    }
+    while (running.load() < 2) {
+        std::this_thread::yield();
+    }
+
+    auto metrics = system.get_metrics();
+    EXPECT_EQ(metrics.active_workers, 2u);
+    ASSERT_EQ(metrics.workers.size(), 3u);
+    size_t busy = 0;
+    for (const auto& worker : metrics.workers) {
+        busy += worker.state == worker_activity::busy ? 1 : 0;
+    }
+    EXPECT_EQ(busy, 2u);
+
+    release.set_value();
+    for (auto& future : futures) {
+        future.get();
+    }
+    system.wait_for_completion();
+    EXPECT_EQ(system.get_metrics().active_workers, 0u);
+}
+
+TEST(WorkerUtilizationTest, BusyTimeAndQueueLengthAreAveraged) {
+    unified_thread_system system(quiet_config(1));
+
+    // One worker, five 20 ms tasks: the last four queue behind the first
+    std::vector<std::future<void>> futures;
+    for (int i = 0; i < 5; ++i) {
+        futures.push_back(system.submit([] { std::this_thread::sleep_for(20ms); }));
+    }
+    for (auto& future : futures) {
+        future.get();
+    }
+    system.wait_for_completion();
+
+    const auto metrics = system.get_metrics();
+    ASSERT_EQ(metrics.workers.size(), 1u);
+    const auto& worker = metrics.workers[0];
+    EXPECT_GE(worker[worker_activity::busy], 100ms);
+    EXPECT_GT(worker.utilization(), 0.0);
+    EXPECT_LE(worker.utilization(), 1.0);
+    EXPECT_DOUBLE_EQ(metrics.pool_utilization, worker.utilization());
+
+    // Queue waits of 20 + 40 + 60 + 80 ms at least, over the system's lifetime
+    const auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                                      metrics.measurement_start).count();
+    EXPECT_GE(metrics.average_queue_length * elapsed, 0.2 * 0.95);
+    EXPECT_GT(metrics.average_busy_workers, 0.0);
+    EXPECT_LE(metrics.average_busy_workers, 1.0);
+    EXPECT_DOUBLE_EQ(metrics.average_tasks_in_system,
+                     metrics.average_busy_workers + metrics.average_queue_length);
+}
+
+TEST(WorkerUtilizationTest, ExportsWorkerTime) {
+    unified_thread_system system(quiet_config(2));
+    system.submit([] { std::this_thread::sleep_for(5ms); }).get();
+    system.wait_for_completion();
+
+    const auto text = system.export_metrics_prometheus();
+    EXPECT_NE(text.find("worker_time_seconds_total{pool=\"utilization\",worker=\"0\",state=\"busy\"}"),
+              std::string::npos);
+    EXPECT_NE(text.find("worker_time_seconds_total{pool=\"utilization\",worker=\"1\",state=\"parked\"} 0"),
+              std::string::npos);
+    EXPECT_NE(text.find("worker_utilization{pool=\"utilization\",worker=\"1\"}"), std::string::npos);
+    EXPECT_NE(text.find("task_queued_seconds_total{pool=\"utilization\"}"), std::string::npos);
+    EXPECT_NE(text.find("configured_workers{pool=\"utilization\"} 2"), std::string::npos);
+
+    const auto json = system.export_metrics_json();
+    EXPECT_NE(json.find("\"pool_utilization\": "), std::string::npos);
+    EXPECT_NE(json.find("\"workers\": [\n    {\"worker\": 0, \"state\": "), std::string::npos);
+}